@@ -26,7 +26,7 @@ dma_free_chunk(struct bio_dma_chunk *chunk)
 }
 
 static struct bio_dma_chunk *
-dma_alloc_chunk(unsigned int cnt)
+dma_alloc_chunk(unsigned int cnt, int numa_node)
 {
 	struct bio_dma_chunk *chunk;
 	ssize_t bytes = (ssize_t)cnt << BIO_DMA_PAGE_SHIFT;
@@ -40,8 +40,7 @@ dma_alloc_chunk(unsigned int cnt)
 	}
 
 	if (bio_spdk_inited) {
-		chunk->bdc_ptr = spdk_dma_malloc_socket(bytes, BIO_DMA_PAGE_SZ, NULL,
-							bio_numa_node);
+		chunk->bdc_ptr = spdk_dma_malloc_socket(bytes, BIO_DMA_PAGE_SZ, NULL, numa_node);
 	} else {
 		rc = posix_memalign(&chunk->bdc_ptr, BIO_DMA_PAGE_SZ, bytes);
 		if (rc)
@@ -86,7 +85,7 @@ dma_buffer_grow(struct bio_dma_buffer *buf, unsigned int cnt)
 	D_ASSERT((buf->bdb_tot_cnt + cnt) <= bio_chk_cnt_max);
 
 	for (i = 0; i < cnt; i++) {
-		chunk = dma_alloc_chunk(bio_chk_sz);
+		chunk = dma_alloc_chunk(bio_chk_sz, buf->bdb_numa_node);
 		if (chunk == NULL) {
 			rc = -DER_NOMEM;
 			break;
@@ -180,10 +179,17 @@ dma_metrics_init(struct bio_dma_buffer *bdb, int tgt_id)
 	if (rc)
 		D_WARN("Failed to create grab_retries telemetry: "DF_RC"\n", DP_RC(rc));
 
+	rc = d_tm_add_metric(&stats->bds_numa_node, D_TM_GAUGE, "NUMA node of the DMA buffer", "",
+			     "dmabuff/numa_node/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create numa_node telemetry: "DF_RC"\n", DP_RC(rc));
+	else
+		d_tm_set_gauge(stats->bds_numa_node, bdb->bdb_numa_node);
+
 }
 
 struct bio_dma_buffer *
-dma_buffer_create(unsigned int init_cnt, int tgt_id)
+dma_buffer_create(unsigned int init_cnt, int tgt_id, int numa_node)
 {
 	struct bio_dma_buffer *buf;
 	int rc;
@@ -196,6 +202,7 @@ dma_buffer_create(unsigned int init_cnt, int tgt_id)
 	D_INIT_LIST_HEAD(&buf->bdb_used_list);
 	buf->bdb_tot_cnt = 0;
 	buf->bdb_active_iods = 0;
+	buf->bdb_numa_node = numa_node;
 
 	rc = ABT_mutex_create(&buf->bdb_mutex);
 	if (rc != ABT_SUCCESS) {
@@ -866,7 +873,7 @@ dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
 	 * be high contention over the SPDK huge page cache.
 	 */
 	if (pg_cnt > bio_chk_sz) {
-		chk = dma_alloc_chunk(pg_cnt);
+		chk = dma_alloc_chunk(pg_cnt, bdb->bdb_numa_node);
 		if (chk == NULL)
 			return -DER_NOMEM;
 
@@ -406,6 +406,9 @@ pci_device_cb(void *ctx, struct spdk_pci_device *pci_device)
 	/* Populate pci_dev_type and socket_id */
 
 	*opts->socket_id = spdk_pci_device_get_socket_id(pci_device);
+	/* Only the socket ID is requested, see bdev_numa_node() */
+	if (opts->pci_type == NULL)
+		return;
 
 	device_type = spdk_pci_device_get_type(pci_device);
 	if (device_type == NULL) {
@@ -434,29 +437,61 @@ pci_device_cb(void *ctx, struct spdk_pci_device *pci_device)
 }
 
 static int
-fetch_pci_dev_info(struct nvme_ctrlr_t *w_ctrlr, const char *tr_addr)
+pci_dev_lookup(struct pci_dev_opts *opts, const char *tr_addr)
 {
-	struct pci_dev_opts  opts = {0};
-	struct spdk_pci_addr pci_addr;
-	int                  rc;
+	int rc;
 
-	rc = spdk_pci_addr_parse(&pci_addr, tr_addr);
+	rc = spdk_pci_addr_parse(&opts->pci_addr, tr_addr);
 	if (rc != 0) {
 		D_ERROR("Unable to parse PCI address for device %s (%s)\n", tr_addr,
 			spdk_strerror(-rc));
 		return -DER_INVAL;
 	}
 
-	opts.finished  = false;
-	opts.status    = 0;
-	opts.pci_addr  = pci_addr;
+	opts->finished = false;
+	opts->status   = 0;
+
+	spdk_pci_for_each_device(opts, pci_device_cb);
+
+	return opts->status;
+}
+
+static int
+fetch_pci_dev_info(struct nvme_ctrlr_t *w_ctrlr, const char *tr_addr)
+{
+	struct pci_dev_opts opts = {0};
+
 	opts.socket_id = &w_ctrlr->socket_id;
 	opts.pci_type  = &w_ctrlr->pci_type;
 	opts.pci_cfg   = &w_ctrlr->pci_cfg;
 
-	spdk_pci_for_each_device(&opts, pci_device_cb);
+	return pci_dev_lookup(&opts, tr_addr);
+}
+
+/*
+ * Return the NUMA node the NVMe controller backing @d_bdev is attached to, -1 when it's
+ * unknown (non-NVMe bdev, VMD or failed lookup).
+ */
+int
+bdev_numa_node(struct bio_bdev *d_bdev)
+{
+	struct bio_dev_info b_info    = {0};
+	struct pci_dev_opts opts      = {0};
+	int                 socket_id = -1;
+	int                 rc;
+
+	if (d_bdev == NULL || d_bdev->bb_name == NULL)
+		return -1;
 
-	return opts.status;
+	rc = fill_in_traddr(&b_info, d_bdev->bb_name);
+	if (rc != 0 || b_info.bdi_traddr == NULL)
+		goto out;
+
+	opts.socket_id = &socket_id;
+	pci_dev_lookup(&opts, b_info.bdi_traddr);
+out:
+	D_FREE(b_info.bdi_traddr);
+	return socket_id >= 0 ? socket_id : -1;
 }
 
 static int
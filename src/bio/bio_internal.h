@@ -110,6 +110,7 @@ struct bio_dma_stats {
 	struct d_tm_node_t	*bds_queued_iods;
 	struct d_tm_node_t	*bds_grab_errs;
 	struct d_tm_node_t	*bds_grab_retries;
+	struct d_tm_node_t	*bds_numa_node;
 };
 
 /*
@@ -130,6 +131,8 @@ struct bio_dma_buffer {
 	struct bio_bulk_cache	 bdb_bulk_cache;
 	struct bio_dma_stats	 bdb_stats;
 	uint64_t		 bdb_dump_ts;
+	/* NUMA node the DMA chunks are allocated from */
+	int			 bdb_numa_node;
 };
 
 #define BIO_PROTO_NVME_STATS_LIST					\
@@ -572,7 +575,7 @@ int bdev_name2roles(const char *bdev_name);
 
 /* bio_buffer.c */
 void dma_buffer_destroy(struct bio_dma_buffer *buf);
-struct bio_dma_buffer *dma_buffer_create(unsigned int init_cnt, int tgt_id);
+struct bio_dma_buffer *dma_buffer_create(unsigned int init_cnt, int tgt_id, int numa_node);
 void bio_memcpy(struct bio_desc *biod, uint16_t media, void *media_addr,
 		void *addr, ssize_t n);
 int dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg);
@@ -654,6 +657,7 @@ void trigger_faulty_reaction(struct bio_blobstore *bbs);
 
 /* bio_device.c */
 int fill_in_traddr(struct bio_dev_info *b_info, char *dev_name);
+int bdev_numa_node(struct bio_bdev *d_bdev);
 
 /* bio_config.c */
 int
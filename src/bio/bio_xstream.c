@@ -1545,6 +1545,7 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id, bool self_polling)
 	struct bio_blobstore	*bbs;
 	struct bio_bdev		*d_bdev;
 	char			 th_name[32];
+	int			 numa_node;
 	int			 rc = 0;
 	enum smd_dev_type	 st;
 
@@ -1557,7 +1558,7 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id, bool self_polling)
 
 	/* Skip NVMe context setup if the daos_nvme.conf isn't present */
 	if (!bio_nvme_configured(SMD_DEV_TYPE_MAX)) {
-		ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id);
+		ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id, bio_numa_node);
 		if (ctxt->bxc_dma_buf == NULL) {
 			D_FREE(ctxt);
 			*pctxt = NULL;
@@ -1670,7 +1671,19 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id, bool self_polling)
 		D_ASSERT(d_bdev != NULL);
 	}
 
-	ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id);
+	/*
+	 * Allocate the DMA chunks from the NUMA node of the data device, the SSD reads and writes
+	 * them, falling back to the node configured for the engine.
+	 */
+	numa_node = -1;
+	if (ctxt->bxc_xs_blobstores[SMD_DEV_TYPE_DATA] != NULL)
+		numa_node = bdev_numa_node(
+			ctxt->bxc_xs_blobstores[SMD_DEV_TYPE_DATA]->bxb_blobstore->bb_dev);
+	if (numa_node < 0)
+		numa_node = bio_numa_node;
+	D_INFO("DMA buffer of tgt_id:%d allocated from NUMA node %d\n", tgt_id, numa_node);
+
+	ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id, numa_node);
 	if (ctxt->bxc_dma_buf == NULL) {
 		D_ERROR("failed to initialize dma buffer\n");
 		rc = -DER_NOMEM;
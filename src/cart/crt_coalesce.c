@@ -0,0 +1,696 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT. It implements the coalescing of small RPCs.
+ *
+ * Requests of opcodes registered with CRT_RPC_FEAT_COALESCE are not sent right
+ * away but have their input encoded into a per-endpoint batch. At the next
+ * crt_progress() call every batch is sent as a single CRT_OPC_COALESCE request
+ * (the carrier), or as is if it holds a single request. The server unpacks the
+ * carrier into regular server side requests which go through the usual handler
+ * dispatch, and packs their replies into the carrier reply once the last one
+ * has been sent.
+ *
+ * The carried requests keep their own tracking: they hold the endpoint credits
+ * and the quota, and time out on their own. The carrier only has a timeout, the
+ * longest of the requests it carries.
+ */
+#define D_LOGFAC	DD_FAC(rpc)
+
+#include "crt_internal.h"
+
+/* Header of each request or reply in a coalesced message, followed by its body */
+struct crt_coal_rec {
+	uint64_t	cr_rpcid;
+	uint32_t	cr_opc;
+	int32_t		cr_rc;
+	uint32_t	cr_len;
+	uint32_t	cr_padding;
+};
+
+/* Reply of a request carried by a coalesced request, server side */
+struct crt_coal_slot {
+	void		*cs_buf;
+	uint32_t	 cs_len;
+	int32_t		 cs_rc;
+	uint64_t	 cs_rpcid;
+	uint32_t	 cs_opc;
+	bool		 cs_done;
+};
+
+struct crt_coal_batch {
+	/* link to crt_context::cc_coal_batches */
+	d_list_t		 cb_link;
+	crt_endpoint_t		 cb_ep;
+	uint32_t		 cb_nr;
+	/* longest timeout of the carried requests */
+	uint32_t		 cb_timeout;
+	/* full, the next request to the endpoint starts a new batch */
+	bool			 cb_closed;
+	/* client side, the carried requests and their packed input */
+	struct crt_rpc_priv	*cb_rpcs[CRT_COAL_NR_MAX];
+	char			*cb_buf;
+	size_t			 cb_buf_size;
+	size_t			 cb_buf_used;
+	/* server side, the replies and the number of them not sent yet */
+	struct crt_coal_slot	*cb_slots;
+	ATOMIC uint32_t		 cb_pending;
+};
+
+int
+crt_coal_ctx_init(struct crt_context *ctx)
+{
+	D_INIT_LIST_HEAD(&ctx->cc_coal_batches);
+	atomic_init(&ctx->cc_coal_nr, 0);
+	ctx->cc_coal_proc = NULL;
+
+	return D_MUTEX_INIT(&ctx->cc_coal_mutex, NULL);
+}
+
+void
+crt_coal_batch_free(struct crt_coal_batch *batch)
+{
+	uint32_t i;
+
+	if (batch->cb_slots != NULL) {
+		for (i = 0; i < batch->cb_nr; i++)
+			D_FREE(batch->cb_slots[i].cs_buf);
+		D_FREE(batch->cb_slots);
+	}
+	D_FREE(batch->cb_buf);
+	D_FREE(batch);
+}
+
+/* Called with cc_coal_mutex held */
+static int
+crt_coal_proc_reset(struct crt_context *ctx, void *buf, size_t size, crt_proc_op_t op)
+{
+	if (ctx->cc_coal_proc == NULL)
+		return crt_proc_create(ctx, buf, size, op, &ctx->cc_coal_proc);
+
+	return crt_proc_reset(ctx->cc_coal_proc, buf, size, op);
+}
+
+/*
+ * Encode \a data into \a buf, called with cc_coal_mutex held. The encoder does
+ * not fail when \a buf is too small, it returns a \a len larger than \a size.
+ */
+static int
+crt_coal_encode(struct crt_context *ctx, crt_proc_cb_t proc_cb, void *data, void *buf,
+		size_t size, size_t *len)
+{
+	int rc;
+
+	*len = 0;
+	if (proc_cb == NULL || data == NULL)
+		return 0;
+
+	rc = crt_coal_proc_reset(ctx, buf, size, CRT_PROC_ENCODE);
+	if (rc != 0)
+		return rc;
+
+	rc = proc_cb(ctx->cc_coal_proc, data);
+	if (rc == 0)
+		*len = crp_proc_get_size_used(ctx->cc_coal_proc);
+	return rc;
+}
+
+static int
+crt_coal_proc(struct crt_context *ctx, crt_proc_cb_t proc_cb, void *data, void *buf,
+	      size_t size, crt_proc_op_t op)
+{
+	int rc;
+
+	if (proc_cb == NULL || data == NULL)
+		return 0;
+
+	D_MUTEX_LOCK(&ctx->cc_coal_mutex);
+	rc = crt_coal_proc_reset(ctx, buf, size, op);
+	if (rc == 0)
+		rc = proc_cb(ctx->cc_coal_proc, data);
+	D_MUTEX_UNLOCK(&ctx->cc_coal_mutex);
+
+	return rc;
+}
+
+/* Return the body of the next record of \a iov and copy its header to \a rec */
+static void *
+crt_coal_rec_next(d_iov_t *iov, size_t *off, struct crt_coal_rec *rec)
+{
+	void *body;
+
+	if (iov->iov_buf == NULL || *off + sizeof(*rec) > iov->iov_len)
+		return NULL;
+
+	memcpy(rec, iov->iov_buf + *off, sizeof(*rec));
+	if (rec->cr_len > iov->iov_len - *off - sizeof(*rec))
+		return NULL;
+
+	body = iov->iov_buf + *off + sizeof(*rec);
+	*off += sizeof(*rec) + rec->cr_len;
+	return body;
+}
+
+static struct crt_coal_batch *
+crt_coal_batch_find(struct crt_context *ctx, crt_endpoint_t *ep)
+{
+	struct crt_coal_batch *batch;
+
+	d_list_for_each_entry(batch, &ctx->cc_coal_batches, cb_link) {
+		if (!batch->cb_closed && batch->cb_ep.ep_grp == ep->ep_grp &&
+		    batch->cb_ep.ep_rank == ep->ep_rank && batch->cb_ep.ep_tag == ep->ep_tag)
+			return batch;
+	}
+	return NULL;
+}
+
+static int
+crt_coal_buf_reserve(struct crt_coal_batch *batch, size_t size)
+{
+	size_t	 new_size;
+	char	*buf;
+
+	if (batch->cb_buf_used + size <= batch->cb_buf_size)
+		return 0;
+
+	new_size = max(batch->cb_buf_size * 2, batch->cb_buf_used + size);
+	D_REALLOC(buf, batch->cb_buf, batch->cb_buf_size, new_size);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	batch->cb_buf      = buf;
+	batch->cb_buf_size = new_size;
+	return 0;
+}
+
+/*
+ * Add a request to the batch of its endpoint, called with the request locked
+ * and its address resolved. \a queued is left false when the request has to be
+ * sent on its own.
+ */
+int
+crt_coal_req_add(struct crt_rpc_priv *rpc_priv, bool *queued)
+{
+	struct crt_context	*ctx = rpc_priv->crp_pub.cr_ctx;
+	struct crt_req_format	*crf = rpc_priv->crp_opc_info->coi_crf;
+	struct crt_coal_batch	*batch;
+	struct crt_coal_rec	 rec = {0};
+	size_t			 len;
+	int			 rc;
+
+	*queued = false;
+	D_MUTEX_LOCK(&ctx->cc_coal_mutex);
+	batch = crt_coal_batch_find(ctx, &rpc_priv->crp_pub.cr_ep);
+	if (batch == NULL) {
+		D_ALLOC_PTR(batch);
+		if (batch == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		batch->cb_ep = rpc_priv->crp_pub.cr_ep;
+		d_list_add_tail(&batch->cb_link, &ctx->cc_coal_batches);
+		atomic_fetch_add(&ctx->cc_coal_nr, 1);
+	}
+
+	rc = crt_coal_buf_reserve(batch, sizeof(rec) + CRT_COAL_INPUT_MAX);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	rc = crt_coal_encode(ctx, crf == NULL ? NULL : crf->crf_proc_in,
+			     rpc_priv->crp_pub.cr_input,
+			     batch->cb_buf + batch->cb_buf_used + sizeof(rec), CRT_COAL_INPUT_MAX,
+			     &len);
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "failed to encode input, " DF_RC "\n", DP_RC(rc));
+		D_GOTO(out, rc);
+	}
+
+	/* too large to be worth it, an empty batch is freed when flushed */
+	if (len > CRT_COAL_INPUT_MAX)
+		D_GOTO(out, rc = 0);
+
+	rec.cr_rpcid = rpc_priv->crp_req_hdr.cch_rpcid;
+	rec.cr_opc   = rpc_priv->crp_pub.cr_opc;
+	rec.cr_len   = len;
+	memcpy(batch->cb_buf + batch->cb_buf_used, &rec, sizeof(rec));
+	batch->cb_buf_used += sizeof(rec) + len;
+
+	/* released once the batch completes */
+	RPC_ADDREF(rpc_priv);
+	batch->cb_rpcs[batch->cb_nr++] = rpc_priv;
+	batch->cb_timeout = max(batch->cb_timeout, rpc_priv->crp_timeout_sec);
+	if (batch->cb_nr >= crt_gdata.cg_coal_max)
+		batch->cb_closed = true;
+
+	rpc_priv->crp_coal  = 1;
+	rpc_priv->crp_state = RPC_STATE_REQ_SENT;
+	*queued = true;
+	RPC_TRACE(DB_NET, rpc_priv, "coalesced, %u in batch.\n", batch->cb_nr);
+out:
+	D_MUTEX_UNLOCK(&ctx->cc_coal_mutex);
+	return rc;
+}
+
+/* Complete a carried request, \a body is its encoded reply within \a carrier */
+static void
+crt_coal_req_complete(struct crt_rpc_priv *rpc_priv, struct crt_rpc_priv *carrier, void *body,
+		      uint32_t len, int rc)
+{
+	crt_rpc_t		*rpc_pub = &rpc_priv->crp_pub;
+	struct crt_req_format	*crf = rpc_priv->crp_opc_info->coi_crf;
+
+	crt_rpc_lock(rpc_priv);
+	/* timed out or aborted on its own, see crt_req_timeout_hdlr() */
+	if (rpc_priv->crp_state != RPC_STATE_REQ_SENT || !rpc_priv->crp_coal) {
+		crt_rpc_unlock(rpc_priv);
+		return;
+	}
+
+	if (rc == 0 && rpc_pub->cr_output_size > 0) {
+		rc = crt_coal_proc(rpc_pub->cr_ctx, crf->crf_proc_out, rpc_pub->cr_output, body,
+				   len, CRT_PROC_DECODE);
+		if (rc == 0) {
+			/* the decoded output points into the carrier reply */
+			RPC_ADDREF(carrier);
+			rpc_priv->crp_coal_parent = carrier;
+			rpc_priv->crp_output_got  = 1;
+		} else {
+			RPC_ERROR(rpc_priv, "failed to decode output, " DF_RC "\n", DP_RC(rc));
+		}
+	}
+
+	/* final state is set from rc by crt_rpc_complete_and_unlock() */
+	rpc_priv->crp_state = (rc == -DER_CANCELED || rc == -DER_TIMEDOUT) ?
+			      RPC_STATE_CANCELED : RPC_STATE_COMPLETED;
+	crt_context_req_untrack(rpc_priv);
+	crt_rpc_complete_and_unlock(rpc_priv, rc);
+}
+
+/* Complete all the requests of a batch from the \a carrier reply, or with \a rc */
+static void
+crt_coal_batch_complete(struct crt_coal_batch *batch, struct crt_rpc_priv *carrier, int rc)
+{
+	struct crt_coalesce_out	*out = NULL;
+	struct crt_rpc_priv	*rpc_priv;
+	struct crt_coal_rec	 rec = {0};
+	size_t			 off = 0;
+	void			*body = NULL;
+	uint32_t		 i;
+	int			 req_rc;
+
+	if (rc == 0)
+		out = crt_reply_get(&carrier->crp_pub);
+
+	for (i = 0; i < batch->cb_nr; i++) {
+		rpc_priv = batch->cb_rpcs[i];
+		req_rc   = rc;
+		if (req_rc == 0) {
+			/* replies are packed in the same order as the requests */
+			body = crt_coal_rec_next(&out->co_buf, &off, &rec);
+			if (body == NULL || rec.cr_rpcid != rpc_priv->crp_req_hdr.cch_rpcid) {
+				RPC_ERROR(rpc_priv, "no reply in coalesced reply\n");
+				req_rc = -DER_PROTO;
+			} else {
+				req_rc = rec.cr_rc;
+			}
+		}
+		crt_coal_req_complete(rpc_priv, carrier, body, rec.cr_len, req_rc);
+		/* addref in crt_coal_req_add() */
+		RPC_DECREF(rpc_priv);
+	}
+	crt_coal_batch_free(batch);
+}
+
+static void
+crt_coal_send_cb(const struct crt_cb_info *cb_info)
+{
+	struct crt_coal_batch	*batch = cb_info->cci_arg;
+	struct crt_coalesce_out	*out;
+	int			 rc = cb_info->cci_rc;
+
+	if (rc == 0) {
+		out = crt_reply_get(cb_info->cci_rpc);
+		rc  = out->co_rc;
+	}
+
+	crt_coal_batch_complete(batch,
+				rc == 0 ? container_of(cb_info->cci_rpc, struct crt_rpc_priv,
+						       crp_pub) : NULL,
+				rc);
+}
+
+/* Send the only request of a batch as a regular request */
+static void
+crt_coal_send_lone(struct crt_rpc_priv *rpc_priv)
+{
+	int rc;
+
+	crt_rpc_lock(rpc_priv);
+	if (rpc_priv->crp_state != RPC_STATE_REQ_SENT || !rpc_priv->crp_coal) {
+		crt_rpc_unlock(rpc_priv);
+		return;
+	}
+
+	rpc_priv->crp_coal = 0;
+	rc = crt_req_send_direct(rpc_priv);
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "crt_req_send_direct() failed, " DF_RC "\n", DP_RC(rc));
+		rpc_priv->crp_state = RPC_STATE_INITED;
+		crt_context_req_untrack(rpc_priv);
+		crt_rpc_complete_and_unlock(rpc_priv, rc);
+		return;
+	}
+	crt_rpc_unlock(rpc_priv);
+}
+
+static void
+crt_coal_batch_send(struct crt_context *ctx, struct crt_coal_batch *batch)
+{
+	struct crt_coalesce_in	*in;
+	crt_rpc_t		*req;
+	int			 rc;
+
+	if (batch->cb_nr <= 1) {
+		if (batch->cb_nr == 1) {
+			crt_coal_send_lone(batch->cb_rpcs[0]);
+			/* addref in crt_coal_req_add() */
+			RPC_DECREF(batch->cb_rpcs[0]);
+		}
+		crt_coal_batch_free(batch);
+		return;
+	}
+
+	rc = crt_req_create(ctx, &batch->cb_ep, CRT_OPC_COALESCE, &req);
+	if (rc != 0) {
+		D_ERROR("crt_req_create(COALESCE) to %u:%u failed, " DF_RC "\n",
+			batch->cb_ep.ep_rank, batch->cb_ep.ep_tag, DP_RC(rc));
+		crt_coal_batch_complete(batch, NULL, rc);
+		return;
+	}
+
+	in           = crt_req_get(req);
+	in->co_count = batch->cb_nr;
+	d_iov_set(&in->co_buf, batch->cb_buf, batch->cb_buf_used);
+	crt_req_set_timeout(req, batch->cb_timeout);
+
+	/* failures are reported through crt_coal_send_cb() */
+	crt_req_send(req, crt_coal_send_cb, batch);
+}
+
+/* Send all the batches of \a ctx, called from the progress routines */
+void
+crt_coal_flush(struct crt_context *ctx)
+{
+	struct crt_coal_batch	*batch;
+	d_list_t		 batches;
+
+	if (atomic_load_relaxed(&ctx->cc_coal_nr) == 0)
+		return;
+
+	D_INIT_LIST_HEAD(&batches);
+	D_MUTEX_LOCK(&ctx->cc_coal_mutex);
+	d_list_splice_init(&ctx->cc_coal_batches, &batches);
+	atomic_store_relaxed(&ctx->cc_coal_nr, 0);
+	D_MUTEX_UNLOCK(&ctx->cc_coal_mutex);
+
+	while ((batch = d_list_pop_entry(&batches, struct crt_coal_batch, cb_link)) != NULL)
+		crt_coal_batch_send(ctx, batch);
+}
+
+void
+crt_coal_ctx_fini(struct crt_context *ctx)
+{
+	struct crt_coal_batch	*batch;
+	d_list_t		 batches;
+
+	/* batches still there were never sent */
+	D_INIT_LIST_HEAD(&batches);
+	D_MUTEX_LOCK(&ctx->cc_coal_mutex);
+	d_list_splice_init(&ctx->cc_coal_batches, &batches);
+	atomic_store_relaxed(&ctx->cc_coal_nr, 0);
+	D_MUTEX_UNLOCK(&ctx->cc_coal_mutex);
+
+	while ((batch = d_list_pop_entry(&batches, struct crt_coal_batch, cb_link)) != NULL)
+		crt_coal_batch_complete(batch, NULL, -DER_CANCELED);
+
+	if (ctx->cc_coal_proc != NULL)
+		crt_proc_destroy(ctx->cc_coal_proc);
+	D_MUTEX_DESTROY(&ctx->cc_coal_mutex);
+}
+
+/* Drop one pending reply of \a carrier, the last one packs and sends them all */
+static void
+crt_coal_reply_put(struct crt_rpc_priv *carrier)
+{
+	struct crt_coal_batch	*batch = carrier->crp_coal_batch;
+	struct crt_coalesce_out	*out = crt_reply_get(&carrier->crp_pub);
+	struct crt_coal_slot	*slot;
+	struct crt_coal_rec	 rec = {0};
+	size_t			 size = 0;
+	char			*buf;
+	char			*ptr;
+	uint32_t		 i;
+	int			 rc;
+
+	if (atomic_fetch_sub(&batch->cb_pending, 1) != 1)
+		return;
+
+	for (i = 0; i < batch->cb_nr; i++)
+		size += sizeof(rec) + batch->cb_slots[i].cs_len;
+
+	D_ALLOC(buf, size);
+	if (buf == NULL) {
+		out->co_rc = -DER_NOMEM;
+	} else {
+		for (i = 0, ptr = buf; i < batch->cb_nr; i++) {
+			slot         = &batch->cb_slots[i];
+			rec.cr_rpcid = slot->cs_rpcid;
+			rec.cr_opc   = slot->cs_opc;
+			rec.cr_rc    = slot->cs_rc;
+			rec.cr_len   = slot->cs_len;
+			memcpy(ptr, &rec, sizeof(rec));
+			if (slot->cs_len > 0)
+				memcpy(ptr + sizeof(rec), slot->cs_buf, slot->cs_len);
+			ptr += sizeof(rec) + slot->cs_len;
+		}
+		d_iov_set(&out->co_buf, buf, size);
+	}
+
+	/* the reply is encoded before crt_reply_send() returns */
+	rc = crt_reply_send(&carrier->crp_pub);
+	if (rc != 0)
+		RPC_ERROR(carrier, "crt_reply_send() failed, " DF_RC "\n", DP_RC(rc));
+
+	d_iov_set(&out->co_buf, NULL, 0);
+	D_FREE(buf);
+	for (i = 0; i < batch->cb_nr; i++)
+		D_FREE(batch->cb_slots[i].cs_buf);
+}
+
+static void
+crt_coal_slot_fail(struct crt_rpc_priv *carrier, uint32_t idx, int rc)
+{
+	carrier->crp_coal_batch->cb_slots[idx].cs_rc   = rc;
+	carrier->crp_coal_batch->cb_slots[idx].cs_done = true;
+	crt_coal_reply_put(carrier);
+}
+
+/* Reply to a request carried by a coalesced request, server side */
+int
+crt_coal_reply_send(struct crt_rpc_priv *rpc_priv, int rc)
+{
+	struct crt_rpc_priv	*carrier = rpc_priv->crp_coal_parent;
+	struct crt_context	*ctx = rpc_priv->crp_pub.cr_ctx;
+	struct crt_req_format	*crf = rpc_priv->crp_opc_info->coi_crf;
+	struct crt_coal_slot	*slot;
+	size_t			 size = CRT_COAL_INPUT_MAX;
+	size_t			 len;
+
+	D_ASSERT(carrier != NULL && carrier->crp_coal_batch != NULL);
+	slot = &carrier->crp_coal_batch->cb_slots[rpc_priv->crp_coal_idx];
+
+	D_MUTEX_LOCK(&ctx->cc_coal_mutex);
+	if (slot->cs_done) {
+		D_MUTEX_UNLOCK(&ctx->cc_coal_mutex);
+		RPC_ERROR(rpc_priv, "reply already sent.\n");
+		return -DER_ALREADY;
+	}
+
+	/* retry with a larger buffer when the first one was too small */
+	while (rc == 0 && rpc_priv->crp_pub.cr_output_size > 0) {
+		D_ALLOC(slot->cs_buf, size);
+		if (slot->cs_buf == NULL) {
+			rc = -DER_NOMEM;
+			break;
+		}
+
+		rc = crt_coal_encode(ctx, crf->crf_proc_out, rpc_priv->crp_pub.cr_output,
+				     slot->cs_buf, size, &len);
+		if (rc == 0 && len <= size) {
+			slot->cs_len = len;
+			break;
+		}
+		D_FREE(slot->cs_buf);
+		size = len;
+	}
+	if (rc != 0)
+		RPC_ERROR(rpc_priv, "failed to encode output, " DF_RC "\n", DP_RC(rc));
+
+	slot->cs_rc   = rc;
+	slot->cs_done = true;
+	D_MUTEX_UNLOCK(&ctx->cc_coal_mutex);
+
+	crt_coal_reply_put(carrier);
+	return rc;
+}
+
+/* Dispatch the request of slot \a idx of \a carrier like crt_rpc_handler_common() */
+static void
+crt_coal_req_dispatch(struct crt_rpc_priv *carrier, uint32_t idx, struct crt_coal_rec *rec,
+		      void *body)
+{
+	struct crt_context	*ctx = carrier->crp_pub.cr_ctx;
+	struct crt_rpc_priv	*rpc_priv;
+	crt_rpc_t		*rpc_pub;
+	int			 rc;
+
+	if (rec->cr_opc == CRT_OPC_COALESCE) {
+		RPC_ERROR(carrier, "nested coalesced request\n");
+		crt_coal_slot_fail(carrier, idx, -DER_PROTO);
+		return;
+	}
+
+	rc = crt_rpc_priv_alloc(rec->cr_opc, &rpc_priv, false /* forward */);
+	if (rc != 0) {
+		crt_coal_slot_fail(carrier, idx, rc == -DER_NOMEM ? -DER_DOS : rc);
+		return;
+	}
+	rpc_pub = &rpc_priv->crp_pub;
+
+	/* bulk transfers of the request go through the carrier handle */
+	crt_hg_header_copy(carrier, rpc_priv);
+	rpc_priv->crp_req_hdr.cch_opc   = rec->cr_opc;
+	rpc_priv->crp_req_hdr.cch_rpcid = rec->cr_rpcid;
+	rpc_priv->crp_fail_hlc          = carrier->crp_fail_hlc;
+	rpc_pub->cr_ep.ep_rank          = rpc_priv->crp_req_hdr.cch_dst_rank;
+	rpc_pub->cr_ep.ep_tag           = rpc_priv->crp_req_hdr.cch_dst_tag;
+
+	/* dropped in crt_coal_req_destroy() */
+	RPC_ADDREF(carrier);
+	rpc_priv->crp_coal_parent = carrier;
+	rpc_priv->crp_coal_idx    = idx;
+	rpc_priv->crp_coal        = 1;
+
+	crt_rpc_priv_init(rpc_priv, ctx, true /* srv_flag */);
+
+	if (rpc_pub->cr_input_size > 0) {
+		rc = crt_coal_proc(ctx, rpc_priv->crp_opc_info->coi_crf->crf_proc_in,
+				   rpc_pub->cr_input, body, rec->cr_len, CRT_PROC_DECODE);
+		if (rc != 0) {
+			RPC_ERROR(rpc_priv, "failed to decode input, " DF_RC "\n", DP_RC(rc));
+			crt_hg_reply_error_send(rpc_priv, -DER_MISC);
+			RPC_DECREF(rpc_priv);
+			return;
+		}
+		rpc_priv->crp_input_got = 1;
+	}
+	rpc_pub->cr_ep.ep_grp = NULL;
+
+	if (rpc_priv->crp_opc_info->coi_rpc_cb == NULL) {
+		RPC_ERROR(rpc_priv, "no handler registered\n");
+		crt_hg_reply_error_send(rpc_priv, -DER_UNREG);
+		RPC_DECREF(rpc_priv);
+		return;
+	}
+
+	rc = crt_rpc_common_hdlr(rpc_priv);
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "crt_rpc_common_hdlr() failed, " DF_RC "\n", DP_RC(rc));
+		crt_hg_reply_error_send(rpc_priv, rc);
+		RPC_DECREF(rpc_priv);
+	}
+}
+
+void
+crt_hdlr_coalesce(crt_rpc_t *rpc)
+{
+	struct crt_rpc_priv	*carrier = container_of(rpc, struct crt_rpc_priv, crp_pub);
+	struct crt_coalesce_in	*in = crt_req_get(rpc);
+	struct crt_coalesce_out	*out = crt_reply_get(rpc);
+	struct crt_coal_batch	*batch;
+	struct crt_coal_rec	 rec;
+	size_t			 off = 0;
+	void			*body;
+	uint32_t		 i;
+	int			 rc;
+
+	if (in->co_count == 0 || in->co_count > CRT_COAL_NR_MAX) {
+		RPC_ERROR(carrier, "invalid number of coalesced requests %u\n", in->co_count);
+		D_GOTO(out, rc = -DER_PROTO);
+	}
+
+	D_ALLOC_PTR(batch);
+	if (batch == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	D_ALLOC_ARRAY(batch->cb_slots, in->co_count);
+	if (batch->cb_slots == NULL) {
+		D_FREE(batch);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	batch->cb_nr = in->co_count;
+	/* one for each request plus one held until all of them are dispatched */
+	atomic_init(&batch->cb_pending, batch->cb_nr + 1);
+	/* freed with the carrier */
+	carrier->crp_coal_batch = batch;
+
+	for (i = 0; i < batch->cb_nr; i++) {
+		body = crt_coal_rec_next(&in->co_buf, &off, &rec);
+		if (body == NULL) {
+			RPC_ERROR(carrier, "truncated coalesced request, %u/%u\n", i,
+				  batch->cb_nr);
+			for (; i < batch->cb_nr; i++)
+				crt_coal_slot_fail(carrier, i, -DER_PROTO);
+			break;
+		}
+
+		batch->cb_slots[i].cs_rpcid = rec.cr_rpcid;
+		batch->cb_slots[i].cs_opc   = rec.cr_opc;
+		crt_coal_req_dispatch(carrier, i, &rec, body);
+	}
+
+	crt_coal_reply_put(carrier);
+	return;
+
+out:
+	out->co_rc = rc;
+	rc = crt_reply_send(rpc);
+	if (rc != 0)
+		RPC_ERROR(carrier, "crt_reply_send() failed, " DF_RC "\n", DP_RC(rc));
+}
+
+/* Free a request carried by a coalesced request, instead of crt_hg_req_destroy() */
+void
+crt_coal_req_destroy(struct crt_rpc_priv *rpc_priv)
+{
+	struct crt_rpc_priv	*carrier = rpc_priv->crp_coal_parent;
+	struct crt_req_format	*crf = rpc_priv->crp_opc_info->coi_crf;
+	crt_rpc_t		*rpc_pub = &rpc_priv->crp_pub;
+
+	if (rpc_priv->crp_output_got != 0)
+		crt_coal_proc(rpc_pub->cr_ctx, crf->crf_proc_out, rpc_pub->cr_output, NULL, 0,
+			      CRT_PROC_FREE);
+	if (rpc_priv->crp_input_got != 0)
+		crt_coal_proc(rpc_pub->cr_ctx, crf->crf_proc_in, rpc_pub->cr_input, NULL, 0,
+			      CRT_PROC_FREE);
+
+	crt_rpc_priv_fini(rpc_priv);
+	crt_rpc_priv_free(rpc_priv);
+
+	/* the decoded data pointed into the carrier */
+	if (carrier != NULL)
+		RPC_DECREF(carrier);
+}
@@ -30,8 +30,7 @@ epi_op_key_hash(struct d_hash_table *hhtab, const void *key,
 {
 	D_ASSERT(ksize == sizeof(d_rank_t));
 
-	return (uint32_t)(*(const uint32_t *)key
-			 & ((1U << CRT_EPI_TABLE_BITS) - 1));
+	return *(const uint32_t *)key;
 }
 
 static bool
@@ -51,8 +50,7 @@ epi_op_rec_hash(struct d_hash_table *htable, d_list_t *link)
 {
 	struct crt_ep_inflight *epi = epi_link2ptr(link);
 
-	return (uint32_t)epi->epi_ep.ep_rank
-			& ((1U << CRT_EPI_TABLE_BITS) - 1);
+	return (uint32_t)epi->epi_ep.ep_rank;
 }
 
 static void
@@ -165,8 +163,8 @@ crt_context_init(crt_context_t crt_ctx)
 		D_GOTO(out_mutex_destroy, rc);
 	}
 
-	/* create epi table, use external lock */
-	rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK, CRT_EPI_TABLE_BITS,
+	/* create epi table, use external lock, grows with the number of peers */
+	rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK | D_HASH_FT_RESIZE, CRT_EPI_TABLE_BITS,
 					 NULL, &epi_table_ops,
 					 &ctx->cc_epi_table);
 	if (rc != 0) {
@@ -175,6 +173,8 @@ crt_context_init(crt_context_t crt_ctx)
 	}
 
 	rc = context_quotas_init(crt_ctx);
+	if (rc == 0)
+		rc = crt_coal_ctx_init(ctx);
 
 	D_GOTO(out, rc);
 
@@ -326,6 +326,45 @@ crt_context_provider_create(crt_context_t *crt_ctx, crt_provider_t provider, boo
 				      "net/%s/quota_exceeded/ctx_%u", prov, ctx->cc_idx);
 		if (ret)
 			DL_WARN(rc, "Failed to create quota exceeded counter");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_hg_pool.chp_hit, D_TM_COUNTER,
+				      "Total number of requests served from the handle pool",
+				      "reqs", "net/%s/hg_pool_hit/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create handle pool hit counter");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_hg_pool.chp_miss, D_TM_COUNTER,
+				      "Total number of requests that found the handle pool empty",
+				      "reqs", "net/%s/hg_pool_miss/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create handle pool miss counter");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_hg_pool.chp_size, D_TM_GAUGE,
+				      "Current number of handles in the handle pool", "handles",
+				      "net/%s/hg_pool_size/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create handle pool size gauge");
+		else
+			d_tm_set_gauge(ctx->cc_hg_ctx.chc_hg_pool.chp_size,
+				       ctx->cc_hg_ctx.chc_hg_pool.chp_num);
+
+		ret = d_tm_add_metric(&ctx->cc_prog_spin_nr, D_TM_COUNTER,
+				      "Total number of progress waits completed while spinning",
+				      "waits", "net/%s/progress_spin/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create progress spin counter");
+
+		ret = d_tm_add_metric(&ctx->cc_prog_sleep_nr, D_TM_COUNTER,
+				      "Total number of progress waits that blocked", "waits",
+				      "net/%s/progress_sleep/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create progress sleep counter");
+
+		ret = d_tm_add_metric(&ctx->cc_prog_spin_us, D_TM_GAUGE,
+				      "Current interval progress spins for after activity", "us",
+				      "net/%s/progress_spin_us/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create progress spin interval gauge");
 	}
 
 	if (crt_is_service() && crt_gdata.cg_auto_swim_disable == 0 &&
@@ -834,6 +873,8 @@ crt_context_destroy(crt_context_t crt_ctx, int force)
 	if (crt_gdata.cg_swim_inited && crt_gdata.cg_swim_ctx_idx == ctx_idx)
 		crt_swim_fini();
 
+	crt_coal_ctx_fini(ctx);
+
 	D_MUTEX_LOCK(&ctx->cc_mutex);
 
 	rc = d_hash_table_destroy_inplace(&ctx->cc_epi_table, true /* force */);
@@ -1198,6 +1239,15 @@ crt_req_timeout_hdlr(struct crt_rpc_priv *rpc_priv)
 		crt_rpc_complete_and_unlock(rpc_priv, -DER_UNREACH);
 		break;
 	case RPC_STATE_REQ_SENT:
+		/* Carried by a coalesced request, complete it on its own */
+		if (rpc_priv->crp_coal) {
+			RPC_INFO(rpc_priv, "aborting coalesced to group %s, rank %d\n",
+				 grp_priv->gp_pub.cg_grpid, tgt_ep->ep_rank);
+			rpc_priv->crp_state = RPC_STATE_TIMEOUT;
+			crt_context_req_untrack(rpc_priv);
+			crt_rpc_complete_and_unlock(rpc_priv, -DER_TIMEDOUT);
+			break;
+		}
 		/* At this point, RPC should always be completed by
 		 * Mercury
 		 */
@@ -1329,6 +1379,17 @@ crt_context_req_track(struct crt_rpc_priv *rpc_priv)
 		D_GOTO(out, rc = CRT_REQ_TRACK_IN_INFLIGHQ);
 	}
 
+	/* the requests it carries hold the quota and credits, only track the timeout */
+	if (rpc_priv->crp_pub.cr_opc == CRT_OPC_COALESCE) {
+		crt_set_timeout(rpc_priv);
+		D_MUTEX_LOCK(&crt_ctx->cc_mutex);
+		rc = crt_req_timeout_track(rpc_priv);
+		D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
+		if (rc != 0)
+			RPC_ERROR(rpc_priv, "crt_req_timeout_track failed, rc: %d.\n", rc);
+		D_GOTO(out, rc = rc ?: CRT_REQ_TRACK_IN_INFLIGHQ);
+	}
+
 	/* check inflight quota. if exceeded, queue this rpc */
 	quota_rc = get_quota_resource(rpc_priv->crp_pub.cr_ctx, CRT_QUOTA_RPCS);
 
@@ -1543,6 +1604,13 @@ crt_context_req_untrack(struct crt_rpc_priv *rpc_priv)
 	if (rpc_priv->crp_pub.cr_opc == CRT_OPC_URI_LOOKUP)
 		return;
 
+	if (rpc_priv->crp_pub.cr_opc == CRT_OPC_COALESCE) {
+		D_MUTEX_LOCK(&crt_ctx->cc_mutex);
+		crt_req_timeout_untrack(rpc_priv);
+		D_MUTEX_UNLOCK(&crt_ctx->cc_mutex);
+		return;
+	}
+
 	epi = rpc_priv->crp_epi;
 	D_ASSERT(epi != NULL);
 
@@ -1831,6 +1899,72 @@ crt_exec_progress_cb(struct crt_context *ctx, int64_t timeout)
 	return timeout;
 }
 
+/* Network activity seen at \a now, update the spin interval from its pace */
+static void
+crt_progress_learn(struct crt_context *ctx, uint64_t now)
+{
+	uint64_t	gap = now - ctx->cc_prog_last;
+	uint64_t	target;
+
+	/* long enough to catch the next activity if it comes at the same pace */
+	target = gap <= crt_gdata.cg_prog_spin_max / 2 ? gap * 2 : 0;
+	ctx->cc_prog_spin = (ctx->cc_prog_spin * 7 + target) / 8;
+	ctx->cc_prog_last = now;
+	d_tm_set_gauge(ctx->cc_prog_spin_us, ctx->cc_prog_spin);
+}
+
+/*
+ * Wait up to \a timeout us (negative for no limit) for network activity.
+ * With D_PROGRESS_SPIN_MAX set, busy poll while within the learned spin
+ * interval from the last activity and only then block on the provider, so
+ * that bursts avoid the wake-up latency while sporadic traffic does not burn
+ * a core.
+ */
+static int
+crt_progress_wait(struct crt_context *ctx, int64_t timeout)
+{
+	uint64_t	start;
+	uint64_t	now;
+	uint64_t	spin_end;
+	int		rc;
+
+	if (crt_gdata.cg_prog_spin_max == 0 || timeout == 0)
+		return crt_hg_progress(&ctx->cc_hg_ctx, timeout);
+
+	start    = d_timeus_secdiff(0);
+	now      = start;
+	spin_end = ctx->cc_prog_last + ctx->cc_prog_spin;
+	if (timeout > 0 && spin_end > start + timeout)
+		spin_end = start + timeout;
+
+	if (now < spin_end) {
+		do {
+			rc = crt_hg_progress(&ctx->cc_hg_ctx, 0);
+			now = d_timeus_secdiff(0);
+		} while (rc == -DER_TIMEDOUT && now < spin_end);
+
+		if (rc == 0) {
+			d_tm_inc_counter(ctx->cc_prog_spin_nr, 1);
+			crt_progress_learn(ctx, now);
+			return 0;
+		}
+		if (rc != -DER_TIMEDOUT)
+			return rc;
+		if (timeout > 0) {
+			timeout -= now - start;
+			if (timeout <= 0)
+				return -DER_TIMEDOUT;
+		}
+	}
+
+	d_tm_inc_counter(ctx->cc_prog_sleep_nr, 1);
+	rc = crt_hg_progress(&ctx->cc_hg_ctx, timeout);
+	if (rc == 0)
+		crt_progress_learn(ctx, d_timeus_secdiff(0));
+
+	return rc;
+}
+
 int
 crt_progress_cond(crt_context_t crt_ctx, int64_t timeout,
 		  crt_progress_cond_cb_t cond_cb, void *arg)
@@ -1867,6 +2001,9 @@ crt_progress_cond(crt_context_t crt_ctx, int64_t timeout,
 		end = now + timeout;
 	}
 
+	/* send the requests held for coalescing */
+	crt_coal_flush(ctx);
+
 	/**
 	 * Call progress once before processing timeouts in case
 	 * any replies are pending in the queue
@@ -1880,6 +2017,7 @@ crt_progress_cond(crt_context_t crt_ctx, int64_t timeout,
 	/** loop until callback returns non-null value */
 	while ((rc = cond_cb(arg)) == 0) {
 		crt_context_timeout_check(ctx);
+		crt_hg_pool_adjust(&ctx->cc_hg_ctx);
 		timeout = crt_exec_progress_cb(ctx, timeout);
 
 		if (timeout < 0) {
@@ -1899,7 +2037,8 @@ crt_progress_cond(crt_context_t crt_ctx, int64_t timeout,
 				hg_timeout = timeout;
 		}
 
-		rc = crt_hg_progress(&ctx->cc_hg_ctx, hg_timeout);
+		crt_coal_flush(ctx);
+		rc = crt_progress_wait(ctx, hg_timeout);
 		if (unlikely(rc && rc != -DER_TIMEDOUT)) {
 			D_ERROR("crt_hg_progress failed with %d\n", rc);
 			return rc;
@@ -1939,6 +2078,9 @@ crt_progress(crt_context_t crt_ctx, int64_t timeout)
 
 	ctx = crt_ctx;
 
+	/* send the requests held for coalescing */
+	crt_coal_flush(ctx);
+
 	/**
 	 * call progress once w/o any timeout before processing timed out
 	 * requests in case any replies are pending in the queue
@@ -1952,11 +2094,15 @@ crt_progress(crt_context_t crt_ctx, int64_t timeout)
 	 * progress
 	 */
 	crt_context_timeout_check(ctx);
+	/* create or release pooled handles out of the request path */
+	crt_hg_pool_adjust(&ctx->cc_hg_ctx);
 	timeout = crt_exec_progress_cb(ctx, timeout);
 
 	if (timeout != 0 && (rc == 0 || rc == -DER_TIMEDOUT)) {
+		/* completions above may have sent more requests */
+		crt_coal_flush(ctx);
 		/** call progress once again with the real timeout */
-		rc = crt_hg_progress(&ctx->cc_hg_ctx, timeout);
+		rc = crt_progress_wait(ctx, timeout);
 		if (unlikely(rc && rc != -DER_TIMEDOUT))
 			D_ERROR("crt_hg_progress failed, rc: %d.\n", rc);
 	}
@@ -1094,9 +1094,15 @@ crt_grp_priv_create(struct crt_grp_priv **grp_priv_created,
 	if (rc)
 		D_GOTO(out_swim_lock, rc);
 
+	rc = D_MUTEX_INIT(&grp_priv->gp_tree_lock, NULL);
+	if (rc)
+		D_GOTO(out_rwlock, rc);
+
 	*grp_priv_created = grp_priv;
 	return rc;
 
+out_rwlock:
+	D_RWLOCK_DESTROY(&grp_priv->gp_rwlock);
 out_swim_lock:
 	D_SPIN_DESTROY(&csm->csm_lock);
 out_grpid:
@@ -1182,7 +1188,13 @@ crt_grp_priv_destroy(struct crt_grp_priv *grp_priv)
 
 	D_FREE(grp_priv->gp_psr_uri);
 	D_FREE(grp_priv->gp_pub.cg_grpid);
+	D_FREE(grp_priv->gp_dom_ranks);
+	D_FREE(grp_priv->gp_domains);
+	D_FREE(grp_priv->gp_dom_pend_ranks);
+	D_FREE(grp_priv->gp_dom_pend_domains);
+	crt_tree_dom_cache_fini(grp_priv);
 
+	D_MUTEX_DESTROY(&grp_priv->gp_tree_lock);
 	D_RWLOCK_DESTROY(&grp_priv->gp_rwlock);
 	D_FREE(grp_priv);
 }
@@ -1434,6 +1446,30 @@ out:
 	return rc;
 }
 
+/*
+ * Install the domains set for the current version of the group, called with
+ * gp_rwlock held for write, so that the trees never see the new membership
+ * with the old domains or the other way around.
+ */
+static void
+crt_grp_dom_install_locked(struct crt_grp_priv *grp_priv)
+{
+	if (!grp_priv->gp_dom_pend || grp_priv->gp_dom_pend_ver != grp_priv->gp_membs_ver)
+		return;
+
+	D_FREE(grp_priv->gp_dom_ranks);
+	D_FREE(grp_priv->gp_domains);
+	grp_priv->gp_dom_ranks = grp_priv->gp_dom_pend_ranks;
+	grp_priv->gp_domains   = grp_priv->gp_dom_pend_domains;
+	grp_priv->gp_dom_nr    = grp_priv->gp_dom_pend_nr;
+	grp_priv->gp_dom_gen++;
+
+	grp_priv->gp_dom_pend_ranks   = NULL;
+	grp_priv->gp_dom_pend_domains = NULL;
+	grp_priv->gp_dom_pend_nr      = 0;
+	grp_priv->gp_dom_pend         = false;
+}
+
 int
 crt_group_version_set(crt_group_t *grp, uint32_t version)
 {
@@ -1453,6 +1489,7 @@ crt_group_version_set(crt_group_t *grp, uint32_t version)
 
 	D_RWLOCK_WRLOCK(&grp_priv->gp_rwlock);
 	grp_priv->gp_membs_ver = version;
+	crt_grp_dom_install_locked(grp_priv);
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
 
 out:
@@ -3521,6 +3558,7 @@ crt_group_primary_modify(crt_group_t *grp, crt_context_t *ctxs, int num_ctxs, d_
 	d_rank_list_free(to_remove);
 
 	grp_priv->gp_membs_ver = version;
+	crt_grp_dom_install_locked(grp_priv);
 unlock:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
 
@@ -3626,6 +3664,7 @@ crt_group_secondary_modify(crt_group_t *grp, d_rank_list_t *sec_ranks,
 	d_rank_list_free(to_remove);
 
 	grp_priv->gp_membs_ver = version;
+	crt_grp_dom_install_locked(grp_priv);
 unlock:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
 
@@ -3647,6 +3686,120 @@ cleanup:
 	return rc;
 }
 
+struct crt_grp_dom {
+	d_rank_t	gd_rank;
+	uint32_t	gd_domain;
+};
+
+static int
+crt_grp_dom_cmp(const void *a, const void *b)
+{
+	const struct crt_grp_dom *da = a;
+	const struct crt_grp_dom *db = b;
+
+	if (da->gd_rank < db->gd_rank)
+		return -1;
+	return da->gd_rank > db->gd_rank;
+}
+
+int
+crt_group_domains_set(crt_group_t *grp, d_rank_list_t *ranks, uint32_t *domains,
+		      uint32_t version)
+{
+	struct crt_grp_priv	*grp_priv;
+	struct crt_grp_dom	*doms = NULL;
+	d_rank_t		*dom_ranks = NULL;
+	uint32_t		*dom_ids = NULL;
+	uint32_t		 nr = 0;
+	uint32_t		 i;
+	int			 rc = 0;
+
+	if (!crt_is_service()) {
+		D_ERROR("Group domains can only be set on the server side\n");
+		D_GOTO(out, rc = -DER_NO_PERM);
+	}
+
+	grp_priv = crt_grp_pub2priv(grp);
+	if (grp_priv == NULL) {
+		D_ERROR("Failed to get grp_priv\n");
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	if (ranks != NULL && ranks->rl_nr > 0) {
+		if (domains == NULL) {
+			D_ERROR("Passed domains is NULL\n");
+			D_GOTO(out, rc = -DER_INVAL);
+		}
+
+		nr = ranks->rl_nr;
+		D_ALLOC_ARRAY(doms, nr);
+		D_ALLOC_ARRAY(dom_ranks, nr);
+		D_ALLOC_ARRAY(dom_ids, nr);
+		if (doms == NULL || dom_ranks == NULL || dom_ids == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		for (i = 0; i < nr; i++) {
+			doms[i].gd_rank   = ranks->rl_ranks[i];
+			doms[i].gd_domain = domains[i];
+		}
+		qsort(doms, nr, sizeof(*doms), crt_grp_dom_cmp);
+
+		for (i = 0; i < nr; i++) {
+			if (i > 0 && doms[i].gd_rank == doms[i - 1].gd_rank) {
+				D_ERROR("Rank %u passed twice\n", doms[i].gd_rank);
+				D_GOTO(out, rc = -DER_INVAL);
+			}
+			dom_ranks[i] = doms[i].gd_rank;
+			dom_ids[i]   = doms[i].gd_domain;
+		}
+	}
+
+	D_RWLOCK_WRLOCK(&grp_priv->gp_rwlock);
+	D_FREE(grp_priv->gp_dom_pend_ranks);
+	D_FREE(grp_priv->gp_dom_pend_domains);
+	grp_priv->gp_dom_pend_ranks   = dom_ranks;
+	grp_priv->gp_dom_pend_domains = dom_ids;
+	grp_priv->gp_dom_pend_nr      = nr;
+	grp_priv->gp_dom_pend_ver     = version;
+	grp_priv->gp_dom_pend         = true;
+	/* Already at that version, nothing else to wait for. */
+	crt_grp_dom_install_locked(grp_priv);
+	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+
+	D_DEBUG(DB_TRACE, "group %s, %u ranks with a domain from version %u\n",
+		grp_priv->gp_pub.cg_grpid, nr, version);
+	dom_ranks = NULL;
+	dom_ids   = NULL;
+out:
+	D_FREE(doms);
+	D_FREE(dom_ranks);
+	D_FREE(dom_ids);
+	return rc;
+}
+
+/*
+ * Domain of \a rank in the domains set by crt_group_domains_set(),
+ * CRT_NO_DOMAIN if none, called with gp_rwlock held.
+ */
+uint32_t
+crt_grp_priv_get_domain(struct crt_grp_priv *grp_priv, d_rank_t rank)
+{
+	uint32_t lo = 0;
+	uint32_t hi = grp_priv->gp_dom_nr;
+	uint32_t mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (grp_priv->gp_dom_ranks[mid] == rank)
+			return grp_priv->gp_domains[mid];
+		if (grp_priv->gp_dom_ranks[mid] < rank)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return CRT_NO_DOMAIN;
+}
+
 int
 crt_group_psrs_set(crt_group_t *grp, d_rank_list_t *rank_list)
 {
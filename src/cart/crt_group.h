@@ -107,6 +107,25 @@ struct crt_grp_priv {
 	/* Secondary to primary rank mapping table */
 	struct d_hash_table	 gp_s2p_table;
 
+	/*
+	 * fault domain of the member ranks for CRT_TREE_DOMAIN, gp_dom_ranks
+	 * is sorted and gp_domains[i] is the domain of gp_dom_ranks[i]
+	 */
+	d_rank_t		*gp_dom_ranks;
+	uint32_t		*gp_domains;
+	uint32_t		 gp_dom_nr;
+	/* bumped each time the domains above change */
+	uint32_t		 gp_dom_gen;
+	/*
+	 * domains set by crt_group_domains_set(), installed together with the
+	 * membership update to gp_dom_pend_ver
+	 */
+	d_rank_t		*gp_dom_pend_ranks;
+	uint32_t		*gp_dom_pend_domains;
+	uint32_t		 gp_dom_pend_nr;
+	uint32_t		 gp_dom_pend_ver;
+	bool			 gp_dom_pend;
+
 	/* set of variables only valid in primary service groups */
 	uint32_t		 gp_primary:1, /* flag of primary group */
 				 gp_view:1, /* flag to indicate it is a view */
@@ -117,6 +136,10 @@ struct crt_grp_priv {
 	uint32_t		 gp_refcount;
 
 	pthread_rwlock_t	 gp_rwlock; /* protect all fields above */
+
+	/* last CRT_TREE_DOMAIN layout, see crt_tree_dom_layout_grp() */
+	struct crt_tree_dom_cache *gp_tree_cache;
+	pthread_mutex_t		 gp_tree_lock;
 };
 
 static inline d_rank_list_t*
@@ -128,6 +151,9 @@ grp_priv_get_membs(struct crt_grp_priv *priv)
 d_rank_t
 crt_grp_priv_get_primary_rank(struct crt_grp_priv *priv, d_rank_t rank);
 
+uint32_t
+crt_grp_priv_get_domain(struct crt_grp_priv *grp_priv, d_rank_t rank);
+
 /*
  * This call is currently called only when group is created.
  */
@@ -113,6 +113,69 @@ crt_prov_str_to_prov(const char *prov_str)
 	return CRT_PROV_UNKNOWN;
 }
 
+/* Create \a nr handles and add them to the pool, returns the number added */
+static int32_t
+crt_hg_pool_fill(struct crt_hg_context *hg_ctx, int32_t nr)
+{
+	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
+	struct crt_hg_hdl	*hdl;
+	hg_return_t		 hg_ret;
+	bool			 added;
+	int32_t			 i;
+
+	for (i = 0; i < nr; i++) {
+		D_ALLOC_PTR(hdl);
+		if (hdl == NULL)
+			break;
+		D_INIT_LIST_HEAD(&hdl->chh_link);
+
+		hg_ret = HG_Create(hg_ctx->chc_hgctx, NULL, CRT_HG_RPCID, &hdl->chh_hdl);
+		if (hg_ret != HG_SUCCESS) {
+			D_FREE(hdl);
+			D_ERROR("HG_Create() failed, hg_ret: %d.\n", hg_ret);
+			break;
+		}
+
+		D_SPIN_LOCK(&hg_pool->chp_lock);
+		added = hg_pool->chp_enabled && hg_pool->chp_num < hg_pool->chp_max_num;
+		if (added) {
+			d_list_add_tail(&hdl->chh_link, &hg_pool->chp_list);
+			hg_pool->chp_num++;
+			D_DEBUG(DB_NET, "hg_pool %p, add, chp_num %d.\n",
+				hg_pool, hg_pool->chp_num);
+		}
+		D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+		if (!added) {
+			HG_Destroy(hdl->chh_hdl);
+			D_FREE(hdl);
+			break;
+		}
+	}
+
+	return i;
+}
+
+static void
+crt_hg_pool_destroy_list(d_list_t *destroy_list)
+{
+	struct crt_hg_hdl	*hdl;
+	hg_return_t		 hg_ret;
+
+	while ((hdl = d_list_pop_entry(destroy_list,
+				       struct crt_hg_hdl,
+				       chh_link))) {
+		D_ASSERT(hdl->chh_hdl != HG_HANDLE_NULL);
+		hg_ret = HG_Destroy(hdl->chh_hdl);
+		if (hg_ret != HG_SUCCESS)
+			D_ERROR("HG_Destroy() failed, hg_hdl %p, hg_ret: %d.\n",
+				hdl->chh_hdl, hg_ret);
+		else
+			D_DEBUG(DB_NET, "hg_hdl %p destroyed.\n", hdl->chh_hdl);
+		D_FREE(hdl);
+	}
+}
+
 /**
  * Enable the HG handle pool, can change/tune the max_num and prepost_num.
  * This allows the pool be enabled/re-enabled and be tunable at runtime
@@ -123,9 +186,7 @@ crt_hg_pool_enable(struct crt_hg_context *hg_ctx, int32_t max_num,
 		   int32_t prepost_num)
 {
 	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
-	struct crt_hg_hdl	*hdl;
-	bool			 prepost;
-	hg_return_t		 hg_ret = HG_SUCCESS;
+	int32_t			 nr;
 	int			 rc = 0;
 
 	if (hg_ctx == NULL || max_num <= 0 || prepost_num < 0 ||
@@ -138,35 +199,16 @@ crt_hg_pool_enable(struct crt_hg_context *hg_ctx, int32_t max_num,
 
 	D_SPIN_LOCK(&hg_pool->chp_lock);
 	hg_pool->chp_max_num = max_num;
+	hg_pool->chp_min_num = prepost_num;
+	hg_pool->chp_target  = min(max(hg_pool->chp_target, prepost_num), max_num);
+	hg_pool->chp_win_min = hg_pool->chp_num;
+	hg_pool->chp_win_gets = 0;
 	hg_pool->chp_enabled = true;
-	prepost = hg_pool->chp_num < prepost_num;
+	nr = prepost_num - hg_pool->chp_num;
 	D_SPIN_UNLOCK(&hg_pool->chp_lock);
 
-	while (prepost) {
-		D_ALLOC_PTR(hdl);
-		if (hdl == NULL) {
-			rc = -DER_NOMEM;
-			break;
-		}
-		D_INIT_LIST_HEAD(&hdl->chh_link);
-
-		hg_ret = HG_Create(hg_ctx->chc_hgctx, NULL, CRT_HG_RPCID, &hdl->chh_hdl);
-		if (hg_ret != HG_SUCCESS) {
-			D_FREE(hdl);
-			D_ERROR("HG_Create() failed, hg_ret: %d.\n", hg_ret);
-			rc = crt_hgret_2_der(hg_ret);
-			break;
-		}
-
-		D_SPIN_LOCK(&hg_pool->chp_lock);
-		d_list_add_tail(&hdl->chh_link, &hg_pool->chp_list);
-		hg_pool->chp_num++;
-		D_DEBUG(DB_NET, "hg_pool %p, add, chp_num %d.\n",
-			hg_pool, hg_pool->chp_num);
-		if (hg_pool->chp_num >= prepost_num)
-			prepost = false;
-		D_SPIN_UNLOCK(&hg_pool->chp_lock);
-	}
+	if (nr > 0 && crt_hg_pool_fill(hg_ctx, nr) < nr)
+		rc = -DER_NOMEM;
 
 out:
 	return rc;
@@ -176,39 +218,30 @@ static inline void
 crt_hg_pool_disable(struct crt_hg_context *hg_ctx)
 {
 	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
-	struct crt_hg_hdl	*hdl;
 	d_list_t		 destroy_list;
-	hg_return_t		 hg_ret = HG_SUCCESS;
 
 	D_INIT_LIST_HEAD(&destroy_list);
 
 	D_SPIN_LOCK(&hg_pool->chp_lock);
 	hg_pool->chp_num = 0;
 	hg_pool->chp_max_num = 0;
+	hg_pool->chp_min_num = 0;
+	hg_pool->chp_target = 0;
 	hg_pool->chp_enabled = false;
+	atomic_store_relaxed(&hg_pool->chp_adjust, 0);
 	d_list_splice_init(&hg_pool->chp_list, &destroy_list);
 	D_DEBUG(DB_NET, "hg_pool %p disabled and become empty (chp_num 0).\n",
 		hg_pool);
 	D_SPIN_UNLOCK(&hg_pool->chp_lock);
 
-	while ((hdl = d_list_pop_entry(&destroy_list,
-				       struct crt_hg_hdl,
-				       chh_link))) {
-		D_ASSERT(hdl->chh_hdl != HG_HANDLE_NULL);
-		hg_ret = HG_Destroy(hdl->chh_hdl);
-		if (hg_ret != HG_SUCCESS)
-			D_ERROR("HG_Destroy() failed, hg_hdl %p, hg_ret: %d.\n",
-				hdl->chh_hdl, hg_ret);
-		else
-			D_DEBUG(DB_NET, "hg_hdl %p destroyed.\n", hdl->chh_hdl);
-		D_FREE(hdl);
-	}
+	crt_hg_pool_destroy_list(&destroy_list);
 }
 
 static inline int
 crt_hg_pool_init(struct crt_hg_context *hg_ctx)
 {
 	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
+	int32_t			 max_num = crt_gdata.cg_hg_pool_max;
 	int			 rc = 0;
 
 	rc = D_SPIN_INIT(&hg_pool->chp_lock, PTHREAD_PROCESS_PRIVATE);
@@ -217,11 +250,18 @@ crt_hg_pool_init(struct crt_hg_context *hg_ctx)
 
 	hg_pool->chp_num = 0;
 	hg_pool->chp_max_num = 0;
+	hg_pool->chp_min_num = 0;
+	hg_pool->chp_target = 0;
 	hg_pool->chp_enabled = false;
+	atomic_init(&hg_pool->chp_adjust, 0);
 	D_INIT_LIST_HEAD(&hg_pool->chp_list);
 
-	rc = crt_hg_pool_enable(hg_ctx, CRT_HG_POOL_MAX_NUM,
-				CRT_HG_POOL_PREPOST_NUM);
+	/* D_HG_POOL_MAX=0 leaves the pool disabled */
+	if (max_num == 0)
+		D_GOTO(exit, rc);
+
+	rc = crt_hg_pool_enable(hg_ctx, max_num,
+				min(CRT_HG_POOL_PREPOST_NUM, max_num));
 	if (rc != 0)
 		D_ERROR("crt_hg_pool_enable() hg_ctx %p, failed, " DF_RC "\n",
 			hg_ctx, DP_RC(rc));
@@ -235,10 +275,60 @@ crt_hg_pool_fini(struct crt_hg_context *hg_ctx)
 {
 	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
 
-	if (hg_pool->chp_enabled) {
-		crt_hg_pool_disable(hg_ctx);
-		D_SPIN_DESTROY(&hg_pool->chp_lock);
+	crt_hg_pool_disable(hg_ctx);
+	D_SPIN_DESTROY(&hg_pool->chp_lock);
+}
+
+/*
+ * Bring the pool to its target size, called from the progress loop so that
+ * handles are created and destroyed out of the request path.
+ */
+void
+crt_hg_pool_adjust(struct crt_hg_context *hg_ctx)
+{
+	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
+	struct crt_hg_hdl	*hdl;
+	d_list_t		 destroy_list;
+	int32_t			 nr = 0;
+	int32_t			 num;
+
+	if (likely(atomic_load_relaxed(&hg_pool->chp_adjust) == 0))
+		return;
+
+	D_INIT_LIST_HEAD(&destroy_list);
+
+	D_SPIN_LOCK(&hg_pool->chp_lock);
+	atomic_store_relaxed(&hg_pool->chp_adjust, 0);
+	if (!hg_pool->chp_enabled)
+		D_GOTO(unlock, 0);
+
+	if (hg_pool->chp_num < hg_pool->chp_target) {
+		nr = min(hg_pool->chp_target - hg_pool->chp_num, CRT_HG_POOL_ADJUST_NUM);
+		if (hg_pool->chp_target - hg_pool->chp_num > nr)
+			atomic_store_relaxed(&hg_pool->chp_adjust, 1);
+	} else {
+		while (hg_pool->chp_num > hg_pool->chp_target && nr < CRT_HG_POOL_ADJUST_NUM) {
+			hdl = d_list_pop_entry(&hg_pool->chp_list, struct crt_hg_hdl, chh_link);
+			D_ASSERT(hdl != NULL);
+			d_list_add_tail(&hdl->chh_link, &destroy_list);
+			hg_pool->chp_num--;
+			nr++;
+		}
+		if (hg_pool->chp_num > hg_pool->chp_target)
+			atomic_store_relaxed(&hg_pool->chp_adjust, 1);
+		hg_pool->chp_win_min = min(hg_pool->chp_win_min, hg_pool->chp_num);
+		D_DEBUG(DB_NET, "hg_pool %p, trim %d, chp_num %d, target %d.\n",
+			hg_pool, nr, hg_pool->chp_num, hg_pool->chp_target);
+		nr = 0;
 	}
+unlock:
+	num = hg_pool->chp_num;
+	D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+	crt_hg_pool_destroy_list(&destroy_list);
+	if (nr > 0)
+		num += crt_hg_pool_fill(hg_ctx, nr);
+	d_tm_set_gauge(hg_pool->chp_size, num);
 }
 
 static inline struct crt_hg_hdl *
@@ -246,30 +336,50 @@ crt_hg_pool_get(struct crt_hg_context *hg_ctx)
 {
 	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
 	struct crt_hg_hdl	*hdl = NULL;
+	int32_t			 shrink;
 
 	D_SPIN_LOCK(&hg_pool->chp_lock);
 	if (!hg_pool->chp_enabled) {
 		D_DEBUG(DB_NET,
 			"hg_pool %p is not enabled cannot get.\n", hg_pool);
-		D_GOTO(unlock, hdl);
+		D_SPIN_UNLOCK(&hg_pool->chp_lock);
+		return NULL;
 	}
 	hdl = d_list_pop_entry(&hg_pool->chp_list,
 			       struct crt_hg_hdl,
 			       chh_link);
 	if (hdl == NULL) {
+		/* one more request in flight than the pool can serve, grow it */
+		if (hg_pool->chp_target < hg_pool->chp_max_num) {
+			hg_pool->chp_target++;
+			atomic_store_relaxed(&hg_pool->chp_adjust, 1);
+		}
 		D_DEBUG(DB_NET,
-			"hg_pool %p is empty, cannot get.\n", hg_pool);
-		D_GOTO(unlock, hdl);
+			"hg_pool %p is empty, cannot get, target %d.\n", hg_pool,
+			hg_pool->chp_target);
+	} else {
+		D_ASSERT(hdl->chh_hdl != HG_HANDLE_NULL);
+		hg_pool->chp_num--;
+		D_ASSERT(hg_pool->chp_num >= 0);
+		D_DEBUG(DB_NET, "hg_pool %p, remove, chp_num %d.\n",
+			hg_pool, hg_pool->chp_num);
 	}
+	hg_pool->chp_win_min = min(hg_pool->chp_win_min, hg_pool->chp_num);
 
-	D_ASSERT(hdl->chh_hdl != HG_HANDLE_NULL);
-	hg_pool->chp_num--;
-	D_ASSERT(hg_pool->chp_num >= 0);
-	D_DEBUG(DB_NET, "hg_pool %p, remove, chp_num %d.\n",
-		hg_pool, hg_pool->chp_num);
-
-unlock:
+	/* handles never taken during the whole window are not needed */
+	if (++hg_pool->chp_win_gets >= CRT_HG_POOL_WINDOW) {
+		shrink = min(hg_pool->chp_win_min / 2,
+			     hg_pool->chp_target - hg_pool->chp_min_num);
+		if (shrink > 0) {
+			hg_pool->chp_target -= shrink;
+			atomic_store_relaxed(&hg_pool->chp_adjust, 1);
+		}
+		hg_pool->chp_win_gets = 0;
+		hg_pool->chp_win_min = hg_pool->chp_num;
+	}
 	D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+	d_tm_inc_counter(hdl != NULL ? hg_pool->chp_hit : hg_pool->chp_miss, 1);
 	return hdl;
 }
 
@@ -297,7 +407,7 @@ crt_hg_pool_put(struct crt_rpc_priv *rpc_priv)
 	}
 
 	D_SPIN_LOCK(&hg_pool->chp_lock);
-	if (hg_pool->chp_enabled && hg_pool->chp_num < hg_pool->chp_max_num) {
+	if (hg_pool->chp_enabled && hg_pool->chp_num < hg_pool->chp_target) {
 		d_list_add_tail(&hdl->chh_link, &hg_pool->chp_list);
 		hg_pool->chp_num++;
 		D_DEBUG(DB_NET, "hg_pool %p, add, chp_num %d.\n",
@@ -305,9 +415,9 @@ crt_hg_pool_put(struct crt_rpc_priv *rpc_priv)
 		rc = true;
 	} else {
 		D_FREE(hdl);
-		D_DEBUG(DB_NET, "hg_pool %p, chp_num %d, max_num %d, "
+		D_DEBUG(DB_NET, "hg_pool %p, chp_num %d, target %d, "
 			"enabled %d, cannot put.\n", hg_pool, hg_pool->chp_num,
-			hg_pool->chp_max_num, hg_pool->chp_enabled);
+			hg_pool->chp_target, hg_pool->chp_enabled);
 	}
 	D_SPIN_UNLOCK(&hg_pool->chp_lock);
 
@@ -1230,6 +1340,12 @@ crt_hg_req_destroy(struct crt_rpc_priv *rpc_priv)
 	hg_return_t hg_ret;
 
 	D_ASSERT(rpc_priv != NULL);
+	/* shares the handle of the request carrying it */
+	if (rpc_priv->crp_coal) {
+		crt_coal_req_destroy(rpc_priv);
+		return;
+	}
+
 	if (rpc_priv->crp_output_got != 0) {
 		hg_ret = HG_Free_output(rpc_priv->crp_hg_hdl,
 					&rpc_priv->crp_pub.cr_output);
@@ -1511,6 +1627,12 @@ crt_hg_reply_error_send(struct crt_rpc_priv *rpc_priv, int error_code)
 	D_ASSERT(rpc_priv != NULL);
 	D_ASSERT(error_code != 0);
 
+	if (rpc_priv->crp_coal) {
+		crt_coal_reply_send(rpc_priv, error_code);
+		rpc_priv->crp_reply_pending = 0;
+		return;
+	}
+
 	hg_out_struct = &rpc_priv->crp_pub.cr_output;
 	rpc_priv->crp_reply_hdr.cch_rc = error_code;
 	hg_ret = HG_Respond(rpc_priv->crp_hg_hdl, NULL, NULL, hg_out_struct);
@@ -10,6 +10,7 @@
 #define __CRT_MERCURY_H__
 
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 
 #include <mercury.h>
 #include <mercury_types.h>
@@ -22,12 +23,21 @@
 #define CRT_HG_RPCID		(0xDA036868)
 #define CRT_HG_ONEWAY_RPCID	(0xDA036869)
 
-/** MAX number of HG handles in pool */
+/** default MAX number of HG handles in pool, see D_HG_POOL_MAX */
 #define CRT_HG_POOL_MAX_NUM	(512)
-/** number of prepost HG handles when enable pool */
+/** number of prepost HG handles when enable pool, the pool never shrinks below it */
 #define CRT_HG_POOL_PREPOST_NUM	(16)
+/** number of gets after which the idle handles of the pool are released */
+#define CRT_HG_POOL_WINDOW	(1024)
+/** max number of handles created or destroyed by one crt_hg_pool_adjust() call */
+#define CRT_HG_POOL_ADJUST_NUM	(32)
 
-/** default values for init / incr to prepost handles */
+/**
+ * default values for init / incr to prepost handles. Those are the handles
+ * Mercury preposts for incoming requests, set once at HG init and grown by
+ * Mercury itself when exhausted; unlike the pool above, they do not follow the
+ * observed concurrency, use D_POST_INIT / D_POST_INCR to tune them.
+ */
 #define CRT_HG_POST_INIT        (512)
 #define CRT_HG_POST_INCR        (512)
 #define CRT_HG_MRECV_BUF        (16)
@@ -100,15 +110,36 @@ struct crt_hg_hdl {
 	hg_handle_t		chh_hdl;
 };
 
+/*
+ * The pool sizes itself from the observed concurrency: every get that finds
+ * the pool empty raises chp_target by one, and the handles that stayed in the
+ * pool for a whole window of CRT_HG_POOL_WINDOW gets lower it by half their
+ * number. The handles are created and destroyed by crt_hg_pool_adjust() from
+ * the progress loop, so that the request path only pops and pushes.
+ */
 struct crt_hg_pool {
 	pthread_spinlock_t	chp_lock;
 	/* number of HG handles in pool */
 	int32_t			chp_num;
 	/* maximum number of HG handles in pool */
 	int32_t			chp_max_num;
+	/* minimum number of HG handles in pool */
+	int32_t			chp_min_num;
+	/* number of HG handles the pool is adjusted to */
+	int32_t			chp_target;
+	/* lowest chp_num and number of gets in the current window */
+	int32_t			chp_win_min;
+	uint32_t		chp_win_gets;
 	/* HG handle list */
 	d_list_t		chp_list;
 	bool			chp_enabled;
+	/* chp_num differs from chp_target, checked without the lock */
+	ATOMIC uint32_t		chp_adjust;
+	/* gets served from the pool and gets that had to create a handle */
+	struct d_tm_node_t	*chp_hit;
+	struct d_tm_node_t	*chp_miss;
+	/* number of HG handles in pool, updated on adjust */
+	struct d_tm_node_t	*chp_size;
 };
 
 /** HG context */
@@ -139,6 +170,7 @@ int crt_hg_reply_send(struct crt_rpc_priv *rpc_priv);
 void crt_hg_reply_error_send(struct crt_rpc_priv *rpc_priv, int error_code);
 int crt_hg_req_cancel(struct crt_rpc_priv *rpc_priv);
 int crt_hg_progress(struct crt_hg_context *hg_ctx, int64_t timeout);
+void crt_hg_pool_adjust(struct crt_hg_context *hg_ctx);
 int crt_hg_addr_free(struct crt_hg_context *hg_ctx, hg_addr_t addr);
 int crt_hg_get_addr(hg_class_t *hg_class, char *addr_str, size_t *str_size);
 
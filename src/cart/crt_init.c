@@ -232,6 +232,9 @@ crt_gdata_dump(void)
 	DUMP_GDATA_FIELD("0x%lx", cg_rpcid);
 	DUMP_GDATA_FIELD("%ld", cg_num_cores);
 	DUMP_GDATA_FIELD("%d", cg_rpc_quota);
+	DUMP_GDATA_FIELD("%d", cg_coal_max);
+	DUMP_GDATA_FIELD("%d", cg_hg_pool_max);
+	DUMP_GDATA_FIELD("%d", cg_prog_spin_max);
 }
 
 static enum crt_traffic_class
@@ -312,6 +315,27 @@ data_init(int server, crt_init_options_t *opt)
 	crt_gdata.cg_rpc_quota = server ? 0 : CRT_QUOTA_RPCS_DEFAULT;
 	crt_env_get(D_QUOTA_RPCS, &crt_gdata.cg_rpc_quota);
 
+	crt_gdata.cg_coal_max = CRT_COAL_NR_DEFAULT;
+	crt_env_get(D_RPC_COALESCE_MAX, &crt_gdata.cg_coal_max);
+	if (crt_gdata.cg_coal_max > CRT_COAL_NR_MAX) {
+		D_WARN("D_RPC_COALESCE_MAX %u is above the max of %u, using the max\n",
+		       crt_gdata.cg_coal_max, CRT_COAL_NR_MAX);
+		crt_gdata.cg_coal_max = CRT_COAL_NR_MAX;
+	}
+
+	crt_gdata.cg_hg_pool_max = CRT_HG_POOL_MAX_NUM;
+	crt_env_get(D_HG_POOL_MAX, &crt_gdata.cg_hg_pool_max);
+	if (crt_gdata.cg_hg_pool_max > INT32_MAX)
+		crt_gdata.cg_hg_pool_max = INT32_MAX;
+
+	crt_gdata.cg_prog_spin_max = 0;
+	crt_env_get(D_PROGRESS_SPIN_MAX, &crt_gdata.cg_prog_spin_max);
+	if (crt_gdata.cg_prog_spin_max > CRT_PROG_SPIN_MAX_US) {
+		D_WARN("D_PROGRESS_SPIN_MAX %u is above the max of %u, using the max\n",
+		       crt_gdata.cg_prog_spin_max, CRT_PROG_SPIN_MAX_US);
+		crt_gdata.cg_prog_spin_max = CRT_PROG_SPIN_MAX_US;
+	}
+
 	/* Must be set on the server when using UCX, will not affect OFI */
 	if (server)
 		d_setenv("UCX_IB_FORK_INIT", "n", 1);
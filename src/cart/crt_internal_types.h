@@ -170,6 +170,12 @@ struct crt_gdata {
 	long			 cg_num_cores;
 	/** Inflight rpc quota limit */
 	uint32_t		cg_rpc_quota;
+	/** Max number of requests packed in one coalesced message, 0 or 1 disables it */
+	uint32_t		cg_coal_max;
+	/** Max number of HG handles pooled per context, 0 disables the pool */
+	uint32_t		cg_hg_pool_max;
+	/** Max interval progress spins for after activity in us, 0 always blocks */
+	uint32_t		cg_prog_spin_max;
 };
 
 extern struct crt_gdata		crt_gdata;
@@ -226,13 +232,16 @@ struct crt_event_cb_priv {
 	ENV_STR(D_PORT)                                                                            \
 	ENV(D_PORT_AUTO_ADJUST)                                                                    \
 	ENV(D_THREAD_MODE_SINGLE)                                                                  \
+	ENV(D_HG_POOL_MAX)                                                                         \
 	ENV(D_POST_INCR)                                                                           \
 	ENV(D_POST_INIT)                                                                           \
 	ENV(D_MRECV_BUF)                                                                           \
 	ENV(D_MRECV_BUF_COPY)                                                                      \
+	ENV(D_PROGRESS_SPIN_MAX)                                                                   \
 	ENV_STR(D_PROVIDER)                                                                        \
 	ENV_STR_NO_PRINT(D_PROVIDER_AUTH_KEY)                                                      \
 	ENV(D_QUOTA_RPCS)                                                                          \
+	ENV(D_RPC_COALESCE_MAX)                                                                    \
 	ENV(FI_OFI_RXM_USE_SRX)                                                                    \
 	ENV(FI_UNIVERSE_SIZE)                                                                      \
 	ENV(SWIM_PING_TIMEOUT)                                                                     \
@@ -432,6 +441,31 @@ struct crt_context {
 
 	/** Stores quotas */
 	struct crt_quotas	cc_quotas;
+
+	/** RPC coalescing, see crt_coalesce.c */
+	/** open batches of small requests waiting for the next progress call */
+	d_list_t		 cc_coal_batches;
+	/** number of batches on cc_coal_batches, checked without the lock */
+	ATOMIC uint32_t		 cc_coal_nr;
+	/** proc used to encode requests and replies into batches */
+	crt_proc_t		 cc_coal_proc;
+	/** protects the above, no other lock is taken while holding it */
+	pthread_mutex_t		 cc_coal_mutex;
+
+	/**
+	 * Hybrid progress, see crt_progress_wait(). Updated without a lock by
+	 * the threads progressing the context, they are only hints.
+	 */
+	/** time the last wait saw network activity, in us */
+	uint64_t		 cc_prog_last;
+	/** learned interval waits spin for after activity, in us */
+	uint64_t		 cc_prog_spin;
+	/** Total number of waits completed while spinning, of type counter */
+	struct d_tm_node_t	*cc_prog_spin_nr;
+	/** Total number of waits that blocked, of type counter */
+	struct d_tm_node_t	*cc_prog_sleep_nr;
+	/** Current spin interval, of type gauge */
+	struct d_tm_node_t	*cc_prog_spin_us;
 };
 
 /* in-flight RPC req list, be tracked per endpoint for every crt_context */
@@ -482,7 +516,8 @@ struct crt_opc_info {
 				 coi_coops_init:1,
 				 coi_no_reply:1, /* flag of one-way RPC */
 				 coi_queue_front:1, /* add to front of queue */
-				 coi_reset_timer:1; /* reset timer on timeout */
+				 coi_reset_timer:1, /* reset timer on timeout */
+				 coi_coalesce:1; /* may be packed with others */
 
 	crt_rpc_cb_t		 coi_rpc_cb;
 	struct crt_corpc_ops	*coi_co_ops;
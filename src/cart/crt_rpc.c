@@ -114,6 +114,8 @@ crt_hdlr_ctl_fi_attr_set(crt_rpc_t *rpc_req)
 /* CRT internal RPC format definitions uri lookup */
 CRT_RPC_DEFINE(crt_uri_lookup, CRT_ISEQ_URI_LOOKUP, CRT_OSEQ_URI_LOOKUP)
 
+CRT_RPC_DEFINE(crt_coalesce, CRT_ISEQ_COALESCE, CRT_OSEQ_COALESCE)
+
 /* for self-test service */
 CRT_RPC_DEFINE(crt_st_send_id_reply_iov,
 	       CRT_ISEQ_ST_SEND_ID, CRT_OSEQ_ST_REPLY_IOV)
@@ -573,6 +575,9 @@ crt_rpc_priv_free(struct crt_rpc_priv *rpc_priv)
 	if (rpc_priv->crp_uri_free != 0)
 		D_FREE(rpc_priv->crp_tgt_uri);
 
+	if (rpc_priv->crp_coal_batch != NULL)
+		crt_coal_batch_free(rpc_priv->crp_coal_batch);
+
 	D_MUTEX_DESTROY(&rpc_priv->crp_mutex);
 	D_SPIN_DESTROY(&rpc_priv->crp_lock);
 
@@ -1347,8 +1352,8 @@ out:
 	return rc;
 }
 
-static inline int
-crt_req_send_immediately(struct crt_rpc_priv *rpc_priv)
+int
+crt_req_send_direct(struct crt_rpc_priv *rpc_priv)
 {
 	crt_rpc_t			*req;
 	struct crt_context		*ctx;
@@ -1373,6 +1378,22 @@ out:
 	return rc;
 }
 
+static inline int
+crt_req_send_immediately(struct crt_rpc_priv *rpc_priv)
+{
+	bool	queued;
+	int	rc;
+
+	if (crt_coal_eligible(rpc_priv)) {
+		/* sent with others to the same endpoint at the next progress call */
+		rc = crt_coal_req_add(rpc_priv, &queued);
+		if (rc != 0 || queued)
+			return rc;
+	}
+
+	return crt_req_send_direct(rpc_priv);
+}
+
 int
 crt_req_send_internal(struct crt_rpc_priv *rpc_priv)
 {
@@ -1578,7 +1599,10 @@ crt_reply_send(crt_rpc_t *req)
 
 	rpc_priv = container_of(req, struct crt_rpc_priv, crp_pub);
 
-	if (rpc_priv->crp_coll == 1) {
+	if (rpc_priv->crp_coal) {
+		RPC_TRACE(DB_ALL, rpc_priv, "coalesced reply_send\n");
+		rc = crt_coal_reply_send(rpc_priv, 0);
+	} else if (rpc_priv->crp_coll == 1) {
 		struct crt_cb_info	cb_info;
 
 		RPC_TRACE(DB_ALL, rpc_priv, "collect reply.\n");
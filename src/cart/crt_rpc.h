@@ -19,6 +19,14 @@
 #define CRT_DEFAULT_TIMEOUT_US	(CRT_DEFAULT_TIMEOUT_S * 1e6) /* micro-second */
 
 #define CRT_QUOTA_RPCS_DEFAULT 64
+/* Max interval progress spins for after network activity, micro-second */
+#define CRT_PROG_SPIN_MAX_US	(10000)
+
+/* default and max number of requests packed in one coalesced message */
+#define CRT_COAL_NR_DEFAULT	(16)
+#define CRT_COAL_NR_MAX		(64)
+/* max encoded input size of a request to be coalesced */
+#define CRT_COAL_INPUT_MAX	(1024)
 
 /* uri lookup max retry times */
 #define CRT_URI_LOOKUP_RETRY_MAX	(8)
@@ -189,11 +197,19 @@ struct crt_rpc_priv {
 	    /* RPC originated from a primary provider */
 	    crp_src_is_primary      : 1,
 	    /* release input buffer early */
-	    crp_release_input_early : 1;
+	    crp_release_input_early : 1,
+	    /* carried by a coalesced request, see crt_coalesce.c */
+	    crp_coal                : 1;
 
 	struct crt_opc_info	*crp_opc_info;
 	/* corpc info, only valid when (crp_coll == 1) */
 	struct crt_corpc_info	*crp_corpc_info;
+	/* coalesced request carrying this one, its decoded data points into it */
+	struct crt_rpc_priv	*crp_coal_parent;
+	/* slot of this request in the carrier, server side */
+	uint32_t		crp_coal_idx;
+	/* replies of the carried requests, server side carrier only */
+	struct crt_coal_batch	*crp_coal_batch;
 	pthread_spinlock_t	crp_lock;
 	/*
 	 * Prevent data races on most crt_rpc_priv fields from crt_req_send,
@@ -245,6 +261,9 @@ crt_rpc_unlock(struct crt_rpc_priv *rpc_priv)
 	X(CRT_OPC_CTL_LS,						\
 		0, &CQF_crt_ctl_ep_ls,					\
 		crt_hdlr_ctl_ls, NULL)					\
+	X(CRT_OPC_COALESCE,						\
+		0, &CQF_crt_coalesce,					\
+		crt_hdlr_coalesce, NULL)				\
 
 #define CRT_FI_RPCS_LIST						\
 	X(CRT_OPC_CTL_FI_TOGGLE,					\
@@ -288,6 +307,18 @@ crt_rpc_unlock(struct crt_rpc_priv *rpc_priv)
 	X(CRT_OPC_SELF_TEST_STATUS_REQ,					\
 		0, &CQF_crt_st_status_req,				\
 		crt_self_test_status_req_handler, NULL)			\
+	X(CRT_OPC_SELF_TEST_BOTH_EMPTY_COAL,				\
+		CRT_RPC_FEAT_COALESCE, NULL,				\
+		crt_self_test_msg_handler, NULL)			\
+	X(CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV_COAL,			\
+		CRT_RPC_FEAT_COALESCE, &CQF_crt_st_send_id_reply_iov,	\
+		crt_self_test_msg_handler, NULL)			\
+	X(CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY_COAL,			\
+		CRT_RPC_FEAT_COALESCE, &CQF_crt_st_send_iov_reply_empty, \
+		crt_self_test_msg_handler, NULL)			\
+	X(CRT_OPC_SELF_TEST_BOTH_IOV_COAL,				\
+		CRT_RPC_FEAT_COALESCE, &CQF_crt_st_both_iov,		\
+		crt_self_test_msg_handler, NULL)			\
 
 #define CRT_CTL_RPCS_LIST						\
 	X(CRT_OPC_CTL_LOG_SET,						\
@@ -308,10 +339,10 @@ crt_rpc_unlock(struct crt_rpc_priv *rpc_priv)
 
 #define CRT_IV_RPCS_LIST						\
 	X(CRT_OPC_IV_FETCH,						\
-		0, &CQF_crt_iv_fetch,					\
+		CRT_RPC_FEAT_COALESCE, &CQF_crt_iv_fetch,		\
 		crt_hdlr_iv_fetch, NULL)				\
 	X(CRT_OPC_IV_UPDATE,						\
-		0, &CQF_crt_iv_update,					\
+		CRT_RPC_FEAT_COALESCE, &CQF_crt_iv_update,		\
 		crt_hdlr_iv_update, NULL)				\
 	X(CRT_OPC_IV_SYNC,						\
 		0, &CQF_crt_iv_sync,					\
@@ -387,6 +418,18 @@ CRT_GEN_STRUCT(crt_grp_cache, CRT_SEQ_GRP_CACHE)
 
 CRT_RPC_DECLARE(crt_uri_lookup, CRT_ISEQ_URI_LOOKUP, CRT_OSEQ_URI_LOOKUP)
 
+/* co_buf holds co_count records, see struct crt_coal_rec */
+#define CRT_ISEQ_COALESCE	/* input fields */		 \
+	((uint32_t)		(co_count)		CRT_VAR) \
+	((uint32_t)		(co_padding)		CRT_VAR) \
+	((d_iov_t)		(co_buf)		CRT_VAR)
+
+#define CRT_OSEQ_COALESCE	/* output fields */		 \
+	((d_iov_t)		(co_buf)		CRT_VAR) \
+	((int32_t)		(co_rc)			CRT_VAR)
+
+CRT_RPC_DECLARE(crt_coalesce, CRT_ISEQ_COALESCE, CRT_OSEQ_COALESCE)
+
 #define CRT_ISEQ_ST_SEND_ID	/* input fields */		 \
 	((uint64_t)		(unused1)		CRT_VAR)
 
@@ -671,6 +714,7 @@ int crt_req_create_internal(crt_context_t crt_ctx, crt_endpoint_t *tgt_ep,
 int crt_internal_rpc_register(bool server);
 int crt_rpc_common_hdlr(struct crt_rpc_priv *rpc_priv);
 int crt_req_send_internal(struct crt_rpc_priv *rpc_priv);
+int crt_req_send_direct(struct crt_rpc_priv *rpc_priv);
 
 static inline bool
 crt_req_timedout(struct crt_rpc_priv *rpc_priv)
@@ -699,6 +743,25 @@ crt_opc_decode(crt_opcode_t opc, char **module_name, char **opc_name);
 
 bool crt_rpc_completed(struct crt_rpc_priv *rpc_priv);
 
+/* crt_coalesce.c */
+struct crt_coal_batch;
+
+int crt_coal_ctx_init(struct crt_context *ctx);
+void crt_coal_ctx_fini(struct crt_context *ctx);
+int crt_coal_req_add(struct crt_rpc_priv *rpc_priv, bool *queued);
+void crt_coal_flush(struct crt_context *ctx);
+void crt_hdlr_coalesce(crt_rpc_t *rpc);
+int crt_coal_reply_send(struct crt_rpc_priv *rpc_priv, int rc);
+void crt_coal_req_destroy(struct crt_rpc_priv *rpc_priv);
+void crt_coal_batch_free(struct crt_coal_batch *batch);
+
+static inline bool
+crt_coal_eligible(struct crt_rpc_priv *rpc_priv)
+{
+	return rpc_priv->crp_opc_info->coi_coalesce && crt_gdata.cg_coal_max > 1 &&
+	       !rpc_priv->crp_coll && !rpc_priv->crp_forward && !rpc_priv->crp_coal;
+}
+
 /* crt_corpc.c */
 int crt_corpc_req_hdlr(struct crt_rpc_priv *rpc_priv);
 void crt_corpc_reply_hdlr(const struct crt_cb_info *cb_info);
@@ -142,6 +142,8 @@ struct crt_st_session_params {
 		struct {
 			enum crt_st_msg_type send_type: 2;
 			enum crt_st_msg_type reply_type: 2;
+			/* use the CRT_RPC_FEAT_COALESCE test opcodes */
+			uint32_t coalesce: 1;
 			int16_t buf_alignment: 16;
 		};
 		uint32_t flags;
@@ -199,6 +201,8 @@ struct crt_st_start_params {
 		struct {
 			enum crt_st_msg_type send_type: 2;
 			enum crt_st_msg_type reply_type: 2;
+			/* use the CRT_RPC_FEAT_COALESCE test opcodes */
+			uint32_t coalesce: 1;
 			int16_t buf_alignment: 16;
 		};
 		uint32_t flags;
@@ -214,7 +218,7 @@ struct st_latency {
 
 static inline crt_opcode_t
 crt_st_compute_opcode(enum crt_st_msg_type send_type,
-		      enum crt_st_msg_type reply_type)
+		      enum crt_st_msg_type reply_type, bool coalesce)
 {
 	D_ASSERT(send_type >= 0 && send_type < 4);
 	D_ASSERT(reply_type >= 0 && reply_type < 4);
@@ -235,9 +239,41 @@ crt_st_compute_opcode(enum crt_st_msg_type send_type,
 					 CRT_OPC_SELF_TEST_BOTH_BULK,
 					 -1 } };
 
+	/* only the requests without bulk have a coalesced twin */
+	if (coalesce) {
+		switch (opcodes[send_type][reply_type]) {
+		case CRT_OPC_SELF_TEST_BOTH_EMPTY:
+			return CRT_OPC_SELF_TEST_BOTH_EMPTY_COAL;
+		case CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV:
+			return CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV_COAL;
+		case CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY:
+			return CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY_COAL;
+		case CRT_OPC_SELF_TEST_BOTH_IOV:
+			return CRT_OPC_SELF_TEST_BOTH_IOV_COAL;
+		}
+	}
+
 	return opcodes[send_type][reply_type];
 }
 
+/* Return the opcode a coalesced test opcode is the twin of */
+static inline crt_opcode_t
+crt_st_base_opcode(crt_opcode_t opc)
+{
+	switch (opc) {
+	case CRT_OPC_SELF_TEST_BOTH_EMPTY_COAL:
+		return CRT_OPC_SELF_TEST_BOTH_EMPTY;
+	case CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV_COAL:
+		return CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV;
+	case CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY_COAL:
+		return CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY;
+	case CRT_OPC_SELF_TEST_BOTH_IOV_COAL:
+		return CRT_OPC_SELF_TEST_BOTH_IOV;
+	default:
+		return opc;
+	}
+}
+
 static inline void *crt_st_get_aligned_ptr(void *base, int16_t buf_alignment)
 {
 	void *returnptr;
@@ -61,6 +61,7 @@ struct st_g_data {
 	int16_t				  buf_alignment;
 	enum crt_st_msg_type		  send_type;
 	enum crt_st_msg_type		  reply_type;
+	bool				  coalesce;
 
 	/* Private arguments data for all RPC callback functions */
 	struct st_cb_args		**cb_args_ptrs;
@@ -377,7 +378,8 @@ static void send_next_rpc(struct st_cb_args *cb_args, int skip_inc_complete)
 		 * should be used for this test message
 		 */
 		opcode = crt_st_compute_opcode(g_data->send_type,
-					       g_data->reply_type);
+					       g_data->reply_type,
+					       g_data->coalesce);
 
 		/* Start a new RPC request */
 		ret = crt_req_create(g_data->crt_ctx, &local_endpt,
@@ -394,7 +396,7 @@ static void send_next_rpc(struct st_cb_args *cb_args, int skip_inc_complete)
 			  "crt_req_create succeeded but RPC is NULL\n");
 
 		/* No arguments to assemble for BOTH_EMPTY RPCs */
-		if (opcode == CRT_OPC_SELF_TEST_BOTH_EMPTY)
+		if (crt_st_base_opcode(opcode) == CRT_OPC_SELF_TEST_BOTH_EMPTY)
 			goto send_rpc;
 
 		/* Get the arguments handle */
@@ -404,7 +406,7 @@ static void send_next_rpc(struct st_cb_args *cb_args, int skip_inc_complete)
 		/* Session ID is always the first field */
 		*((int64_t *)args) = endpt_ptr->session_id;
 
-		switch (opcode) {
+		switch (crt_st_base_opcode(opcode)) {
 		case CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY:
 		case CRT_OPC_SELF_TEST_BOTH_IOV:
 			{
@@ -694,6 +696,7 @@ static void open_sessions(void)
 		args->send_type = g_data->send_type;
 		args->reply_type = g_data->reply_type;
 		args->buf_alignment = g_data->buf_alignment;
+		args->coalesce = g_data->coalesce;
 
 		/*
 		 * Set the number of buffers that the service should allocate.
@@ -852,6 +855,7 @@ crt_self_test_start_handler(crt_rpc_t *rpc_req)
 	g_data->send_type = args->send_type;
 	g_data->buf_alignment = args->buf_alignment;
 	g_data->reply_type = args->reply_type;
+	g_data->coalesce = args->coalesce;
 	g_data->num_endpts = args->endpts.iov_buf_len / 8;
 	ret = D_SPIN_INIT(&g_data->ctr_lock, PTHREAD_PROCESS_PRIVATE);
 	if (ret != 0)
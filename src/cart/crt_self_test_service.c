@@ -565,15 +565,17 @@ crt_self_test_msg_handler(crt_rpc_t *rpc_req)
 	struct st_buf_entry	*buf_entry = NULL;
 	struct st_session	*session;
 	int64_t			 session_id;
+	crt_opcode_t		 opc;
 	int			 ret;
 
-	D_ASSERT(rpc_req->cr_opc == CRT_OPC_SELF_TEST_BOTH_EMPTY ||
-		 rpc_req->cr_opc == CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV ||
-		 rpc_req->cr_opc == CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY ||
-		 rpc_req->cr_opc == CRT_OPC_SELF_TEST_BOTH_IOV ||
-		 rpc_req->cr_opc == CRT_OPC_SELF_TEST_SEND_BULK_REPLY_IOV ||
-		 rpc_req->cr_opc == CRT_OPC_SELF_TEST_SEND_IOV_REPLY_BULK ||
-		 rpc_req->cr_opc == CRT_OPC_SELF_TEST_BOTH_BULK);
+	opc = crt_st_base_opcode(rpc_req->cr_opc);
+	D_ASSERT(opc == CRT_OPC_SELF_TEST_BOTH_EMPTY ||
+		 opc == CRT_OPC_SELF_TEST_SEND_ID_REPLY_IOV ||
+		 opc == CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY ||
+		 opc == CRT_OPC_SELF_TEST_BOTH_IOV ||
+		 opc == CRT_OPC_SELF_TEST_SEND_BULK_REPLY_IOV ||
+		 opc == CRT_OPC_SELF_TEST_SEND_IOV_REPLY_BULK ||
+		 opc == CRT_OPC_SELF_TEST_BOTH_BULK);
 
 	/*
 	 * Increment the reference counter for this RPC
@@ -585,8 +587,8 @@ crt_self_test_msg_handler(crt_rpc_t *rpc_req)
 	 * For messages that do not use bulk and have no reply data, skip
 	 * directly to sending the reply
 	 */
-	if (rpc_req->cr_opc == CRT_OPC_SELF_TEST_BOTH_EMPTY ||
-	    rpc_req->cr_opc == CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY) {
+	if (opc == CRT_OPC_SELF_TEST_BOTH_EMPTY ||
+	    opc == CRT_OPC_SELF_TEST_SEND_IOV_REPLY_EMPTY) {
 		crt_self_test_msg_send_reply(rpc_req, NULL, 0);
 		return;
 	}
@@ -627,7 +629,8 @@ crt_self_test_msg_handler(crt_rpc_t *rpc_req)
 	}
 	if (rpc_req->cr_opc !=
 		crt_st_compute_opcode(session->params.send_type,
-				      session->params.reply_type)) {
+				      session->params.reply_type,
+				      session->params.coalesce)) {
 		D_ERROR("Opcode / self-test session params mismatch\n");
 		crt_self_test_msg_send_reply(rpc_req, NULL, 1);
 		return;
@@ -81,6 +81,110 @@ out:
 	return rc;
 }
 
+static void
+crt_tree_dom_cache_put_locked(struct crt_tree_dom_cache *cache)
+{
+	D_ASSERT(cache->tdc_ref > 0);
+	if (--cache->tdc_ref > 0)
+		return;
+
+	crt_tree_dom_layout_fini(&cache->tdc_layout);
+	d_rank_list_free(cache->tdc_ranks);
+	D_FREE(cache);
+}
+
+static void
+crt_tree_dom_cache_put(struct crt_grp_priv *grp_priv, struct crt_tree_dom_cache *cache)
+{
+	if (cache == NULL)
+		return;
+
+	D_MUTEX_LOCK(&grp_priv->gp_tree_lock);
+	crt_tree_dom_cache_put_locked(cache);
+	D_MUTEX_UNLOCK(&grp_priv->gp_tree_lock);
+}
+
+/* Release the cached layout when the group is destroyed */
+void
+crt_tree_dom_cache_fini(struct crt_grp_priv *grp_priv)
+{
+	if (grp_priv->gp_tree_cache != NULL) {
+		crt_tree_dom_cache_put_locked(grp_priv->gp_tree_cache);
+		grp_priv->gp_tree_cache = NULL;
+	}
+}
+
+/*
+ * Get the layout of the CRT_TREE_DOMAIN tree of grp_rank_list, from the cache
+ * of the group if it is the same tree, otherwise lay it out and cache it.
+ * Called with gp_rwlock held, which keeps the domains stable. Released by
+ * crt_tree_dom_cache_put().
+ */
+static int
+crt_tree_dom_layout_grp(struct crt_grp_priv *grp_priv, d_rank_list_t *grp_rank_list,
+			uint32_t tree_ratio, d_rank_t grp_root,
+			struct crt_tree_dom_cache **cachep)
+{
+	struct crt_tree_dom_cache	*cache;
+	uint32_t			*domains = NULL;
+	uint32_t			 i;
+	int				 rc;
+
+	D_MUTEX_LOCK(&grp_priv->gp_tree_lock);
+	cache = grp_priv->gp_tree_cache;
+	if (cache != NULL && cache->tdc_dom_gen == grp_priv->gp_dom_gen &&
+	    cache->tdc_ratio == tree_ratio && cache->tdc_root == grp_root &&
+	    d_rank_list_identical(cache->tdc_ranks, grp_rank_list)) {
+		cache->tdc_ref++;
+		D_MUTEX_UNLOCK(&grp_priv->gp_tree_lock);
+		*cachep = cache;
+		return 0;
+	}
+	D_MUTEX_UNLOCK(&grp_priv->gp_tree_lock);
+
+	D_ALLOC_PTR(cache);
+	if (cache == NULL)
+		return -DER_NOMEM;
+
+	rc = d_rank_list_dup(&cache->tdc_ranks, grp_rank_list);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	if (grp_priv->gp_dom_nr > 0) {
+		D_ALLOC_ARRAY(domains, grp_rank_list->rl_nr);
+		if (domains == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+		for (i = 0; i < grp_rank_list->rl_nr; i++)
+			domains[i] = crt_grp_priv_get_domain(grp_priv,
+							     grp_rank_list->rl_ranks[i]);
+	}
+
+	rc = crt_tree_dom_layout_init(&cache->tdc_layout, grp_rank_list->rl_nr, tree_ratio,
+				      domains, grp_root);
+	D_FREE(domains);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	cache->tdc_dom_gen = grp_priv->gp_dom_gen;
+	cache->tdc_ratio = tree_ratio;
+	cache->tdc_root = grp_root;
+	/* one for the cache, one for the caller */
+	cache->tdc_ref = 2;
+
+	D_MUTEX_LOCK(&grp_priv->gp_tree_lock);
+	if (grp_priv->gp_tree_cache != NULL)
+		crt_tree_dom_cache_put_locked(grp_priv->gp_tree_cache);
+	grp_priv->gp_tree_cache = cache;
+	D_MUTEX_UNLOCK(&grp_priv->gp_tree_lock);
+
+	*cachep = cache;
+	return 0;
+out:
+	d_rank_list_free(cache->tdc_ranks);
+	D_FREE(cache);
+	return rc;
+}
+
 #define CRT_TREE_PARAMETER_CHECKING(grp_priv, tree_topo, root, self)	\
 	do {								\
 									\
@@ -145,6 +249,18 @@ crt_tree_get_nchildren(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
+	if (tree_type == CRT_TREE_DOMAIN) {
+		struct crt_tree_dom_cache *cache;
+
+		rc = crt_tree_dom_layout_grp(grp_priv, grp_rank_list, tree_ratio,
+					     grp_root, &cache);
+		if (rc != 0)
+			D_GOTO(out, rc);
+		*nchildren = crt_tree_dom_get_children(&cache->tdc_layout, grp_self, NULL);
+		crt_tree_dom_cache_put(grp_priv, cache);
+		D_GOTO(out, rc);
+	}
+
 	tops = crt_tops[tree_type];
 	rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root, grp_self,
 				       nchildren);
@@ -181,6 +297,7 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	uint32_t		 grp_size, nchildren;
 	uint32_t		 *tree_children;
 	struct crt_topo_ops	*tops;
+	struct crt_tree_dom_cache *cache = NULL;
 	int			 i, rc = 0;
 
 
@@ -226,8 +343,16 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 
 	tops = crt_tops[tree_type];
 
-	rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root, grp_self,
-				       &nchildren);
+	if (tree_type == CRT_TREE_DOMAIN) {
+		rc = crt_tree_dom_layout_grp(grp_priv, grp_rank_list, tree_ratio,
+					     grp_root, &cache);
+		if (rc != 0)
+			D_GOTO(out, rc);
+		nchildren = crt_tree_dom_get_children(&cache->tdc_layout, grp_self, NULL);
+	} else {
+		rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root,
+					       grp_self, &nchildren);
+	}
 	if (rc != 0) {
 		D_ERROR("to_get_children_cnt (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -247,8 +372,11 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		d_rank_list_free(result_rank_list);
 		D_GOTO(out, rc = -DER_NOMEM);
 	}
-	rc = tops->to_get_children(grp_size, tree_ratio, grp_root, grp_self,
-				   tree_children);
+	if (tree_type == CRT_TREE_DOMAIN)
+		crt_tree_dom_get_children(&cache->tdc_layout, grp_self, tree_children);
+	else
+		rc = tops->to_get_children(grp_size, tree_ratio, grp_root,
+					   grp_self, tree_children);
 	if (rc != 0) {
 		D_ERROR("to_get_children (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -267,6 +395,7 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 
 out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+	crt_tree_dom_cache_put(grp_priv, cache);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
 	return rc;
@@ -314,9 +443,20 @@ crt_tree_get_parent(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
-	tops = crt_tops[tree_type];
-	rc = tops->to_get_parent(grp_size, tree_ratio, grp_root, grp_self,
-				 &tree_parent);
+	if (tree_type == CRT_TREE_DOMAIN) {
+		struct crt_tree_dom_cache *cache;
+
+		rc = crt_tree_dom_layout_grp(grp_priv, grp_rank_list, tree_ratio,
+					     grp_root, &cache);
+		if (rc != 0)
+			D_GOTO(out, rc);
+		rc = crt_tree_dom_get_parent(&cache->tdc_layout, grp_self, &tree_parent);
+		crt_tree_dom_cache_put(grp_priv, cache);
+	} else {
+		tops = crt_tops[tree_type];
+		rc = tops->to_get_parent(grp_size, tree_ratio, grp_root,
+					 grp_self, &tree_parent);
+	}
 	if (rc != 0) {
 		D_ERROR("to_get_parent (group %s, root %d, self %d) failed, "
 			"rc: %d.\n", grp_priv->gp_pub.cg_grpid, root, self, rc);
@@ -336,4 +476,5 @@ struct crt_topo_ops *crt_tops[] = {
 	&crt_flat_ops,		/* CRT_TREE_FLAT */
 	&crt_kary_ops,		/* CRT_TREE_KARY */
 	&crt_knomial_ops,	/* CRT_TREE_KNOMIAL */
+	NULL,			/* CRT_TREE_DOMAIN, see crt_tree_dom_layout */
 };
@@ -69,6 +69,51 @@ extern struct crt_topo_ops	 crt_knomial_ops;
 
 extern struct crt_topo_ops	*crt_tops[];
 
+/*
+ * Layout of a CRT_TREE_DOMAIN tree, see crt_tree_domain.c. Its trees need the
+ * domain of every rank, so they do not fit crt_topo_ops.
+ */
+struct crt_tree_dom_layout {
+	uint32_t	 tdl_size;
+	/* requested ratio and ratio of the level of the domain leaders */
+	uint32_t	 tdl_ratio;
+	uint32_t	 tdl_dom_ratio;
+	uint32_t	 tdl_ndoms;
+	/* group ranks domain by domain, each domain starting with its leader */
+	uint32_t	*tdl_order;
+	/* index in tdl_order and domain of each group rank */
+	uint32_t	*tdl_pos;
+	uint32_t	*tdl_dom;
+	/* index in tdl_order of the first rank of each domain, tdl_ndoms + 1 */
+	uint32_t	*tdl_start;
+};
+
+/*
+ * Last CRT_TREE_DOMAIN layout computed for a group, reused as long as the
+ * filtered member ranks, the domains, the root and the ratio are the same.
+ * Protected by gp_tree_lock of the group, referenced by the cache itself and
+ * by each user.
+ */
+struct crt_tree_dom_cache {
+	uint32_t			 tdc_ref;
+	uint32_t			 tdc_dom_gen;
+	uint32_t			 tdc_ratio;
+	d_rank_t			 tdc_root;
+	d_rank_list_t			*tdc_ranks;
+	struct crt_tree_dom_layout	 tdc_layout;
+};
+
+void crt_tree_dom_cache_fini(struct crt_grp_priv *grp_priv);
+
+uint32_t crt_tree_dom_level_ratio(uint32_t nr, uint32_t tree_ratio);
+int crt_tree_dom_layout_init(struct crt_tree_dom_layout *layout, uint32_t grp_size,
+			     uint32_t tree_ratio, const uint32_t *domains, uint32_t grp_root);
+void crt_tree_dom_layout_fini(struct crt_tree_dom_layout *layout);
+uint32_t crt_tree_dom_get_children(struct crt_tree_dom_layout *layout, uint32_t grp_self,
+				   uint32_t *children);
+int crt_tree_dom_get_parent(struct crt_tree_dom_layout *layout, uint32_t grp_self,
+			    uint32_t *parent);
+
 /* some simple helpers */
 static inline int
 crt_tree_type(int tree_topo)
@@ -0,0 +1,209 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT. It gives out the fault domain aware tree topo
+ * related function implementation.
+ *
+ * The group ranks are laid out domain by domain, the domain of the root first
+ * and then the others by domain ID. The first rank of each domain is its
+ * leader, the root for its own domain and the lowest tree rank for the others.
+ * The leaders form a knomial tree rooted at the root, and each leader is the
+ * root of a knomial tree over the members of its domain.
+ */
+#define D_LOGFAC	DD_FAC(grp)
+
+#include "crt_internal.h"
+
+struct crt_tree_dom_ent {
+	/* 0 for the domain of the root, 1 for the others */
+	uint32_t	tde_other;
+	uint32_t	tde_domain;
+	uint32_t	tde_tree_rank;
+	uint32_t	tde_grp_rank;
+};
+
+static int
+crt_tree_dom_ent_cmp(const void *a, const void *b)
+{
+	const struct crt_tree_dom_ent *ea = a;
+	const struct crt_tree_dom_ent *eb = b;
+
+	if (ea->tde_other != eb->tde_other)
+		return ea->tde_other < eb->tde_other ? -1 : 1;
+	if (ea->tde_domain != eb->tde_domain)
+		return ea->tde_domain < eb->tde_domain ? -1 : 1;
+	if (ea->tde_tree_rank != eb->tde_tree_rank)
+		return ea->tde_tree_rank < eb->tde_tree_rank ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Ratio of a level of \a nr ranks: the smallest one from \a tree_ratio that
+ * keeps the level within CRT_TREE_DOMAIN_LEVEL_DEPTH hops, a knomial tree
+ * being as deep as the number of digits of its ranks.
+ */
+uint32_t
+crt_tree_dom_level_ratio(uint32_t nr, uint32_t tree_ratio)
+{
+	uint64_t	reach;
+	int		i;
+
+	for (; tree_ratio < CRT_TREE_MAX_RATIO; tree_ratio++) {
+		reach = 1;
+		for (i = 0; i < CRT_TREE_DOMAIN_LEVEL_DEPTH; i++)
+			reach *= tree_ratio;
+		if (reach >= nr)
+			break;
+	}
+
+	return tree_ratio;
+}
+
+int
+crt_tree_dom_layout_init(struct crt_tree_dom_layout *layout, uint32_t grp_size,
+			 uint32_t tree_ratio, const uint32_t *domains, uint32_t grp_root)
+{
+	struct crt_tree_dom_ent	*ents;
+	uint32_t		 root_dom;
+	uint32_t		 i;
+	int			 rc = 0;
+
+	D_ASSERT(grp_size > 0);
+	D_ASSERT(grp_root < grp_size);
+	D_ASSERT(tree_ratio >= CRT_TREE_MIN_RATIO &&
+		 tree_ratio <= CRT_TREE_MAX_RATIO);
+
+	memset(layout, 0, sizeof(*layout));
+	D_ALLOC_ARRAY(ents, grp_size);
+	D_ALLOC_ARRAY(layout->tdl_order, grp_size);
+	D_ALLOC_ARRAY(layout->tdl_pos, grp_size);
+	D_ALLOC_ARRAY(layout->tdl_dom, grp_size);
+	D_ALLOC_ARRAY(layout->tdl_start, grp_size + 1);
+	if (ents == NULL || layout->tdl_order == NULL || layout->tdl_pos == NULL ||
+	    layout->tdl_dom == NULL || layout->tdl_start == NULL) {
+		crt_tree_dom_layout_fini(layout);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	root_dom = domains != NULL ? domains[grp_root] : CRT_NO_DOMAIN;
+	for (i = 0; i < grp_size; i++) {
+		ents[i].tde_domain    = domains != NULL ? domains[i] : CRT_NO_DOMAIN;
+		ents[i].tde_other     = ents[i].tde_domain != root_dom;
+		ents[i].tde_tree_rank = crt_grprank_2_tree_rank(grp_size, grp_root, i);
+		ents[i].tde_grp_rank  = i;
+	}
+	qsort(ents, grp_size, sizeof(*ents), crt_tree_dom_ent_cmp);
+
+	for (i = 0; i < grp_size; i++) {
+		if (i == 0 || ents[i].tde_other != ents[i - 1].tde_other ||
+		    ents[i].tde_domain != ents[i - 1].tde_domain)
+			layout->tdl_start[layout->tdl_ndoms++] = i;
+		layout->tdl_order[i]                    = ents[i].tde_grp_rank;
+		layout->tdl_pos[ents[i].tde_grp_rank]   = i;
+		layout->tdl_dom[ents[i].tde_grp_rank]   = layout->tdl_ndoms - 1;
+	}
+	layout->tdl_start[layout->tdl_ndoms] = grp_size;
+	layout->tdl_size  = grp_size;
+	layout->tdl_ratio = tree_ratio;
+	layout->tdl_dom_ratio = crt_tree_dom_level_ratio(layout->tdl_ndoms, tree_ratio);
+	D_ASSERT(layout->tdl_order[0] == grp_root);
+
+out:
+	D_FREE(ents);
+	return rc;
+}
+
+void
+crt_tree_dom_layout_fini(struct crt_tree_dom_layout *layout)
+{
+	D_FREE(layout->tdl_order);
+	D_FREE(layout->tdl_pos);
+	D_FREE(layout->tdl_dom);
+	D_FREE(layout->tdl_start);
+}
+
+/*
+ * Children of \a grp_self, the leaders of the child domains first. Only
+ * counted when \a children is NULL, which otherwise has to be large enough.
+ */
+uint32_t
+crt_tree_dom_get_children(struct crt_tree_dom_layout *layout, uint32_t grp_self,
+			  uint32_t *children)
+{
+	uint32_t	dom;
+	uint32_t	start;
+	uint32_t	nr;
+	uint32_t	self;
+	uint32_t	ratio;
+	uint32_t	cnt;
+	uint32_t	nchildren = 0;
+	uint32_t	i;
+
+	D_ASSERT(grp_self < layout->tdl_size);
+
+	dom   = layout->tdl_dom[grp_self];
+	start = layout->tdl_start[dom];
+	nr    = layout->tdl_start[dom + 1] - start;
+	self  = layout->tdl_pos[grp_self] - start;
+
+	/* leader, reaches the leaders of its child domains */
+	if (self == 0) {
+		ratio = layout->tdl_dom_ratio;
+		crt_knomial_ops.to_get_children_cnt(layout->tdl_ndoms, ratio, 0, dom, &cnt);
+		if (children != NULL && cnt > 0) {
+			crt_knomial_ops.to_get_children(layout->tdl_ndoms, ratio, 0, dom,
+							children);
+			for (i = 0; i < cnt; i++)
+				children[i] = layout->tdl_order[layout->tdl_start[children[i]]];
+		}
+		nchildren = cnt;
+	}
+
+	/* the members of its domain */
+	ratio = crt_tree_dom_level_ratio(nr, layout->tdl_ratio);
+	crt_knomial_ops.to_get_children_cnt(nr, ratio, 0, self, &cnt);
+	if (children != NULL && cnt > 0) {
+		crt_knomial_ops.to_get_children(nr, ratio, 0, self, children + nchildren);
+		for (i = nchildren; i < nchildren + cnt; i++)
+			children[i] = layout->tdl_order[start + children[i]];
+	}
+
+	return nchildren + cnt;
+}
+
+int
+crt_tree_dom_get_parent(struct crt_tree_dom_layout *layout, uint32_t grp_self,
+			uint32_t *parent)
+{
+	uint32_t	dom;
+	uint32_t	start;
+	uint32_t	nr;
+	uint32_t	self;
+	uint32_t	tree_parent;
+	int		rc;
+
+	D_ASSERT(grp_self < layout->tdl_size);
+
+	dom   = layout->tdl_dom[grp_self];
+	start = layout->tdl_start[dom];
+	nr    = layout->tdl_start[dom + 1] - start;
+	self  = layout->tdl_pos[grp_self] - start;
+
+	if (self != 0) {
+		rc = crt_knomial_ops.to_get_parent(nr, crt_tree_dom_level_ratio(nr, layout->tdl_ratio),
+						   0, self, &tree_parent);
+		if (rc == 0)
+			*parent = layout->tdl_order[start + tree_parent];
+	} else {
+		/* -DER_INVAL for the root, as the other tree types */
+		rc = crt_knomial_ops.to_get_parent(layout->tdl_ndoms, layout->tdl_dom_ratio, 0, dom,
+						   &tree_parent);
+		if (rc == 0)
+			*parent = layout->tdl_order[layout->tdl_start[tree_parent]];
+	}
+
+	return rc;
+}
@@ -242,6 +242,27 @@ daos_array_get_size(daos_handle_t oh, daos_handle_t th, daos_size_t *size,
 	return dc_task_schedule(task, true);
 } /* end daos_array_get_size */
 
+int
+daos_array_get_size_multi(uint32_t nr, daos_handle_t *ohs, daos_handle_t th, daos_size_t *sizes,
+			  daos_event_t *ev)
+{
+	daos_array_get_size_multi_t	*args;
+	tse_task_t			*task;
+	int				 rc;
+
+	rc = dc_task_create(dc_array_get_size_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->nr	= nr;
+	args->ohs	= ohs;
+	args->th	= th;
+	args->sizes	= sizes;
+
+	return dc_task_schedule(task, true);
+} /* end daos_array_get_size_multi */
+
 int
 daos_array_stat(daos_handle_t oh, daos_handle_t th, daos_array_stbuf_t *stbuf, daos_event_t *ev)
 {
@@ -264,6 +264,11 @@ daos_init(void)
 	if (rc != 0)
 		D_GOTO(out_co, rc);
 
+	/** set up array */
+	rc = dc_array_init();
+	if (rc != 0)
+		D_GOTO(out_obj, rc);
+
 #if BUILD_PIPELINE
 	/** set up pipeline */
 	rc = dc_pipeline_init();
@@ -273,10 +278,8 @@ daos_init(void)
 	module_initialized++;
 	D_GOTO(unlock, rc = 0);
 
-#if BUILD_PIPELINE
 out_obj:
 	dc_obj_fini();
-#endif
 out_co:
 	dc_cont_fini();
 out_pool:
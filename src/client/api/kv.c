@@ -120,6 +120,57 @@ daos_kv_get(daos_handle_t oh, daos_handle_t th, uint64_t flags, const char *key,
 	return dc_task_schedule(task, true);
 }
 
+int
+daos_kv_put_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags, unsigned int nr,
+		  const char **keys, const daos_size_t *sizes, const void **bufs, int *rcs,
+		  daos_event_t *ev)
+{
+	daos_kv_multi_t	*args;
+	tse_task_t	*task;
+	int		 rc;
+
+	rc = dc_task_create(dc_kv_put_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->oh	= oh;
+	args->th	= th;
+	args->flags	= flags;
+	args->nr	= nr;
+	args->keys	= keys;
+	args->sizes	= (daos_size_t *)sizes;
+	args->bufs	= (void **)bufs;
+	args->rcs	= rcs;
+
+	return dc_task_schedule(task, true);
+}
+
+int
+daos_kv_get_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags, unsigned int nr,
+		  const char **keys, daos_size_t *sizes, void **bufs, int *rcs, daos_event_t *ev)
+{
+	daos_kv_multi_t	*args;
+	tse_task_t	*task;
+	int		 rc;
+
+	rc = dc_task_create(dc_kv_get_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->oh	= oh;
+	args->th	= th;
+	args->flags	= flags;
+	args->nr	= nr;
+	args->keys	= keys;
+	args->sizes	= sizes;
+	args->bufs	= bufs;
+	args->rcs	= rcs;
+
+	return dc_task_schedule(task, true);
+}
+
 int
 daos_kv_remove(daos_handle_t oh, daos_handle_t th, uint64_t flags,
 	       const char *key, daos_event_t *ev)
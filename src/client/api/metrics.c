@@ -21,10 +21,16 @@
 #include <gurt/telemetry_producer.h>
 
 #define INIT_JOB_NUM 1024
+/* Log-linear histograms of the per-thread op and per-size latency */
+#define INIT_HDR_NUM 512
+/* Slots of the sharded per-thread sensors and per-pool counters */
+#define INIT_SHARD_NUM 4096
 bool daos_client_metric;
 bool daos_client_metric_retain;
 
 #define MAX_IDS_SIZE(num) (num * D_TM_METRIC_SIZE)
+#define MAX_HDR_SIZE(num) (num * D_TM_HDR_SIZE(D_TM_HDR_SUB_BITS, D_TM_HDR_MAX_BITS))
+#define MAX_SHARD_SIZE(num) (num * sizeof(struct d_tm_shard_t))
 /* The client side metrics structure looks like
  * root/job_id/pid/....
  */
@@ -74,7 +80,9 @@ init_root(const char *name, pid_t pid, int flags)
 	int   rc;
 
 	key = shm_key(pid);
-	rc  = d_tm_init_with_name(key, MAX_IDS_SIZE(INIT_JOB_NUM), flags, name);
+	rc  = d_tm_init_with_name(key, MAX_IDS_SIZE(INIT_JOB_NUM) + MAX_HDR_SIZE(INIT_HDR_NUM) +
+				  MAX_SHARD_SIZE(INIT_SHARD_NUM),
+				  flags, name);
 	if (rc != 0) {
 		DL_ERROR(rc, "failed to initialize root for %s.", name);
 		return rc;
@@ -23,6 +23,23 @@
 #define CELL_SIZE	"daos_array_cell_size"
 #define CHUNK_SIZE	"daos_array_chunk_size"
 
+/** default number of dkey I/Os of one array read/write kept in flight */
+#define ARRAY_IO_DEPTH_DEF	64
+
+/**
+ * Max number of per-dkey fetch/update tasks of a single array I/O that are in flight at any time.
+ * Large transfers are streamed through this window: the task for the Nth dkey starts only when
+ * the one for dkey N - depth has completed. 0 means no limit.
+ */
+static unsigned int array_io_depth = ARRAY_IO_DEPTH_DEF;
+
+/**
+ * Time in ms a size fetched from the servers can be served from the array handle before it is
+ * queried again. Local writes, punches and truncates keep the cached size up to date in between.
+ * 0 disables size caching.
+ */
+static unsigned int array_size_cache_timeout;
+
 struct dc_array {
 	/** link chain in the global handle hash table */
 	struct d_hlink		hlink;
@@ -40,6 +57,18 @@ struct dc_array {
 	unsigned int		mode;
 	/** Is this a byte array (set short fetch & memset holes to 0 */
 	bool			byte_array;
+	/** protects the cached size fields below */
+	pthread_spinlock_t	size_lock;
+	/** cached array size in records, valid if size_cached is set */
+	daos_size_t		size;
+	/** max epoch of the array when the size was cached, 0 if unknown */
+	daos_epoch_t		size_epoch;
+	/** time (us) the cached size was last fetched from the servers */
+	uint64_t		size_time;
+	/** bumped on every local modification to drop racing size queries */
+	uint64_t		size_gen;
+	/** is the cached size valid */
+	bool			size_cached;
 };
 
 struct md_params {
@@ -69,6 +98,16 @@ struct io_params {
 	char			akey_val;
 };
 
+int
+dc_array_init(void)
+{
+	d_getenv_uint("DAOS_ARRAY_IO_DEPTH", &array_io_depth);
+	d_getenv_uint("DAOS_ARRAY_SIZE_CACHE_TIMEOUT", &array_size_cache_timeout);
+	D_DEBUG(DB_IO, "array I/O depth set to %u, size cache timeout %u ms\n", array_io_depth,
+		array_size_cache_timeout);
+	return 0;
+}
+
 static void
 array_free(struct d_hlink *hlink)
 {
@@ -76,6 +115,7 @@ array_free(struct d_hlink *hlink)
 
 	array = container_of(hlink, struct dc_array, hlink);
 	D_ASSERT(daos_hhash_link_empty(&array->hlink));
+	D_SPIN_DESTROY(&array->size_lock);
 	D_FREE(array);
 }
 
@@ -87,21 +127,138 @@ static struct dc_array *
 array_alloc(void)
 {
 	struct dc_array *array;
+	int		 rc;
 
 	D_ALLOC_PTR(array);
 	if (array == NULL)
 		return NULL;
 
+	rc = D_SPIN_INIT(&array->size_lock, PTHREAD_PROCESS_PRIVATE);
+	if (rc != 0) {
+		D_FREE(array);
+		return NULL;
+	}
+
 	daos_hhash_hlink_init(&array->hlink, &array_h_ops);
 	return array;
 }
 
+static void
+array_addref(struct dc_array *array)
+{
+	daos_hhash_link_getref(&array->hlink);
+}
+
 static void
 array_decref(struct dc_array *array)
 {
 	daos_hhash_link_putref(&array->hlink);
 }
 
+/**
+ * Size cache timeout in ms. Tests override it with the fail value of the DAOS_ARRAY_SIZE_CACHE_TMO
+ * fault, the environment is only read once at init.
+ */
+static inline unsigned int
+array_size_cache_tmo(void)
+{
+	if (DAOS_FAIL_CHECK(DAOS_ARRAY_SIZE_CACHE_TMO))
+		return daos_fail_value_get();
+	return array_size_cache_timeout;
+}
+
+/** Return the cached size (and max epoch if \a epoch is not NULL) if it is still fresh. */
+static bool
+array_size_cache_lookup(struct dc_array *array, daos_handle_t th, daos_size_t *size,
+			daos_epoch_t *epoch)
+{
+	unsigned int	tmo = array_size_cache_tmo();
+	bool		hit = false;
+
+	/** a transaction reads at its own epoch, don't mix it with the cache */
+	if (tmo == 0 || daos_handle_is_valid(th))
+		return false;
+
+	D_SPIN_LOCK(&array->size_lock);
+	if (array->size_cached && (epoch == NULL || array->size_epoch != 0) &&
+	    daos_getutime() - array->size_time < (uint64_t)tmo * 1000) {
+		*size = array->size;
+		if (epoch)
+			*epoch = array->size_epoch;
+		hit = true;
+	}
+	D_SPIN_UNLOCK(&array->size_lock);
+
+	return hit;
+}
+
+static uint64_t
+array_size_cache_gen(struct dc_array *array)
+{
+	uint64_t gen;
+
+	D_SPIN_LOCK(&array->size_lock);
+	gen = array->size_gen;
+	D_SPIN_UNLOCK(&array->size_lock);
+
+	return gen;
+}
+
+/** Cache a size fetched from the servers unless the array was modified locally meanwhile. */
+static void
+array_size_cache_store(struct dc_array *array, uint64_t gen, daos_size_t size, daos_epoch_t epoch)
+{
+	if (array_size_cache_tmo() == 0)
+		return;
+
+	D_SPIN_LOCK(&array->size_lock);
+	if (array->size_gen == gen) {
+		array->size		= size;
+		array->size_epoch	= epoch;
+		array->size_time	= daos_getutime();
+		array->size_cached	= true;
+	}
+	D_SPIN_UNLOCK(&array->size_lock);
+}
+
+/**
+ * Account for a local modification of the array. A completed write outside of a transaction can
+ * only grow the array, so \a extend keeps a cached size and raises it to \a size if needed.
+ * Otherwise the cached size is dropped. Either way, size queries in flight are not cached.
+ */
+static void
+array_size_cache_modify(struct dc_array *array, bool extend, daos_size_t size)
+{
+	if (array_size_cache_tmo() == 0)
+		return;
+
+	D_SPIN_LOCK(&array->size_lock);
+	array->size_gen++;
+	if (!extend) {
+		array->size_cached = false;
+	} else if (array->size_cached && size > array->size) {
+		array->size		= size;
+		array->size_epoch	= 0;
+	}
+	D_SPIN_UNLOCK(&array->size_lock);
+}
+
+/** The array was truncated/extended to \a size locally, which is authoritative for now. */
+static void
+array_size_cache_set(struct dc_array *array, daos_size_t size)
+{
+	if (array_size_cache_tmo() == 0)
+		return;
+
+	D_SPIN_LOCK(&array->size_lock);
+	array->size_gen++;
+	array->size		= size;
+	array->size_epoch	= 0;
+	array->size_time	= daos_getutime();
+	array->size_cached	= true;
+	D_SPIN_UNLOCK(&array->size_lock);
+}
+
 static daos_handle_t
 array_ptr2hdl(struct dc_array *array)
 {
@@ -180,6 +337,72 @@ free_io_params_cb(tse_task_t *task, void *data)
 	return task->dt_result;
 }
 
+/**
+ * Number of dkey I/Os of one array I/O in flight, tracked under the DAOS_ARRAY_IO_DEPTH_CHECK
+ * fault injection to verify that the I/O window bounds it.
+ */
+struct io_depth_check {
+	ATOMIC int	idc_inflight;
+	ATOMIC int	idc_max;
+	int		idc_depth;
+};
+
+static int
+io_depth_prep_cb(tse_task_t *task, void *data)
+{
+	struct io_depth_check	*idc = *((struct io_depth_check **)data);
+	int			 inflight;
+	int			 max;
+
+	inflight = atomic_fetch_add(&idc->idc_inflight, 1) + 1;
+	max = atomic_load(&idc->idc_max);
+	while (inflight > max && !atomic_compare_exchange(&idc->idc_max, max, inflight))
+		max = atomic_load(&idc->idc_max);
+	return 0;
+}
+
+static int
+io_depth_comp_cb(tse_task_t *task, void *data)
+{
+	struct io_depth_check *idc = *((struct io_depth_check **)data);
+
+	atomic_fetch_sub(&idc->idc_inflight, 1);
+	return task->dt_result;
+}
+
+static int
+io_depth_check_cb(tse_task_t *task, void *data)
+{
+	struct io_depth_check	*idc = *((struct io_depth_check **)data);
+	int			 rc = task->dt_result;
+
+	if (rc == 0 && idc->idc_max > idc->idc_depth) {
+		D_ERROR("%d dkey I/Os were in flight, more than the depth %d\n", idc->idc_max,
+			idc->idc_depth);
+		rc = -DER_MISMATCH;
+	}
+	D_FREE(idc);
+	return rc;
+}
+
+struct io_size_args {
+	struct dc_array	*array;
+	/** end of the highest range written, in records */
+	daos_size_t	 end;
+	/** whether a successful I/O can only grow the array */
+	bool		 extend;
+};
+
+static int
+io_size_cb(tse_task_t *task, void *data)
+{
+	struct io_size_args *args = data;
+
+	array_size_cache_modify(args->array, args->extend && task->dt_result == 0, args->end);
+	array_decref(args->array);
+	return task->dt_result;
+}
+
 static int
 create_handle_cb(tse_task_t *task, void *data)
 {
@@ -1429,6 +1652,10 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 	d_list_t	io_task_list;
 	daos_size_t	tot_num_records = 0;
 	tse_task_t	*stask; /* task for short read and hole mgmt */
+	tse_task_t	**io_window = NULL; /* ring of the last io_depth dkey tasks */
+	struct io_depth_check *depth_chk = NULL;
+	unsigned int	io_depth = array_io_depth;
+	daos_size_t	num_tasks = 0;
 	int		rc;
 
 	if (rg_iod == NULL) {
@@ -1465,6 +1692,25 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 	head = NULL;
 	D_INIT_LIST_HEAD(&io_task_list);
 
+	if (io_depth != 0) {
+		D_ALLOC_ARRAY(io_window, io_depth);
+		if (io_window == NULL)
+			D_GOTO(err_task, rc = -DER_NOMEM);
+	}
+
+	if (io_window != NULL && DAOS_FAIL_CHECK(DAOS_ARRAY_IO_DEPTH_CHECK)) {
+		D_ALLOC_PTR(depth_chk);
+		if (depth_chk == NULL)
+			D_GOTO(err_task, rc = -DER_NOMEM);
+		depth_chk->idc_depth = io_depth;
+		rc = tse_task_register_comp_cb(task, io_depth_check_cb, &depth_chk,
+					       sizeof(depth_chk));
+		if (rc) {
+			D_FREE(depth_chk);
+			D_GOTO(err_task, rc);
+		}
+	}
+
 	/*
 	 * for a read on a byte array, create a get_size task for short read
 	 * handling that will have a dependency on all the dkey IO tasks that
@@ -1747,6 +1993,35 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		} else {
 			D_ASSERTF(0, "Invalid array operation.\n");
 		}
+
+		/*
+		 * Bound the number of dkey I/Os in flight: this task waits for the one issued
+		 * io_depth dkeys before it. Errors are reported to the parent (or short read task)
+		 * directly, so don't propagate them along the chain.
+		 */
+		if (io_window != NULL) {
+			tse_task_t **slot = &io_window[num_tasks % io_depth];
+
+			if (depth_chk != NULL) {
+				rc = tse_task_register_cbs(io_task, io_depth_prep_cb, &depth_chk,
+							   sizeof(depth_chk), io_depth_comp_cb,
+							   &depth_chk, sizeof(depth_chk));
+				if (rc) {
+					tse_task_complete(io_task, rc);
+					D_GOTO(err_iotask, rc);
+				}
+			}
+			if (*slot != NULL) {
+				tse_disable_propagate(io_task);
+				rc = tse_task_register_deps(io_task, 1, slot);
+				if (rc) {
+					tse_task_complete(io_task, rc);
+					D_GOTO(err_iotask, rc);
+				}
+			}
+			*slot = io_task;
+		}
+		num_tasks++;
 		tse_task_list_add(io_task, &io_task_list);
 	} /* end while */
 
@@ -1755,6 +2030,29 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		D_GOTO(err_iotask, rc);
 	head_cb_registered = true;
 
+	/*
+	 * Keep the cached size in sync with local modifications. Writes in a transaction are not
+	 * visible until commit, and punches can shrink the array, so both drop the cached size.
+	 */
+	if (op_type != DAOS_OPC_ARRAY_READ && array_size_cache_tmo() != 0) {
+		struct io_size_args size_args = {0};
+
+		size_args.array = array;
+		size_args.extend = op_type == DAOS_OPC_ARRAY_WRITE && !daos_handle_is_valid(th);
+		for (u = 0; u < rg_iod->arr_nr; u++) {
+			daos_range_t *rg = &rg_iod->arr_rgs[u];
+
+			if (rg->rg_len != 0 && rg->rg_idx + rg->rg_len > size_args.end)
+				size_args.end = rg->rg_idx + rg->rg_len;
+		}
+
+		rc = tse_task_register_comp_cb(task, io_size_cb, &size_args, sizeof(size_args));
+		if (rc)
+			D_GOTO(err_iotask, rc);
+		array_addref(array);
+		array_size_cache_modify(array, size_args.extend, 0);
+	}
+
 	/*
 	 * If this is a byte array, schedule the get_size task with a prep callback that decides if
 	 * the get size is necessary for short read handling. The prep callback also handles the
@@ -1792,7 +2090,9 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		}
 	}
 
+	D_DEBUG(DB_IO, "array I/O with "DF_U64" dkey tasks, depth %u\n", num_tasks, io_depth);
 	tse_task_list_sched(&io_task_list, true);
+	D_FREE(io_window);
 	array_decref(array);
 	return 0;
 
@@ -1803,6 +2103,7 @@ err_iotask:
 	if (op_type == DAOS_OPC_ARRAY_READ && array->byte_array)
 		tse_task_complete(stask, rc);
 err_task:
+	D_FREE(io_window);
 	if (array)
 		array_decref(array);
 	tse_task_complete(task, rc);
@@ -1849,7 +2150,12 @@ struct key_query_props {
 	daos_recx_t		recx;
 	daos_size_t		*size;
 	daos_epoch_t		max_epoch;
+	daos_epoch_t		*max_epochp;
 	tse_task_t		*ptask;
+	/** size cache generation when the query was issued */
+	uint64_t		size_gen;
+	/** cache the result on the array handle */
+	bool			cache_size;
 };
 
 static int
@@ -1876,17 +2182,35 @@ get_array_size_cb(tse_task_t *task, void *data)
 	D_DEBUG(DB_IO, "Key Query: dkey %zu, IDX %"PRIu64", NR %"PRIu64"\n",
 		props->dkey_val, props->recx.rx_idx, props->recx.rx_nr);
 
-	if (props->dkey_val == 0) {
+	if (props->dkey_val == 0)
 		*props->size = 0;
-		return rc;
-	}
+	else
+		*props->size = props->array->chunk_size * (props->dkey_val - 1) +
+			props->recx.rx_idx + props->recx.rx_nr;
 
-	*props->size = props->array->chunk_size * (props->dkey_val - 1) +
-		props->recx.rx_idx + props->recx.rx_nr;
+	if (props->cache_size)
+		array_size_cache_store(props->array, props->size_gen, *props->size,
+				       *props->max_epochp);
 
 	return rc;
 }
 
+/** Serve a size query from the array handle if possible. */
+static bool
+array_size_query_cached(struct dc_array *array, daos_handle_t th, struct key_query_props *kqp,
+			bool with_epoch)
+{
+	if (array_size_cache_lookup(array, th, kqp->size, with_epoch ? kqp->max_epochp : NULL)) {
+		D_DEBUG(DB_IO, "array size "DF_U64" served from cache\n", *kqp->size);
+		return true;
+	}
+
+	kqp->cache_size = array_size_cache_tmo() != 0 && !daos_handle_is_valid(th);
+	if (kqp->cache_size)
+		kqp->size_gen = array_size_cache_gen(array);
+	return false;
+}
+
 int
 dc_array_get_size(tse_task_t *task)
 {
@@ -1917,8 +2241,16 @@ dc_array_get_size(tse_task_t *task)
 	d_iov_set(&kqp->dkey, &kqp->dkey_val, sizeof(uint64_t));
 	kqp->ptask	= task;
 	kqp->size	= args->size;
+	kqp->max_epochp	= &kqp->max_epoch;
 	kqp->array	= array;
 
+	if (array_size_query_cached(array, args->th, kqp, false)) {
+		array_decref(array);
+		D_FREE(kqp);
+		tse_task_complete(task, 0);
+		return 0;
+	}
+
 	rc = daos_task_create(DAOS_OPC_OBJ_QUERY_KEY, tse_task2sched(task), 0, NULL, &query_task);
 	if (rc != 0)
 		D_GOTO(err_task, rc);
@@ -1930,7 +2262,7 @@ dc_array_get_size(tse_task_t *task)
 	query_args->dkey	= &kqp->dkey;
 	query_args->akey	= &kqp->akey;
 	query_args->recx	= &kqp->recx;
-	query_args->max_epoch	= &kqp->max_epoch;
+	query_args->max_epoch	= kqp->max_epochp;
 
 	rc = tse_task_register_comp_cb(task, free_query_cb, &kqp, sizeof(kqp));
 	if (rc != 0)
@@ -1961,6 +2293,57 @@ err_task:
 	return rc;
 } /* end daos_array_get_size */
 
+int
+dc_array_get_size_multi(tse_task_t *task)
+{
+	daos_array_get_size_multi_t	*args = daos_task_get_args(task);
+	d_list_t			 task_list;
+	uint32_t			 i;
+	int				 rc = 0;
+
+	if (args->nr > DAOS_ARRAY_GET_SIZE_MULTI_MAX || (args->nr > 0 &&
+	    (args->ohs == NULL || args->sizes == NULL))) {
+		D_ERROR("Invalid batch of %u arrays\n", args->nr);
+		D_GOTO(err_task, rc = -DER_INVAL);
+	}
+
+	if (args->nr == 0)
+		D_GOTO(err_task, rc = 0);
+
+	/** one get_size subtask per array, the cached ones complete immediately */
+	D_INIT_LIST_HEAD(&task_list);
+	for (i = 0; i < args->nr; i++) {
+		daos_array_get_size_t	*size_args;
+		tse_task_t		*size_task;
+
+		rc = daos_task_create(DAOS_OPC_ARRAY_GET_SIZE, tse_task2sched(task), 0, NULL,
+				      &size_task);
+		if (rc)
+			D_GOTO(err_list, rc);
+
+		size_args	= daos_task_get_args(size_task);
+		size_args->oh	= args->ohs[i];
+		size_args->th	= args->th;
+		size_args->size	= &args->sizes[i];
+
+		rc = tse_task_register_deps(task, 1, &size_task);
+		if (rc) {
+			tse_task_complete(size_task, rc);
+			D_GOTO(err_list, rc);
+		}
+		tse_task_list_add(size_task, &task_list);
+	}
+
+	tse_task_list_sched(&task_list, true);
+	return 0;
+
+err_list:
+	tse_task_list_abort(&task_list, rc);
+err_task:
+	tse_task_complete(task, rc);
+	return rc;
+} /* end daos_array_get_size_multi */
+
 int
 dc_array_stat(tse_task_t *task)
 {
@@ -1992,8 +2375,16 @@ dc_array_stat(tse_task_t *task)
 	d_iov_set(&kqp->dkey, &kqp->dkey_val, sizeof(uint64_t));
 	kqp->ptask	= task;
 	kqp->size	= &args->stbuf->st_size;
+	kqp->max_epochp	= &args->stbuf->st_max_epoch;
 	kqp->array	= array;
 
+	if (array_size_query_cached(array, args->th, kqp, true)) {
+		array_decref(array);
+		D_FREE(kqp);
+		tse_task_complete(task, 0);
+		return 0;
+	}
+
 	rc = daos_task_create(DAOS_OPC_OBJ_QUERY_KEY, tse_task2sched(task), 0, NULL, &query_task);
 	if (rc != 0)
 		D_GOTO(err_task, rc);
@@ -2005,7 +2396,7 @@ dc_array_stat(tse_task_t *task)
 	query_args->dkey	= &kqp->dkey;
 	query_args->akey	= &kqp->akey;
 	query_args->recx	= &kqp->recx;
-	query_args->max_epoch	= &args->stbuf->st_max_epoch;
+	query_args->max_epoch	= kqp->max_epochp;
 
 	rc = tse_task_register_comp_cb(task, free_query_cb, &kqp, sizeof(kqp));
 	if (rc != 0)
@@ -2053,6 +2444,7 @@ struct set_size_props {
 	daos_size_t	chunk_size;
 	daos_off_t	record_i;
 	tse_task_t	*ptask;
+	bool		cache_size;
 };
 
 static int
@@ -2061,8 +2453,13 @@ free_set_size_cb(tse_task_t *task, void *data)
 	struct set_size_props *props = *((struct set_size_props **)data);
 
 	D_FREE(props->val);
-	if (props->array)
+	if (props->array) {
+		if (props->cache_size && task->dt_result == 0)
+			array_size_cache_set(props->array, props->size);
+		else
+			array_size_cache_modify(props->array, false, 0);
 		array_decref(props->array);
+	}
 	D_FREE(props);
 	return 0;
 }
@@ -2571,6 +2968,7 @@ dc_array_set_size(tse_task_t *task)
 	set_size_props->size = args->size;
 	set_size_props->ptask = task;
 	set_size_props->val = NULL;
+	set_size_props->cache_size = !daos_handle_is_valid(args->th);
 	if (args->size == 0)
 		set_size_props->update_dkey = false;
 	else
@@ -2598,6 +2996,7 @@ dc_array_set_size(tse_task_t *task)
 	if (rc)
 		D_GOTO(err_enum_task, rc);
 	cleanup = false;
+	array_size_cache_modify(array, false, 0);
 
 	rc = tse_task_register_comp_cb(enum_task, adjust_array_size_cb, &set_size_props,
 				       sizeof(set_size_props));
@@ -544,6 +544,179 @@ err_task:
 	return rc;
 }
 
+static int
+set_key_rc_cb(tse_task_t *task, void *data)
+{
+	int *rc = *((int **)data);
+
+	*rc = task->dt_result;
+	return 0;
+}
+
+/*
+ * Issue one update/fetch per key under a single parent task, with one allocation for the I/O
+ * parameters of all keys. This is a client-side fan-out only, each key is still its own object
+ * RPC: the object layer has no multi-dkey RPC outside of distributed transactions.
+ */
+static int
+kv_multi_io(tse_task_t *task, bool put)
+{
+	daos_kv_multi_t		*args = daos_task_get_args(task);
+	struct dc_kv		*kv = NULL;
+	struct io_params	*params = NULL;
+	d_list_t		 task_list;
+	bool			 free_params = true;
+	uint32_t		 i;
+	int			 rc;
+
+	D_INIT_LIST_HEAD(&task_list);
+
+	if (args->nr > DAOS_KV_MULTI_MAX || (args->nr > 0 &&
+	    (args->keys == NULL || args->sizes == NULL))) {
+		D_ERROR("Invalid batch of %u keys\n", args->nr);
+		D_GOTO(err_task, rc = -DER_INVAL);
+	}
+
+	if (args->nr == 0)
+		D_GOTO(err_task, rc = 0);
+
+	for (i = 0; i < args->nr; i++) {
+		if (args->keys[i] == NULL)
+			D_GOTO(err_task, rc = -DER_INVAL);
+		if (put && args->sizes[i] != 0 && (args->bufs == NULL || args->bufs[i] == NULL))
+			D_GOTO(err_task, rc = -DER_INVAL);
+	}
+
+	kv = kv_hdl2ptr(args->oh);
+	if (kv == NULL)
+		D_GOTO(err_task, rc = -DER_NO_HDL);
+
+	D_ALLOC_ARRAY(params, args->nr);
+	if (params == NULL)
+		D_GOTO(err_task, rc = -DER_NOMEM);
+
+	for (i = 0; i < args->nr; i++) {
+		struct io_params *p = &params[i];
+
+		d_iov_set(&p->dkey, (void *)args->keys[i], strlen(args->keys[i]));
+
+		p->akey_val = '0';
+		d_iov_set(&p->iod.iod_name, &p->akey_val, 1);
+		p->iod.iod_nr	= 1;
+		p->iod.iod_recxs	= NULL;
+		p->iod.iod_size	= args->sizes[i];
+		p->iod.iod_type	= DAOS_IOD_SINGLE;
+
+		if (args->bufs != NULL && args->bufs[i] != NULL && args->sizes[i] != 0) {
+			d_iov_set(&p->iov, args->bufs[i], args->sizes[i]);
+			p->sgl.sg_iovs	= &p->iov;
+			p->sgl.sg_nr	= 1;
+		}
+	}
+
+	rc = tse_task_register_comp_cb(task, free_io_params_cb, &params, sizeof(params));
+	if (rc != 0)
+		D_GOTO(err_task, rc);
+	free_params = false;
+
+	/** with per-key return codes, a failed key doesn't fail the whole batch */
+	if (args->rcs != NULL)
+		tse_disable_propagate(task);
+
+	for (i = 0; i < args->nr; i++) {
+		struct io_params	*p = &params[i];
+		tse_task_t		*io_task;
+
+		if (put) {
+			daos_obj_update_t *update_args;
+
+			rc = daos_task_create(DAOS_OPC_OBJ_UPDATE, tse_task2sched(task), 0, NULL,
+					      &io_task);
+			if (rc != 0)
+				D_GOTO(err_list, rc);
+
+			update_args		= daos_task_get_args(io_task);
+			update_args->oh		= kv->daos_oh;
+			update_args->th		= args->th;
+			update_args->flags	= args->flags;
+			update_args->dkey	= &p->dkey;
+			update_args->nr		= 1;
+			update_args->iods	= &p->iod;
+			update_args->sgls	= &p->sgl;
+		} else {
+			daos_obj_fetch_t	*fetch_args;
+			daos_size_t		*buf_size = &args->sizes[i];
+
+			rc = daos_task_create(DAOS_OPC_OBJ_FETCH, tse_task2sched(task), 0, NULL,
+					      &io_task);
+			if (rc != 0)
+				D_GOTO(err_list, rc);
+
+			fetch_args		= daos_task_get_args(io_task);
+			fetch_args->oh		= kv->daos_oh;
+			fetch_args->th		= args->th;
+			fetch_args->flags	= args->flags;
+			fetch_args->dkey	= &p->dkey;
+			fetch_args->nr		= 1;
+			fetch_args->iods	= &p->iod;
+			if (p->sgl.sg_nr != 0)
+				fetch_args->sgls = &p->sgl;
+
+			rc = tse_task_register_comp_cb(io_task, set_size_cb, &buf_size,
+						       sizeof(buf_size));
+			if (rc != 0) {
+				tse_task_complete(io_task, rc);
+				D_GOTO(err_list, rc);
+			}
+		}
+
+		if (args->rcs != NULL) {
+			int *key_rc = &args->rcs[i];
+
+			rc = tse_task_register_comp_cb(io_task, set_key_rc_cb, &key_rc,
+						       sizeof(key_rc));
+			if (rc != 0) {
+				tse_task_complete(io_task, rc);
+				D_GOTO(err_list, rc);
+			}
+		}
+
+		rc = tse_task_register_deps(task, 1, &io_task);
+		if (rc != 0) {
+			tse_task_complete(io_task, rc);
+			D_GOTO(err_list, rc);
+		}
+
+		tse_task_list_add(io_task, &task_list);
+	}
+
+	tse_task_list_sched(&task_list, true);
+	kv_decref(kv);
+	return 0;
+
+err_list:
+	tse_task_list_abort(&task_list, rc);
+err_task:
+	tse_task_complete(task, rc);
+	if (free_params)
+		D_FREE(params);
+	if (kv)
+		kv_decref(kv);
+	return rc;
+}
+
+int
+dc_kv_put_multi(tse_task_t *task)
+{
+	return kv_multi_io(task, true);
+}
+
+int
+dc_kv_get_multi(tse_task_t *task)
+{
+	return kv_multi_io(task, false);
+}
+
 int
 dc_kv_remove(tse_task_t *task)
 {
@@ -54,6 +54,7 @@ rsvc_client_init(struct rsvc_client *client, const d_rank_list_t *ranks)
 	}
 	rsvc_client_reset_leader(client);
 	client->sc_next = -1;
+	client->sc_follower_reads = false;
 	return 0;
 }
 
@@ -104,6 +105,32 @@ rsvc_client_choose(struct rsvc_client *client, crt_endpoint_t *ep)
 	return 0;
 }
 
+/**
+ * Choose an \a ep for a query-only RPC of \a client. If the service has
+ * advertised RSVC_HINT_READS, pick a random replica, so that the queries of
+ * many clients spread over all replicas; otherwise, same as
+ * rsvc_client_choose. Does not change \a ep->ep_group.
+ *
+ * \param[in,out]	client	client state
+ * \param[out]		ep	crt_endpoint_t for the RPC
+ */
+int
+rsvc_client_choose_read(struct rsvc_client *client, crt_endpoint_t *ep)
+{
+	int chosen;
+
+	/* Follow the leader search until a leader is known. */
+	if (!client->sc_follower_reads || !client->sc_leader_known ||
+	    client->sc_leader_aliveness == 0 || client->sc_ranks->rl_nr < 2)
+		return rsvc_client_choose(client, ep);
+
+	chosen = d_rand() % client->sc_ranks->rl_nr;
+	D_DEBUG(DB_MD, "read from %d: "DF_CLI"\n", chosen, DP_CLI(client));
+	ep->ep_rank = client->sc_ranks->rl_ranks[chosen];
+	ep->ep_tag = 0;
+	return 0;
+}
+
 static void
 rsvc_client_delete_rank_at(struct rsvc_client *client, int index)
 {
@@ -295,6 +322,7 @@ rsvc_client_complete_rpc(struct rsvc_client *client, const crt_endpoint_t *ep,
 		rsvc_client_process_error(client, rc_svc, ep);
 		rsvc_client_process_hint(client, hint, false /* !from_leader */,
 					 ep);
+		client->sc_follower_reads = hint->sh_flags & RSVC_HINT_READS;
 		return RSVC_CLIENT_RECHOOSE;
 	} else if (rc_svc == -DER_NOTREPLICA) {
 		/* This may happen when a service replica was destroyed. */
@@ -307,12 +335,21 @@ rsvc_client_complete_rpc(struct rsvc_client *client, const crt_endpoint_t *ep,
 		D_DEBUG(DB_MD, "\"leader\" reply without hint from rank %u: "
 			"rc_svc=%d\n", ep->ep_rank, rc_svc);
 		return RSVC_CLIENT_PROCEED;
+	} else if (hint->sh_flags & RSVC_HINT_FOLLOWER) {
+		D_DEBUG(DB_MD, "follower reply with hint from rank %u: hint.term="
+			DF_U64" hint.rank=%u rc_svc=%d\n", ep->ep_rank,
+			hint->sh_term, hint->sh_rank, rc_svc);
+		rsvc_client_process_hint(client, hint, false /* !from_leader */,
+					 ep);
+		client->sc_follower_reads = hint->sh_flags & RSVC_HINT_READS;
+		return RSVC_CLIENT_PROCEED;
 	} else {
 		D_DEBUG(DB_MD, "leader reply with hint from rank %u: hint.term="
 			DF_U64" hint.rank=%u rc_svc=%d\n", ep->ep_rank,
 			hint->sh_term, hint->sh_rank, rc_svc);
 		rsvc_client_process_hint(client, hint, true /* from_leader */,
 					 ep);
+		client->sc_follower_reads = hint->sh_flags & RSVC_HINT_READS;
 		return RSVC_CLIENT_PROCEED;
 	}
 }
@@ -439,5 +476,7 @@ rsvc_client_decode(void *buf, size_t len, struct rsvc_client *client)
 	client->sc_leader_term = p->scb_leader_term;
 	client->sc_leader_index = p->scb_leader_index;
 	client->sc_next = p->scb_next;
+	/* Not encoded; learned again from the next hint. */
+	client->sc_follower_reads = false;
 	return sizeof(*p) + sizeof(*p->scb_ranks) * p->scb_nranks;
 }
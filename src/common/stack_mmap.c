@@ -18,6 +18,8 @@
 #include <daos/stack_mmap.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 
 /* ABT_key for mmap()'ed ULT stacks */
 ABT_key stack_key;
@@ -47,6 +49,30 @@ ATOMIC int nb_free_stacks;
 /* mmap()'ed or Argobot's legacy/internal allocation method for ULT stacks ? */
 bool daos_ult_mmap_stack = true;
 
+/* max NUMA node index supported for stacks placement */
+#define STACK_NUMA_NODE_MAX	256
+
+/* Prefer the NUMA node of the stack pool for the pages of a newly mmap()'ed stack, before the
+ * descriptor at its bottom gets touched by the creating XStream.
+ */
+static void
+stack_numa_bind(void *stack, size_t stack_size, int numa_node)
+{
+	unsigned long	nodemask[STACK_NUMA_NODE_MAX / (8 * sizeof(unsigned long))] = {0};
+	long		rc;
+
+	if (numa_node < 0 || numa_node >= STACK_NUMA_NODE_MAX)
+		return;
+
+	nodemask[numa_node / (8 * sizeof(unsigned long))] |=
+		1UL << (numa_node % (8 * sizeof(unsigned long)));
+	rc = syscall(SYS_mbind, stack, stack_size, MPOL_PREFERRED, nodemask,
+		     STACK_NUMA_NODE_MAX + 1, 0);
+	if (rc != 0)
+		D_DEBUG(DB_MEM, "Failed to bind stack %p to NUMA node %d : %s\n",
+			stack, numa_node, strerror(errno));
+}
+
 /* one per supported ABT_thread_create[_...] API type */
 enum AbtThreadCreateType {
 	MAIN,
@@ -183,6 +209,8 @@ mmap_stack_thread_create_common(struct stack_pool *sp_alloc, void (*free_stack_c
 
 		atomic_fetch_add(&nb_mmap_stacks, 1);
 
+		stack_numa_bind(stack, stack_size, sp_alloc->sp_numa_node);
+
 		/* put descriptor at bottom of mmap()'ed stack */
 		mmap_stack_desc = (mmap_stack_desc_t *)(stack + stack_size -
 				  sizeof(mmap_stack_desc_t));
@@ -307,7 +335,7 @@ free_stack(void *arg)
 }
 
 int
-stack_pool_create(struct stack_pool **sp)
+stack_pool_create_numa(struct stack_pool **sp, int numa_node)
 {
 	D_ALLOC(*sp, sizeof(struct stack_pool));
 	if (*sp == NULL) {
@@ -315,11 +343,18 @@ stack_pool_create(struct stack_pool **sp)
 		return -DER_NOMEM;
 	}
 	(*sp)->sp_free_stacks = 0;
+	(*sp)->sp_numa_node = numa_node;
 	D_INIT_LIST_HEAD(&(*sp)->sp_stack_free_list);
-	D_DEBUG(DB_MEM, "pool %p has been allocated\n", *sp);
+	D_DEBUG(DB_MEM, "pool %p has been allocated, NUMA node %d\n", *sp, numa_node);
 	return 0;
 }
 
+int
+stack_pool_create(struct stack_pool **sp)
+{
+	return stack_pool_create_numa(sp, -1);
+}
+
 void stack_pool_destroy(struct stack_pool *sp)
 {
 	mmap_stack_desc_t *desc;
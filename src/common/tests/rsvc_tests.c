@@ -204,6 +204,58 @@ rsvc_test_subtract_above_next(void **state)
 	rsvc_client_fini(&client);
 }
 
+static void
+rsvc_test_follower_reads(void **state)
+{
+	struct rsvc_client client;
+	crt_endpoint_t     ep   = {.ep_grp = NULL, .ep_tag = 0};
+	struct rsvc_hint   hint = {.sh_flags = RSVC_HINT_VALID | RSVC_HINT_READS, .sh_term = 1};
+	bool               spread = false;
+	int                rc;
+	int                i;
+	RANK_LIST(ranks, 0, 1, 2, 3, 4);
+
+	/* Without RSVC_HINT_READS, queries go to the leader. */
+	prepare(&client, &ranks, 2 /* leader_index */);
+	assert_false(client.sc_follower_reads);
+	rc = rsvc_client_choose_read(&client, &ep);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(ep.ep_rank, 2);
+
+	/* The leader advertises follower reads. */
+	hint.sh_rank = 2;
+	rc = rsvc_client_complete_rpc(&client, &ep, 0 /* rc_crt */, 0 /* rc_svc */, &hint);
+	assert_rc_equal(rc, RSVC_CLIENT_PROCEED);
+	assert_true(client.sc_follower_reads);
+	for (i = 0; i < 100; i++) {
+		rc = rsvc_client_choose_read(&client, &ep);
+		assert_rc_equal(rc, 0);
+		if (ep.ep_rank != 2)
+			spread = true;
+	}
+	assert_true(spread);
+
+	/* A follower reply leaves the leader as it is. */
+	ep.ep_rank = 4;
+	hint.sh_flags |= RSVC_HINT_FOLLOWER;
+	rc = rsvc_client_complete_rpc(&client, &ep, 0 /* rc_crt */, 0 /* rc_svc */, &hint);
+	assert_rc_equal(rc, RSVC_CLIENT_PROCEED);
+	assert_true(client.sc_leader_known);
+	assert_int_equal(at(client.sc_ranks, client.sc_leader_index), 2);
+	assert_int_equal(client.sc_leader_aliveness, 1);
+
+	/* A replica without follower reads turns them off. */
+	hint.sh_flags = RSVC_HINT_VALID;
+	rc = rsvc_client_complete_rpc(&client, &ep, 0 /* rc_crt */, -DER_NOTLEADER, &hint);
+	assert_rc_equal(rc, RSVC_CLIENT_RECHOOSE);
+	assert_false(client.sc_follower_reads);
+	rc = rsvc_client_choose_read(&client, &ep);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(ep.ep_rank, 2);
+
+	rsvc_client_fini(&client);
+}
+
 int
 main(void)
 {
@@ -214,7 +266,8 @@ main(void)
 		cmocka_unit_test(rsvc_test_subtract_next),
 		cmocka_unit_test(rsvc_test_subtract_next_wrap),
 		cmocka_unit_test(rsvc_test_subtract_next_end_up_empty),
-		cmocka_unit_test(rsvc_test_subtract_above_next)
+		cmocka_unit_test(rsvc_test_subtract_above_next),
+		cmocka_unit_test(rsvc_test_follower_reads)
 	};
 	/* clang-format on */
 
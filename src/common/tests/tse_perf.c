@@ -0,0 +1,283 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Microbenchmark of the task scheduler engine: a number of threads share one scheduler, each
+ * builds task graphs on it and progresses it until its graphs complete. Two graph shapes are
+ * measured:
+ *  - wide: a parent task whose body creates and schedules N subtasks it depends on.
+ *  - deep: a chain of N tasks, each depending on the previous one.
+ *
+ * common/tests/tse_perf.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <daos/common.h>
+#include <daos/tse.h>
+#include "perf_common.h"
+
+enum perf_graph {
+	GRAPH_WIDE	= (1 << 0),
+	GRAPH_DEEP	= (1 << 1),
+};
+
+/** state of one thread, each one builds its graphs on the shared scheduler */
+struct perf_args {
+	tse_sched_t		*pa_sched;
+	uint32_t		 pa_tasks;
+	uint64_t		 pa_iters;
+	enum perf_graph		 pa_graph;
+	/** number of leaf tasks executed by this thread's graphs */
+	ATOMIC uint64_t		 pa_executed;
+	ATOMIC bool		 pa_done;
+	int			 pa_rc;
+};
+
+static uint32_t	perf_tasks = 1000;
+static int	perf_runq = -1;
+static int	perf_graphs = GRAPH_WIDE | GRAPH_DEEP;
+
+static int
+leaf_body(tse_task_t *task)
+{
+	struct perf_args *args = tse_task_get_priv(task);
+
+	atomic_fetch_add_relaxed(&args->pa_executed, 1);
+	tse_task_complete(task, 0);
+	return 0;
+}
+
+static int
+graph_done_cb(tse_task_t *task, void *data)
+{
+	struct perf_args *args = *((struct perf_args **)data);
+
+	if (task->dt_result != 0)
+		args->pa_rc = task->dt_result;
+	atomic_store_release(&args->pa_done, true);
+	return 0;
+}
+
+/** body of the parent of a wide graph: create all the subtasks and wait for them */
+static int
+wide_body(tse_task_t *task)
+{
+	struct perf_args	*args = tse_task_get_priv(task);
+	tse_task_t		*sub;
+	d_list_t		 task_list;
+	uint32_t		 i;
+	int			 rc;
+
+	D_INIT_LIST_HEAD(&task_list);
+	for (i = 0; i < args->pa_tasks; i++) {
+		rc = tse_task_create(leaf_body, tse_task2sched(task), args, &sub);
+		if (rc != 0)
+			D_GOTO(err, rc);
+
+		rc = tse_task_register_deps(task, 1, &sub);
+		if (rc != 0) {
+			tse_task_complete(sub, rc);
+			D_GOTO(err, rc);
+		}
+		tse_task_list_add(sub, &task_list);
+	}
+	tse_task_list_sched(&task_list, false);
+	return 0;
+
+err:
+	tse_task_list_abort(&task_list, rc);
+	tse_task_complete(task, rc);
+	return rc;
+}
+
+static int
+graph_wide(struct perf_args *args)
+{
+	tse_task_t	*task;
+	int		 rc;
+
+	rc = tse_task_create(wide_body, args->pa_sched, args, &task);
+	if (rc != 0)
+		return rc;
+
+	rc = tse_task_register_comp_cb(task, graph_done_cb, &args, sizeof(args));
+	if (rc != 0) {
+		tse_task_complete(task, rc);
+		return rc;
+	}
+
+	return tse_task_schedule(task, false);
+}
+
+static int
+graph_deep(struct perf_args *args)
+{
+	tse_task_t	*prev = NULL;
+	tse_task_t	*task;
+	d_list_t	 task_list;
+	uint32_t	 i;
+	int		 rc;
+
+	D_INIT_LIST_HEAD(&task_list);
+	for (i = 0; i < args->pa_tasks; i++) {
+		rc = tse_task_create(leaf_body, args->pa_sched, args, &task);
+		if (rc != 0)
+			D_GOTO(err, rc);
+
+		if (prev != NULL) {
+			rc = tse_task_register_deps(task, 1, &prev);
+			if (rc != 0) {
+				tse_task_complete(task, rc);
+				D_GOTO(err, rc);
+			}
+		}
+		tse_task_list_add(task, &task_list);
+		prev = task;
+	}
+
+	rc = tse_task_register_comp_cb(prev, graph_done_cb, &args, sizeof(args));
+	if (rc != 0)
+		D_GOTO(err, rc);
+
+	tse_task_list_sched(&task_list, false);
+	return 0;
+
+err:
+	tse_task_list_abort(&task_list, rc);
+	return rc;
+}
+
+static int
+perf_func(void *arg, int idx, int nr)
+{
+	struct perf_args	*args = (struct perf_args *)arg + idx;
+	uint64_t		 i;
+	int			 rc;
+
+	for (i = 0; i < args->pa_iters; i++) {
+		atomic_store_relaxed(&args->pa_done, false);
+		if (args->pa_graph == GRAPH_WIDE)
+			rc = graph_wide(args);
+		else
+			rc = graph_deep(args);
+		if (rc != 0)
+			return rc;
+
+		while (!atomic_load(&args->pa_done))
+			tse_sched_progress(args->pa_sched);
+		if (args->pa_rc != 0)
+			return args->pa_rc;
+	}
+	return 0;
+}
+
+static int
+perf_run_graph(enum perf_graph graph, int nr_threads, uint32_t nr_runq, uint64_t iters)
+{
+	struct perf_args	 args[PERF_MAX_THREADS] = {0};
+	tse_sched_t		 sched;
+	uint64_t		 executed = 0;
+	uint64_t		 ns;
+	int			 i;
+	int			 rc;
+
+	rc = tse_sched_init_runq(&sched, NULL, NULL, nr_runq);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < nr_threads; i++) {
+		args[i].pa_sched	= &sched;
+		args[i].pa_tasks	= perf_tasks;
+		args[i].pa_iters	= iters;
+		args[i].pa_graph	= graph;
+	}
+
+	rc = perf_threads_run(nr_threads, perf_func, args, &ns);
+	for (i = 0; i < nr_threads; i++)
+		executed += args[i].pa_executed;
+	tse_sched_complete(&sched, 0, false);
+
+	printf("%-6s threads %3d runq %3u tasks %6u: %10.0f tasks/s (%.1f ns/task)%s\n",
+	       graph == GRAPH_WIDE ? "wide" : "deep", nr_threads, nr_runq, perf_tasks,
+	       executed * 1e9 / (ns ?: 1), executed ? (double)ns / executed : 0.0,
+	       rc == 0 && executed == nr_threads * perf_tasks * iters ? "" : " FAILED");
+	if (rc == 0 && executed != nr_threads * perf_tasks * iters)
+		rc = -DER_MISC;
+	return rc;
+}
+
+static int
+perf_run(int nr_threads, uint64_t iters)
+{
+	int graph;
+	int rc = 0;
+
+	for (graph = GRAPH_WIDE; graph <= GRAPH_DEEP && rc == 0; graph <<= 1) {
+		if (!(perf_graphs & graph))
+			continue;
+
+		if (perf_runq < 0) {
+			rc = perf_run_graph(graph, nr_threads, 0, iters);
+			if (rc == 0)
+				rc = perf_run_graph(graph, nr_threads,
+						    min(nr_threads, TSE_SCHED_RUNQ_MAX), iters);
+		} else {
+			rc = perf_run_graph(graph, nr_threads, perf_runq, iters);
+		}
+	}
+	return rc;
+}
+
+static int
+perf_parse(int opt, const char *arg)
+{
+	switch (opt) {
+	case 'q':
+		perf_runq = atoi(arg);
+		return perf_runq > TSE_SCHED_RUNQ_MAX ? -DER_INVAL : 0;
+	case 's':
+		/** the wide graph parent depends on all its subtasks, the counter is 16 bits */
+		perf_tasks = atoi(arg);
+		return perf_tasks == 0 || perf_tasks >= UINT16_MAX ? -DER_INVAL : 0;
+	case 'g':
+		if (strcmp(arg, "wide") == 0)
+			perf_graphs = GRAPH_WIDE;
+		else if (strcmp(arg, "deep") == 0)
+			perf_graphs = GRAPH_DEEP;
+		else
+			return -DER_INVAL;
+		return 0;
+	default:
+		return -DER_INVAL;
+	}
+}
+
+static const struct perf_opt perf_opts[] = {
+	{"runq",	'q',	"NR",
+	 "Number of run queues, 0 for a single scheduler list.\n"
+	 "\t\t\t\t\tDefault: both 0 and the number of threads"},
+	{"tasks",	's',	"TASKS",	"Tasks per graph. Default: 1000"},
+	{"graph",	'g',	"GRAPH",	"Graph shape (wide, deep). Default: both"},
+	{NULL},
+};
+
+static const int perf_threads[] = {1, 2, 4, 8, 0};
+
+static const struct perf_tool perf_tool = {
+	.pt_opts	= perf_opts,
+	.pt_parse	= perf_parse,
+	.pt_loops_help	= "Graphs built by each thread",
+	.pt_loops	= 20,
+	.pt_threads	= perf_threads,
+	.pt_run		= perf_run,
+};
+
+int
+main(int argc, char *argv[])
+{
+	return perf_main(&perf_tool, argc, argv);
+}
@@ -24,6 +24,7 @@
 
 D_CASSERT(sizeof(struct tse_task) == TSE_TASK_SIZE);
 D_CASSERT(sizeof(struct tse_task_private) <= TSE_PRIV_SIZE);
+D_CASSERT(sizeof(struct tse_runq) == 64);
 
 struct tse_task_link {
 	d_list_t		 tl_link;
@@ -32,15 +33,55 @@ struct tse_task_link {
 
 static void tse_sched_priv_decref(struct tse_sched_private *dsp);
 
+/** sequence to assign a run queue to each thread */
+static ATOMIC uint32_t	tse_runq_seq;
+static __thread int	tse_runq_tid = -1;
+
+static void
+tse_runqs_free(struct tse_sched_private *dsp, uint32_t nr)
+{
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		D_SPIN_DESTROY(&dsp->dsp_runqs[i].rq_lock);
+	D_FREE(dsp->dsp_runqs);
+	dsp->dsp_runq_nr = 0;
+}
+
+static int
+tse_runqs_alloc(struct tse_sched_private *dsp, uint32_t nr)
+{
+	uint32_t i;
+	int	 rc;
+
+	D_ALLOC_ARRAY(dsp->dsp_runqs, nr);
+	if (dsp->dsp_runqs == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < nr; i++) {
+		rc = D_SPIN_INIT(&dsp->dsp_runqs[i].rq_lock, PTHREAD_PROCESS_PRIVATE);
+		if (rc != 0) {
+			tse_runqs_free(dsp, i);
+			return rc;
+		}
+		D_INIT_LIST_HEAD(&dsp->dsp_runqs[i].rq_list);
+	}
+	dsp->dsp_runq_nr = nr;
+	return 0;
+}
+
 int
-tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
-	       void *udata)
+tse_sched_init_runq(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb, void *udata,
+		    uint32_t nr_runq)
 {
 	struct tse_sched_private	*dsp = tse_sched2priv(sched);
 	int				 rc;
 
 	D_CASSERT(sizeof(sched->ds_private) >= sizeof(*dsp));
 
+	if (nr_runq > TSE_SCHED_RUNQ_MAX)
+		return -DER_INVAL;
+
 	memset(sched, 0, sizeof(*sched));
 
 	D_INIT_LIST_HEAD(&dsp->dsp_init_list);
@@ -56,6 +97,14 @@ tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
 	if (rc != 0)
 		return rc;
 
+	if (nr_runq != 0) {
+		rc = tse_runqs_alloc(dsp, nr_runq);
+		if (rc != 0) {
+			D_MUTEX_DESTROY(&dsp->dsp_lock);
+			return rc;
+		}
+	}
+
 	if (comp_cb != NULL) {
 		rc = tse_sched_register_comp_cb(sched, comp_cb, udata);
 		if (rc != 0)
@@ -68,6 +117,115 @@ tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
 	return 0;
 }
 
+int
+tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
+	       void *udata)
+{
+	unsigned int nr_runq = 0;
+
+	d_getenv_uint("DAOS_TSE_RUNQ_NR", &nr_runq);
+	if (nr_runq > TSE_SCHED_RUNQ_MAX)
+		nr_runq = TSE_SCHED_RUNQ_MAX;
+
+	return tse_sched_init_runq(sched, comp_cb, udata, nr_runq);
+}
+
+/* Index of the run queue of the calling thread */
+static inline uint32_t
+tse_runq_self(struct tse_sched_private *dsp)
+{
+	if (tse_runq_tid < 0)
+		tse_runq_tid = atomic_fetch_add_relaxed(&tse_runq_seq, 1) & INT32_MAX;
+
+	return tse_runq_tid % dsp->dsp_runq_nr;
+}
+
+/*
+ * Queue a ready task on the run queue of the calling thread. The caller holds either no lock
+ * or dsp_lock, the lock order is dsp_lock -> rq_lock.
+ */
+static void
+tse_runq_push(struct tse_sched_private *dsp, struct tse_task_private *dtp)
+{
+	uint32_t	 idx = tse_runq_self(dsp);
+	struct tse_runq	*rq = &dsp->dsp_runqs[idx];
+
+	D_ASSERT(d_list_empty(&dtp->dtp_list));
+	/* counted until the task is accounted as in-flight, see tse_task_exec() */
+	atomic_fetch_add(&dsp->dsp_runq_tasks, 1);
+
+	D_SPIN_LOCK(&rq->rq_lock);
+	dtp->dtp_runq = idx + 1;
+	d_list_add_tail(&dtp->dtp_list, &rq->rq_list);
+	atomic_fetch_add_relaxed(&rq->rq_nr, 1);
+	D_SPIN_UNLOCK(&rq->rq_lock);
+}
+
+/*
+ * Dequeue a task from run queue \a idx, from the head if it is the queue of the calling thread
+ * and from the tail if the task is stolen from another thread.
+ */
+static struct tse_task_private *
+tse_runq_pop(struct tse_sched_private *dsp, uint32_t idx, bool steal)
+{
+	struct tse_runq		*rq = &dsp->dsp_runqs[idx];
+	struct tse_task_private	*dtp = NULL;
+
+	if (atomic_load_relaxed(&rq->rq_nr) == 0)
+		return NULL;
+
+	D_SPIN_LOCK(&rq->rq_lock);
+	if (!d_list_empty(&rq->rq_list)) {
+		if (steal)
+			dtp = d_list_entry(rq->rq_list.prev, struct tse_task_private, dtp_list);
+		else
+			dtp = d_list_entry(rq->rq_list.next, struct tse_task_private, dtp_list);
+		d_list_del_init(&dtp->dtp_list);
+		dtp->dtp_runq = 0;
+		atomic_fetch_sub_relaxed(&rq->rq_nr, 1);
+	}
+	D_SPIN_UNLOCK(&rq->rq_lock);
+
+	return dtp;
+}
+
+/* Remove a task that is completed before running from its run queue, called with dsp_lock */
+static bool
+tse_runq_remove_locked(struct tse_sched_private *dsp, struct tse_task_private *dtp)
+{
+	struct tse_runq	*rq;
+	bool		 removed = false;
+
+	if (dtp->dtp_runq == 0)
+		return false;
+
+	rq = &dsp->dsp_runqs[dtp->dtp_runq - 1];
+	D_SPIN_LOCK(&rq->rq_lock);
+	if (dtp->dtp_runq != 0) {
+		d_list_del_init(&dtp->dtp_list);
+		dtp->dtp_runq = 0;
+		atomic_fetch_sub_relaxed(&rq->rq_nr, 1);
+		removed = true;
+	}
+	D_SPIN_UNLOCK(&rq->rq_lock);
+
+	return removed;
+}
+
+/*
+ * Queue a task that is ready to run, called with dsp_lock. With run queues it goes to the queue
+ * of the calling thread, otherwise to the init list, where it is also parked while it still
+ * has dependencies.
+ */
+static void
+tse_task_ready_locked(struct tse_sched_private *dsp, struct tse_task_private *dtp)
+{
+	if (dsp->dsp_runqs != NULL && atomic_load(&dtp->dtp_dep_cnt) == 0)
+		tse_runq_push(dsp, dtp);
+	else
+		d_list_add_tail(&dtp->dtp_list, &dsp->dsp_init_list);
+}
+
 static inline uint32_t
 tse_task_buf_size(int size)
 {
@@ -207,44 +365,41 @@ tse_task2sched(tse_task_t *task)
 }
 
 static void
-tse_task_addref_locked(struct tse_task_private *dtp)
+tse_task_priv_addref(struct tse_task_private *dtp)
 {
-	D_ASSERT(dtp->dtp_refcnt < UINT16_MAX);
-	dtp->dtp_refcnt++;
+	uint16_t old;
+
+	old = atomic_fetch_add(&dtp->dtp_refcnt, 1);
+	D_ASSERT(old < UINT16_MAX);
 }
 
 static bool
-tse_task_decref_locked(struct tse_task_private *dtp)
+tse_task_priv_decref(struct tse_task_private *dtp)
 {
-	D_ASSERT(dtp->dtp_refcnt > 0);
-	dtp->dtp_refcnt--;
-	return dtp->dtp_refcnt == 0;
+	uint16_t old;
+
+	old = atomic_fetch_sub(&dtp->dtp_refcnt, 1);
+	D_ASSERT(old > 0);
+	return old == 1;
 }
 
 void
 tse_task_addref(tse_task_t *task)
 {
 	struct tse_task_private  *dtp = tse_task2priv(task);
-	struct tse_sched_private *dsp = dtp->dtp_sched;
 
-	D_ASSERT(dsp != NULL);
-
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-	tse_task_addref_locked(dtp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	D_ASSERT(dtp->dtp_sched != NULL);
+	tse_task_priv_addref(dtp);
 }
 
 void
 tse_task_decref(tse_task_t *task)
 {
 	struct tse_task_private  *dtp = tse_task2priv(task);
-	struct tse_sched_private *dsp = dtp->dtp_sched;
 	bool			   zombie;
 
-	D_ASSERT(dsp != NULL);
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-	zombie = tse_task_decref_locked(dtp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	D_ASSERT(dtp->dtp_sched != NULL);
+	zombie = tse_task_priv_decref(dtp);
 	if (!zombie)
 		return;
 
@@ -259,7 +414,7 @@ tse_task_decref_free_locked(tse_task_t *task)
 	struct tse_task_private *dtp = tse_task2priv(task);
 	bool			zombie;
 
-	zombie = tse_task_decref_locked(dtp);
+	zombie = tse_task_priv_decref(dtp);
 	if (!zombie)
 		return;
 
@@ -278,40 +433,34 @@ tse_sched_fini(tse_sched_t *sched)
 	D_ASSERT(d_list_empty(&dsp->dsp_running_list));
 	D_ASSERT(d_list_empty(&dsp->dsp_complete_list));
 	D_ASSERT(d_list_empty(&dsp->dsp_sleeping_list));
+	D_ASSERT(atomic_load(&dsp->dsp_runq_tasks) == 0);
+	if (dsp->dsp_runqs != NULL)
+		tse_runqs_free(dsp, dsp->dsp_runq_nr);
 	D_MUTEX_DESTROY(&dsp->dsp_lock);
 }
 
 static inline void
-tse_sched_priv_addref_locked(struct tse_sched_private *dsp)
+tse_sched_priv_addref(struct tse_sched_private *dsp)
 {
-	dsp->dsp_refcount++;
+	atomic_fetch_add(&dsp->dsp_refcount, 1);
 }
 
 static void
 tse_sched_priv_decref(struct tse_sched_private *dsp)
 {
-	bool	finalize;
-
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-
-	D_ASSERT(dsp->dsp_refcount > 0);
-	dsp->dsp_refcount--;
-	finalize = dsp->dsp_refcount == 0;
+	int	old;
 
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	old = atomic_fetch_sub(&dsp->dsp_refcount, 1);
+	D_ASSERT(old > 0);
 
-	if (finalize)
+	if (old == 1)
 		tse_sched_fini(tse_priv2sched(dsp));
 }
 
 void
 tse_sched_addref(tse_sched_t *sched)
 {
-	struct tse_sched_private *dsp = tse_sched2priv(sched);
-
-	D_MUTEX_LOCK(&dsp->dsp_lock);
-	tse_sched_priv_addref_locked(dsp);
-	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+	tse_sched_priv_addref(tse_sched2priv(sched));
 }
 
 void
@@ -373,8 +522,10 @@ tse_task_complete_locked(struct tse_task_private *dtp,
 	 * before adding it to tail of completed list.
 	 */
 	if (!dtp->dtp_running) {
-		tse_sched_priv_addref_locked(dsp);
+		tse_sched_priv_addref(dsp);
 		dsp->dsp_inflight++;
+		if (tse_runq_remove_locked(dsp, dtp))
+			atomic_fetch_sub(&dsp->dsp_runq_tasks, 1);
 	}
 
 	dtp->dtp_running = 0;
@@ -529,11 +680,93 @@ tse_task_complete_callback(tse_task_t *task)
 	return true;
 }
 
+/*
+ * Run the prep callbacks and the body function of a ready task. A task taken from a run queue
+ * is not accounted as in-flight yet, the task goes back to the init list if a dependency was
+ * added after it had been scheduled.
+ */
+static bool
+tse_task_exec(struct tse_sched_private *dsp, struct tse_task_private *dtp, bool from_runq)
+{
+	tse_task_t	*task = tse_priv2task(dtp);
+	bool		 bumped = false;
+
+	D_MUTEX_LOCK(&dsp->dsp_lock);
+	if (from_runq) {
+		atomic_fetch_sub(&dsp->dsp_runq_tasks, 1);
+		if (atomic_load(&dtp->dtp_dep_cnt) != 0 && !dsp->dsp_cancelling) {
+			d_list_add_tail(&dtp->dtp_list, &dsp->dsp_init_list);
+			D_MUTEX_UNLOCK(&dsp->dsp_lock);
+			return false;
+		}
+		dsp->dsp_inflight++;
+	}
+
+	if (dsp->dsp_cancelling) {
+		tse_task_complete_locked(dtp, dsp);
+	} else {
+		dtp->dtp_running = 1;
+		d_list_move_tail(&dtp->dtp_list,
+				 &dsp->dsp_running_list);
+		/** +1 in case prep cb calls task_complete() */
+		tse_task_priv_addref(dtp);
+		bumped = true;
+	}
+	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+
+	if (!dsp->dsp_cancelling) {
+		/** if task is reinitialized in prep cb, skip over it */
+		if (!tse_task_prep_callback(task)) {
+			tse_task_decref(task);
+			return false;
+		}
+		D_ASSERT(dtp->dtp_func != NULL);
+		if (!atomic_load(&dtp->dtp_completed))
+			dtp->dtp_func(task);
+	}
+	if (bumped)
+		tse_task_decref(task);
+
+	return true;
+}
+
+/*
+ * Run the tasks queued on the run queues, starting with the queue of the calling thread and
+ * stealing from the other ones once it is empty. The number of tasks processed in one call is
+ * bounded by the number of tasks queued when it started.
+ */
+static int
+tse_sched_process_runq(struct tse_sched_private *dsp)
+{
+	uint32_t	self = tse_runq_self(dsp);
+	uint32_t	budget = atomic_load(&dsp->dsp_runq_tasks);
+	int		processed = 0;
+
+	while (budget-- > 0) {
+		struct tse_task_private	*dtp;
+		uint32_t		 i;
+
+		dtp = tse_runq_pop(dsp, self, false);
+		for (i = 1; dtp == NULL && i < dsp->dsp_runq_nr; i++)
+			dtp = tse_runq_pop(dsp, (self + i) % dsp->dsp_runq_nr, true);
+		if (dtp == NULL)
+			break;
+
+		if (tse_task_exec(dsp, dtp, true))
+			processed++;
+	}
+	return processed;
+}
+
 /*
  * Process the init and sleeping lists of the scheduler. This first moves all
  * tasks who shall wake up now from the sleeping list to the tail of the init
  * list, and then executes all the body functions of all tasks with no
  * dependencies in the scheduler's init list.
+ *
+ * With run queues, the init list only holds tasks waiting for dependencies
+ * (they are moved to a run queue by tse_task_post_process()), so it is only
+ * scanned when cancelling, and woken up tasks go to a run queue directly.
  */
 static int
 tse_sched_process_init(struct tse_sched_private *dsp)
@@ -541,62 +774,43 @@ tse_sched_process_init(struct tse_sched_private *dsp)
 	struct tse_task_private		*dtp;
 	struct tse_task_private		*tmp;
 	d_list_t			list;
-	uint64_t			now = daos_getutime();
+	uint64_t			now;
 	int				processed = 0;
 
 	D_INIT_LIST_HEAD(&list);
+	/** unlocked peek, the lists are checked again under the lock */
+	if (dsp->dsp_runqs != NULL && d_list_empty(&dsp->dsp_sleeping_list) &&
+	    (d_list_empty(&dsp->dsp_init_list) || !dsp->dsp_cancelling))
+		return tse_sched_process_runq(dsp);
+
+	now = daos_getutime();
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_sleeping_list,
 				   dtp_list) {
 		if (dtp->dtp_wakeup_time > now)
 			break;
 		dtp->dtp_wakeup_time = 0;
-		d_list_move_tail(&dtp->dtp_list, &dsp->dsp_init_list);
+		d_list_del_init(&dtp->dtp_list);
+		tse_task_ready_locked(dsp, dtp);
 	}
-	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_init_list, dtp_list) {
-		if (dtp->dtp_dep_cnt == 0 || dsp->dsp_cancelling) {
-			d_list_move_tail(&dtp->dtp_list, &list);
-			dsp->dsp_inflight++;
+	if (dsp->dsp_runqs == NULL || dsp->dsp_cancelling) {
+		d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_init_list, dtp_list) {
+			if (dtp->dtp_dep_cnt == 0 || dsp->dsp_cancelling) {
+				d_list_move_tail(&dtp->dtp_list, &list);
+				dsp->dsp_inflight++;
+			}
 		}
 	}
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
-	while (!d_list_empty(&list)) {
-		tse_task_t *task;
-		bool bumped = false;
+	if (dsp->dsp_runqs != NULL)
+		processed = tse_sched_process_runq(dsp);
 
+	while (!d_list_empty(&list)) {
 		dtp = d_list_entry(list.next, struct tse_task_private,
 				   dtp_list);
-
-		task = tse_priv2task(dtp);
-
-		D_MUTEX_LOCK(&dsp->dsp_lock);
-		if (dsp->dsp_cancelling) {
-			tse_task_complete_locked(dtp, dsp);
-		} else {
-			dtp->dtp_running = 1;
-			d_list_move_tail(&dtp->dtp_list,
-					 &dsp->dsp_running_list);
-			/** +1 in case prep cb calls task_complete() */
-			tse_task_addref_locked(dtp);
-			bumped = true;
-		}
-		D_MUTEX_UNLOCK(&dsp->dsp_lock);
-
-		if (!dsp->dsp_cancelling) {
-			/** if task is reinitialized in prep cb, skip over it */
-			if (!tse_task_prep_callback(task)) {
-				tse_task_decref(task);
-				continue;
-			}
-			D_ASSERT(dtp->dtp_func != NULL);
-			if (!atomic_load(&dtp->dtp_completed))
-				dtp->dtp_func(task);
-		}
-		if (bumped)
-			tse_task_decref(task);
-
-		processed++;
+		if (tse_task_exec(dsp, dtp, false))
+			processed++;
 	}
 	return processed;
 }
@@ -625,6 +839,7 @@ tse_task_post_process(tse_task_t *task)
 		tse_task_t			*task_tmp;
 		struct tse_task_private		*dtp_tmp;
 		struct tse_sched_private	*dsp_tmp;
+		uint16_t			 dep_cnt;
 		bool				 diff_sched;
 
 		tlink = d_list_entry(dtp->dtp_dep_list.next,
@@ -646,12 +861,29 @@ tse_task_post_process(tse_task_t *task)
 			D_MUTEX_LOCK(&dsp_tmp->dsp_lock);
 		}
 		/* see if the dependent task is ready to be scheduled */
-		D_ASSERT(dtp_tmp->dtp_dep_cnt > 0);
-		dtp_tmp->dtp_dep_cnt--;
-		D_DEBUG(DB_TRACE, "daos task %p dep_cnt %d\n", dtp_tmp,
-			dtp_tmp->dtp_dep_cnt);
-		if (!dsp_tmp->dsp_cancelling && dtp_tmp->dtp_dep_cnt == 0 &&
-		    dtp_tmp->dtp_running) {
+		dep_cnt = atomic_fetch_sub(&dtp_tmp->dtp_dep_cnt, 1);
+		D_ASSERT(dep_cnt > 0);
+		dep_cnt--;
+		D_DEBUG(DB_TRACE, "daos task %p dep_cnt %d\n", dtp_tmp, dep_cnt);
+		if (!dsp_tmp->dsp_cancelling && dep_cnt == 0 && dsp_tmp->dsp_runqs != NULL &&
+		    !dtp_tmp->dtp_running && !dtp_tmp->dtp_completed &&
+		    dtp_tmp->dtp_wakeup_time == 0) {
+			if (dtp_tmp->dtp_runq != 0) {
+				/*
+				 * Already on a run queue, only the owner of the queue lock may
+				 * unlink it. If it was not popped meanwhile, requeue it here.
+				 */
+				if (tse_runq_remove_locked(dsp_tmp, dtp_tmp)) {
+					atomic_fetch_sub(&dsp_tmp->dsp_runq_tasks, 1);
+					tse_runq_push(dsp_tmp, dtp_tmp);
+				}
+			} else if (!d_list_empty(&dtp_tmp->dtp_list)) {
+				/* parked on the init list, it's ready to run now */
+				d_list_del_init(&dtp_tmp->dtp_list);
+				tse_runq_push(dsp_tmp, dtp_tmp);
+			}
+		} else if (!dsp_tmp->dsp_cancelling && dep_cnt == 0 &&
+			   dtp_tmp->dtp_running) {
 			bool done;
 
 			/*
@@ -733,6 +965,7 @@ tse_sched_check_complete(tse_sched_t *sched)
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	completed = (d_list_empty(&dsp->dsp_init_list) &&
 		     d_list_empty(&dsp->dsp_sleeping_list) &&
+		     atomic_load(&dsp->dsp_runq_tasks) == 0 &&
 		     dsp->dsp_inflight == 0);
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
@@ -774,7 +1007,7 @@ tse_sched_progress(tse_sched_t *sched)
 
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	/** +1 for tse_sched_run() */
-	tse_sched_priv_addref_locked(dsp);
+	tse_sched_priv_addref(dsp);
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
 	if (!dsp->dsp_cancelling)
@@ -826,7 +1059,7 @@ tse_sched_complete(tse_sched_t *sched, int ret, bool cancel)
 	/** Wait for all in-flight tasks */
 	while (1) {
 		/** +1 for tse_sched_run */
-		tse_sched_priv_addref_locked(dsp);
+		tse_sched_priv_addref(dsp);
 		D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
 		tse_sched_run(sched);
@@ -884,6 +1117,7 @@ tse_task_add_dependent(tse_task_t *task, tse_task_t *dep)
 	struct tse_task_private	*dtp = tse_task2priv(task);
 	struct tse_task_private	*dep_dtp = tse_task2priv(dep);
 	struct tse_task_link	*tlink;
+	uint16_t		 dep_cnt;
 	bool			 diff_sched;
 
 	D_ASSERT(task != dep);
@@ -907,10 +1141,10 @@ tse_task_add_dependent(tse_task_t *task, tse_task_t *dep)
 	D_DEBUG(DB_TRACE, "Add dependent %p ---> %p\n", dep, task);
 
 	D_MUTEX_LOCK(&dtp->dtp_sched->dsp_lock);
-	D_ASSERT(dtp->dtp_dep_cnt < UINT16_MAX);
-	tse_task_addref_locked(dtp);
+	tse_task_priv_addref(dtp);
 	tlink->tl_task = task;
-	dtp->dtp_dep_cnt++;
+	dep_cnt = atomic_fetch_add(&dtp->dtp_dep_cnt, 1);
+	D_ASSERT(dep_cnt < UINT16_MAX);
 	dtp_generation_inc(dtp);
 	if (!diff_sched)
 		d_list_add_tail(&tlink->tl_link, &dep_dtp->dtp_dep_list);
@@ -1015,6 +1249,16 @@ tse_task_schedule_with_delay(tse_task_t *task, bool instant, uint64_t delay)
 
 	D_ASSERT(!instant || (dtp->dtp_func && delay == 0));
 
+	/** ready task with run queues, it can be queued without taking the scheduler lock */
+	if (dsp->dsp_runqs != NULL && !instant && delay == 0 && dtp->dtp_func != NULL &&
+	    atomic_load(&dtp->dtp_dep_cnt) == 0) {
+		/* decref when remove the task from dsp (tse_sched_process_complete) */
+		tse_sched_priv_addref(dsp);
+		dtp->dtp_wakeup_time = 0;
+		tse_runq_push(dsp, dtp);
+		return 0;
+	}
+
 	/* Add task to scheduler */
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	ready = (dtp->dtp_dep_cnt == 0 && d_list_empty(&dtp->dtp_prep_cb_list));
@@ -1027,18 +1271,18 @@ tse_task_schedule_with_delay(tse_task_t *task, bool instant, uint64_t delay)
 
 		/** +1 in case task is completed in body function */
 		if (instant)
-			tse_task_addref_locked(dtp);
+			tse_task_priv_addref(dtp);
 	} else if (delay == 0) {
-		/** Otherwise, scheduler will process it from init list */
+		/** Otherwise, scheduler will process it from init list or a run queue */
 		dtp->dtp_wakeup_time = 0;
-		d_list_add_tail(&dtp->dtp_list, &dsp->dsp_init_list);
+		tse_task_ready_locked(dsp, dtp);
 	} else {
 		/* A delay is requested; insert into the sleeping list. */
 		dtp->dtp_wakeup_time = daos_getutime() + delay;
 		tse_task_insert_sleeping(dtp, dsp);
 	}
 	/* decref when remove the task from dsp (tse_sched_process_complete) */
-	tse_sched_priv_addref_locked(dsp);
+	tse_sched_priv_addref(dsp);
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
 	/** if caller wants to run the task instantly, call the task body function now. */
@@ -1081,9 +1325,9 @@ tse_task_reinit_with_delay(tse_task_t *task, uint64_t delay)
 	if (dtp->dtp_completed) {
 		D_ASSERT(d_list_empty(&dtp->dtp_list));
 		/* +1 ref for valid until complete */
-		tse_task_addref_locked(dtp);
+		tse_task_priv_addref(dtp);
 		/* +1 dsp ref as will add back to dsp again below */
-		tse_sched_priv_addref_locked(dsp);
+		tse_sched_priv_addref(dsp);
 	} else if (dtp->dtp_running) {
 		/** Task not in-flight anymore */
 		dsp->dsp_inflight--;
@@ -1108,10 +1352,11 @@ tse_task_reinit_with_delay(tse_task_t *task, uint64_t delay)
 
 	task->dt_result = 0;
 
-	/** Move back to init list */
+	/** Move back to init list or a run queue */
 	if (delay == 0) {
 		dtp->dtp_wakeup_time = 0;
-		d_list_move_tail(&dtp->dtp_list, &dsp->dsp_init_list);
+		d_list_del_init(&dtp->dtp_list);
+		tse_task_ready_locked(dsp, dtp);
 	} else {
 		dtp->dtp_wakeup_time = daos_getutime() + delay;
 		d_list_del_init(&dtp->dtp_list);
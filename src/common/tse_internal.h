@@ -49,11 +49,12 @@ struct tse_task_private {
 	ATOMIC uint8_t			dtp_running;
 	/* Don't propagate err-code from dependent tasks */
 	uint8_t				dtp_no_propagate;
-	uint8_t				dtp_pad;
+	/* run queue index + 1 the task is queued on, 0 if none */
+	uint8_t				dtp_runq;
 	/* number of dependent tasks */
-	uint16_t			 dtp_dep_cnt;
+	ATOMIC uint16_t			 dtp_dep_cnt;
 	/* refcount of the task */
-	uint16_t			 dtp_refcnt;
+	ATOMIC uint16_t			 dtp_refcnt;
 	/**
 	 * task parameter pointer, it can be assigned while creating task,
 	 * or explicitly call API tse_task_priv_set. User can just use
@@ -88,6 +89,19 @@ struct tse_task_cb {
 	char			dtc_arg[0];
 };
 
+/**
+ * Per-thread queue of ready tasks, used when the scheduler is initialized with run queues. A
+ * thread pushes the tasks it schedules to its own queue and runs them in FIFO order, idle
+ * threads steal from the tail of the other queues.
+ */
+struct tse_runq {
+	pthread_spinlock_t	rq_lock;
+	ATOMIC uint32_t		rq_nr;
+	d_list_t		rq_list;
+	/* keep each queue in its own cache line */
+	char			rq_pad[40];
+};
+
 struct tse_sched_private {
 	/* lock to protect schedule status and sub task list */
 	pthread_mutex_t dsp_lock;
@@ -114,11 +128,17 @@ struct tse_sched_private {
 	/* the list for complete callback */
 	d_list_t	dsp_comp_cb_list;
 
-	int		dsp_refcount;
+	ATOMIC int	dsp_refcount;
 
 	/* number of tasks being executed */
 	int		dsp_inflight;
 
+	/* per-thread run queues, NULL if all ready tasks go through dsp_init_list */
+	struct tse_runq	*dsp_runqs;
+	uint32_t	dsp_runq_nr;
+	/* number of tasks queued on the run queues */
+	ATOMIC uint32_t	dsp_runq_tasks;
+
 	uint32_t	dsp_cancelling:1,
 			dsp_completing:1;
 };
@@ -662,11 +662,12 @@ cont_child_alloc_ref(void *co_uuid, unsigned int ksize, void *po_uuid,
 	cont->sc_aggregation_max = 0;
 	cont->sc_snapshots_nr = 0;
 	cont->sc_snapshots = NULL;
-	cont->sc_dtx_cos_hdl = DAOS_HDL_INVAL;
+	cont->sc_dtx_cos_tab = NULL;
 	D_INIT_LIST_HEAD(&cont->sc_link);
 	D_INIT_LIST_HEAD(&cont->sc_open_hdls);
 	cont->sc_dtx_committable_count = 0;
 	cont->sc_dtx_committable_coll_count = 0;
+	cont->sc_dtx_cmt_thd = DTX_THRESHOLD_COUNT;
 	D_INIT_LIST_HEAD(&cont->sc_dtx_cos_list);
 	D_INIT_LIST_HEAD(&cont->sc_dtx_coll_list);
 	D_INIT_LIST_HEAD(&cont->sc_dtx_batched_list);
@@ -20,10 +20,11 @@ func run_self_test(sizes *C.struct_st_size_params, numSizes C.int, repCount C.in
 	optMsEndpoints *C.struct_st_endpoint, numOptMsEndpoints C.uint32_t,
 	tgtEndpoints *C.struct_st_endpoint, numTgtEndpoints C.uint32_t,
 	msEndpoints **C.struct_st_master_endpt, numMsEndpoints *C.uint32_t,
-	sizeLatencies ****C.struct_st_latency, bufAlignment C.int16_t) C.int {
+	sizeLatencies ****C.struct_st_latency, bufAlignment C.int16_t,
+	sizeDurations **C.int64_t) C.int {
 	return C.run_self_test(sizes, numSizes, repCount, maxInflight, groupName,
 		optMsEndpoints, numOptMsEndpoints, tgtEndpoints, numTgtEndpoints,
-		msEndpoints, numMsEndpoints, sizeLatencies, bufAlignment, nil, true, true)
+		msEndpoints, numMsEndpoints, sizeLatencies, bufAlignment, nil, true, true, sizeDurations)
 }
 
 func self_test_fini(agent_used C.bool) {
@@ -9,6 +9,7 @@
 package api
 
 import (
+	"time"
 	"unsafe"
 
 	"github.com/daos-stack/daos/src/control/lib/daos"
@@ -70,7 +71,8 @@ func run_self_test(sizes *C.struct_st_size_params, numSizes C.int, repCount C.in
 	optMsEndpoints *C.struct_st_endpoint, numOptMsEndpoints C.uint32_t,
 	tgtEndpoints *C.struct_st_endpoint, numTgtEndpoints C.uint32_t,
 	msEndpoints **C.struct_st_master_endpt, numMsEndpoints *C.uint32_t,
-	sizeLatencies ****C.struct_st_latency, bufAlignment C.int16_t) C.int {
+	sizeLatencies ****C.struct_st_latency, bufAlignment C.int16_t,
+	sizeDurations **C.int64_t) C.int {
 
 	cfg := &daos.SelfTestConfig{
 		GroupName:       C.GoString(groupName),
@@ -164,6 +166,20 @@ func run_self_test(sizes *C.struct_st_size_params, numSizes C.int, repCount C.in
 		}
 	}
 
+	// Construct the C array of per-size test durations for the out parameter,
+	// size i lasts i + 1 ms on every master endpoint. Must be freed by the caller.
+	ptr, err = C.calloc(C.size_t(int(numSizes)*int(*numMsEndpoints)), C.sizeof_int64_t)
+	if err != nil {
+		panic("calloc() failed for size durations")
+	}
+	*sizeDurations = (*C.int64_t)(ptr)
+	durSlice := unsafe.Slice(*sizeDurations, int(numSizes)*int(*numMsEndpoints))
+	for i := 0; i < int(numSizes); i++ {
+		for j := 0; j < int(*numMsEndpoints); j++ {
+			durSlice[i*int(*numMsEndpoints)+j] = C.int64_t(time.Duration(i+1) * time.Millisecond)
+		}
+	}
+
 	return run_self_test_RC
 }
 
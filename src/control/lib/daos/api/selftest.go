@@ -138,6 +138,7 @@ func RunSelfTest(ctx context.Context, cfg *daos.SelfTestConfig) ([]*daos.SelfTes
 	var cMasterEndpoints *C.struct_st_master_endpt
 	var numMsEndpoints C.uint32_t
 	var cSizeLatencies ***C.struct_st_latency
+	var cSizeDurations *C.int64_t
 	var bufAlignment = C.int16_t(cfg.BufferAlignment)
 
 	cGroupName := C.CString(cfg.GroupName)
@@ -166,6 +167,9 @@ func RunSelfTest(ctx context.Context, cfg *daos.SelfTestConfig) ([]*daos.SelfTes
 		if cSizeLatencies != nil {
 			C.free_size_latencies(cSizeLatencies, C.uint32_t(len(testSizes)), numMsEndpoints)
 		}
+		if cSizeDurations != nil {
+			C.free(unsafe.Pointer(cSizeDurations))
+		}
 		self_test_fini(true)
 	}()
 
@@ -173,7 +177,7 @@ func RunSelfTest(ctx context.Context, cfg *daos.SelfTestConfig) ([]*daos.SelfTes
 		cOptMasterEndpoints, numOptMsEndpoints,
 		cTgtEndpoints, C.uint32_t(len(tgtEndpoints)),
 		&cMasterEndpoints, &numMsEndpoints,
-		&cSizeLatencies, bufAlignment)
+		&cSizeLatencies, bufAlignment, &cSizeDurations)
 	if err := daos.ErrorFromRC(int(rc)); err != nil {
 		return nil, errors.Wrap(err, "self_test failed")
 	}
@@ -184,10 +188,15 @@ func RunSelfTest(ctx context.Context, cfg *daos.SelfTestConfig) ([]*daos.SelfTes
 	if cSizeLatencies == nil {
 		return nil, errors.New("no test latencies recorded")
 	}
+	if cSizeDurations == nil {
+		return nil, errors.New("no test durations recorded")
+	}
 
 	masterEndpoints := unsafe.Slice(cMasterEndpoints, int(numMsEndpoints))
 	var results []*daos.SelfTestResult
 	perSizeList := unsafe.Slice(cSizeLatencies, len(testSizes))
+	// The duration of size i on master endpoint j is at i * numMsEndpoints + j.
+	sizeDurations := unsafe.Slice(cSizeDurations, len(testSizes)*int(numMsEndpoints))
 	for i := 0; i < len(testSizes); i++ {
 		params := testSizes[i]
 		msSessions := unsafe.Slice(perSizeList[i], int(numMsEndpoints))
@@ -203,7 +212,7 @@ func RunSelfTest(ctx context.Context, cfg *daos.SelfTestConfig) ([]*daos.SelfTes
 				SendSize:        uint64(params.send_size),
 				ReplySize:       uint64(params.reply_size),
 				BufferAlignment: int16(bufAlignment),
-				Duration:        time.Duration(msEp.reply.test_duration_ns),
+				Duration:        time.Duration(sizeDurations[i*int(numMsEndpoints)+j]),
 				MasterLatency:   new(daos.EndpointLatency),
 				TargetLatencies: make(map[daos.SelfTestEndpoint]*daos.EndpointLatency),
 			}
@@ -8,6 +8,7 @@ package api
 
 import (
 	"testing"
+	"time"
 
 	"github.com/google/go-cmp/cmp"
 	"github.com/google/go-cmp/cmp/cmpopts"
@@ -88,6 +89,7 @@ func TestAPI_RunSelfTest(t *testing.T) {
 					SendSize:        cfg.SendSizes[i],
 					ReplySize:       cfg.ReplySizes[i],
 					BufferAlignment: cfg.BufferAlignment,
+					Duration:        time.Duration(i+1) * time.Millisecond,
 					MasterLatency:   &daos.EndpointLatency{},
 					TargetLatencies: make(map[daos.SelfTestEndpoint]*daos.EndpointLatency),
 				}
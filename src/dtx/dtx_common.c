@@ -23,6 +23,9 @@ uint32_t dtx_agg_thd_cnt_lo;
 uint32_t dtx_agg_thd_age_up;
 uint32_t dtx_agg_thd_age_lo;
 uint32_t dtx_batched_ult_max;
+uint32_t dtx_srdg_sync_max;
+uint32_t dtx_resync_ult_max;
+uint32_t dtx_resync_cont_max;
 
 struct dtx_batched_pool_args {
 	/* Link to dss_module_info::dmi_dtx_batched_pool_list. */
@@ -50,10 +53,20 @@ struct dtx_batched_cont_args {
 	int				 dbca_refs;
 	uint32_t			 dbca_reg_gen;
 	uint32_t			 dbca_cleanup_thd;
+	/* Committable age (in second) that triggers DTX batched commit. */
+	uint32_t			 dbca_cmt_age;
+	/* Start of current DTX batched commit control interval. */
+	uint64_t			 dbca_cmt_ctl_time;
+	/* The container's refresh count at the start of the interval. */
+	uint64_t			 dbca_cmt_refresh_cnt;
+	/* Time (in us) spent in batched commit RPCs during the interval. */
+	uint64_t			 dbca_cmt_busy;
 	uint32_t			 dbca_deregister:1,
 					 dbca_cleanup_done:1,
 					 dbca_commit_done:1,
-					 dbca_agg_done:1;
+					 dbca_agg_done:1,
+					 /* Thresholds accounted in dtx_tls::dt_cmt_{thd,age}_nr. */
+					 dbca_cmt_tracked:1;
 };
 
 struct dtx_partial_cmt_item {
@@ -110,10 +123,7 @@ dtx_free_dbca(struct dtx_batched_cont_args *dbca)
 	struct ds_cont_child		*cont = dbca->dbca_cont;
 	struct dtx_batched_pool_args	*dbpa = dbca->dbca_pool;
 
-	if (daos_handle_is_valid(cont->sc_dtx_cos_hdl)) {
-		dbtree_destroy(cont->sc_dtx_cos_hdl, NULL);
-		cont->sc_dtx_cos_hdl = DAOS_HDL_INVAL;
-	}
+	dtx_cos_fini(cont);
 
 	D_ASSERT(cont->sc_dtx_committable_count == 0);
 	D_ASSERT(cont->sc_dtx_committable_coll_count == 0);
@@ -606,6 +616,15 @@ dtx_aggregation_main(void *arg)
 	dmi->dmi_dtx_agg_req = NULL;
 }
 
+static inline bool
+dtx_batched_commit_needed(struct dtx_batched_cont_args *dbca, struct dtx_stat *stat)
+{
+	return stat->dtx_committable_count > dbca->dbca_cont->sc_dtx_cmt_thd ||
+	       stat->dtx_committable_coll_count > 0 ||
+	       (stat->dtx_oldest_committable_time != 0 &&
+		d_hlc_age2sec(stat->dtx_oldest_committable_time) >= dbca->dbca_cmt_age);
+}
+
 static void
 dtx_batched_commit_one(void *arg)
 {
@@ -625,6 +644,7 @@ dtx_batched_commit_one(void *arg)
 		struct dtx_entry	**dtes = NULL;
 		struct dtx_coll_entry	 *dce = NULL;
 		struct dtx_stat		  stat = { 0 };
+		uint64_t		  start;
 		int			  cnt;
 		int			  rc;
 
@@ -639,6 +659,7 @@ dtx_batched_commit_one(void *arg)
 			break;
 		}
 
+		start = daos_getutime();
 		if (dce != NULL) {
 			/* Currently, commit collective DTX one by one. */
 			D_ASSERT(cnt == 1);
@@ -654,17 +675,17 @@ dtx_batched_commit_one(void *arg)
 			break;
 		}
 
+		start = daos_getutime() - start;
+		dbca->dbca_cmt_busy += start;
+		d_tm_set_gauge(tls->dt_cmt_rpc_lat, start);
+
 		dtx_stat(cont, &stat);
 
 		if (stat.dtx_pool_cmt_count >= dtx_agg_thd_cnt_up &&
 		    dbca->dbca_pool->dbpa_aggregating == 0)
 			sched_req_wakeup(dmi->dmi_dtx_agg_req);
 
-		if ((stat.dtx_committable_count <= DTX_THRESHOLD_COUNT) &&
-		    (stat.dtx_committable_coll_count == 0) &&
-		    (stat.dtx_oldest_committable_time == 0 ||
-		     d_hlc_age2sec(stat.dtx_oldest_committable_time) <
-		     DTX_COMMIT_THRESHOLD_AGE))
+		if (!dtx_batched_commit_needed(dbca, &stat))
 			break;
 	}
 
@@ -675,6 +696,92 @@ out:
 	dtx_put_dbca(dbca);
 }
 
+/* Add (\a delta 1) or remove (-1) the thresholds of an opened container to the target ones. */
+static void
+dtx_cmt_thd_account(struct dtx_tls *tls, struct dtx_batched_cont_args *dbca, int delta)
+{
+	uint32_t	thd = dbca->dbca_cont->sc_dtx_cmt_thd;
+
+	D_ASSERT(thd != 0 && (thd & (thd - 1)) == 0 && thd <= DTX_THRESHOLD_COUNT);
+	D_ASSERT(dbca->dbca_cmt_age <= DTX_COMMIT_THRESHOLD_AGE);
+
+	tls->dt_cmt_thd_nr[__builtin_ctz(thd)] += delta;
+	tls->dt_cmt_age_nr[dbca->dbca_cmt_age] += delta;
+}
+
+/* Export the most aggressive thresholds among the opened containers on the target. */
+static void
+dtx_cmt_thd_export(struct dtx_tls *tls)
+{
+	uint32_t	i;
+
+	for (i = 0; i < DTX_CMT_THD_LEVELS - 1 && tls->dt_cmt_thd_nr[i] == 0; i++)
+		;
+	d_tm_set_gauge(tls->dt_cmt_thd, 1U << i);
+
+	for (i = 0; i < DTX_COMMIT_THRESHOLD_AGE && tls->dt_cmt_age_nr[i] == 0; i++)
+		;
+	d_tm_set_gauge(tls->dt_cmt_age, i);
+}
+
+static void
+dtx_cmt_thd_track(struct dtx_batched_cont_args *dbca, bool opened)
+{
+	struct dtx_tls	*tls = dtx_tls_get();
+
+	if (dbca->dbca_cmt_tracked == opened)
+		return;
+
+	dtx_cmt_thd_account(tls, dbca, opened ? 1 : -1);
+	dbca->dbca_cmt_tracked = opened;
+	dtx_cmt_thd_export(tls);
+}
+
+/*
+ * Adjust the thresholds that trigger DTX batched commit for the container based on the
+ * reader refresh and the commit RPC cost observed during the past control interval.
+ */
+static void
+dtx_batched_commit_ctl(struct dtx_batched_cont_args *dbca, struct dtx_tls *tls)
+{
+	struct ds_cont_child		*cont = dbca->dbca_cont;
+	uint64_t			 now = daos_gettime_coarse();
+	uint64_t			 refresh;
+	uint64_t			 busy;
+	uint32_t			 thd = cont->sc_dtx_cmt_thd;
+	uint32_t			 age = dbca->dbca_cmt_age;
+
+	if (now < dbca->dbca_cmt_ctl_time + DTX_CMT_CTL_INTERVAL)
+		return;
+
+	refresh = cont->sc_dtx_refresh_cnt - dbca->dbca_cmt_refresh_cnt;
+	busy = dbca->dbca_cmt_busy * 100 / ((now - dbca->dbca_cmt_ctl_time) * 1000000);
+
+	if (dbca->dbca_cmt_tracked)
+		dtx_cmt_thd_account(tls, dbca, -1);
+
+	if (refresh > 0 && busy < DTX_CMT_BUSY_PCT) {
+		cont->sc_dtx_cmt_thd = max(cont->sc_dtx_cmt_thd >> 1, DTX_CMT_THD_MIN);
+		dbca->dbca_cmt_age = max(dbca->dbca_cmt_age >> 1, DTX_CMT_AGE_MIN);
+	} else {
+		cont->sc_dtx_cmt_thd = min(cont->sc_dtx_cmt_thd << 1, DTX_THRESHOLD_COUNT);
+		dbca->dbca_cmt_age = min(dbca->dbca_cmt_age << 1, DTX_COMMIT_THRESHOLD_AGE);
+	}
+
+	D_DEBUG(DB_TRACE, DF_UUID": %lu refresh, %lu%% busy, commit threshold %u/%us\n",
+		DP_UUID(cont->sc_uuid), refresh, busy, cont->sc_dtx_cmt_thd, dbca->dbca_cmt_age);
+
+	dbca->dbca_cmt_ctl_time = now;
+	dbca->dbca_cmt_refresh_cnt = cont->sc_dtx_refresh_cnt;
+	dbca->dbca_cmt_busy = 0;
+
+	if (dbca->dbca_cmt_tracked) {
+		dtx_cmt_thd_account(tls, dbca, 1);
+		if (thd != cont->sc_dtx_cmt_thd || age != dbca->dbca_cmt_age)
+			dtx_cmt_thd_export(tls);
+	}
+}
+
 void
 dtx_batched_commit(void *arg)
 {
@@ -719,6 +826,7 @@ dtx_batched_commit(void *arg)
 		d_list_move_tail(&dbca->dbca_sys_link,
 				 &dmi->dmi_dtx_batched_cont_open_list);
 		dtx_stat(cont, &stat);
+		dtx_batched_commit_ctl(dbca, tls);
 
 		if (dbca->dbca_commit_req != NULL && dbca->dbca_commit_done) {
 			sched_req_put(dbca->dbca_commit_req);
@@ -728,11 +836,7 @@ dtx_batched_commit(void *arg)
 
 		if (dtx_cont_opened(cont) && dbca->dbca_commit_req == NULL &&
 		    (dtx_batched_ult_max != 0 && tls->dt_batched_ult_cnt < dtx_batched_ult_max) &&
-		    ((stat.dtx_committable_count > DTX_THRESHOLD_COUNT) ||
-		     (stat.dtx_committable_coll_count > 0) ||
-		     (stat.dtx_oldest_committable_time != 0 &&
-		      d_hlc_age2sec(stat.dtx_oldest_committable_time) >=
-		      DTX_COMMIT_THRESHOLD_AGE))) {
+		    dtx_batched_commit_needed(dbca, &stat)) {
 			D_ASSERT(!dbca->dbca_commit_done);
 			sleep_time = 0;
 			dtx_get_dbca(dbca);
@@ -1272,6 +1376,7 @@ dtx_leader_end(struct dtx_leader_handle *dlh, struct ds_cont_hdl *coh, int resul
 	int				 rc = 0;
 	bool				 aborted = false;
 	bool				 unpin = false;
+	bool				 no_committable = false;
 
 	D_ASSERT(cont != NULL);
 
@@ -1363,6 +1468,21 @@ dtx_leader_end(struct dtx_leader_handle *dlh, struct ds_cont_hdl *coh, int resul
 	if (DAOS_FAIL_CHECK(DAOS_DTX_MISS_COMMIT))
 		dth->dth_sync = 1;
 
+	/*
+	 * Small distributed transaction within single replicated redundancy group: commit it
+	 * before replying, then the client does not need another round trip and subsequent
+	 * readers on the non-leaders will not hit the 'prepared' entries and refresh them.
+	 * Unless the test wants to keep it non-committable.
+	 */
+	if (!dth->dth_sync && dth->dth_dist && dth->dth_mbs != NULL &&
+	    dth->dth_mbs->dm_flags & DMF_SRDG_REP &&
+	    dth->dth_modification_cnt <= dtx_srdg_sync_max) {
+		if (DAOS_FAIL_CHECK(DAOS_DTX_NO_COMMITTABLE))
+			no_committable = true;
+		else
+			dth->dth_sync = 1;
+	}
+
 	/* For synchronous DTX, do not add it into CoS cache, otherwise,
 	 * we may have no way to remove it from the cache.
 	 */
@@ -1403,9 +1523,9 @@ dtx_leader_end(struct dtx_leader_handle *dlh, struct ds_cont_hdl *coh, int resul
 	}
 
 	if (rc == 0) {
-		if (!DAOS_FAIL_CHECK(DAOS_DTX_NO_COMMITTABLE)) {
+		if (!no_committable && !DAOS_FAIL_CHECK(DAOS_DTX_NO_COMMITTABLE)) {
 			vos_dtx_mark_committable(dth);
-			if (cont->sc_dtx_committable_count > DTX_THRESHOLD_COUNT || dlh->dlh_coll)
+			if (cont->sc_dtx_committable_count > cont->sc_dtx_cmt_thd || dlh->dlh_coll)
 				sched_req_wakeup(dss_get_module_info()->dmi_dtx_cmt_req);
 		}
 	} else {
@@ -1624,8 +1744,6 @@ out:
 	return result;
 }
 
-#define DTX_COS_BTREE_ORDER		23
-
 static void
 dtx_flush_on_close(struct dss_module_info *dmi, struct dtx_batched_cont_args *dbca)
 {
@@ -1776,7 +1894,6 @@ dtx_cont_register(struct ds_cont_child *cont)
 	struct dss_module_info		*dmi = dss_get_module_info();
 	struct dtx_batched_pool_args	*dbpa = NULL;
 	struct dtx_batched_cont_args	*dbca = NULL;
-	struct umem_attr		 uma;
 	uint32_t			 timeout;
 	int				 rc;
 	bool				 new_pool = true;
@@ -1786,7 +1903,7 @@ dtx_cont_register(struct ds_cont_child *cont)
 
 	D_ASSERT(cont != NULL);
 	D_ASSERT(!dtx_cont_opened(cont));
-	D_ASSERT(daos_handle_is_inval(cont->sc_dtx_cos_hdl));
+	D_ASSERT(cont->sc_dtx_cos_tab == NULL);
 
 	d_list_for_each_entry(dbpa, &dmi->dmi_dtx_batched_pool_list, dbpa_sys_link) {
 		if (dbpa->dbpa_pool == cont->sc_pool) {
@@ -1828,18 +1945,14 @@ dtx_cont_register(struct ds_cont_child *cont)
 	 * handle potential stale DTX entries.
 	 */
 	dbca->dbca_cleanup_thd = timeout + DTX_COMMIT_THRESHOLD_AGE * 2;
+	dbca->dbca_cmt_age = DTX_COMMIT_THRESHOLD_AGE;
+	dbca->dbca_cmt_ctl_time = daos_gettime_coarse();
+	dbca->dbca_cmt_refresh_cnt = cont->sc_dtx_refresh_cnt;
 
-	memset(&uma, 0, sizeof(uma));
-	uma.uma_id = UMEM_CLASS_VMEM;
-	rc = dbtree_create_inplace_ex(DBTREE_CLASS_DTX_COS, 0,
-				      DTX_COS_BTREE_ORDER, &uma,
-				      &cont->sc_dtx_cos_btr,
-				      DAOS_HDL_INVAL, cont,
-				      &cont->sc_dtx_cos_hdl);
+	rc = dtx_cos_init(cont);
 	if (rc != 0) {
-		D_ERROR("Failed to create DTX CoS btree: "DF_RC"\n",
-			DP_RC(rc));
-		D_GOTO(out, rc = -DER_NOMEM);
+		D_ERROR("Failed to create DTX CoS table: "DF_RC"\n", DP_RC(rc));
+		goto out;
 	}
 
 	ds_cont_child_get(cont);
@@ -1884,6 +1997,7 @@ dtx_cont_deregister(struct ds_cont_child *cont)
 			if (dbca->dbca_cont == cont) {
 				d_list_del_init(&dbca->dbca_sys_link);
 				d_list_del_init(&dbca->dbca_pool_link);
+				dtx_cmt_thd_track(dbca, false);
 				dbca->dbca_deregister = 1;
 				dtx_free_dbca(dbca);
 				return;
@@ -1917,6 +2031,7 @@ dtx_cont_open(struct ds_cont_child *cont)
 				d_list_del(&dbca->dbca_sys_link);
 				d_list_add_tail(&dbca->dbca_sys_link,
 						&dmi->dmi_dtx_batched_cont_open_list);
+				dtx_cmt_thd_track(dbca, true);
 				return 0;
 			}
 		}
@@ -1948,6 +2063,7 @@ dtx_cont_close(struct ds_cont_child *cont, bool force)
 				d_list_del(&dbca->dbca_sys_link);
 				d_list_add_tail(&dbca->dbca_sys_link,
 						&dmi->dmi_dtx_batched_cont_close_list);
+				dtx_cmt_thd_track(dbca, false);
 				dtx_flush_on_close(dmi, dbca);
 
 				/* If nobody reopen the container during dtx_flush_on_close,
@@ -10,17 +10,16 @@
  */
 #define D_LOGFAC	DD_FAC(dtx)
 
-#include <daos/btree.h>
 #include <daos_srv/vos.h>
 #include "dtx_internal.h"
 
-/* The record for the DTX CoS B+tree in DRAM. Each record contains current
+/* The record for the DTX CoS index in DRAM. Each record contains current
  * committable DTXs that modify (update or punch) something under the same
  * object and the same dkey.
  */
 struct dtx_cos_rec {
-	daos_unit_oid_t		 dcr_oid;
-	uint64_t		 dcr_dkey_hash;
+	/* The key indexed by the container::sc_dtx_cos_tab. */
+	struct dtx_cos_key	 dcr_key;
 	/* The DTXs in the list only modify some SVT value or EVT value
 	 * (neither obj nor dkey/akey) that will not be shared by other
 	 * modifications.
@@ -71,256 +70,91 @@ struct dtx_cos_rec_child {
 					 dcrc_coll:1; /* For collective DTX. */
 };
 
-struct dtx_cos_rec_bundle {
-	void				*entry;
-	daos_epoch_t			 epoch;
-	uint32_t			 flags;
-};
-
-static int
-dtx_cos_hkey_size(void)
-{
-	return sizeof(struct dtx_cos_key);
-}
-
-static void
-dtx_cos_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
-{
-	D_ASSERT(key_iov->iov_len == sizeof(struct dtx_cos_key));
-
-	memcpy(hkey, key_iov->iov_buf, key_iov->iov_len);
-}
-
-static int
-dtx_cos_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
+static struct dtx_cos_rec *
+dtx_cos_lookup(struct ds_cont_child *cont, daos_unit_oid_t *oid, uint64_t dkey_hash)
 {
-	struct dtx_cos_key *hkey1 = (struct dtx_cos_key *)&rec->rec_hkey[0];
-	struct dtx_cos_key *hkey2 = (struct dtx_cos_key *)hkey;
-	int		    rc;
-
-	rc = memcmp(hkey1, hkey2, sizeof(struct dtx_cos_key));
-
-	return dbtree_key_cmp_rc(rc);
-}
-
-static int
-dtx_cos_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov,
-		  d_iov_t *val_iov, struct btr_record *rec, d_iov_t *val_out)
-{
-	struct ds_cont_child		*cont = tins->ti_priv;
-	struct dtx_cos_key		*key;
-	struct dtx_cos_rec_bundle	*rbund;
-	struct dtx_cos_rec		*dcr;
-	struct dtx_cos_rec_child	*dcrc;
-	struct dtx_tls			*tls = dtx_tls_get();
-
-	D_ASSERT(tins->ti_umm.umm_id == UMEM_CLASS_VMEM);
-
-	key = (struct dtx_cos_key *)key_iov->iov_buf;
-	rbund = (struct dtx_cos_rec_bundle *)val_iov->iov_buf;
-
-	D_ALLOC_PTR(dcr);
-	if (dcr == NULL)
-		return -DER_NOMEM;
-
-	dcr->dcr_oid = key->oid;
-	dcr->dcr_dkey_hash = key->dkey_hash;
-	D_INIT_LIST_HEAD(&dcr->dcr_reg_list);
-	D_INIT_LIST_HEAD(&dcr->dcr_prio_list);
-	D_INIT_LIST_HEAD(&dcr->dcr_expcmt_list);
-
-	D_ALLOC_PTR(dcrc);
-	if (dcrc == NULL) {
-		D_FREE(dcr);
-		return -DER_NOMEM;
-	}
+	struct dtx_cos_key	 key;
+	struct dtx_cos_key	*found;
 
-	D_INIT_LIST_HEAD(&dcrc->dcrc_batched_link);
-	dcrc->dcrc_ready_time = daos_getmtime_coarse();
-	dcrc->dcrc_epoch = rbund->epoch;
-	dcrc->dcrc_ptr = dcr;
-	if (rbund->flags & DCF_COLL) {
-		dcrc->dcrc_coll = 1;
-		dcrc->dcrc_dce = dtx_coll_entry_get(rbund->entry);
-		d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_coll_list);
-		cont->sc_dtx_committable_coll_count++;
-	} else {
-		dcrc->dcrc_dte = dtx_entry_get(rbund->entry);
-		d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_cos_list);
-	}
-	cont->sc_dtx_committable_count++;
-	d_tm_inc_gauge(tls->dt_committable, 1);
+	if (cont->sc_dtx_cos_tab == NULL)
+		return NULL;
 
-	if (rbund->flags & DCF_EXP_CMT) {
-		dcrc->dcrc_expcmt = 1;
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_expcmt_list);
-		dcr->dcr_expcmt_count = 1;
-	} else if (rbund->flags & DCF_SHARED) {
-		dcrc->dcrc_prio = 1;
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_prio_list);
-		dcr->dcr_prio_count = 1;
-	} else {
-		dcrc->dcrc_reg = 1;
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_reg_list);
-		dcr->dcr_reg_count = 1;
-	}
-
-	rec->rec_off = umem_ptr2off(&tins->ti_umm, dcr);
+	key.oid = *oid;
+	key.dkey_hash = dkey_hash;
+	found = dtx_cos_tab_lookup(cont->sc_dtx_cos_tab, &key);
 
-	return 0;
+	return found != NULL ? container_of(found, struct dtx_cos_rec, dcr_key) : NULL;
 }
 
 static int
-dtx_cos_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
+dtx_cos_rec_free(struct ds_cont_child *cont, struct dtx_cos_rec *dcr)
 {
-	struct ds_cont_child		*cont = tins->ti_priv;
-	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
-	struct dtx_cos_rec_child	*next;
+	d_list_t			*lists[] = { &dcr->dcr_reg_list, &dcr->dcr_prio_list,
+						     &dcr->dcr_expcmt_list };
 	int				 dec = 0;
-	int				 coll = 0;
-	struct dtx_tls			*tls = dtx_tls_get();
-
-	D_ASSERT(tins->ti_umm.umm_id == UMEM_CLASS_VMEM);
+	int				 i;
 
-	dcr = (struct dtx_cos_rec *)umem_off2ptr(&tins->ti_umm, rec->rec_off);
-	d_list_for_each_entry_safe(dcrc, next, &dcr->dcr_reg_list,
-				   dcrc_lo_link) {
-		d_list_del(&dcrc->dcrc_lo_link);
-		d_list_del(&dcrc->dcrc_gl_committable);
-		d_list_del(&dcrc->dcrc_batched_link);
-		if (dcrc->dcrc_coll) {
-			dtx_coll_entry_put(dcrc->dcrc_dce);
-			coll++;
-		} else {
-			dtx_entry_put(dcrc->dcrc_dte);
-		}
-		D_FREE(dcrc);
-		dec++;
-	}
-	d_list_for_each_entry_safe(dcrc, next, &dcr->dcr_prio_list,
-				   dcrc_lo_link) {
-		d_list_del(&dcrc->dcrc_lo_link);
-		d_list_del(&dcrc->dcrc_gl_committable);
-		d_list_del(&dcrc->dcrc_batched_link);
-		if (dcrc->dcrc_coll) {
-			dtx_coll_entry_put(dcrc->dcrc_dce);
-			coll++;
-		} else {
-			dtx_entry_put(dcrc->dcrc_dte);
-		}
-		D_FREE(dcrc);
-		dec++;
-	}
-	d_list_for_each_entry_safe(dcrc, next, &dcr->dcr_expcmt_list,
-				   dcrc_lo_link) {
-		d_list_del(&dcrc->dcrc_lo_link);
-		d_list_del(&dcrc->dcrc_gl_committable);
-		d_list_del(&dcrc->dcrc_batched_link);
-		if (dcrc->dcrc_coll) {
-			dtx_coll_entry_put(dcrc->dcrc_dce);
-			coll++;
-		} else {
-			dtx_entry_put(dcrc->dcrc_dte);
+	for (i = 0; i < ARRAY_SIZE(lists); i++) {
+		while ((dcrc = d_list_pop_entry(lists[i], struct dtx_cos_rec_child,
+						dcrc_lo_link)) != NULL) {
+			d_list_del(&dcrc->dcrc_gl_committable);
+			d_list_del(&dcrc->dcrc_batched_link);
+			if (dcrc->dcrc_coll) {
+				dtx_coll_entry_put(dcrc->dcrc_dce);
+				cont->sc_dtx_committable_coll_count--;
+			} else {
+				dtx_entry_put(dcrc->dcrc_dte);
+			}
+			D_FREE(dcrc);
+			dec++;
 		}
-		D_FREE(dcrc);
-		dec++;
 	}
 	D_FREE(dcr);
 
 	cont->sc_dtx_committable_count -= dec;
-	cont->sc_dtx_committable_coll_count -= coll;
 
-	/** adjust per-pool counter */
-	d_tm_dec_gauge(tls->dt_committable, dec);
-
-	return 0;
+	return dec;
 }
 
-static int
-dtx_cos_rec_fetch(struct btr_instance *tins, struct btr_record *rec,
-		  d_iov_t *key_iov, d_iov_t *val_iov)
+int
+dtx_cos_init(struct ds_cont_child *cont)
 {
-	struct dtx_cos_rec	*dcr;
-
-	D_ASSERT(val_iov != NULL);
+	D_ASSERT(cont->sc_dtx_cos_tab == NULL);
 
-	dcr = (struct dtx_cos_rec *)umem_off2ptr(&tins->ti_umm, rec->rec_off);
-	d_iov_set(val_iov, dcr, sizeof(struct dtx_cos_rec));
-
-	return 0;
+	return dtx_cos_tab_create(DTX_COS_TAB_BITS_MIN, &cont->sc_dtx_cos_tab);
 }
 
-static int
-dtx_cos_rec_update(struct btr_instance *tins, struct btr_record *rec,
-		   d_iov_t *key, d_iov_t *val, d_iov_t *val_out)
+void
+dtx_cos_fini(struct ds_cont_child *cont)
 {
-	struct ds_cont_child		*cont = tins->ti_priv;
-	struct dtx_cos_rec_bundle	*rbund;
-	struct dtx_cos_rec		*dcr;
-	struct dtx_cos_rec_child	*dcrc;
-	struct dtx_tls			*tls = dtx_tls_get();
-
-	D_ASSERT(tins->ti_umm.umm_id == UMEM_CLASS_VMEM);
-
-	dcr = (struct dtx_cos_rec *)umem_off2ptr(&tins->ti_umm, rec->rec_off);
-	rbund = (struct dtx_cos_rec_bundle *)val->iov_buf;
-
-	D_ALLOC_PTR(dcrc);
-	if (dcrc == NULL)
-		return -DER_NOMEM;
-
-	D_INIT_LIST_HEAD(&dcrc->dcrc_batched_link);
-	dcrc->dcrc_ready_time = daos_getmtime_coarse();
-	dcrc->dcrc_epoch = rbund->epoch;
-	dcrc->dcrc_ptr = dcr;
-	if (rbund->flags & DCF_COLL) {
-		dcrc->dcrc_coll = 1;
-		dcrc->dcrc_dce = dtx_coll_entry_get(rbund->entry);
-		d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_coll_list);
-		cont->sc_dtx_committable_coll_count++;
-	} else {
-		dcrc->dcrc_dte = dtx_entry_get(rbund->entry);
-		d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_cos_list);
+	struct dtx_cos_tab	*tab = cont->sc_dtx_cos_tab;
+	int			 dec = 0;
+	uint32_t		 i;
+
+	if (tab == NULL)
+		return;
+
+	/* The whole table is dropped, no need to remove the records one by one. */
+	for (i = 0; i < (1U << tab->dct_bits); i++) {
+		if (tab->dct_slots[i].dcs_key != NULL)
+			dec += dtx_cos_rec_free(cont, container_of(tab->dct_slots[i].dcs_key,
+								   struct dtx_cos_rec, dcr_key));
 	}
-	cont->sc_dtx_committable_count++;
-	d_tm_inc_gauge(tls->dt_committable, 1);
 
-	if (rbund->flags & DCF_EXP_CMT) {
-		dcrc->dcrc_expcmt = 1;
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_expcmt_list);
-		dcr->dcr_expcmt_count++;
-	} else if (rbund->flags & DCF_SHARED) {
-		dcrc->dcrc_prio = 1;
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_prio_list);
-		dcr->dcr_prio_count++;
-	} else {
-		dcrc->dcrc_reg = 1;
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_reg_list);
-		dcr->dcr_reg_count++;
-	}
+	/** adjust per-pool counter */
+	if (dec > 0)
+		d_tm_dec_gauge(dtx_tls_get()->dt_committable, dec);
 
-	return 0;
+	dtx_cos_tab_destroy(tab);
+	cont->sc_dtx_cos_tab = NULL;
 }
 
-btr_ops_t dtx_btr_cos_ops = {
-	.to_hkey_size	= dtx_cos_hkey_size,
-	.to_hkey_gen	= dtx_cos_hkey_gen,
-	.to_hkey_cmp	= dtx_cos_hkey_cmp,
-	.to_rec_alloc	= dtx_cos_rec_alloc,
-	.to_rec_free	= dtx_cos_rec_free,
-	.to_rec_fetch	= dtx_cos_rec_fetch,
-	.to_rec_update	= dtx_cos_rec_update,
-};
-
-static int
+static void
 dtx_cos_del_one(struct ds_cont_child *cont, struct dtx_cos_rec_child *dcrc)
 {
-	struct dtx_cos_key	 key;
-	d_iov_t			 kiov;
 	struct dtx_cos_rec	*dcr = dcrc->dcrc_ptr;
 	uint64_t		 time = daos_getmtime_coarse() - dcrc->dcrc_ready_time;
-	int			 rc = 0;
 
 	d_list_del(&dcrc->dcrc_gl_committable);
 	d_list_del(&dcrc->dcrc_lo_link);
@@ -341,14 +175,11 @@ dtx_cos_del_one(struct ds_cont_child *cont, struct dtx_cos_rec_child *dcrc)
 	d_tm_set_gauge(dtx_tls_get()->dt_async_cmt_lat, time);
 
 	if (dcr->dcr_reg_count == 0 && dcr->dcr_prio_count == 0 && dcr->dcr_expcmt_count == 0) {
-		key.oid = dcr->dcr_oid;
-		key.dkey_hash = dcr->dcr_dkey_hash;
-		d_iov_set(&kiov, &key, sizeof(key));
-		rc = dbtree_delete(cont->sc_dtx_cos_hdl, BTR_PROBE_EQ, &kiov, NULL);
+		dtx_cos_tab_delete(cont->sc_dtx_cos_tab, &dcr->dcr_key);
+		D_FREE(dcr);
 	}
 
-	DL_CDEBUG(rc != 0, DLOG_ERR, DB_IO, rc,
-		  "Remove DTX "DF_DTI" from CoS cache", DP_DTI(&dcrc->dcrc_dte->dte_xid));
+	D_DEBUG(DB_IO, "Remove DTX "DF_DTI" from CoS cache\n", DP_DTI(&dcrc->dcrc_dte->dte_xid));
 
 	if (dcrc->dcrc_coll)
 		dtx_coll_entry_put(dcrc->dcrc_dce);
@@ -356,8 +187,6 @@ dtx_cos_del_one(struct ds_cont_child *cont, struct dtx_cos_rec_child *dcrc)
 		dtx_entry_put(dcrc->dcrc_dte);
 
 	D_FREE(dcrc);
-
-	return rc;
 }
 
 int
@@ -404,8 +233,7 @@ dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 					if (dck_buf == NULL)
 						return -DER_NOMEM;
 
-					dck_buf->oid = dcrc->dcrc_ptr->dcr_oid;
-					dck_buf->dkey_hash = dcrc->dcrc_ptr->dcr_dkey_hash;
+					*dck_buf = dcrc->dcrc_ptr->dcr_key;
 					*dcks = dck_buf;
 				} else {
 					d_list_add_tail(&dcrc->dcrc_batched_link,
@@ -435,7 +263,7 @@ dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 	}
 
 	d_list_for_each_entry(dcrc, &cont->sc_dtx_cos_list, dcrc_gl_committable) {
-		if (oid != NULL && daos_unit_oid_compare(dcrc->dcrc_ptr->dcr_oid, *oid) != 0)
+		if (oid != NULL && daos_unit_oid_compare(dcrc->dcrc_ptr->dcr_key.oid, *oid) != 0)
 			continue;
 
 		if (epoch < dcrc->dcrc_epoch || (dcrc->dcrc_piggyback_refs > 0 && !force))
@@ -447,8 +275,7 @@ dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 
 			D_FREE(dte_buf);
 			if (dcks != NULL) {
-				dck_buf[i].oid = dcrc->dcrc_ptr->dcr_oid;
-				dck_buf[i].dkey_hash = dcrc->dcrc_ptr->dcr_dkey_hash;
+				dck_buf[i] = dcrc->dcrc_ptr->dcr_key;
 				*dcks = dck_buf;
 			} else {
 				d_list_add_tail(&dcrc->dcrc_batched_link,
@@ -461,8 +288,7 @@ dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 
 		dte_buf[i] = dtx_entry_get(dcrc->dcrc_dte);
 		if (dcks != NULL) {
-			dck_buf[i].oid = dcrc->dcrc_ptr->dcr_oid;
-			dck_buf[i].dkey_hash = dcrc->dcrc_ptr->dcr_dkey_hash;
+			dck_buf[i] = dcrc->dcrc_ptr->dcr_key;
 		} else {
 			d_list_add_tail(&dcrc->dcrc_batched_link, &cont->sc_dtx_batched_list);
 		}
@@ -487,27 +313,14 @@ int
 dtx_cos_get_piggyback(struct ds_cont_child *cont, daos_unit_oid_t *oid,
 		      uint64_t dkey_hash, int max, struct dtx_id **dtis)
 {
-	struct dtx_cos_key		 key;
-	d_iov_t				 kiov;
-	d_iov_t				 riov;
 	struct dtx_id			*dti = NULL;
-	struct dtx_cos_rec		*dcr = NULL;
+	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
 	int				 count;
-	int				 rc;
 	int				 i = 0;
 
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
-	d_iov_set(&riov, NULL, 0);
-
-	rc = dbtree_lookup(cont->sc_dtx_cos_hdl, &kiov, &riov);
-	if (rc != 0)
-		return rc == -DER_NONEXIST ? 0 : rc;
-
-	dcr = (struct dtx_cos_rec *)riov.iov_buf;
-	if (dcr->dcr_prio_count == 0)
+	dcr = dtx_cos_lookup(cont, oid, dkey_hash);
+	if (dcr == NULL || dcr->dcr_prio_count == 0)
 		return 0;
 
 	/* There are too many priority DTXs to be committed, as to cannot be
@@ -541,71 +354,111 @@ void
 dtx_cos_put_piggyback(struct ds_cont_child *cont, daos_unit_oid_t *oid, uint64_t dkey_hash,
 		      struct dtx_id xid[], uint32_t count, bool rm)
 {
-	struct dtx_cos_key		 key;
-	d_iov_t				 kiov;
-	d_iov_t				 riov;
 	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
 	int				 del = 0;
-	int				 rc;
 	int				 i;
 
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
-	d_iov_set(&riov, NULL, 0);
-
-	rc = dbtree_lookup(cont->sc_dtx_cos_hdl, &kiov, &riov);
-	if (rc == 0) {
-		dcr = (struct dtx_cos_rec *)riov.iov_buf;
-		for (i = 0; i < count; i++) {
-			d_list_for_each_entry(dcrc, &dcr->dcr_prio_list, dcrc_lo_link) {
-				if (memcmp(&dcrc->dcrc_dte->dte_xid, &xid[i],
-					   sizeof(struct dtx_id)) == 0) {
-					if (rm) {
-						rc = dtx_cos_del_one(cont, dcrc);
-						if (rc == 0)
-							del++;
-					} else {
-						dcrc->dcrc_piggyback_refs--;
-					}
-					break;
+	dcr = dtx_cos_lookup(cont, oid, dkey_hash);
+	if (dcr == NULL)
+		return;
+
+	for (i = 0; i < count; i++) {
+		d_list_for_each_entry(dcrc, &dcr->dcr_prio_list, dcrc_lo_link) {
+			if (memcmp(&dcrc->dcrc_dte->dte_xid, &xid[i], sizeof(struct dtx_id)) == 0) {
+				if (rm) {
+					/* The record may be released together with the last child. */
+					if (dcr->dcr_reg_count + dcr->dcr_prio_count +
+					    dcr->dcr_expcmt_count == 1)
+						i = count;
+					dtx_cos_del_one(cont, dcrc);
+					del++;
+				} else {
+					dcrc->dcrc_piggyback_refs--;
 				}
+				break;
 			}
 		}
-
-		if (del > 0)
-			d_tm_dec_gauge(dtx_tls_get()->dt_committable, del);
 	}
+
+	if (del > 0)
+		d_tm_dec_gauge(dtx_tls_get()->dt_committable, del);
 }
 
 int
 dtx_cos_add(struct ds_cont_child *cont, void *entry, daos_unit_oid_t *oid,
 	    uint64_t dkey_hash, daos_epoch_t epoch, uint32_t flags)
 {
-	struct dtx_cos_key		key;
-	struct dtx_cos_rec_bundle	rbund;
-	d_iov_t				kiov;
-	d_iov_t				riov;
-	int				rc;
+	struct dtx_cos_rec		*dcr;
+	struct dtx_cos_rec_child	*dcrc;
+	bool				 new_rec = false;
+	int				 rc = 0;
 
 	if (!dtx_cont_opened(cont))
 		return -DER_SHUTDOWN;
 
 	D_ASSERT(epoch != DAOS_EPOCH_MAX);
 
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
+	dcr = dtx_cos_lookup(cont, oid, dkey_hash);
+	if (dcr == NULL) {
+		D_ALLOC_PTR(dcr);
+		if (dcr == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		dcr->dcr_key.oid = *oid;
+		dcr->dcr_key.dkey_hash = dkey_hash;
+		D_INIT_LIST_HEAD(&dcr->dcr_reg_list);
+		D_INIT_LIST_HEAD(&dcr->dcr_prio_list);
+		D_INIT_LIST_HEAD(&dcr->dcr_expcmt_list);
+
+		rc = dtx_cos_tab_insert(cont->sc_dtx_cos_tab, &dcr->dcr_key);
+		if (rc != 0) {
+			D_FREE(dcr);
+			goto out;
+		}
+		new_rec = true;
+	}
 
-	rbund.entry = entry;
-	rbund.epoch = epoch;
-	rbund.flags = flags;
-	d_iov_set(&riov, &rbund, sizeof(rbund));
+	D_ALLOC_PTR(dcrc);
+	if (dcrc == NULL) {
+		if (new_rec) {
+			dtx_cos_tab_delete(cont->sc_dtx_cos_tab, &dcr->dcr_key);
+			D_FREE(dcr);
+		}
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	D_INIT_LIST_HEAD(&dcrc->dcrc_batched_link);
+	dcrc->dcrc_ready_time = daos_getmtime_coarse();
+	dcrc->dcrc_epoch = epoch;
+	dcrc->dcrc_ptr = dcr;
+	if (flags & DCF_COLL) {
+		dcrc->dcrc_coll = 1;
+		dcrc->dcrc_dce = dtx_coll_entry_get(entry);
+		d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_coll_list);
+		cont->sc_dtx_committable_coll_count++;
+	} else {
+		dcrc->dcrc_dte = dtx_entry_get(entry);
+		d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_cos_list);
+	}
+	cont->sc_dtx_committable_count++;
+	d_tm_inc_gauge(dtx_tls_get()->dt_committable, 1);
 
-	rc = dbtree_upsert(cont->sc_dtx_cos_hdl, BTR_PROBE_EQ,
-			   DAOS_INTENT_UPDATE, &kiov, &riov, NULL);
+	if (flags & DCF_EXP_CMT) {
+		dcrc->dcrc_expcmt = 1;
+		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_expcmt_list);
+		dcr->dcr_expcmt_count++;
+	} else if (flags & DCF_SHARED) {
+		dcrc->dcrc_prio = 1;
+		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_prio_list);
+		dcr->dcr_prio_count++;
+	} else {
+		dcrc->dcrc_reg = 1;
+		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_reg_list);
+		dcr->dcr_reg_count++;
+	}
 
+out:
 	if (flags & DCF_COLL)
 		D_CDEBUG(rc != 0, DLOG_ERR, DB_TRACE, "Insert coll DTX "DF_DTI" to CoS cache, "
 			 DF_UOID", key %lu, flags %x: "DF_RC"\n",
@@ -624,42 +477,31 @@ int
 dtx_cos_del(struct ds_cont_child *cont, struct dtx_id *xid,
 	    daos_unit_oid_t *oid, uint64_t dkey_hash)
 {
-	struct dtx_cos_key		 key;
-	d_iov_t				 kiov;
-	d_iov_t				 riov;
 	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
 	int				 found = 0;
-	int				 rc;
-
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
-	d_iov_set(&riov, NULL, 0);
 
-	rc = dbtree_lookup(cont->sc_dtx_cos_hdl, &kiov, &riov);
-	if (rc != 0)
+	dcr = dtx_cos_lookup(cont, oid, dkey_hash);
+	if (dcr == NULL)
 		goto out;
 
-	dcr = (struct dtx_cos_rec *)riov.iov_buf;
-
 	d_list_for_each_entry(dcrc, &dcr->dcr_prio_list, dcrc_lo_link) {
 		if (memcmp(&dcrc->dcrc_dte->dte_xid, xid, sizeof(*xid)) == 0) {
-			rc = dtx_cos_del_one(cont, dcrc);
+			dtx_cos_del_one(cont, dcrc);
 			D_GOTO(out, found = 1);
 		}
 	}
 
 	d_list_for_each_entry(dcrc, &dcr->dcr_reg_list, dcrc_lo_link) {
 		if (memcmp(&dcrc->dcrc_dte->dte_xid, xid, sizeof(*xid)) == 0) {
-			rc = dtx_cos_del_one(cont, dcrc);
+			dtx_cos_del_one(cont, dcrc);
 			D_GOTO(out, found = 2);
 		}
 	}
 
 	d_list_for_each_entry(dcrc, &dcr->dcr_expcmt_list, dcrc_lo_link) {
 		if (memcmp(&dcrc->dcrc_dte->dte_xid, xid, sizeof(*xid)) == 0) {
-			rc = dtx_cos_del_one(cont, dcrc);
+			dtx_cos_del_one(cont, dcrc);
 			D_GOTO(out, found = 3);
 		}
 	}
@@ -668,14 +510,10 @@ out:
 	if (found > 0)
 		d_tm_dec_gauge(dtx_tls_get()->dt_committable, 1);
 
-	if (rc == 0 && found == 0)
-		rc = -DER_NONEXIST;
-
-	DL_CDEBUG(rc != 0 && rc != -DER_NONEXIST, DLOG_ERR, DB_TRACE, rc,
-		  "Remove DTX from CoS cache "DF_UOID", key %lu",
-		  DP_UOID(*oid), (unsigned long)dkey_hash);
+	D_DEBUG(DB_TRACE, "Remove DTX from CoS cache "DF_UOID", key %lu, found %d\n",
+		DP_UOID(*oid), (unsigned long)dkey_hash, found);
 
-	return rc == -DER_NONEXIST ? 0 : rc;
+	return 0;
 }
 
 uint64_t
@@ -702,25 +540,14 @@ void
 dtx_cos_prio(struct ds_cont_child *cont, struct dtx_id *xid,
 	     daos_unit_oid_t *oid, uint64_t dkey_hash)
 {
-	struct dtx_cos_key		 key;
-	d_iov_t				 kiov;
-	d_iov_t				 riov;
 	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
-	int				 rc;
 	bool				 found = false;
 
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
-	d_iov_set(&riov, NULL, 0);
-
-	rc = dbtree_lookup(cont->sc_dtx_cos_hdl, &kiov, &riov);
-	if (rc != 0)
+	dcr = dtx_cos_lookup(cont, oid, dkey_hash);
+	if (dcr == NULL)
 		goto out;
 
-	dcr = (struct dtx_cos_rec *)riov.iov_buf;
-
 	if (dcr->dcr_reg_count > DTX_COS_SEARCH_MAX)
 		goto expcmt;
 
@@ -763,7 +590,6 @@ dtx_cos_batched_del(struct ds_cont_child *cont, struct dtx_id xid[], bool rm[],
 {
 	struct dtx_cos_rec_child	*dcrc;
 	int				 del = 0;
-	int				 rc;
 	int				 i = 0;
 	bool				 found;
 
@@ -779,9 +605,8 @@ dtx_cos_batched_del(struct ds_cont_child *cont, struct dtx_id xid[], bool rm[],
 				found = true;
 
 				if (rm[i]) {
-					rc = dtx_cos_del_one(cont, dcrc);
-					if (rc == 0)
-						del++;
+					dtx_cos_del_one(cont, dcrc);
+					del++;
 				}
 			}
 		}
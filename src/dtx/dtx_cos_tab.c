@@ -0,0 +1,189 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of daos two-phase commit transaction.
+ *
+ * dtx/dtx_cos_tab.c
+ *
+ * The volatile index of the DTX CoS records. It is an open addressing hash
+ * table with linear probing, each slot caches the hash of the key so that a
+ * probe only dereferences the record on a likely match. Removal shifts the
+ * following entries of the cluster backward, so there is no tombstone and
+ * the lookup cost does not degrade with add/del churn.
+ */
+#define D_LOGFAC	DD_FAC(dtx)
+
+#include <daos_srv/vos.h>
+#include "dtx_internal.h"
+
+#define DTX_COS_TAB_SEED	0x9e3779b9U
+
+static inline uint64_t
+dtx_cos_tab_hash(struct dtx_cos_key *key)
+{
+	return d_hash_murmur64((unsigned char *)key, sizeof(*key), DTX_COS_TAB_SEED);
+}
+
+static inline uint32_t
+dtx_cos_tab_mask(struct dtx_cos_tab *tab)
+{
+	return (1U << tab->dct_bits) - 1;
+}
+
+static void
+dtx_cos_tab_place(struct dtx_cos_slot *slots, uint32_t mask, struct dtx_cos_slot *slot)
+{
+	uint32_t	i;
+
+	for (i = slot->dcs_hash & mask; slots[i].dcs_key != NULL; i = (i + 1) & mask)
+		;
+
+	slots[i] = *slot;
+}
+
+static int
+dtx_cos_tab_resize(struct dtx_cos_tab *tab, uint32_t bits)
+{
+	struct dtx_cos_slot	*slots;
+	uint32_t		 size = 1U << tab->dct_bits;
+	uint32_t		 i;
+
+	D_ALLOC_ARRAY(slots, 1U << bits);
+	if (slots == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < size; i++) {
+		if (tab->dct_slots[i].dcs_key != NULL)
+			dtx_cos_tab_place(slots, (1U << bits) - 1, &tab->dct_slots[i]);
+	}
+
+	D_FREE(tab->dct_slots);
+	tab->dct_slots = slots;
+	tab->dct_bits = bits;
+
+	return 0;
+}
+
+int
+dtx_cos_tab_create(uint32_t bits, struct dtx_cos_tab **tabp)
+{
+	struct dtx_cos_tab	*tab;
+
+	D_ASSERT(bits >= DTX_COS_TAB_BITS_MIN && bits <= DTX_COS_TAB_BITS_MAX);
+
+	D_ALLOC_PTR(tab);
+	if (tab == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY(tab->dct_slots, 1U << bits);
+	if (tab->dct_slots == NULL) {
+		D_FREE(tab);
+		return -DER_NOMEM;
+	}
+
+	tab->dct_bits = bits;
+	*tabp = tab;
+
+	return 0;
+}
+
+void
+dtx_cos_tab_destroy(struct dtx_cos_tab *tab)
+{
+	/* The caller owns the records, they must have been released. */
+	D_FREE(tab->dct_slots);
+	D_FREE(tab);
+}
+
+struct dtx_cos_key *
+dtx_cos_tab_lookup(struct dtx_cos_tab *tab, struct dtx_cos_key *key)
+{
+	struct dtx_cos_slot	*slot;
+	uint64_t		 hash = dtx_cos_tab_hash(key);
+	uint32_t		 mask = dtx_cos_tab_mask(tab);
+	uint32_t		 i;
+
+	for (i = hash & mask; ; i = (i + 1) & mask) {
+		slot = &tab->dct_slots[i];
+		if (slot->dcs_key == NULL)
+			return NULL;
+
+		if (slot->dcs_hash == hash && memcmp(slot->dcs_key, key, sizeof(*key)) == 0)
+			return slot->dcs_key;
+	}
+}
+
+int
+dtx_cos_tab_insert(struct dtx_cos_tab *tab, struct dtx_cos_key *key)
+{
+	struct dtx_cos_slot	*slot;
+	uint64_t		 hash = dtx_cos_tab_hash(key);
+	uint32_t		 size = 1U << tab->dct_bits;
+	uint32_t		 mask;
+	uint32_t		 i;
+	int			 rc;
+
+	/* Keep the load factor under 3/4, the probe sequences stay short. */
+	if ((tab->dct_count + 1) * 4 > size * 3 && tab->dct_bits < DTX_COS_TAB_BITS_MAX) {
+		rc = dtx_cos_tab_resize(tab, tab->dct_bits + 1);
+		/* Still usable as long as there is a free slot, just slower. */
+		if (rc != 0 && tab->dct_count + 1 >= size)
+			return rc;
+	} else if (tab->dct_count + 1 >= size) {
+		return -DER_OVERFLOW;
+	}
+
+	/* The probe for a free slot goes through any slot holding the same key. */
+	mask = dtx_cos_tab_mask(tab);
+	for (i = hash & mask; ; i = (i + 1) & mask) {
+		slot = &tab->dct_slots[i];
+		if (slot->dcs_key == NULL)
+			break;
+
+		if (slot->dcs_hash == hash && memcmp(slot->dcs_key, key, sizeof(*key)) == 0)
+			return -DER_EXIST;
+	}
+
+	slot->dcs_hash = hash;
+	slot->dcs_key = key;
+	tab->dct_count++;
+
+	return 0;
+}
+
+void
+dtx_cos_tab_delete(struct dtx_cos_tab *tab, struct dtx_cos_key *key)
+{
+	struct dtx_cos_slot	*slots = tab->dct_slots;
+	uint64_t		 hash = dtx_cos_tab_hash(key);
+	uint32_t		 mask = dtx_cos_tab_mask(tab);
+	uint32_t		 home;
+	uint32_t		 i;
+	uint32_t		 j;
+
+	for (i = hash & mask; slots[i].dcs_key != key; i = (i + 1) & mask)
+		D_ASSERT(slots[i].dcs_key != NULL);
+
+	/*
+	 * Shift back the following entries of the cluster that cannot be reached from
+	 * their home slot once the slot @i is emptied.
+	 */
+	for (j = (i + 1) & mask; slots[j].dcs_key != NULL; j = (j + 1) & mask) {
+		home = slots[j].dcs_hash & mask;
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			slots[i] = slots[j];
+			i = j;
+		}
+	}
+
+	slots[i].dcs_key = NULL;
+	slots[i].dcs_hash = 0;
+	tab->dct_count--;
+
+	/* Give back the memory after a burst, failing to shrink is harmless. */
+	if (tab->dct_bits > DTX_COS_TAB_BITS_MIN && tab->dct_count * 8 < mask + 1)
+		dtx_cos_tab_resize(tab, tab->dct_bits - 1);
+}
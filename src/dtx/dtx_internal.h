@@ -33,9 +33,9 @@
  * OPCODE, flags, FMT, handler, corpc_hdlr,
  */
 #define DTX_PROTO_SRV_RPC_LIST							\
-	X(DTX_COMMIT,		0,	&CQF_dtx,	dtx_handler,		\
+	X(DTX_COMMIT,		DAOS_RPC_COALESCE, &CQF_dtx, dtx_handler,	\
 	  NULL,			"dtx_commit")					\
-	X(DTX_ABORT,		0,	&CQF_dtx,	dtx_handler,		\
+	X(DTX_ABORT,		DAOS_RPC_COALESCE, &CQF_dtx, dtx_handler,	\
 	  NULL,			"dtx_abort")					\
 	X(DTX_CHECK,		0,	&CQF_dtx,	dtx_handler,		\
 	  NULL,			"dtx_check")					\
@@ -167,6 +167,49 @@ extern uint32_t dtx_agg_thd_age_lo;
  */
 extern uint32_t dtx_batched_ult_max;
 
+/* The default max count of modifications for synchronously committed single RDG DTX. */
+#define DTX_SRDG_SYNC_DEF	8
+
+/*
+ * The distributed transaction with at most such count of modifications within single
+ * replicated redundancy group will be committed synchronously by the leader before reply.
+ * It can be adjusted via the environment "DAOS_DTX_SRDG_SYNC_MAX" when load the module.
+ *
+ * Zero:		disable such synchronous commit, use batched commit as others.
+ */
+extern uint32_t dtx_srdg_sync_max;
+
+/* The default count of ULTs for checking DTX status in parallel during DTX resync. */
+#define DTX_RESYNC_ULT_DEF	16
+
+/* The default count of containers to be resynced in parallel on each target. */
+#define DTX_RESYNC_CONT_DEF	4
+
+/*
+ * During DTX resync, each container checks the status of its DTX entries via at most
+ * dtx_resync_ult_max ULTs in parallel, and each target resyncs at most dtx_resync_cont_max
+ * containers in parallel. They can be adjusted via the environment "DAOS_DTX_RESYNC_ULT_MAX"
+ * and "DAOS_DTX_RESYNC_CONT_MAX" when load the module. Zero is regarded as one.
+ */
+extern uint32_t dtx_resync_ult_max;
+extern uint32_t dtx_resync_cont_max;
+
+/*
+ * DTX batched commit is adjusted per container once every DTX_CMT_CTL_INTERVAL. When readers
+ * have to refresh DTX status from the leader and the commit ULT is not busy, the committable
+ * count and age that trigger the batched commit are halved (down to DTX_CMT_THD_MIN and
+ * DTX_CMT_AGE_MIN), so that the entries are committed before more readers hit them. When no
+ * reader is blocked, or commit RPCs already take most of the interval, they are doubled back
+ * up to DTX_THRESHOLD_COUNT and DTX_COMMIT_THRESHOLD_AGE to send fewer and larger batches.
+ */
+#define DTX_CMT_CTL_INTERVAL	1	/* second */
+#define DTX_CMT_THD_MIN		16
+#define DTX_CMT_AGE_MIN		1	/* second */
+/* The count thresholds are power of 2 fractions of DTX_THRESHOLD_COUNT, one level per bit. */
+#define DTX_CMT_THD_LEVELS	(__builtin_ctz(DTX_THRESHOLD_COUNT) + 1)
+/* Percentage of the interval spent in commit RPCs beyond which the batches are not shrunk. */
+#define DTX_CMT_BUSY_PCT	50
+
 /*
  * If the size of dtx_memberships exceeds DTX_INLINE_MBS_SIZE, then load it (DTX mbs)
  * dynamically when use it to avoid holding a lot of DRAM resource for long time that
@@ -214,8 +257,43 @@ struct dtx_tls {
 	struct d_tm_node_t	*dt_committable;
 	struct d_tm_node_t	*dt_dtx_leader_total;
 	struct d_tm_node_t	*dt_async_cmt_lat;
+	struct d_tm_node_t	*dt_cmt_thd;
+	struct d_tm_node_t	*dt_cmt_age;
+	struct d_tm_node_t	*dt_cmt_rpc_lat;
+	struct d_tm_node_t	*dt_refresh;
+	struct d_tm_node_t	*dt_resync_pending;
+	struct d_tm_node_t	*dt_resync_eta;
 	uint64_t		 dt_agg_gen;
+	/* DTX resync progress on the target, the start time is in ms. */
+	uint64_t		 dt_resync_left;
+	uint64_t		 dt_resync_done;
+	uint64_t		 dt_resync_start;
 	uint32_t		 dt_batched_ult_cnt;
+	/*
+	 * Number of opened containers per batched commit threshold, by log2 of the count and by
+	 * the age, to export the minimum ones without walking the containers.
+	 */
+	uint32_t		 dt_cmt_thd_nr[DTX_CMT_THD_LEVELS];
+	uint32_t		 dt_cmt_age_nr[DTX_COMMIT_THRESHOLD_AGE + 1];
+};
+
+/*
+ * The DTX CoS index, one per container in DRAM. The slots refer to the keys
+ * embedded in the CoS records, the table starts with 1 << DTX_COS_TAB_BITS_MIN
+ * slots, grows when 3/4 full and shrinks when less than 1/8 is used.
+ */
+#define DTX_COS_TAB_BITS_MIN	6
+#define DTX_COS_TAB_BITS_MAX	24
+
+struct dtx_cos_slot {
+	uint64_t		 dcs_hash;
+	struct dtx_cos_key	*dcs_key;
+};
+
+struct dtx_cos_tab {
+	struct dtx_cos_slot	*dct_slots;
+	uint32_t		 dct_bits;
+	uint32_t		 dct_count;
 };
 
 extern struct dss_module_key dtx_module_key;
@@ -240,7 +318,6 @@ dtx_cont2ver(struct ds_cont_child *cont)
 
 extern struct crt_proto_format dtx_proto_fmt;
 extern btr_ops_t dbtree_dtx_cf_ops;
-extern btr_ops_t dtx_btr_cos_ops;
 
 /* dtx_common.c */
 int dtx_handle_reinit(struct dtx_handle *dth);
@@ -266,6 +343,15 @@ void dtx_cos_prio(struct ds_cont_child *cont, struct dtx_id *xid,
 
 void dtx_cos_batched_del(struct ds_cont_child *cont, struct dtx_id xid[], bool rm[],
 			 uint32_t count);
+int dtx_cos_init(struct ds_cont_child *cont);
+void dtx_cos_fini(struct ds_cont_child *cont);
+
+/* dtx_cos_tab.c */
+int dtx_cos_tab_create(uint32_t bits, struct dtx_cos_tab **tabp);
+void dtx_cos_tab_destroy(struct dtx_cos_tab *tab);
+struct dtx_cos_key *dtx_cos_tab_lookup(struct dtx_cos_tab *tab, struct dtx_cos_key *key);
+int dtx_cos_tab_insert(struct dtx_cos_tab *tab, struct dtx_cos_key *key);
+void dtx_cos_tab_delete(struct dtx_cos_tab *tab, struct dtx_cos_key *key);
 
 /* dtx_rpc.c */
 int dtx_check(struct ds_cont_child *cont, struct dtx_entry *dte,
@@ -36,17 +36,63 @@ struct dtx_resync_head {
 
 struct dtx_resync_args {
 	struct ds_cont_child	*cont;
+	/* The DTXs to be checked. */
 	struct dtx_resync_head	 tables;
+	/* The DTXs to be committed. */
+	struct dtx_resync_head	 cmt_tables;
+	/* The DTXs to be checked again. */
+	struct dtx_resync_head	 retry_tables;
 	daos_epoch_t		 epoch;
 	uint32_t		 resync_version;
 	uint32_t		 discard_version;
+	ABT_future		 future;
+	int			 tgt_cnt;
+	int			 err;
 };
 
+/*
+ * Account the DTX entries that are found (@added) or resolved (@done) by DTX resync on current
+ * target, and estimate the remaining time from the rate since the target's resync started.
+ */
+static void
+dtx_resync_progress(int added, int done)
+{
+	struct dtx_tls	*tls = dtx_tls_get();
+	uint64_t	 now = daos_getmtime_coarse();
+
+	if (tls->dt_resync_left == 0 && added > 0) {
+		tls->dt_resync_start = now;
+		tls->dt_resync_done = 0;
+	}
+
+	tls->dt_resync_left += added;
+	D_ASSERT(tls->dt_resync_left >= done);
+	tls->dt_resync_left -= done;
+	tls->dt_resync_done += done;
+
+	d_tm_set_gauge(tls->dt_resync_pending, tls->dt_resync_left);
+	if (tls->dt_resync_left == 0)
+		d_tm_set_gauge(tls->dt_resync_eta, 0);
+	else if (done > 0)
+		d_tm_set_gauge(tls->dt_resync_eta, tls->dt_resync_left *
+			       (now - tls->dt_resync_start) / tls->dt_resync_done / 1000);
+}
+
+static inline void
+dtx_dre_move(struct dtx_resync_head *from, struct dtx_resync_head *to,
+	     struct dtx_resync_entry *dre)
+{
+	from->drh_count--;
+	d_list_move_tail(&dre->dre_link, &to->drh_list);
+	to->drh_count++;
+}
+
 static inline void
 dtx_dre_release(struct dtx_resync_head *drh, struct dtx_resync_entry *dre)
 {
 	drh->drh_count--;
 	d_list_del(&dre->dre_link);
+	dtx_resync_progress(0, 1);
 	if (--(dre->dre_dte.dte_refs) == 0) {
 		if (dre->dre_inline_mbs == 0)
 			D_FREE(dre->dre_dte.dte_mbs);
@@ -366,43 +412,151 @@ out:
 	return rc;
 }
 
+/* Commit the DTXs collected in the commit list, the caller may yield. */
 static int
-dtx_status_handle(struct dtx_resync_args *dra)
+dtx_resync_commit_all(struct dtx_resync_args *dra)
 {
-	struct ds_cont_child		*cont = dra->cont;
+	struct dtx_resync_head	 drh;
+	struct dtx_resync_entry	*dre;
+	int			 rc;
+
+	if (dra->cmt_tables.drh_count == 0)
+		return 0;
+
+	/* Detach them, other ULTs may add more DTXs into the list during the commit. */
+	D_INIT_LIST_HEAD(&drh.drh_list);
+	d_list_splice_init(&dra->cmt_tables.drh_list, &drh.drh_list);
+	drh.drh_count = dra->cmt_tables.drh_count;
+	dra->cmt_tables.drh_count = 0;
+
+	rc = dtx_resync_commit(dra->cont, &drh, drh.drh_count);
+
+	/* Failed before handling them (out of memory), the next DTX resync will take them. */
+	while ((dre = d_list_pop_entry(&drh.drh_list, struct dtx_resync_entry,
+				       dre_link)) != NULL)
+		dtx_dre_release(&drh, dre);
+
+	return rc;
+}
+
+static void
+dtx_status_handle_ult(void *arg)
+{
+	struct dtx_resync_args		*dra = arg;
 	struct dtx_resync_head		*drh = &dra->tables;
 	struct dtx_resync_entry		*dre;
-	struct dtx_resync_entry		*next;
-	struct dtx_memberships		*mbs;
-	struct ds_pool			*pool = cont->sc_pool->spc_pool;
 	int				*tgt_array = NULL;
-	int				 tgt_cnt;
-	int				 count = 0;
-	int				 err = 0;
 	int				 rc;
 
-	if (drh->drh_count == 0)
+	D_ALLOC_ARRAY(tgt_array, dra->tgt_cnt);
+	if (tgt_array == NULL) {
+		dra->err = -DER_NOMEM;
 		goto out;
+	}
 
-	ABT_rwlock_rdlock(pool->sp_lock);
-	tgt_cnt = pool_map_target_nr(pool->sp_map);
-	ABT_rwlock_unlock(pool->sp_lock);
-	D_ASSERT(tgt_cnt != 0);
+	while (!d_list_empty(&drh->drh_list)) {
+		dre = d_list_entry(drh->drh_list.next, struct dtx_resync_entry, dre_link);
+		/* Take it off the list, others will not handle it when we yield for RPC. */
+		dtx_dre_move(drh, &dra->retry_tables, dre);
+
+		rc = dtx_status_handle_one(dra->cont, &dre->dre_dte, dre->dre_oid,
+					   dre->dre_dkey_hash, dre->dre_epoch, tgt_array,
+					   &dra->err);
+		switch (rc) {
+		case DSHR_NEED_COMMIT:
+			D_DEBUG(DB_TRACE, "As the new leader for TX "
+				DF_DTI", try to commit it.\n", DP_DTI(&dre->dre_xid));
+
+			dtx_dre_move(&dra->retry_tables, &dra->cmt_tables, dre);
+			if (dra->cmt_tables.drh_count >= DTX_THRESHOLD_COUNT) {
+				rc = dtx_resync_commit_all(dra);
+				if (rc < 0)
+					dra->err = rc;
+			}
+			break;
+		case DSHR_NEED_RETRY:
+			break;
+		case DSHR_IGNORE:
+		case DSHR_ABORT_FAILED:
+		case DSHR_CORRUPT:
+		default:
+			dtx_dre_release(&dra->retry_tables, dre);
+			break;
+		}
+	}
+
+out:
+	D_FREE(tgt_array);
+	rc = ABT_future_set(dra->future, NULL);
+	D_ASSERTF(rc == ABT_SUCCESS, "ABT_future_set failed for DTX resync: %d\n", rc);
+}
+
+/*
+ * Check the status of the DTXs in the list with up to dtx_resync_ult_max ULTs, each of them
+ * handles one DTX at a time, then the DTX_CHECK RPCs for different DTXs are in-flight together.
+ */
+static int
+dtx_status_handle_parallel(struct dtx_resync_args *dra)
+{
+	int	ult_cnt;
+	int	rc;
+	int	i;
+
+	ult_cnt = dtx_resync_ult_max > 0 ? dtx_resync_ult_max : 1;
+	if (ult_cnt > dra->tables.drh_count)
+		ult_cnt = dra->tables.drh_count;
+
+	rc = ABT_future_create(ult_cnt, NULL, &dra->future);
+	if (rc != ABT_SUCCESS)
+		return dss_abterr2der(rc);
+
+	for (i = 0; i < ult_cnt; i++) {
+		rc = dss_ult_create(dtx_status_handle_ult, dra, DSS_XS_SELF, 0, DSS_DEEP_STACK_SZ,
+				    NULL);
+		if (rc != 0) {
+			D_ERROR("Failed to create DTX resync ULT %d/%d: "DF_RC"\n",
+				i, ult_cnt, DP_RC(rc));
+			/* Handle them by current ULT if none created, otherwise leave to others. */
+			if (i == 0)
+				dtx_status_handle_ult(dra);
+			else
+				ABT_future_set(dra->future, NULL);
+		}
+	}
+
+	rc = ABT_future_wait(dra->future);
+	D_ASSERTF(rc == ABT_SUCCESS, "ABT_future_wait failed for DTX resync: %d\n", rc);
+	ABT_future_free(&dra->future);
 
-	D_ALLOC_ARRAY(tgt_array, tgt_cnt);
-	if (tgt_array == NULL)
-		D_GOTO(out, err = -DER_NOMEM);
+	return 0;
+}
+
+/*
+ * Drop the DTXs that are stale or led by others, and move the partially committed ones to the
+ * commit list. The others are left in the list to check their status.
+ */
+static int
+dtx_resync_filter(struct dtx_resync_args *dra, struct ds_pool *pool)
+{
+	struct ds_cont_child		*cont = dra->cont;
+	struct dtx_resync_head		*drh = &dra->tables;
+	struct dtx_resync_entry		*dre;
+	struct dtx_resync_entry		*next;
+	struct dtx_memberships		*mbs;
+	int				 err = 0;
+	int				 rc;
 
-again:
 	d_list_for_each_entry_safe(dre, next, &drh->drh_list, dre_link) {
 		if (dre->dre_dte.dte_ver < dra->discard_version) {
-			err = vos_dtx_abort(cont->sc_hdl, &dre->dre_xid, dre->dre_epoch);
-			if (err == -DER_NONEXIST)
-				err = 0;
-			if (err != 0)
+			rc = vos_dtx_abort(cont->sc_hdl, &dre->dre_xid, dre->dre_epoch);
+			if (rc == -DER_NONEXIST)
+				rc = 0;
+			if (rc != 0) {
 				D_ERROR("Failed to discard stale DTX "DF_DTI" with ver %d/%d: "
 					DF_RC"\n", DP_DTI(&dre->dre_xid), dre->dre_dte.dte_ver,
-					dra->discard_version, DP_RC(err));
+					dra->discard_version, DP_RC(rc));
+				err = rc;
+			}
 			dtx_dre_release(drh, dre);
 			continue;
 		}
@@ -424,8 +578,10 @@ again:
 		mbs = dre->dre_dte.dte_mbs;
 		D_ASSERT(mbs->dm_tgt_cnt > 0);
 
-		if (mbs->dm_dte_flags & DTE_PARTIAL_COMMITTED)
-			goto commit;
+		if (mbs->dm_dte_flags & DTE_PARTIAL_COMMITTED) {
+			dtx_dre_move(drh, &dra->cmt_tables, dre);
+			continue;
+		}
 
 		rc = dtx_is_leader(pool, dra, dre);
 		if (rc <= 0) {
@@ -442,50 +598,59 @@ again:
 			dtx_dre_release(drh, dre);
 			continue;
 		}
+	}
 
-		rc = dtx_status_handle_one(cont, &dre->dre_dte, dre->dre_oid, dre->dre_dkey_hash,
-					   dre->dre_epoch, tgt_array, &err);
-		switch (rc) {
-		case DSHR_NEED_COMMIT:
-			goto commit;
-		case DSHR_NEED_RETRY:
-			d_list_del(&dre->dre_link);
-			d_list_add_tail(&dre->dre_link, &drh->drh_list);
-			continue;
-		case DSHR_IGNORE:
-		case DSHR_ABORT_FAILED:
-		case DSHR_CORRUPT:
-		default:
-			dtx_dre_release(drh, dre);
-			continue;
-		}
+	return err;
+}
+
+static int
+dtx_status_handle(struct dtx_resync_args *dra)
+{
+	struct ds_cont_child		*cont = dra->cont;
+	struct dtx_resync_head		*drh = &dra->tables;
+	struct dtx_resync_entry		*dre;
+	struct ds_pool			*pool = cont->sc_pool->spc_pool;
+	int				 err = 0;
+	int				 rc;
 
-commit:
-		D_DEBUG(DB_TRACE, "As the new leader for TX "
-			DF_DTI", try to commit it.\n", DP_DTI(&dre->dre_xid));
+	if (drh->drh_count == 0)
+		goto out;
 
-		if (++count >= DTX_THRESHOLD_COUNT) {
-			rc = dtx_resync_commit(cont, drh, count);
-			if (rc < 0)
-				err = rc;
-			count = 0;
+	ABT_rwlock_rdlock(pool->sp_lock);
+	dra->tgt_cnt = pool_map_target_nr(pool->sp_map);
+	ABT_rwlock_unlock(pool->sp_lock);
+	D_ASSERT(dra->tgt_cnt != 0);
+
+	err = dtx_resync_filter(dra, pool);
+
+	while (drh->drh_count > 0) {
+		rc = dtx_status_handle_parallel(dra);
+
+		/* Some DTXs may need to be checked again because of DSHR_NEED_RETRY. */
+		d_list_splice_init(&dra->retry_tables.drh_list, &drh->drh_list);
+		drh->drh_count += dra->retry_tables.drh_count;
+		dra->retry_tables.drh_count = 0;
+
+		/* Out of memory, the left DTXs will be handled by next DTX resync. */
+		if (rc != 0 || dra->err == -DER_NOMEM) {
+			err = rc != 0 ? rc : dra->err;
+			break;
 		}
-	}
 
-	if (count > 0) {
-		rc = dtx_resync_commit(cont, drh, count);
-		if (rc < 0)
+		/* The pool map may have been changed during the check, verify them again. */
+		rc = dtx_resync_filter(dra, pool);
+		if (rc != 0)
 			err = rc;
-		count = 0;
 	}
 
-	/* The last DTX entry may be re-added to the list because of DSHR_NEED_RETRY. */
-	if (unlikely(!d_list_empty(&drh->drh_list)))
-		goto again;
+	rc = dtx_resync_commit_all(dra);
+	if (rc < 0)
+		err = rc;
 
-out:
-	D_FREE(tgt_array);
+	if (dra->err < 0)
+		err = dra->err;
 
+out:
 	while ((dre = d_list_pop_entry(&drh->drh_list, struct dtx_resync_entry,
 				       dre_link)) != NULL)
 		dtx_dre_release(drh, dre);
@@ -589,6 +754,7 @@ out:
 	dte->dte_refs = 1;
 	d_list_add_tail(&dre->dre_link, &dra->tables.drh_list);
 	dra->tables.drh_count++;
+	dtx_resync_progress(1, 0);
 
 	return 0;
 }
@@ -667,6 +833,10 @@ dtx_resync(daos_handle_t po_hdl, uuid_t po_uuid, uuid_t co_uuid, uint32_t ver, b
 	dra.epoch = d_hlc_get();
 	D_INIT_LIST_HEAD(&dra.tables.drh_list);
 	dra.tables.drh_count = 0;
+	D_INIT_LIST_HEAD(&dra.cmt_tables.drh_list);
+	dra.cmt_tables.drh_count = 0;
+	D_INIT_LIST_HEAD(&dra.retry_tables.drh_list);
+	dra.retry_tables.drh_count = 0;
 
 	/*
 	 * Trigger DTX reindex. That will avoid DTX_CHECK from others being blocked.
@@ -716,6 +886,14 @@ out:
 struct dtx_container_scan_arg {
 	uuid_t			co_uuid;
 	struct dtx_scan_args	arg;
+	daos_handle_t		po_hdl;
+	/* The containers to be resynced, and the next one to be handled. */
+	uuid_t			*co_uuids;
+	int			co_cnt;
+	int			co_cap;
+	int			co_next;
+	int			co_rc;
+	ABT_future		future;
 };
 
 static int
@@ -724,8 +902,7 @@ container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 		  void *data, unsigned *acts)
 {
 	struct dtx_container_scan_arg	*scan_arg = data;
-	struct dtx_scan_args		*arg = &scan_arg->arg;
-	int				rc;
+	uuid_t				*co_uuids;
 
 	if (uuid_compare(scan_arg->co_uuid, entry->ie_couuid) == 0) {
 		D_DEBUG(DB_REBUILD, DF_UUID" already scan\n",
@@ -734,15 +911,43 @@ container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	}
 
 	uuid_copy(scan_arg->co_uuid, entry->ie_couuid);
-	rc = dtx_resync(iter_param->ip_hdl, arg->pool_uuid, entry->ie_couuid, arg->version, true);
-	if (rc)
-		D_ERROR(DF_UUID" dtx resync failed: rc %d\n",
-			DP_UUID(arg->pool_uuid), rc);
+	if (scan_arg->co_cnt == scan_arg->co_cap) {
+		D_REALLOC_ARRAY(co_uuids, scan_arg->co_uuids, scan_arg->co_cap,
+				scan_arg->co_cap == 0 ? 8 : scan_arg->co_cap * 2);
+		if (co_uuids == NULL)
+			return -DER_NOMEM;
 
-	/* Since dtx_resync might yield, let's reprobe anyway */
-	*acts |= VOS_ITER_CB_YIELD;
+		scan_arg->co_uuids = co_uuids;
+		scan_arg->co_cap = scan_arg->co_cap == 0 ? 8 : scan_arg->co_cap * 2;
+	}
 
-	return rc;
+	uuid_copy(scan_arg->co_uuids[scan_arg->co_cnt++], entry->ie_couuid);
+
+	return 0;
+}
+
+static void
+dtx_resync_cont_ult(void *data)
+{
+	struct dtx_container_scan_arg	*scan_arg = data;
+	struct dtx_scan_args		*arg = &scan_arg->arg;
+	int				 idx;
+	int				 rc;
+
+	while (scan_arg->co_next < scan_arg->co_cnt) {
+		idx = scan_arg->co_next++;
+		rc = dtx_resync(scan_arg->po_hdl, arg->pool_uuid, scan_arg->co_uuids[idx],
+				arg->version, true);
+		if (rc) {
+			D_ERROR(DF_UUID"/"DF_UUID" dtx resync failed: rc %d\n",
+				DP_UUID(arg->pool_uuid), DP_UUID(scan_arg->co_uuids[idx]), rc);
+			if (scan_arg->co_rc == 0)
+				scan_arg->co_rc = rc;
+		}
+	}
+
+	rc = ABT_future_set(scan_arg->future, NULL);
+	D_ASSERTF(rc == ABT_SUCCESS, "ABT_future_set failed for DTX resync: %d\n", rc);
 }
 
 static int
@@ -753,7 +958,9 @@ dtx_resync_one(void *data)
 	vos_iter_param_t		*param = NULL;
 	struct vos_iter_anchors		*anchor = NULL;
 	struct dtx_container_scan_arg	 cb_arg = { 0 };
+	int				 ult_cnt;
 	int				 rc;
+	int				 i;
 
 	child = ds_pool_child_lookup(arg->pool_uuid);
 	if (child == NULL)
@@ -771,12 +978,43 @@ dtx_resync_one(void *data)
 		D_GOTO(out, rc = -DER_NOMEM);
 
 	cb_arg.arg = *arg;
+	cb_arg.po_hdl = child->spc_hdl;
 	param->ip_hdl = child->spc_hdl;
 	param->ip_flags = VOS_IT_FOR_MIGRATION;
 	rc = vos_iterate(param, VOS_ITER_COUUID, false, anchor,
 			 container_scan_cb, NULL, &cb_arg, NULL);
+	if (rc != 0 || cb_arg.co_cnt == 0)
+		goto out;
+
+	/* Resync the containers in parallel, each ULT handles the next container in turn. */
+	ult_cnt = dtx_resync_cont_max > 0 ? dtx_resync_cont_max : 1;
+	if (ult_cnt > cb_arg.co_cnt)
+		ult_cnt = cb_arg.co_cnt;
+
+	rc = ABT_future_create(ult_cnt, NULL, &cb_arg.future);
+	if (rc != ABT_SUCCESS)
+		D_GOTO(out, rc = dss_abterr2der(rc));
+
+	for (i = 0; i < ult_cnt; i++) {
+		rc = dss_ult_create(dtx_resync_cont_ult, &cb_arg, DSS_XS_SELF, 0,
+				    DSS_DEEP_STACK_SZ, NULL);
+		if (rc != 0) {
+			D_ERROR(DF_UUID" failed to create DTX resync ULT %d/%d: "DF_RC"\n",
+				DP_UUID(arg->pool_uuid), i, ult_cnt, DP_RC(rc));
+			if (i == 0)
+				dtx_resync_cont_ult(&cb_arg);
+			else
+				ABT_future_set(cb_arg.future, NULL);
+		}
+	}
+
+	rc = ABT_future_wait(cb_arg.future);
+	D_ASSERTF(rc == ABT_SUCCESS, "ABT_future_wait failed for DTX resync: %d\n", rc);
+	ABT_future_free(&cb_arg.future);
+	rc = cb_arg.co_rc;
 
 out:
+	D_FREE(cb_arg.co_uuids);
 	D_FREE(param);
 	D_FREE(anchor);
 	if (child != NULL)
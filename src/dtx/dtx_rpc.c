@@ -1324,6 +1324,9 @@ dtx_refresh(struct dtx_handle *dth, struct ds_cont_child *cont)
 	if (DAOS_FAIL_CHECK(DAOS_DTX_NO_RETRY))
 		return -DER_IO;
 
+	cont->sc_dtx_refresh_cnt++;
+	d_tm_inc_counter(dtx_tls_get()->dt_refresh, 1);
+
 	rc = dtx_refresh_internal(cont, &dth->dth_share_tbd_count,
 				  &dth->dth_share_tbd_list,
 				  &dth->dth_share_cmt_list,
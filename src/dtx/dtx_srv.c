@@ -55,6 +55,48 @@ dtx_tls_init(int tags, int xs_id, int tgt_id)
 		D_WARN("Failed to create DTX async commit latency metric: " DF_RC"\n",
 		       DP_RC(rc));
 
+	rc = d_tm_add_metric(&tls->dt_cmt_thd, D_TM_GAUGE,
+			     "minimum committable count to trigger DTX batched commit", "entry",
+			     "io/dtx/cmt_thd/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX commit threshold metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_cmt_age, D_TM_GAUGE,
+			     "minimum committable age to trigger DTX batched commit", "s",
+			     "io/dtx/cmt_age/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX commit age metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_cmt_rpc_lat, D_TM_STATS_GAUGE,
+			     "DTX batched commit RPC latency", "us",
+			     "io/dtx/cmt_rpc_lat/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX commit RPC latency metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_refresh, D_TM_COUNTER,
+			     "total number of DTX refresh by readers", "refresh",
+			     "io/dtx/refresh/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX refresh metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_resync_pending, D_TM_GAUGE,
+			     "number of DTX entries left for DTX resync", "entry",
+			     "io/dtx/resync/pending/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX resync pending metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_resync_eta, D_TM_GAUGE,
+			     "estimated time to finish DTX resync", "s",
+			     "io/dtx/resync/eta/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX resync ETA metric: " DF_RC"\n",
+		       DP_RC(rc));
+
 	return tls;
 }
 
@@ -320,6 +362,8 @@ dtx_handler(crt_rpc_t *rpc)
 			} else if (*ptr == DTX_ST_COMMITTABLE) {
 				/* Higher priority for the DTX, then it can be committed ASAP. */
 				dtx_cos_prio(cont, dtis, &dcks[i].oid, dcks[i].dkey_hash);
+				/* Remote reader blocked by our committable DTX, commit sooner. */
+				cont->sc_dtx_refresh_cnt++;
 			}
 		}
 		break;
@@ -519,12 +563,21 @@ dtx_init(void)
 	d_getenv_uint32_t("DAOS_DTX_BATCHED_ULT_MAX", &dtx_batched_ult_max);
 	D_INFO("Set the max count of DTX batched commit ULTs as %d\n", dtx_batched_ult_max);
 
+	dtx_srdg_sync_max = DTX_SRDG_SYNC_DEF;
+	d_getenv_uint32_t("DAOS_DTX_SRDG_SYNC_MAX", &dtx_srdg_sync_max);
+	D_INFO("Set the max modifications of single RDG DTX to be committed synchronously as %u\n",
+	       dtx_srdg_sync_max);
+
+	dtx_resync_ult_max = DTX_RESYNC_ULT_DEF;
+	d_getenv_uint32_t("DAOS_DTX_RESYNC_ULT_MAX", &dtx_resync_ult_max);
+	dtx_resync_cont_max = DTX_RESYNC_CONT_DEF;
+	d_getenv_uint32_t("DAOS_DTX_RESYNC_CONT_MAX", &dtx_resync_cont_max);
+	D_INFO("Set DTX resync parallelism as %u ULTs per container, %u containers per target\n",
+	       dtx_resync_ult_max, dtx_resync_cont_max);
+
 	rc = dbtree_class_register(DBTREE_CLASS_DTX_CF,
 				   BTR_FEAT_UINT_KEY | BTR_FEAT_DYNAMIC_ROOT,
 				   &dbtree_dtx_cf_ops);
-	if (rc == 0)
-		rc = dbtree_class_register(DBTREE_CLASS_DTX_COS, 0,
-					   &dtx_btr_cos_ops);
 
 	return rc;
 }
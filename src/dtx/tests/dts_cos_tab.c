@@ -0,0 +1,264 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * DTX CoS index checks
+ */
+#define D_LOGFAC DD_FAC(tests)
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <uuid/uuid.h>
+#include <daos_types.h>
+#include <daos/object.h>
+
+#include "vts_io.h"
+#include "dtx_internal.h"
+
+#define DTS_COS_KEYS	1024
+
+static void
+dts_cos_key(struct dtx_cos_key *key, uint32_t nr)
+{
+	memset(key, 0, sizeof(*key));
+	key->oid.id_pub.lo = nr;
+	key->oid.id_pub.hi = 0x1000000000000000ULL;
+	key->dkey_hash = nr * 7;
+}
+
+/* Return the slot holding @key, -1 if it is not indexed */
+static int
+dts_cos_slot(struct dtx_cos_tab *tab, struct dtx_cos_key *key)
+{
+	uint32_t i;
+
+	for (i = 0; i < (1U << tab->dct_bits); i++) {
+		if (tab->dct_slots[i].dcs_key == key)
+			return i;
+	}
+	return -1;
+}
+
+/* Home slot of @key in a table of the minimal size */
+static uint32_t
+dts_cos_home(struct dtx_cos_key *key)
+{
+	struct dtx_cos_tab	*tab;
+	uint32_t		 home;
+	int			 rc;
+
+	rc = dtx_cos_tab_create(DTX_COS_TAB_BITS_MIN, &tab);
+	assert_rc_equal(rc, 0);
+
+	rc = dtx_cos_tab_insert(tab, key);
+	assert_rc_equal(rc, 0);
+	home = tab->dct_slots[dts_cos_slot(tab, key)].dcs_hash &
+	       ((1U << DTX_COS_TAB_BITS_MIN) - 1);
+
+	dtx_cos_tab_delete(tab, key);
+	dtx_cos_tab_destroy(tab);
+	return home;
+}
+
+/* Check that only the keys in [@first, @last) are indexed */
+static void
+dts_cos_check(struct dtx_cos_tab *tab, struct dtx_cos_key *keys, int first, int last, int nr)
+{
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		if (i >= first && i < last)
+			assert_ptr_equal(dtx_cos_tab_lookup(tab, &keys[i]), &keys[i]);
+		else
+			assert_null(dtx_cos_tab_lookup(tab, &keys[i]));
+	}
+	assert_int_equal(tab->dct_count, last - first);
+}
+
+/* Insert, look up (including by an equal key at another address) and delete. */
+static void
+dts_cos_tab_basic(void **state)
+{
+	struct dtx_cos_tab	*tab;
+	struct dtx_cos_key	 keys[16];
+	struct dtx_cos_key	 copy;
+	int			 i;
+	int			 rc;
+
+	rc = dtx_cos_tab_create(DTX_COS_TAB_BITS_MIN, &tab);
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < ARRAY_SIZE(keys); i++) {
+		dts_cos_key(&keys[i], i);
+		assert_null(dtx_cos_tab_lookup(tab, &keys[i]));
+		rc = dtx_cos_tab_insert(tab, &keys[i]);
+		assert_rc_equal(rc, 0);
+	}
+	dts_cos_check(tab, keys, 0, ARRAY_SIZE(keys), ARRAY_SIZE(keys));
+
+	/* The record is found from any copy of its key, and cannot be added twice. */
+	copy = keys[3];
+	assert_ptr_equal(dtx_cos_tab_lookup(tab, &copy), &keys[3]);
+	rc = dtx_cos_tab_insert(tab, &copy);
+	assert_rc_equal(rc, -DER_EXIST);
+	assert_int_equal(tab->dct_count, ARRAY_SIZE(keys));
+
+	for (i = 0; i < ARRAY_SIZE(keys); i++) {
+		dtx_cos_tab_delete(tab, &keys[i]);
+		dts_cos_check(tab, keys, i + 1, ARRAY_SIZE(keys), ARRAY_SIZE(keys));
+	}
+
+	dtx_cos_tab_destroy(tab);
+}
+
+/*
+ * Deleting the head of a probe chain that wraps around the end of the table
+ * shifts the rest of the chain backward, a later lookup of the deleted key
+ * stops at the emptied slot.
+ */
+static void
+dts_cos_tab_wrap(void **state)
+{
+	uint32_t		 mask = (1U << DTX_COS_TAB_BITS_MIN) - 1;
+	struct dtx_cos_tab	*tab;
+	struct dtx_cos_key	*keys;
+	struct dtx_cos_key	*last[3] = {NULL};
+	struct dtx_cos_key	*first = NULL;
+	uint32_t		 home;
+	int			 nr_last = 0;
+	int			 i;
+	int			 rc;
+
+	D_ALLOC_ARRAY(keys, DTS_COS_KEYS);
+	assert_non_null(keys);
+
+	/* Three keys whose home is the last slot and one whose home is the first. */
+	for (i = 0; i < DTS_COS_KEYS && (nr_last < 3 || first == NULL); i++) {
+		dts_cos_key(&keys[i], i);
+		home = dts_cos_home(&keys[i]);
+		if (home == mask && nr_last < 3)
+			last[nr_last++] = &keys[i];
+		else if (home == 0 && first == NULL)
+			first = &keys[i];
+	}
+	assert_int_equal(nr_last, 3);
+	assert_non_null(first);
+
+	rc = dtx_cos_tab_create(DTX_COS_TAB_BITS_MIN, &tab);
+	assert_rc_equal(rc, 0);
+
+	/* Chain: last[0] at 63, last[1] wraps to 0, first at 1, last[2] at 2. */
+	assert_rc_equal(dtx_cos_tab_insert(tab, last[0]), 0);
+	assert_rc_equal(dtx_cos_tab_insert(tab, last[1]), 0);
+	assert_rc_equal(dtx_cos_tab_insert(tab, first), 0);
+	assert_rc_equal(dtx_cos_tab_insert(tab, last[2]), 0);
+	assert_int_equal(dts_cos_slot(tab, last[0]), mask);
+	assert_int_equal(dts_cos_slot(tab, last[1]), 0);
+	assert_int_equal(dts_cos_slot(tab, first), 1);
+	assert_int_equal(dts_cos_slot(tab, last[2]), 2);
+
+	/* Every entry moves back by one slot, across the end of the table. */
+	dtx_cos_tab_delete(tab, last[0]);
+	assert_int_equal(dts_cos_slot(tab, last[1]), mask);
+	assert_int_equal(dts_cos_slot(tab, first), 0);
+	assert_int_equal(dts_cos_slot(tab, last[2]), 1);
+	assert_null(tab->dct_slots[2].dcs_key);
+
+	assert_null(dtx_cos_tab_lookup(tab, last[0]));
+	assert_ptr_equal(dtx_cos_tab_lookup(tab, last[1]), last[1]);
+	assert_ptr_equal(dtx_cos_tab_lookup(tab, first), first);
+	assert_ptr_equal(dtx_cos_tab_lookup(tab, last[2]), last[2]);
+
+	/* first is at its home, it stays there while last[2] moves over the end. */
+	dtx_cos_tab_delete(tab, last[1]);
+	assert_int_equal(dts_cos_slot(tab, first), 0);
+	assert_int_equal(dts_cos_slot(tab, last[2]), mask);
+	assert_null(dtx_cos_tab_lookup(tab, last[1]));
+	assert_ptr_equal(dtx_cos_tab_lookup(tab, last[2]), last[2]);
+
+	dtx_cos_tab_delete(tab, first);
+	dtx_cos_tab_delete(tab, last[2]);
+	assert_int_equal(tab->dct_count, 0);
+	for (i = 0; i <= mask; i++)
+		assert_null(tab->dct_slots[i].dcs_key);
+
+	dtx_cos_tab_destroy(tab);
+	D_FREE(keys);
+}
+
+/* The table grows when 3/4 full and shrinks back when less than 1/8 is used. */
+static void
+dts_cos_tab_resize(void **state)
+{
+	uint32_t		 size = 1U << DTX_COS_TAB_BITS_MIN;
+	struct dtx_cos_tab	*tab;
+	struct dtx_cos_key	*keys;
+	int			 i;
+	int			 rc;
+
+	D_ALLOC_ARRAY(keys, DTS_COS_KEYS);
+	assert_non_null(keys);
+
+	rc = dtx_cos_tab_create(DTX_COS_TAB_BITS_MIN, &tab);
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < DTS_COS_KEYS; i++) {
+		dts_cos_key(&keys[i], i);
+		rc = dtx_cos_tab_insert(tab, &keys[i]);
+		assert_rc_equal(rc, 0);
+
+		if (i + 1 == size * 3 / 4) {
+			assert_int_equal(tab->dct_bits, DTX_COS_TAB_BITS_MIN);
+			dts_cos_check(tab, keys, 0, i + 1, DTS_COS_KEYS);
+		} else if (i == size * 3 / 4) {
+			assert_int_equal(tab->dct_bits, DTX_COS_TAB_BITS_MIN + 1);
+			dts_cos_check(tab, keys, 0, i + 1, DTS_COS_KEYS);
+		}
+	}
+	/* 1024 keys fit in 2048 slots under the 3/4 load */
+	assert_int_equal(tab->dct_bits, 11);
+	dts_cos_check(tab, keys, 0, DTS_COS_KEYS, DTS_COS_KEYS);
+
+	/* Shrink one step at a time down to the minimal size. */
+	for (i = 0; i < DTS_COS_KEYS; i++) {
+		size = 1U << tab->dct_bits;
+		dtx_cos_tab_delete(tab, &keys[i]);
+		if (size > (1U << DTX_COS_TAB_BITS_MIN) && (DTS_COS_KEYS - i - 1) * 8 < size)
+			assert_int_equal(1U << tab->dct_bits, size / 2);
+		else
+			assert_int_equal(1U << tab->dct_bits, size);
+		if (i % 64 == 0)
+			dts_cos_check(tab, keys, i + 1, DTS_COS_KEYS, DTS_COS_KEYS);
+	}
+	assert_int_equal(tab->dct_bits, DTX_COS_TAB_BITS_MIN);
+	assert_int_equal(tab->dct_count, 0);
+
+	/* And grows again from there. */
+	for (i = 0; i < DTS_COS_KEYS; i++) {
+		rc = dtx_cos_tab_insert(tab, &keys[i]);
+		assert_rc_equal(rc, 0);
+	}
+	assert_int_equal(tab->dct_bits, 11);
+	dts_cos_check(tab, keys, 0, DTS_COS_KEYS, DTS_COS_KEYS);
+
+	for (i = 0; i < DTS_COS_KEYS; i++)
+		dtx_cos_tab_delete(tab, &keys[i]);
+	dtx_cos_tab_destroy(tab);
+	D_FREE(keys);
+}
+
+static const struct CMUnitTest cos_tab_tests_all[] = {
+    {"DTX400: CoS index insert, lookup and delete", dts_cos_tab_basic, NULL, NULL},
+    {"DTX401: CoS index delete in a wrapped probe chain", dts_cos_tab_wrap, NULL, NULL},
+    {"DTX402: CoS index grow and shrink", dts_cos_tab_resize, NULL, NULL},
+};
+
+int
+run_cos_tab_tests(const char *cfg)
+{
+	const char *test_name = "DTX CoS index checks";
+
+	return cmocka_run_group_tests_name(test_name, cos_tab_tests_all, NULL, NULL);
+}
@@ -0,0 +1,419 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Microbenchmark of the DTX CoS index. A number of committable DTXs is added against
+ * a set of object + dkey keys, each DTX linked into an age list as the CoS cache does,
+ * then the records are looked up and eventually the DTXs are removed oldest first.
+ * Each thread has its own index, as each target has its own containers.
+ * Two indexes are measured:
+ *  - btree: the volatile dbtree keyed by dtx_cos_key that was used before.
+ *  - hash:  the open addressing dtx_cos_tab.
+ *
+ * dtx/tests/dtx_cos_perf.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <daos/common.h>
+#include <daos/btree.h>
+#include <daos/btree_class.h>
+#include <daos_srv/vos.h>
+#include "dtx_internal.h"
+#include "perf_common.h"
+
+#define PERF_BTREE_ORDER	23
+
+enum perf_mode {
+	PERF_BTREE,
+	PERF_HASH,
+	PERF_MODE_MAX,
+};
+
+static const char *perf_mode_str[] = {"btree", "hash"};
+
+struct perf_rec {
+	struct dtx_cos_key	 pr_key;
+	int			 pr_count;
+};
+
+struct perf_dtx {
+	d_list_t		 pd_age_link;
+	struct perf_rec		*pd_rec;
+};
+
+struct perf_index {
+	daos_handle_t		 pi_toh;
+	struct btr_root		 pi_root;
+	struct dtx_cos_tab	*pi_tab;
+};
+
+/* State of one thread, the phases of a run are timed separately */
+struct perf_args {
+	enum perf_mode		 pa_mode;
+	struct perf_index	 pa_idx;
+	struct perf_dtx		*pa_dtxs;
+	d_list_t		 pa_age_list;
+	uint32_t		 pa_nr_recs;
+	/* shared by all the threads, each key is used by several DTXs */
+	uint32_t		*pa_keys;
+	uint32_t		 pa_nr_dtxs;
+};
+
+static uint32_t perf_keys;
+
+static int
+perf_hkey_size(void)
+{
+	return sizeof(struct dtx_cos_key);
+}
+
+static void
+perf_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
+{
+	memcpy(hkey, key_iov->iov_buf, key_iov->iov_len);
+}
+
+static int
+perf_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
+{
+	return dbtree_key_cmp_rc(memcmp(&rec->rec_hkey[0], hkey, sizeof(struct dtx_cos_key)));
+}
+
+static int
+perf_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov, d_iov_t *val_iov,
+	       struct btr_record *rec, d_iov_t *val_out)
+{
+	rec->rec_off = umem_ptr2off(&tins->ti_umm, val_iov->iov_buf);
+	return 0;
+}
+
+static int
+perf_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
+{
+	return 0;
+}
+
+static int
+perf_rec_fetch(struct btr_instance *tins, struct btr_record *rec, d_iov_t *key_iov,
+	       d_iov_t *val_iov)
+{
+	d_iov_set(val_iov, umem_off2ptr(&tins->ti_umm, rec->rec_off), sizeof(struct perf_rec));
+	return 0;
+}
+
+static btr_ops_t perf_btr_ops = {
+	.to_hkey_size	= perf_hkey_size,
+	.to_hkey_gen	= perf_hkey_gen,
+	.to_hkey_cmp	= perf_hkey_cmp,
+	.to_rec_alloc	= perf_rec_alloc,
+	.to_rec_free	= perf_rec_free,
+	.to_rec_fetch	= perf_rec_fetch,
+};
+
+static struct perf_rec *
+perf_lookup(enum perf_mode mode, struct perf_index *idx, struct dtx_cos_key *key)
+{
+	struct dtx_cos_key	*found;
+	d_iov_t			 kiov;
+	d_iov_t			 riov;
+	int			 rc;
+
+	if (mode == PERF_HASH) {
+		found = dtx_cos_tab_lookup(idx->pi_tab, key);
+		return found != NULL ? container_of(found, struct perf_rec, pr_key) : NULL;
+	}
+
+	d_iov_set(&kiov, key, sizeof(*key));
+	d_iov_set(&riov, NULL, 0);
+	rc = dbtree_lookup(idx->pi_toh, &kiov, &riov);
+
+	return rc == 0 ? riov.iov_buf : NULL;
+}
+
+static int
+perf_insert(enum perf_mode mode, struct perf_index *idx, struct perf_rec *rec)
+{
+	d_iov_t		kiov;
+	d_iov_t		riov;
+
+	if (mode == PERF_HASH)
+		return dtx_cos_tab_insert(idx->pi_tab, &rec->pr_key);
+
+	d_iov_set(&kiov, &rec->pr_key, sizeof(rec->pr_key));
+	d_iov_set(&riov, rec, sizeof(*rec));
+
+	return dbtree_upsert(idx->pi_toh, BTR_PROBE_EQ, DAOS_INTENT_UPDATE, &kiov, &riov, NULL);
+}
+
+static int
+perf_delete(enum perf_mode mode, struct perf_index *idx, struct perf_rec *rec)
+{
+	d_iov_t		kiov;
+
+	if (mode == PERF_HASH) {
+		dtx_cos_tab_delete(idx->pi_tab, &rec->pr_key);
+		return 0;
+	}
+
+	d_iov_set(&kiov, &rec->pr_key, sizeof(rec->pr_key));
+
+	return dbtree_delete(idx->pi_toh, BTR_PROBE_EQ, &kiov, NULL);
+}
+
+static void
+perf_key(struct dtx_cos_key *key, uint32_t nr)
+{
+	memset(key, 0, sizeof(*key));
+	key->oid.id_pub.lo = nr / 16;
+	key->oid.id_pub.hi = 0x1000000000000000ULL;
+	key->dkey_hash = d_hash_murmur64((unsigned char *)&nr, sizeof(nr), 0);
+}
+
+/* dtx_cos_add: find or create the record of the key, link the DTX to the age list. */
+static int
+perf_add(void *arg, int idx, int nr)
+{
+	struct perf_args	*args = (struct perf_args *)arg + idx;
+	struct perf_rec		*rec;
+	struct dtx_cos_key	 key;
+	uint32_t		 i;
+	int			 rc;
+
+	for (i = 0; i < args->pa_nr_dtxs; i++) {
+		perf_key(&key, args->pa_keys[i]);
+		rec = perf_lookup(args->pa_mode, &args->pa_idx, &key);
+		if (rec == NULL) {
+			D_ALLOC_PTR(rec);
+			if (rec == NULL)
+				return -DER_NOMEM;
+
+			rec->pr_key = key;
+			rc = perf_insert(args->pa_mode, &args->pa_idx, rec);
+			if (rc != 0) {
+				D_FREE(rec);
+				return rc;
+			}
+			args->pa_nr_recs++;
+		}
+		rec->pr_count++;
+		args->pa_dtxs[i].pd_rec = rec;
+		d_list_add_tail(&args->pa_dtxs[i].pd_age_link, &args->pa_age_list);
+	}
+	return 0;
+}
+
+/* dtx_cos_get_piggyback/dtx_cos_prio: look up the record of some key. */
+static int
+perf_find(void *arg, int idx, int nr)
+{
+	struct perf_args	*args = (struct perf_args *)arg + idx;
+	struct dtx_cos_key	 key;
+	uint32_t		 i;
+
+	for (i = 0; i < args->pa_nr_dtxs; i++) {
+		perf_key(&key, args->pa_keys[args->pa_nr_dtxs - i - 1]);
+		if (perf_lookup(args->pa_mode, &args->pa_idx, &key) == NULL)
+			return -DER_NONEXIST;
+	}
+	return 0;
+}
+
+/* dtx_cos_oldest + dtx_cos_del: drop the oldest DTX, then its record once empty. */
+static int
+perf_del(void *arg, int idx, int nr)
+{
+	struct perf_args	*args = (struct perf_args *)arg + idx;
+	struct perf_dtx		*dtx;
+	struct perf_rec		*rec;
+	int			 rc;
+
+	while ((dtx = d_list_pop_entry(&args->pa_age_list, struct perf_dtx, pd_age_link)) !=
+	       NULL) {
+		rec = dtx->pd_rec;
+		if (--rec->pr_count == 0) {
+			rc = perf_delete(args->pa_mode, &args->pa_idx, rec);
+			D_FREE(rec);
+			if (rc != 0)
+				return rc;
+		}
+	}
+	return 0;
+}
+
+static int
+perf_args_init(struct perf_args *args, enum perf_mode mode, uint32_t *keys, uint32_t nr_dtxs)
+{
+	struct umem_attr uma = {.uma_id = UMEM_CLASS_VMEM};
+
+	args->pa_mode    = mode;
+	args->pa_keys    = keys;
+	args->pa_nr_dtxs = nr_dtxs;
+	D_INIT_LIST_HEAD(&args->pa_age_list);
+
+	D_ALLOC_ARRAY(args->pa_dtxs, nr_dtxs);
+	if (args->pa_dtxs == NULL)
+		return -DER_NOMEM;
+
+	if (mode == PERF_HASH)
+		return dtx_cos_tab_create(DTX_COS_TAB_BITS_MIN, &args->pa_idx.pi_tab);
+
+	return dbtree_create_inplace(DBTREE_CLASS_DTX_COS, 0, PERF_BTREE_ORDER, &uma,
+				     &args->pa_idx.pi_root, &args->pa_idx.pi_toh);
+}
+
+static void
+perf_args_fini(struct perf_args *args)
+{
+	struct perf_dtx *dtx;
+
+	if (args->pa_dtxs == NULL)
+		return;
+
+	while ((dtx = d_list_pop_entry(&args->pa_age_list, struct perf_dtx, pd_age_link)) !=
+	       NULL) {
+		if (--dtx->pd_rec->pr_count == 0) {
+			perf_delete(args->pa_mode, &args->pa_idx, dtx->pd_rec);
+			D_FREE(dtx->pd_rec);
+		}
+	}
+	if (args->pa_idx.pi_tab != NULL)
+		dtx_cos_tab_destroy(args->pa_idx.pi_tab);
+	else if (daos_handle_is_valid(args->pa_idx.pi_toh))
+		dbtree_destroy(args->pa_idx.pi_toh, NULL);
+	D_FREE(args->pa_dtxs);
+}
+
+static int
+perf_run_mode(enum perf_mode mode, int nr_threads, uint32_t nr_keys, uint32_t nr_dtxs,
+	      uint32_t *keys)
+{
+	struct perf_args	args[PERF_MAX_THREADS] = {0};
+	uint64_t		add_ns;
+	uint64_t		find_ns;
+	uint64_t		del_ns;
+	uint64_t		nr_recs = 0;
+	int			i;
+	int			rc = 0;
+
+	for (i = 0; i < nr_threads && rc == 0; i++)
+		rc = perf_args_init(&args[i], mode, keys, nr_dtxs);
+	if (rc != 0)
+		goto out;
+
+	rc = perf_threads_run(nr_threads, perf_add, args, &add_ns);
+	if (rc != 0)
+		goto out;
+
+	rc = perf_threads_run(nr_threads, perf_find, args, &find_ns);
+	if (rc != 0)
+		goto out;
+
+	for (i = 0; i < nr_threads; i++)
+		nr_recs += args[i].pa_nr_recs;
+
+	rc = perf_threads_run(nr_threads, perf_del, args, &del_ns);
+	if (rc != 0)
+		goto out;
+
+	printf("%-6s threads %3d keys %8u dtxs %8u (%8u records): add %7.1f ns, "
+	       "lookup %7.1f ns, del %7.1f ns\n", perf_mode_str[mode], nr_threads, nr_keys,
+	       nr_dtxs, (uint32_t)(nr_recs / nr_threads), (double)add_ns / nr_dtxs,
+	       (double)find_ns / nr_dtxs, (double)del_ns / nr_dtxs);
+out:
+	for (i = 0; i < nr_threads; i++)
+		perf_args_fini(&args[i]);
+	if (rc != 0)
+		printf("%-6s threads %3d keys %8u dtxs %8u: FAILED "DF_RC"\n", perf_mode_str[mode],
+		       nr_threads, nr_keys, nr_dtxs, DP_RC(rc));
+	return rc;
+}
+
+static int
+perf_run(int nr_threads, uint64_t per_key)
+{
+	uint32_t	 nr_keys[] = {1000, 10000, 100000, 1000000};
+	uint32_t	*keys;
+	uint32_t	 nr;
+	uint32_t	 i;
+	uint32_t	 j;
+	int		 mode;
+	int		 rc = 0;
+
+	srand(0);
+	for (i = 0; i < ARRAY_SIZE(nr_keys) && rc == 0; i++) {
+		nr = perf_keys ?: nr_keys[i];
+		if (nr * per_key > UINT32_MAX)
+			return -DER_INVAL;
+
+		/* Random order of the keys, each of them shared by @per_key DTXs. */
+		D_ALLOC_ARRAY(keys, nr * per_key);
+		if (keys == NULL)
+			return -DER_NOMEM;
+
+		for (j = 0; j < nr * per_key; j++)
+			keys[j] = rand() % nr;
+
+		for (mode = 0; mode < PERF_MODE_MAX && rc == 0; mode++)
+			rc = perf_run_mode(mode, nr_threads, nr, nr * per_key, keys);
+
+		D_FREE(keys);
+		if (perf_keys != 0)
+			break;
+	}
+	return rc;
+}
+
+static int
+perf_parse(int opt, const char *arg)
+{
+	if (opt != 'k')
+		return -DER_INVAL;
+
+	perf_keys = strtoul(arg, NULL, 0);
+	return 0;
+}
+
+static int
+perf_init(void)
+{
+	int rc;
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = dbtree_class_register(DBTREE_CLASS_DTX_COS, 0, &perf_btr_ops);
+	if (rc != 0)
+		daos_debug_fini();
+	return rc;
+}
+
+static const struct perf_opt perf_opts[] = {
+	{"keys",	'k',	"KEYS",
+	 "Number of object + dkey keys.\n"
+	 "\t\t\t\t\tDefault: 1000, 10000, 100000 and 1000000"},
+	{NULL},
+};
+
+static const int perf_threads[] = {1, 8, 0};
+
+static const struct perf_tool perf_tool = {
+	.pt_opts	= perf_opts,
+	.pt_parse	= perf_parse,
+	.pt_loops_help	= "DTXs per key",
+	.pt_loops	= 4,
+	.pt_threads	= perf_threads,
+	.pt_init	= perf_init,
+	.pt_fini	= daos_debug_fini,
+	.pt_run		= perf_run,
+};
+
+int
+main(int argc, char **argv)
+{
+	return perf_main(&perf_tool, argc, argv);
+}
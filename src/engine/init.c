@@ -731,8 +731,13 @@ metrics_region_size(int num_tgts)
 {
 	const uint64_t	est_std_metrics = 1024; /* high estimate to allow for pool links */
 	const uint64_t	est_tgt_metrics = 128; /* high estimate */
+	const uint64_t	est_tgt_hdr_histograms = 96; /* per-opcode and per-size latency */
+	const uint64_t	est_tgt_sharded = 256; /* single shard object sensors and counters */
 
-	return (est_std_metrics + est_tgt_metrics * num_tgts) * D_TM_METRIC_SIZE;
+	return (est_std_metrics + est_tgt_metrics * num_tgts) * D_TM_METRIC_SIZE +
+	       est_tgt_sharded * num_tgts * D_TM_SHARDS_SIZE(1) +
+	       est_tgt_hdr_histograms * num_tgts *
+	       D_TM_HDR_SIZE(D_TM_HDR_SUB_BITS, D_TM_HDR_MAX_BITS);
 }
 
 static int
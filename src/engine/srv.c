@@ -161,6 +161,88 @@ dss_xstream_set_affinity(struct dss_xstream *dxs)
 	return 0;
 }
 
+/** NUMA node (OS index) whose cores include \a cpus, -1 if there is none */
+static int
+dss_cpuset2numa(hwloc_const_cpuset_t cpus)
+{
+	hwloc_obj_t	numa = NULL;
+
+	while ((numa = hwloc_get_next_obj_by_type(dss_topo, HWLOC_OBJ_NUMANODE, numa)) != NULL) {
+		if (numa->cpuset != NULL && hwloc_bitmap_isincluded(cpus, numa->cpuset))
+			return numa->os_index;
+	}
+	return -1;
+}
+
+/**
+ * Prefer the NUMA node of \a cpus for the memory allocated by the calling thread, so that the
+ * state of an xstream set up before it runs (scheduler, pools, stacks) is local to it. The
+ * previous binding is returned in \a old_set and \a old_policy for dss_membind_restore().
+ */
+static bool
+dss_membind_push(hwloc_const_cpuset_t cpus, hwloc_bitmap_t old_set,
+		 hwloc_membind_policy_t *old_policy)
+{
+	int rc;
+
+	rc = hwloc_get_membind(dss_topo, old_set, old_policy, HWLOC_MEMBIND_THREAD);
+	if (rc != 0)
+		return false;
+
+	rc = hwloc_set_membind(dss_topo, cpus, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_THREAD);
+	if (rc != 0) {
+		D_DEBUG(DB_TRACE, "failed to set memory affinity: %d\n", errno);
+		return false;
+	}
+	return true;
+}
+
+static void
+dss_membind_restore(hwloc_bitmap_t old_set, hwloc_membind_policy_t old_policy)
+{
+	int rc;
+
+	rc = hwloc_set_membind(dss_topo, old_set, old_policy, HWLOC_MEMBIND_THREAD);
+	if (rc != 0)
+		D_DEBUG(DB_TRACE, "failed to restore memory affinity: %d\n", errno);
+}
+
+/** Report the placement of an xstream in the engine log and telemetry, called on the xstream */
+static void
+dss_xstream_placement_report(struct dss_xstream *dx)
+{
+	struct d_tm_node_t	*numa_node = NULL;
+	hwloc_membind_policy_t	 policy = HWLOC_MEMBIND_DEFAULT;
+	hwloc_bitmap_t		 membind;
+	char			*cpuset = NULL;
+	char			*nodeset = NULL;
+	int			 rc;
+
+	membind = hwloc_bitmap_alloc();
+	if (membind != NULL &&
+	    hwloc_get_membind(dss_topo, membind, &policy, HWLOC_MEMBIND_THREAD |
+			      HWLOC_MEMBIND_BYNODESET) == 0)
+		hwloc_bitmap_list_asprintf(&nodeset, membind);
+	hwloc_bitmap_list_asprintf(&cpuset, dx->dx_cpuset);
+
+	D_INFO("XS %s (xs_id %d, tgt_id %d): cpus %s, NUMA node %d, memory bound to nodes %s%s\n",
+	       dx->dx_name, dx->dx_xs_id, dx->dx_tgt_id, cpuset != NULL ? cpuset : "?",
+	       dx->dx_numa_node, nodeset != NULL ? nodeset : "?",
+	       policy == HWLOC_MEMBIND_BIND ? "" : " (not enforced)");
+
+	free(cpuset);
+	free(nodeset);
+	if (membind != NULL)
+		hwloc_bitmap_free(membind);
+
+	rc = d_tm_add_metric(&numa_node, D_TM_GAUGE, "NUMA node of the xstream", "",
+			     "sched/numa_node/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create numa_node telemetry: "DF_RC"\n", DP_RC(rc));
+	else
+		d_tm_set_gauge(numa_node, dx->dx_numa_node);
+}
+
 bool
 dss_xstream_exiting(struct dss_xstream *dxs)
 {
@@ -398,6 +480,9 @@ dss_srv_handler(void *arg)
 	if (rc)
 		goto signal;
 
+	dss_xstream_placement_report(dx);
+	d_tm_set_shard(dx->dx_xs_id);
+
 	d_getenv_bool(D_MEMORY_TRACK_ENV, &track_mem);
 	if (unlikely(track_mem))
 		d_set_alloc_track_cb(dss_mem_total_alloc_track, dss_mem_total_free_track,
@@ -611,7 +696,7 @@ signal:
 }
 
 static inline struct dss_xstream *
-dss_xstream_alloc(hwloc_cpuset_t cpus)
+dss_xstream_alloc(hwloc_cpuset_t cpus, int numa_node)
 {
 	struct dss_xstream	*dx;
 	int			i;
@@ -621,10 +706,11 @@ dss_xstream_alloc(hwloc_cpuset_t cpus)
 	if (dx == NULL) {
 		return NULL;
 	}
+	dx->dx_numa_node = numa_node;
 
 #ifdef ULT_MMAP_STACK
 	if (daos_ult_mmap_stack == true) {
-		rc = stack_pool_create(&dx->dx_sp);
+		rc = stack_pool_create_numa(&dx->dx_sp, numa_node);
 		if (rc != 0) {
 			D_ERROR("failed to create stack pool\n");
 			D_GOTO(err_free, rc);
@@ -742,14 +828,22 @@ dss_start_one_xstream(hwloc_cpuset_t cpus, int tag, int xs_id)
 {
 	struct dss_xstream	*dx;
 	ABT_thread_attr		attr = ABT_THREAD_ATTR_NULL;
+	hwloc_bitmap_t		old_membind;
+	hwloc_membind_policy_t	old_policy;
+	bool			membind = false;
 	int			rc = 0;
 	bool			comm; /* true to create cart ctx for RPC */
 	int			xs_offset = 0;
 
+	old_membind = hwloc_bitmap_alloc();
+	if (old_membind == NULL)
+		return -DER_NOMEM;
+	membind = dss_membind_push(cpus, old_membind, &old_policy);
+
 	/** allocate & init xstream configuration data */
-	dx = dss_xstream_alloc(cpus);
+	dx = dss_xstream_alloc(cpus, dss_cpuset2numa(cpus));
 	if (dx == NULL)
-		return -DER_NOMEM;
+		D_GOTO(out_membind, rc = -DER_NOMEM);
 
 	/* Partial XS need the RPC communication ability - system XS, each
 	 * main XS and its first offload XS (for IO dispatch).
@@ -877,7 +971,7 @@ dss_start_one_xstream(hwloc_cpuset_t cpus, int tag, int xs_id)
 		dx->dx_name, dx->dx_xs_id, dx->dx_tgt_id, dx->dx_ctx_id,
 		dx->dx_comm, dx->dx_main_xs);
 
-	return 0;
+	D_GOTO(out_membind, rc = 0);
 out_xstream:
 	if (attr != ABT_THREAD_ATTR_NULL)
 		ABT_thread_attr_free(&attr);
@@ -889,6 +983,10 @@ out_sched:
 	dss_sched_fini(dx);
 out_dx:
 	dss_xstream_free(dx);
+out_membind:
+	if (membind)
+		dss_membind_restore(old_membind, old_policy);
+	hwloc_bitmap_free(old_membind);
 	return rc;
 }
 
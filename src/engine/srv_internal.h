@@ -112,6 +112,8 @@ struct dss_xstream {
 #endif
 	bool			dx_progress_started;	/* Network poll started */
 	int                     dx_tag;                 /** tag for xstream */
+	/* NUMA node (OS index) of the cores the xstream is bound to, -1 if unknown */
+	int			dx_numa_node;
 	struct dss_chore_queue	dx_chore_queue;
 };
 
@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include <pthread.h>
+#include <sched.h>
 
 #include <sys/socket.h>
 #include <sys/time.h>
@@ -35,9 +36,11 @@
 #include <gurt/dlog.h>
 #include <gurt/common.h>
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 
 /* extra tag bytes to alloc for a pid */
 #define DLOG_TAGPAD 16
+#define DLOG_TBSIZ    1024	/* bigger than any line should be */
 
 enum {
 	/** minimum log file size is 1MB */
@@ -46,6 +49,17 @@ enum {
 	LOG_SIZE_DEF	= (1ULL << 31),
 };
 
+enum {
+	/** minimum per-thread ring size of the asynchronous writer is 16KB */
+	LOG_RING_SIZE_MIN	= (1U << 14),
+	/** default per-thread ring size of the asynchronous writer is 256KB */
+	LOG_RING_SIZE_DEF	= (1U << 18),
+	/** maximum per-thread ring size of the asynchronous writer is 64MB */
+	LOG_RING_SIZE_MAX	= (1U << 26),
+	/** how long the asynchronous writer sleeps when all rings are empty */
+	LOG_RING_IDLE_US	= 1000,
+};
+
 /**
  * internal global state
  */
@@ -106,10 +120,16 @@ static const char        *default_fac0name = "CLOG";
 /* whether we should merge log and stderr */
 static bool               merge_stderr;
 
+/*
+ * protects the lifetime of the facility array and names against the asynchronous
+ * log path, which reads them without clogmux. taken for write under clogmux.
+ */
+static pthread_rwlock_t dlog_fac_lock = PTHREAD_RWLOCK_INITIALIZER;
 #define clog_lock()   (void)pthread_mutex_lock(&clogmux)
 #define clog_unlock() (void)pthread_mutex_unlock(&clogmux)
 
 static int d_log_write(char *buf, int len, bool flush);
+static void dlog_async_stop(void);
 static const char *clog_pristr(int);
 static int clog_setnfac(int);
 
@@ -184,10 +204,12 @@ static int clog_setnfac(int n)
 		nfacs[lcv].is_enabled = true; /* enable all facs by default */
 	}
 	/* install */
+	(void)pthread_rwlock_wrlock(&dlog_fac_lock);
 	if (d_log_xst.dlog_facs)
 		free(d_log_xst.dlog_facs);
 	d_log_xst.dlog_facs = nfacs;
 	d_log_xst.fac_cnt = n;
+	(void)pthread_rwlock_unlock(&dlog_fac_lock);
 	mst.fac_alloc = try;
 	return 0;
 }
@@ -271,6 +293,8 @@ static void dlog_cleanout(void)
 	struct cache_entry	*ce;
 	int			 lcv;
 
+	dlog_async_stop();
+
 	clog_lock();
 	if (mst.log_file) {
 		if (mst.log_fd >= 0) {
@@ -504,11 +528,337 @@ d_log_write(char *msg, int len, bool flush)
 	return 0;
 }
 
+/**
+ * Asynchronous writer, enabled by D_LOG_ASYNC. d_vlog() then formats the
+ * record without clogmux and appends it to a single-producer/single-consumer
+ * ring owned by the calling thread. A background thread drains all the rings
+ * into the log buffer, so batching, flushing and rotation under clogmux happen
+ * off the logging threads. A record which does not fit in the ring is dropped
+ * and counted, the writer reports the drops in the log.
+ */
+struct dlog_ring {
+	/** link in dlog_async::da_rings */
+	d_list_t		 dr_link;
+	char			*dr_buf;
+	/** size of dr_buf, power of two */
+	uint32_t		 dr_size;
+	/** the owner thread exited, the ring is freed once drained */
+	ATOMIC bool		 dr_exited;
+	/** producer position, only advanced by the owner thread */
+	ATOMIC uint64_t		 dr_head;
+	/** consumer position, only advanced by the writer */
+	ATOMIC uint64_t		 dr_tail;
+};
+
+struct dlog_async {
+	/** rings of all the logging threads */
+	d_list_t		 da_rings;
+	/** protects da_rings and serializes the consumers of the rings */
+	pthread_mutex_t		 da_lock;
+	/** releases the ring of an exiting thread */
+	pthread_key_t		 da_key;
+	pthread_t		 da_thread;
+	/** size of the rings allocated by the logging threads */
+	uint32_t		 da_ring_size;
+	/** bumped on each start, invalidates the rings of a previous writer */
+	uint32_t		 da_gen;
+	/** the writer is running, d_vlog() goes through the rings */
+	ATOMIC bool		 da_enabled;
+	/** number of d_vlog() calls in the asynchronous path, drained before stop */
+	ATOMIC uint32_t		 da_producers;
+	ATOMIC bool		 da_stop;
+	/** number of records dropped because a ring was full */
+	ATOMIC uint64_t		 da_dropped;
+	/** value of da_dropped already reported in the log */
+	uint64_t		 da_dropped_logged;
+};
+
+static struct dlog_async dlog_async = {
+	.da_rings	= D_LIST_HEAD_INIT(dlog_async.da_rings),
+	.da_lock	= PTHREAD_MUTEX_INITIALIZER,
+};
+
+static __thread struct dlog_ring *dlog_ring_self;
+static __thread uint32_t          dlog_ring_gen;
+
+static void
+dlog_ring_copy_in(struct dlog_ring *ring, uint64_t pos, const void *src, uint32_t len)
+{
+	uint32_t off = pos & (ring->dr_size - 1);
+	uint32_t nob = min(len, ring->dr_size - off);
+
+	memcpy(&ring->dr_buf[off], src, nob);
+	memcpy(ring->dr_buf, (const char *)src + nob, len - nob);
+}
+
+static void
+dlog_ring_copy_out(struct dlog_ring *ring, uint64_t pos, void *dst, uint32_t len)
+{
+	uint32_t off = pos & (ring->dr_size - 1);
+	uint32_t nob = min(len, ring->dr_size - off);
+
+	memcpy(dst, &ring->dr_buf[off], nob);
+	memcpy((char *)dst + nob, ring->dr_buf, len - nob);
+}
+
+/* pthread key destructor, the writer frees the ring after draining it */
+static void
+dlog_ring_exit(void *arg)
+{
+	struct dlog_ring *ring = arg;
+
+	dlog_ring_self = NULL;
+	/* the ring is already released if the writer is stopped, or restarted */
+	(void)pthread_mutex_lock(&dlog_async.da_lock);
+	if (atomic_load_relaxed(&dlog_async.da_enabled) && dlog_ring_gen == dlog_async.da_gen)
+		atomic_store_release(&ring->dr_exited, true);
+	(void)pthread_mutex_unlock(&dlog_async.da_lock);
+}
+
+/*
+ * enter the asynchronous path of d_vlog(), return false if the writer is not running.
+ * dlog_async_stop() waits for the callers which entered before releasing the rings.
+ */
+static inline bool
+dlog_async_enter(void)
+{
+	if (!atomic_load_relaxed(&dlog_async.da_enabled))
+		return false;
+
+	atomic_fetch_add(&dlog_async.da_producers, 1);
+	if (atomic_load(&dlog_async.da_enabled))
+		return true;
+
+	/* raced with dlog_async_stop() */
+	atomic_fetch_sub(&dlog_async.da_producers, 1);
+	return false;
+}
+
+static inline void
+dlog_async_exit(void)
+{
+	atomic_fetch_sub(&dlog_async.da_producers, 1);
+}
+
+/* return the ring of the calling thread, allocate it on first use */
+static struct dlog_ring *
+dlog_ring_get(void)
+{
+	struct dlog_ring *ring;
+
+	if (likely(dlog_ring_self != NULL && dlog_ring_gen == dlog_async.da_gen))
+		return dlog_ring_self;
+
+	/* Note: Can't use D_* allocation macros in the log path */
+	ring = calloc(1, sizeof(*ring));
+	if (ring == NULL)
+		return NULL;
+	ring->dr_size = dlog_async.da_ring_size;
+	ring->dr_buf  = malloc(ring->dr_size);
+	if (ring->dr_buf == NULL) {
+		free(ring);
+		return NULL;
+	}
+
+	(void)pthread_mutex_lock(&dlog_async.da_lock);
+	if (!atomic_load_relaxed(&dlog_async.da_enabled)) {
+		/* raced with d_log_close() */
+		(void)pthread_mutex_unlock(&dlog_async.da_lock);
+		free(ring->dr_buf);
+		free(ring);
+		return NULL;
+	}
+	d_list_add_tail(&ring->dr_link, &dlog_async.da_rings);
+	(void)pthread_setspecific(dlog_async.da_key, ring);
+	dlog_ring_gen = dlog_async.da_gen;
+	(void)pthread_mutex_unlock(&dlog_async.da_lock);
+
+	dlog_ring_self = ring;
+	return ring;
+}
+
+/* append a formatted record to the ring of the calling thread, never blocks */
+static void
+dlog_ring_put(const char *msg, uint32_t len)
+{
+	struct dlog_ring	*ring;
+	uint64_t		 head;
+	uint64_t		 tail;
+
+	ring = dlog_ring_get();
+	if (ring == NULL)
+		goto drop;
+
+	head = atomic_load_relaxed(&ring->dr_head);
+	tail = atomic_load_explicit(&ring->dr_tail, memory_order_acquire);
+	if (head - tail + sizeof(len) + len > ring->dr_size)
+		goto drop;
+
+	dlog_ring_copy_in(ring, head, &len, sizeof(len));
+	dlog_ring_copy_in(ring, head + sizeof(len), msg, len);
+	atomic_store_release(&ring->dr_head, head + sizeof(len) + len);
+	return;
+drop:
+	atomic_fetch_add_relaxed(&dlog_async.da_dropped, 1);
+}
+
+/* move the records of @ring to the log buffer, caller holds da_lock and clogmux */
+static uint64_t
+dlog_ring_drain(struct dlog_ring *ring)
+{
+	char		buf[DLOG_TBSIZ];
+	uint64_t	head;
+	uint64_t	tail;
+	uint32_t	len;
+	uint64_t	nr = 0;
+
+	head = atomic_load_explicit(&ring->dr_head, memory_order_acquire);
+	tail = atomic_load_relaxed(&ring->dr_tail);
+	while (tail != head) {
+		dlog_ring_copy_out(ring, tail, &len, sizeof(len));
+		dlog_ring_copy_out(ring, tail + sizeof(len), buf, len);
+		tail += sizeof(len) + len;
+		/* release the space before the write, which may block on the file */
+		atomic_store_release(&ring->dr_tail, tail);
+
+		d_log_write(buf, len, false);
+		nr++;
+	}
+	return nr;
+}
+
+/**
+ * Drain the rings of all the threads into the log buffer, write the buffer to
+ * the log file if @flush is true. Return the number of drained records.
+ */
+static uint64_t
+dlog_async_drain(bool flush)
+{
+	struct dlog_ring	*ring;
+	struct dlog_ring	*tmp;
+	uint64_t		 dropped;
+	uint64_t		 nr = 0;
+	int			 log_flags;
+
+	(void)pthread_mutex_lock(&dlog_async.da_lock);
+	clog_lock();
+	d_list_for_each_entry_safe(ring, tmp, &dlog_async.da_rings, dr_link) {
+		/* check before draining, records can't be added after the exit */
+		bool exited = atomic_load_explicit(&ring->dr_exited, memory_order_acquire);
+
+		nr += dlog_ring_drain(ring);
+		if (exited) {
+			d_list_del(&ring->dr_link);
+			free(ring->dr_buf);
+			free(ring);
+		}
+	}
+	if (flush || mst.flush_pri == DLOG_DBG)
+		d_log_write(NULL, 0, true);
+	clog_unlock();
+
+	dropped = atomic_load_relaxed(&dlog_async.da_dropped) - dlog_async.da_dropped_logged;
+	dlog_async.da_dropped_logged += dropped;
+	(void)pthread_mutex_unlock(&dlog_async.da_lock);
+
+	/* logged from outside of the locks, it goes through the ring of the caller */
+	if (dropped > 0) {
+		log_flags = d_log_check(DLOG_WARN);
+		if (log_flags)
+			d_log(log_flags, "dlog: "DF_U64" messages dropped, "
+			      "asynchronous log ring full\n", dropped);
+	}
+	return nr;
+}
+
+static void *
+dlog_async_writer(void *arg)
+{
+	while (!atomic_load_relaxed(&dlog_async.da_stop)) {
+		if (dlog_async_drain(false) > 0)
+			continue;
+
+		/* nothing new, write back what is batched then idle for a while */
+		dlog_async_drain(true);
+		usleep(LOG_RING_IDLE_US);
+	}
+	return NULL;
+}
+
+static int
+dlog_async_start(uint32_t ring_size)
+{
+	int rc;
+
+	rc = pthread_key_create(&dlog_async.da_key, dlog_ring_exit);
+	if (rc != 0) {
+		fprintf(stderr, "d_log_open: failed to create ring key: %s\n", strerror(rc));
+		return -1;
+	}
+
+	dlog_async.da_ring_size      = ring_size;
+	dlog_async.da_gen++;
+	dlog_async.da_dropped_logged = atomic_load_relaxed(&dlog_async.da_dropped);
+	atomic_store_relaxed(&dlog_async.da_stop, false);
+	atomic_store_release(&dlog_async.da_enabled, true);
+
+	rc = pthread_create(&dlog_async.da_thread, NULL, dlog_async_writer, NULL);
+	if (rc != 0) {
+		fprintf(stderr, "d_log_open: failed to start log writer: %s\n", strerror(rc));
+		atomic_store_relaxed(&dlog_async.da_enabled, false);
+		(void)pthread_key_delete(dlog_async.da_key);
+		return -1;
+	}
+	return 0;
+}
+
+/* stop the writer and release all the rings, the log is written synchronously after this */
+static void
+dlog_async_stop(void)
+{
+	struct dlog_ring *ring;
+
+	if (!atomic_load_relaxed(&dlog_async.da_enabled))
+		return;
+
+	atomic_store_relaxed(&dlog_async.da_stop, true);
+	(void)pthread_join(dlog_async.da_thread, NULL);
+
+	(void)pthread_mutex_lock(&dlog_async.da_lock);
+	atomic_store(&dlog_async.da_enabled, false);
+	(void)pthread_mutex_unlock(&dlog_async.da_lock);
+
+	/* no new producer from now on, wait for the ones still appending to their rings */
+	while (atomic_load(&dlog_async.da_producers) != 0)
+		sched_yield();
+
+	/* records appended by threads which raced with the stop still get written */
+	dlog_async_drain(true);
+
+	(void)pthread_mutex_lock(&dlog_async.da_lock);
+	while ((ring = d_list_pop_entry(&dlog_async.da_rings, struct dlog_ring, dr_link))) {
+		free(ring->dr_buf);
+		free(ring);
+	}
+	(void)pthread_mutex_unlock(&dlog_async.da_lock);
+	(void)pthread_key_delete(dlog_async.da_key);
+}
+
+uint64_t
+d_log_dropped(void)
+{
+	return atomic_load_relaxed(&dlog_async.da_dropped);
+}
+
 void
 d_log_sync(void)
 {
 	int rc = 0;
 
+	/* pick up the records still sitting in the rings of the asynchronous writer */
+	if (atomic_load_relaxed(&dlog_async.da_enabled))
+		dlog_async_drain(false);
+
 	clog_lock();
 	if (mst.log_buf_nob > 0) /* write back the in-flight buffer */
 		rc = d_log_write(NULL, 0, true);
@@ -548,7 +898,9 @@ d_log_disable_logging(void)
  * we vsnprintf the message into a holding buffer to format it.  then we
  * send it to all target output logs.  the holding buffer is set to
  * DLOG_TBSIZ, if the message is too long it will be silently truncated.
- * caller should not hold clogmux, d_vlog will grab it as needed.
+ * caller should not hold clogmux, d_vlog will grab it as needed.  with the
+ * asynchronous writer the message is handed over to the ring of the calling
+ * thread and clogmux is not taken.
  *
  * @param flags returned by d_log_check
  * @param fmt the printf(3) format to use
@@ -556,7 +908,6 @@ d_log_disable_logging(void)
  */
 void d_vlog(int flags, const char *fmt, va_list ap)
 {
-#define DLOG_TBSIZ    1024	/* bigger than any line should be */
 	static __thread char b[DLOG_TBSIZ];
 	static __thread uint32_t tid = -1;
 	static __thread uint32_t pid = -1;
@@ -566,10 +917,11 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 	int fac, lvl, pri;
 	bool flush;
 	char *b_nopt1hdr;
-	char facstore[16], *facstr;
+	char facstore[32], *facstr;
 	struct timeval tv;
-	struct tm *tm;
+	struct tm tm;
 	unsigned int hlen_pt1, hlen, mlen, tlen;
+	bool async;
 	/*
 	 * since we ignore any potential errors in CLOG let's always re-set
 	 * errno to its original value
@@ -613,19 +965,35 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 
 	/*
 	 * we must log it, start computing the parts of the log we'll need.
+	 * the asynchronous writer relies on facilities being registered
+	 * before logging starts, and formats everything without the lock.
 	 */
-	clog_lock();		/* lock out other threads */
+	async = dlog_async_enter();
+	if (!async)
+		clog_lock();	/* lock out other threads */
+	else
+		(void)pthread_rwlock_rdlock(&dlog_fac_lock);
 	if (d_log_xst.dlog_facs[fac].fac_aname) {
 		facstr = d_log_xst.dlog_facs[fac].fac_aname;
 	} else {
 		snprintf(facstore, sizeof(facstore), "%d", fac);
 		facstr = facstore;
 	}
+	if (async) {
+		/* the name can be released once the lock is dropped */
+		if (facstr != facstore) {
+			snprintf(facstore, sizeof(facstore), "%s", facstr);
+			facstr = facstore;
+		}
+		(void)pthread_rwlock_unlock(&dlog_fac_lock);
+	}
 	(void)gettimeofday(&tv, 0);
-	tm = localtime(&tv.tv_sec);
-	if (tm == NULL) {
+	if (localtime_r(&tv.tv_sec, &tm) == NULL) {
 		dlog_print_err(errno, "localtime returned NULL\n");
-		clog_unlock();
+		if (!async)
+			clog_unlock();
+		else
+			dlog_async_exit();
 		return;
 	}
 
@@ -634,12 +1002,12 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 	 */
 	hlen = 0;
 	if (mst.oflags & DLOG_FLV_YEAR)
-		hlen = snprintf(b, sizeof(b), "%04d/", tm->tm_year + 1900);
+		hlen = snprintf(b, sizeof(b), "%04d/", tm.tm_year + 1900);
 
 	hlen += snprintf(b + hlen, sizeof(b) - hlen,
 			 "%02d/%02d-%02d:%02d:%02d.%02ld %s ",
-			 tm->tm_mon + 1, tm->tm_mday,
-			 tm->tm_hour, tm->tm_min, tm->tm_sec,
+			 tm.tm_mon + 1, tm.tm_mday,
+			 tm.tm_hour, tm.tm_min, tm.tm_sec,
 			 (long int)tv.tv_usec / 10000, mst.uts.nodename);
 
 	if (mst.oflags & DLOG_FLV_TAG) {
@@ -668,7 +1036,10 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 	 * check for it anyway.
 	 */
 	if (hlen + 1 >= sizeof(b)) {
-		clog_unlock();	/* drop lock, this is the only early exit */
+		if (!async)
+			clog_unlock();	/* drop lock, this is the only early exit */
+		else
+			dlog_async_exit();
 		dlog_print_err(E2BIG,
 			       "header overflowed %zd byte buffer (%d)\n",
 			       sizeof(b), hlen + 1);
@@ -705,20 +1076,26 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 
 	/* log message is ready to be dispatched, write to log file.
 	 * NB: flush to logfile if the message is important (warning/error...)
-	 * or the last flush was 1+ second ago.
+	 * or the last flush was 1+ second ago.  the asynchronous writer
+	 * batches the records and flushes whenever it catches up.
 	 */
-	if (mst.flush_pri == DLOG_DBG)
-		flush = true;
-	else
-		flush = (lvl >= mst.flush_pri) || (tv.tv_sec > last_flush);
-	if (flush)
-		last_flush = tv.tv_sec;
+	if (async) {
+		dlog_ring_put(b, tlen);
+		dlog_async_exit();
+	} else {
+		if (mst.flush_pri == DLOG_DBG)
+			flush = true;
+		else
+			flush = (lvl >= mst.flush_pri) || (tv.tv_sec > last_flush);
+		if (flush)
+			last_flush = tv.tv_sec;
 
-	rc = d_log_write(b, tlen, flush);
-	if (rc < 0)
-		errno = save_errno;
+		rc = d_log_write(b, tlen, flush);
+		if (rc < 0)
+			errno = save_errno;
 
-	clog_unlock();		/* drop lock here */
+		clog_unlock();	/* drop lock here */
+	}
 	/*
 	 * log it to stderr and/or stdout.  skip part one of the header
 	 * if the output channel is a tty
@@ -842,6 +1219,8 @@ d_log_open(char *tag, int maxfac_hint, int default_mask, int stderr_mask,
 	char		*env;
 	char		*buffer = NULL;
 	uint64_t	log_size = LOG_SIZE_DEF;
+	uint64_t	ring_size = LOG_RING_SIZE_DEF;
+	bool		async = false;
 	int		pri;
 
 	memset(&mst, 0, sizeof(mst));
@@ -870,6 +1249,23 @@ d_log_open(char *tag, int maxfac_hint, int default_mask, int stderr_mask,
 		d_freeenv_str(&env);
 	}
 
+	d_agetenv_str(&env, D_LOG_ASYNC_ENV);
+	if (env != NULL && atoi(env) > 0)
+		async = true;
+	d_freeenv_str(&env);
+
+	d_agetenv_str(&env, D_LOG_ASYNC_RING_SIZE_ENV);
+	if (env != NULL) {
+		ring_size = d_getenv_size(env);
+		if (ring_size < LOG_RING_SIZE_MIN)
+			ring_size = LOG_RING_SIZE_MIN;
+		if (ring_size > LOG_RING_SIZE_MAX)
+			ring_size = LOG_RING_SIZE_MAX;
+		/* ring positions are masked, round down to a power of two */
+		ring_size = 1ULL << (63 - __builtin_clzll(ring_size));
+		d_freeenv_str(&env);
+	}
+
 	d_agetenv_str(&env, D_LOG_FILE_APPEND_PID_ENV);
 	if (logfile != NULL && env != NULL) {
 		if (strcmp(env, "0") != 0) {
@@ -1000,6 +1396,10 @@ d_log_open(char *tag, int maxfac_hint, int default_mask, int stderr_mask,
 	d_log_xst.tag = newtag;
 	clog_unlock();
 
+	/* no point in a writer thread without a log file, stderr stays synchronous */
+	if (async && mst.log_fd >= 0 && dlog_async_start(ring_size) != 0)
+		fprintf(stderr, "d_log_open: asynchronous log writer disabled\n");
+
 	/* ensure buffer+log flush upon exit in case fini routine not
 	 * being called
 	 */
@@ -1071,6 +1471,8 @@ void d_log_close(void)
 	if (!d_log_xst.tag)
 		return;		/* return if already closed */
 
+	/* the writer may still log, stop it while the tag is valid */
+	dlog_async_stop();
 	free(d_log_xst.tag);
 	d_log_xst.tag = NULL;	/* marks us as down */
 	dlog_cleanout();
@@ -1149,6 +1551,7 @@ int d_log_namefacility(int facility, const char *aname, const char *lname)
 		goto done;
 	}
 
+	(void)pthread_rwlock_wrlock(&dlog_fac_lock);
 	if (d_log_xst.dlog_facs[facility].fac_aname &&
 	    d_log_xst.dlog_facs[facility].fac_aname != default_fac0name)
 		free(d_log_xst.dlog_facs[facility].fac_aname);
@@ -1156,6 +1559,7 @@ int d_log_namefacility(int facility, const char *aname, const char *lname)
 		free(d_log_xst.dlog_facs[facility].fac_lname);
 	d_log_xst.dlog_facs[facility].fac_aname = n;
 	d_log_xst.dlog_facs[facility].fac_lname = nl;
+	(void)pthread_rwlock_unlock(&dlog_fac_lock);
 	/* is facility enabled? */
 	if (!d_logfac_is_enabled(aname) && !d_logfac_is_enabled(lname))
 		d_log_xst.dlog_facs[facility].is_enabled = false;
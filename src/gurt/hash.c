@@ -219,7 +219,7 @@ d_hash_jump(uint64_t key, uint32_t num_buckets)
  ******************************************************************************/
 
 /**
- * Lock the hash table
+ * Lock the hash table, or the bucket (or lock stripe) of hash value \p idx
  *
  * Note: if hash table is using rwlock, it only takes read lock for
  * reference-only operations and caller should protect refcount.
@@ -234,7 +234,8 @@ ch_bucket_lock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		return;
 
 	lock = (htable->ht_feats & D_HASH_FT_GLOCK)
-		? &htable->ht_lock : &htable->ht_locks[idx];
+		? &htable->ht_lock
+		: &htable->ht_locks[idx & ((1U << htable->ht_lock_bits) - 1)];
 	if (htable->ht_feats & D_HASH_FT_MUTEX) {
 		D_MUTEX_LOCK(&lock->mutex);
 	} else if (htable->ht_feats & D_HASH_FT_RWLOCK) {
@@ -257,7 +258,8 @@ ch_bucket_unlock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		return;
 
 	lock = (htable->ht_feats & D_HASH_FT_GLOCK)
-		? &htable->ht_lock : &htable->ht_locks[idx];
+		? &htable->ht_lock
+		: &htable->ht_locks[idx & ((1U << htable->ht_lock_bits) - 1)];
 	if (htable->ht_feats & D_HASH_FT_MUTEX)
 		D_MUTEX_UNLOCK(&lock->mutex);
 	else if (htable->ht_feats & D_HASH_FT_RWLOCK)
@@ -266,6 +268,61 @@ ch_bucket_unlock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		D_SPIN_UNLOCK(&lock->spin);
 }
 
+/** take the write lock of all the buckets, in order */
+static void
+ch_lock_all(struct d_hash_table *htable)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < (1U << htable->ht_lock_bits); idx++) {
+		ch_bucket_lock(htable, idx, false);
+		if (htable->ht_feats & (D_HASH_FT_GLOCK | D_HASH_FT_NOLOCK))
+			break;
+	}
+}
+
+static void
+ch_unlock_all(struct d_hash_table *htable)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < (1U << htable->ht_lock_bits); idx++) {
+		ch_bucket_unlock(htable, idx, false);
+		if (htable->ht_feats & (D_HASH_FT_GLOCK | D_HASH_FT_NOLOCK))
+			break;
+	}
+}
+
+/**
+ * Return the bucket of hash value \p hash, caller holds the lock of the
+ * bucket. While resizing, the lock stripes which have been moved use the
+ * new buckets, the other ones still use the old buckets.
+ */
+static inline struct d_hash_bucket *
+ch_bucket(struct d_hash_table *htable, uint32_t hash)
+{
+	if (htable->ht_new_buckets != NULL &&
+	    htable->ht_moved[hash & ((1U << htable->ht_lock_bits) - 1)])
+		return &htable->ht_new_buckets[hash & ((1U << htable->ht_new_bits) - 1)];
+
+	return &htable->ht_buckets[hash & ((1U << htable->ht_bits) - 1)];
+}
+
+/** bits of the buckets used by lock stripe \p stripe, caller holds the lock */
+static inline uint32_t
+ch_stripe_bits(struct d_hash_table *htable, uint32_t stripe)
+{
+	if (htable->ht_new_buckets != NULL && htable->ht_moved[stripe])
+		return htable->ht_new_bits;
+
+	return htable->ht_bits;
+}
+
+/** iterate over the buckets covered by the lock of stripe \p stripe */
+#define ch_for_each_stripe_bucket(htable, stripe, bucket, i)				\
+	for (i = (stripe); i < (1U << ch_stripe_bits(htable, stripe)) &&		\
+	     ((bucket) = ch_bucket(htable, i)) != NULL; i += 1U << (htable)->ht_lock_bits)
+
 /**
  * wrappers for member functions.
  */
@@ -284,35 +341,28 @@ ch_key_init(struct d_hash_table *htable, d_list_t *link, void *arg)
 }
 
 /**
- * Convert key to hash bucket id.
+ * Convert key to hash value, see ch_bucket() and ch_bucket_lock() for the
+ * bucket and the lock of the key.
  *
  * It calls DJB2 hash if no customized hash function is provided.
  */
 static inline uint32_t
 ch_key_hash(struct d_hash_table *htable, const void *key, unsigned int ksize)
 {
-	uint32_t idx;
-
 	if (htable->ht_ops->hop_key_hash)
-		idx = htable->ht_ops->hop_key_hash(htable, key, ksize);
-	else
-		idx = d_hash_string_u32((const char *)key, ksize);
+		return htable->ht_ops->hop_key_hash(htable, key, ksize);
 
-	return idx & ((1U << htable->ht_bits) - 1);
+	return d_hash_string_u32((const char *)key, ksize);
 }
 
 static inline uint32_t
 ch_rec_hash(struct d_hash_table *htable, d_list_t *link)
 {
-	uint32_t idx = 0;
-
 	if (htable->ht_ops->hop_rec_hash)
-		idx = htable->ht_ops->hop_rec_hash(htable, link);
-	else
-		D_ASSERT(htable->ht_feats &
-			 (D_HASH_FT_NOLOCK | D_HASH_FT_GLOCK));
+		return htable->ht_ops->hop_rec_hash(htable, link);
 
-	return idx & ((1U << htable->ht_bits) - 1);
+	D_ASSERT(htable->ht_feats & (D_HASH_FT_NOLOCK | D_HASH_FT_GLOCK));
+	return 0;
 }
 
 static inline void
@@ -341,6 +391,8 @@ ch_rec_insert(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 	      d_list_t *link)
 {
 	d_list_add(link, &bucket->hb_head);
+	if (htable->ht_feats & D_HASH_FT_RESIZE)
+		atomic_fetch_add_relaxed(&htable->ht_rec_nr, 1);
 #if D_HASH_DEBUG
 	htable->ht_nr++;
 	if (htable->ht_nr > htable->ht_nr_max)
@@ -375,16 +427,18 @@ ch_rec_insert_addref(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 static inline void
 ch_rec_delete(struct d_hash_table *htable, d_list_t *link)
 {
-	d_list_del_init(link);
 #if D_HASH_DEBUG
 	htable->ht_nr--;
 	if (htable->ht_ops->hop_rec_hash) {
 		struct d_hash_bucket *bucket;
 
-		bucket = &htable->ht_buckets[ch_rec_hash(htable, link)];
+		bucket = ch_bucket(htable, ch_rec_hash(htable, link));
 		bucket->hb_dep--;
 	}
 #endif
+	d_list_del_init(link);
+	if (htable->ht_feats & D_HASH_FT_RESIZE)
+		atomic_fetch_sub_relaxed(&htable->ht_rec_nr, 1);
 }
 
 /**
@@ -429,6 +483,179 @@ ch_rec_find(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 	return NULL;
 }
 
+/******************************************************************************
+ * Incremental resize (D_HASH_FT_RESIZE)
+ *
+ * The key of a record always maps to the same lock stripe, whatever the size
+ * of the table, because the stripe bits are a subset of the bucket bits. So a
+ * stripe can be moved from the old to the new buckets under its own lock. The
+ * operations on the table move the stripes one by one, until all of them have
+ * been moved and the old buckets can be released. Starting and finishing a
+ * resize take all the locks, which happens a logarithmic number of times.
+ ******************************************************************************/
+
+/** the table grows when it has more than D_HASH_GROW_LOAD records per bucket */
+#define D_HASH_GROW_LOAD	2
+/** the table shrinks when it has less than 1/D_HASH_SHRINK_LOAD record per bucket */
+#define D_HASH_SHRINK_LOAD	8
+
+static int
+ch_resize_start(struct d_hash_table *htable, uint32_t bits)
+{
+	struct d_hash_bucket	*buckets;
+	bool			*moved;
+	uint32_t		 nr = 1U << bits;
+	uint32_t		 i;
+
+	D_ALLOC_ARRAY(buckets, nr);
+	if (buckets == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY(moved, 1U << htable->ht_lock_bits);
+	if (moved == NULL) {
+		D_FREE(buckets);
+		return -DER_NOMEM;
+	}
+
+	for (i = 0; i < nr; i++)
+		D_INIT_LIST_HEAD(&buckets[i].hb_head);
+
+	ch_lock_all(htable);
+	htable->ht_new_bits	= bits;
+	htable->ht_new_buckets	= buckets;
+	htable->ht_moved	= moved;
+	atomic_store_relaxed(&htable->ht_move_next, 0);
+	atomic_store_relaxed(&htable->ht_move_done, 0);
+	ch_unlock_all(htable);
+
+	D_DEBUG(DB_TRACE, "Resizing hash table %p from %u to %u buckets, %u records\n",
+		htable, 1U << htable->ht_bits, nr, atomic_load_relaxed(&htable->ht_rec_nr));
+	return 0;
+}
+
+static void
+ch_resize_finish(struct d_hash_table *htable)
+{
+	struct d_hash_bucket	*buckets;
+	bool			*moved;
+
+	ch_lock_all(htable);
+	buckets			= htable->ht_buckets;
+	moved			= htable->ht_moved;
+	htable->ht_buckets	= htable->ht_new_buckets;
+	htable->ht_bits		= htable->ht_new_bits;
+	htable->ht_new_buckets	= NULL;
+	htable->ht_moved	= NULL;
+	ch_unlock_all(htable);
+
+	atomic_store_release(&htable->ht_resizing, false);
+	D_FREE(buckets);
+	D_FREE(moved);
+}
+
+/**
+ * Move the buckets of lock stripe \p stripe to the new buckets, caller holds
+ * the lock of the stripe. Return true if all the stripes have been moved.
+ */
+static bool
+ch_stripe_move(struct d_hash_table *htable, uint32_t stripe)
+{
+	struct d_hash_bucket	*bucket;
+	struct d_hash_bucket	*new_bucket;
+	d_list_t		*link;
+	uint32_t		 nr_locks = 1U << htable->ht_lock_bits;
+	uint32_t		 idx;
+
+	if (htable->ht_new_buckets == NULL || htable->ht_moved[stripe])
+		return false;
+
+	for (idx = stripe; idx < (1U << htable->ht_bits); idx += nr_locks) {
+		bucket = &htable->ht_buckets[idx];
+		while (!d_list_empty(&bucket->hb_head)) {
+			link = bucket->hb_head.next;
+			new_bucket = &htable->ht_new_buckets[ch_rec_hash(htable, link) &
+							     ((1U << htable->ht_new_bits) - 1)];
+			/* keep the LRU order of the records */
+			d_list_move_tail(link, &new_bucket->hb_head);
+#if D_HASH_DEBUG
+			bucket->hb_dep--;
+			new_bucket->hb_dep++;
+#endif
+		}
+	}
+	htable->ht_moved[stripe] = true;
+
+	return atomic_fetch_add_relaxed(&htable->ht_move_done, 1) + 1 == nr_locks;
+}
+
+/**
+ * Called without any lock after an operation on the table: move one more lock
+ * stripe if a resize is in progress, or start a resize if the load of the
+ * table calls for it.
+ */
+static void
+ch_resize_step(struct d_hash_table *htable)
+{
+	uint32_t	stripe;
+	uint32_t	bits;
+	uint32_t	nr;
+	bool		done;
+	bool		resizing = false;
+	int		rc;
+
+	if (!(htable->ht_feats & D_HASH_FT_RESIZE))
+		return;
+
+	if (atomic_load(&htable->ht_resizing)) {
+		stripe = atomic_fetch_add_relaxed(&htable->ht_move_next, 1);
+		if (stripe >= (1U << htable->ht_lock_bits))
+			return;
+
+		ch_bucket_lock(htable, stripe, false);
+		done = ch_stripe_move(htable, stripe);
+		ch_bucket_unlock(htable, stripe, false);
+		if (done)
+			ch_resize_finish(htable);
+		return;
+	}
+
+	bits = htable->ht_bits;
+	nr   = atomic_load_relaxed(&htable->ht_rec_nr);
+	if (nr > (D_HASH_GROW_LOAD << bits) && bits < D_HASH_BITS_MAX)
+		bits++;
+	else if (nr < (1U << bits) / D_HASH_SHRINK_LOAD && bits > htable->ht_min_bits)
+		bits--;
+	else
+		return;
+
+	/* only one thread starts the resize */
+	if (!atomic_compare_exchange(&htable->ht_resizing, resizing, true))
+		return;
+
+	rc = ch_resize_start(htable, bits);
+	if (rc != 0) {
+		DL_WARN(rc, "Failed to resize hash table %p", htable);
+		atomic_store_release(&htable->ht_resizing, false);
+	}
+}
+
+/** move all the remaining lock stripes, finish the resize in progress if any */
+static void
+ch_resize_complete(struct d_hash_table *htable)
+{
+	uint32_t stripe;
+
+	if (htable->ht_new_buckets == NULL)
+		return;
+
+	for (stripe = 0; stripe < (1U << htable->ht_lock_bits); stripe++) {
+		ch_bucket_lock(htable, stripe, false);
+		ch_stripe_move(htable, stripe);
+		ch_bucket_unlock(htable, stripe, false);
+	}
+	ch_resize_finish(htable);
+}
+
 bool
 d_hash_rec_unlinked(d_list_t *link)
 {
@@ -446,15 +673,16 @@ d_hash_rec_find(struct d_hash_table *htable, const void *key,
 
 	D_ASSERT(key != NULL && ksize != 0);
 	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
 
 	ch_bucket_lock(htable, idx, !is_lru);
 
+	bucket = ch_bucket(htable, idx);
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_HEAD);
 	if (link != NULL)
 		ch_rec_addref(htable, link);
 
 	ch_bucket_unlock(htable, idx, !is_lru);
+	ch_resize_step(htable);
 	return link;
 }
 
@@ -469,10 +697,10 @@ d_hash_rec_insert(struct d_hash_table *htable, const void *key,
 
 	D_ASSERT(key != NULL && ksize != 0);
 	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
 
 	ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, idx);
 	if (exclusive) {
 		tmp = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_NONE);
 		if (tmp) {
@@ -484,6 +712,7 @@ d_hash_rec_insert(struct d_hash_table *htable, const void *key,
 
 out_unlock:
 	ch_bucket_unlock(htable, idx, false);
+	ch_resize_step(htable);
 	return rc;
 }
 
@@ -497,10 +726,10 @@ d_hash_rec_find_insert(struct d_hash_table *htable, const void *key,
 
 	D_ASSERT(key != NULL && ksize != 0);
 	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
 
 	ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, idx);
 	tmp = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_HEAD);
 	if (tmp) {
 		ch_rec_addref(htable, tmp);
@@ -511,6 +740,7 @@ d_hash_rec_find_insert(struct d_hash_table *htable, const void *key,
 
 out_unlock:
 	ch_bucket_unlock(htable, idx, false);
+	ch_resize_step(htable);
 	return link;
 }
 
@@ -520,7 +750,7 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 {
 	struct d_hash_bucket	*bucket;
 	uint32_t		 idx;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	uint32_t		 nr = 1U << htable->ht_lock_bits;
 	bool			 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 	bool			 need_keyinit_lock;
 
@@ -540,11 +770,11 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 	/* has no key, hash table should have provided key generator */
 	ch_key_init(htable, link, arg);
 	idx = ch_rec_hash(htable, link);
-	bucket = &htable->ht_buckets[idx];
 
 	if (need_lock && !need_keyinit_lock)
 		ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, idx);
 	ch_rec_insert_addref(htable, bucket, link);
 
 	if (need_lock) {
@@ -558,6 +788,7 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 			}
 		}
 	}
+	ch_resize_step(htable);
 	return 0;
 }
 
@@ -573,10 +804,10 @@ d_hash_rec_delete(struct d_hash_table *htable, const void *key,
 
 	D_ASSERT(key != NULL && ksize != 0);
 	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
 
 	ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, idx);
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_NONE);
 	if (link != NULL) {
 		zombie  = ch_rec_del_decref(htable, link);
@@ -584,6 +815,7 @@ d_hash_rec_delete(struct d_hash_table *htable, const void *key,
 	}
 
 	ch_bucket_unlock(htable, idx, false);
+	ch_resize_step(htable);
 
 	if (zombie)
 		ch_rec_free(htable, link);
@@ -610,6 +842,7 @@ d_hash_rec_delete_at(struct d_hash_table *htable, d_list_t *link)
 
 	if (need_lock)
 		ch_bucket_unlock(htable, idx, false);
+	ch_resize_step(htable);
 
 	if (zombie)
 		ch_rec_free(htable, link);
@@ -629,10 +862,10 @@ d_hash_rec_evict(struct d_hash_table *htable, const void *key,
 
 	D_ASSERT(key != NULL && ksize != 0);
 	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
 
 	ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, idx);
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_TAIL);
 
 	ch_bucket_unlock(htable, idx, false);
@@ -650,10 +883,10 @@ d_hash_rec_evict_at(struct d_hash_table *htable, d_list_t *link)
 		return false;
 
 	idx = ch_rec_hash(htable, link);
-	bucket = &htable->ht_buckets[idx];
 
 	ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, idx);
 	if (link != bucket->hb_head.prev) {
 		d_list_move_tail(link, &bucket->hb_head);
 		evicted = true;
@@ -701,6 +934,7 @@ d_hash_rec_decref(struct d_hash_table *htable, d_list_t *link)
 
 	if (need_lock)
 		ch_bucket_unlock(htable, idx, !ephemeral);
+	ch_resize_step(htable);
 
 	if (zombie)
 		ch_rec_free(htable, link);
@@ -744,6 +978,7 @@ d_hash_rec_ndecref(struct d_hash_table *htable, int count, d_list_t *link)
 
 	if (need_lock)
 		ch_bucket_unlock(htable, idx, !ephemeral);
+	ch_resize_step(htable);
 
 	if (zombie)
 		ch_rec_free(htable, link);
@@ -784,17 +1019,36 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 			    d_hash_table_ops_t *hops,
 			    struct d_hash_table *htable)
 {
-	uint32_t nr = (1 << bits);
+	uint32_t nr;
+	uint32_t nr_locks;
 	uint32_t i;
 	int	 rc = 0;
 
 	D_ASSERT(hops != NULL);
 	D_ASSERT(hops->hop_key_cmp != NULL);
 
-	htable->ht_feats = feats;
-	htable->ht_bits	 = bits;
-	htable->ht_ops	 = hops;
-	htable->ht_priv	 = priv;
+	if (feats & D_HASH_FT_RESIZE) {
+		/* records are moved by their hash, which needs hop_rec_hash */
+		if (hops->hop_rec_hash == NULL || bits > D_HASH_BITS_MAX) {
+			D_ERROR("Resizable hash table needs hop_rec_hash() and at most %u bits\n",
+				D_HASH_BITS_MAX);
+			return -DER_INVAL;
+		}
+		bits = max(bits, D_HASH_STRIPE_BITS);
+	}
+
+	htable->ht_feats	= feats;
+	htable->ht_bits		= bits;
+	htable->ht_lock_bits	= (feats & D_HASH_FT_RESIZE) ? D_HASH_STRIPE_BITS : bits;
+	htable->ht_min_bits	= bits;
+	htable->ht_ops		= hops;
+	htable->ht_priv		= priv;
+	htable->ht_new_buckets	= NULL;
+	htable->ht_moved	= NULL;
+	atomic_store_relaxed(&htable->ht_rec_nr, 0);
+	atomic_store_relaxed(&htable->ht_resizing, false);
+	nr	 = 1U << bits;
+	nr_locks = 1U << htable->ht_lock_bits;
 
 	if (hops->hop_rec_hash == NULL && !(feats & D_HASH_FT_NOLOCK)) {
 		htable->ht_feats |= D_HASH_FT_GLOCK;
@@ -824,11 +1078,11 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 		if (rc)
 			D_GOTO(free_buckets, rc);
 	} else {
-		D_ALLOC_ARRAY(htable->ht_locks, nr);
+		D_ALLOC_ARRAY(htable->ht_locks, nr_locks);
 		if (htable->ht_locks == NULL)
 			D_GOTO(free_buckets, rc = -DER_NOMEM);
 
-		for (i = 0; i < nr; i++) {
+		for (i = 0; i < nr_locks; i++) {
 			if (htable->ht_feats & D_HASH_FT_MUTEX)
 				rc = D_MUTEX_INIT(&htable->ht_locks[i].mutex,
 						  NULL);
@@ -888,8 +1142,9 @@ d_hash_table_traverse(struct d_hash_table *htable, d_hash_traverse_cb_t cb,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	uint32_t		 nr = 1U << htable->ht_lock_bits;
 	uint32_t		 idx;
+	uint32_t		 i;
 	int			 rc = 0;
 
 	if (htable->ht_buckets == NULL) {
@@ -902,13 +1157,17 @@ d_hash_table_traverse(struct d_hash_table *htable, d_hash_traverse_cb_t cb,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
+	/* w/o D_HASH_FT_RESIZE, each lock covers a single bucket */
 	for (idx = 0; idx < nr && !rc; idx++) {
 		d_list_t *linkn;
 
-		bucket = &htable->ht_buckets[idx];
 		ch_bucket_lock(htable, idx, true);
-		d_list_for_each_safe(link, linkn, &bucket->hb_head) {
-			rc = cb(link, arg);
+		ch_for_each_stripe_bucket(htable, idx, bucket, i) {
+			d_list_for_each_safe(link, linkn, &bucket->hb_head) {
+				rc = cb(link, arg);
+				if (rc)
+					break;
+			}
 			if (rc)
 				break;
 		}
@@ -921,9 +1180,11 @@ out:
 static bool
 d_hash_table_is_empty(struct d_hash_table *htable)
 {
-	uint32_t	 nr = 1U << htable->ht_bits;
-	uint32_t	 idx;
-	bool		 is_empty = true;
+	struct d_hash_bucket	*bucket;
+	uint32_t		 nr = 1U << htable->ht_lock_bits;
+	uint32_t		 idx;
+	uint32_t		 i;
+	bool			 is_empty = true;
 
 	if (htable->ht_buckets == NULL) {
 		D_ERROR("d_hash_table %p not initialized (NULL buckets).\n",
@@ -933,7 +1194,11 @@ d_hash_table_is_empty(struct d_hash_table *htable)
 
 	for (idx = 0; idx < nr && is_empty; idx++) {
 		ch_bucket_lock(htable, idx, true);
-		is_empty = d_list_empty(&htable->ht_buckets[idx].hb_head);
+		ch_for_each_stripe_bucket(htable, idx, bucket, i) {
+			is_empty = d_list_empty(&bucket->hb_head);
+			if (!is_empty)
+				break;
+		}
 		ch_bucket_unlock(htable, idx, true);
 	}
 
@@ -945,7 +1210,7 @@ int
 d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 {
 	struct d_hash_bucket	*bucket;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	uint32_t		 nr;
 	uint32_t		 i;
 	int			 rc = 0;
 
@@ -955,6 +1220,13 @@ d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 		D_GOTO(out, 0);
 	}
 
+	/* nobody else accesses the table now, finish any resize in progress */
+	ch_resize_complete(htable);
+	nr = 1U << htable->ht_bits;
+	/* don't shrink the table under the loop below */
+	if (force)
+		htable->ht_feats &= ~D_HASH_FT_RESIZE;
+
 	for (i = 0; i < nr; i++) {
 		bucket = &htable->ht_buckets[i];
 		while (!d_list_empty(&bucket->hb_head)) {
@@ -977,7 +1249,7 @@ d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 		else
 			D_SPIN_DESTROY(&htable->ht_lock.spin);
 	} else {
-		for (i = 0; i < nr; i++) {
+		for (i = 0; i < (1U << htable->ht_lock_bits); i++) {
 			if (htable->ht_feats & D_HASH_FT_MUTEX)
 				D_MUTEX_DESTROY(&htable->ht_locks[i].mutex);
 			else if (htable->ht_feats & D_HASH_FT_RWLOCK)
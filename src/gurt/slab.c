@@ -5,15 +5,24 @@
  */
 #include <stdlib.h>
 #include <string.h>
+#include <sched.h>
 
 #include <gurt/debug.h>
 #include <gurt/common.h>
 
 #include <gurt/slab.h>
 
+/* Magazine used by this thread, the same index is used for every type */
+static __thread int slab_mag_idx = -1;
+static ATOMIC int   slab_mag_next;
+
 static void
 debug_dump(struct d_slab_type *type)
 {
+	int mag_acquire = 0;
+	int mag_release = 0;
+	int i;
+
 	D_TRACE_INFO(type, "DescAlloc type %p '%s'\n", type, type->st_reg.sr_name);
 	D_TRACE_DEBUG(DB_ANY, type, "size %d offset %d", type->st_reg.sr_size,
 		      type->st_reg.sr_offset);
@@ -24,6 +33,98 @@ debug_dump(struct d_slab_type *type)
 	D_TRACE_DEBUG(DB_ANY, type, "OP: init %d reset %d", type->st_op_init, type->st_op_reset);
 	D_TRACE_DEBUG(DB_ANY, type, "No restock: current %d hwm %d", type->st_no_restock,
 		      type->st_no_restock_hwm);
+
+	if (type->st_mags == NULL)
+		return;
+
+	for (i = 0; i < D_SLAB_MAG_NR; i++) {
+		mag_acquire += type->st_mags[i].sm_acquire_count;
+		mag_release += type->st_mags[i].sm_release_count;
+	}
+	D_TRACE_DEBUG(DB_ANY, type, "Magazine: acquire %d release %d busy %d", mag_acquire,
+		      mag_release, type->st_mag_busy);
+	D_TRACE_DEBUG(DB_ANY, type, "Depot: hit %d miss %d flush %d", type->st_depot_hit,
+		      type->st_depot_miss, type->st_depot_flush);
+}
+
+/* Try to take the calling thread's magazine for a type.
+ *
+ * Returns NULL if the type has no magazines or if another thread sharing the
+ * same index is using it, in which case the caller should use the depot.
+ */
+static struct d_slab_mag *
+mag_get(struct d_slab_type *type)
+{
+	struct d_slab_mag *mag;
+
+	if (type->st_mags == NULL)
+		return NULL;
+
+	if (unlikely(slab_mag_idx < 0))
+		slab_mag_idx = atomic_fetch_add_relaxed(&slab_mag_next, 1) % D_SLAB_MAG_NR;
+
+	mag = &type->st_mags[slab_mag_idx];
+	if (atomic_exchange_explicit(&mag->sm_busy, true, memory_order_acquire))
+		return NULL;
+	return mag;
+}
+
+static void
+mag_put(struct d_slab_mag *mag)
+{
+	atomic_store_release(&mag->sm_busy, false);
+}
+
+/* Return the pending stack of a magazine to the depot.
+ *
+ * This function should be called with the type lock held.
+ */
+static void
+mag_flush(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	int i;
+
+	if (mag->sm_pending_count == 0)
+		return;
+
+	for (i = 0; i < mag->sm_pending_count; i++)
+		d_list_add_tail(mag->sm_pending[i] + type->st_reg.sr_offset,
+				&type->st_pending_list);
+	type->st_pending_count += mag->sm_pending_count;
+	mag->sm_pending_count = 0;
+	type->st_depot_flush++;
+}
+
+/* Return all objects cached in magazines to the depot.
+ *
+ * Waits for threads using the magazines so must be called without the type
+ * lock held.
+ */
+static void
+mag_drain(struct d_slab_type *type)
+{
+	int i;
+
+	if (type->st_mags == NULL)
+		return;
+
+	for (i = 0; i < D_SLAB_MAG_NR; i++) {
+		struct d_slab_mag *mag = &type->st_mags[i];
+
+		while (atomic_exchange_explicit(&mag->sm_busy, true, memory_order_acquire))
+			sched_yield();
+
+		D_MUTEX_LOCK(&type->st_lock);
+		mag_flush(type, mag);
+		while (mag->sm_free_count > 0) {
+			void *ptr = mag->sm_free[--mag->sm_free_count];
+
+			d_list_add(ptr + type->st_reg.sr_offset, &type->st_free_list);
+			type->st_free_count++;
+		}
+		D_MUTEX_UNLOCK(&type->st_lock);
+		mag_put(mag);
+	}
 }
 
 /* Create a data slab manager */
@@ -70,6 +171,7 @@ d_slab_destroy(struct d_slab *slab)
 		rc = pthread_mutex_destroy(&type->st_lock);
 		if (rc != 0)
 			D_TRACE_ERROR(type, "Failed to destroy lock %d %s\n", rc, strerror(rc));
+		D_FREE(type->st_mags);
 		D_FREE(type);
 	}
 	rc = pthread_mutex_destroy(&slab->slab_lock);
@@ -151,6 +253,8 @@ d_slab_reclaim(struct d_slab *slab)
 
 		D_TRACE_DEBUG(DB_ANY, type, "Resetting type");
 
+		mag_drain(type);
+
 		D_MUTEX_LOCK(&type->st_lock);
 
 		/* Reclaim any pending objects.  Count here just needs to be
@@ -271,6 +375,17 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d
 	type->st_reg   = *reg;
 	type->st_arg   = arg;
 
+	/* Magazines could hold objects back from a thread hitting max_desc */
+	if (!reg->sr_no_mag && !reg->sr_max_desc) {
+		D_ALIGNED_ALLOC(type->st_mags, __alignof__(struct d_slab_mag),
+				sizeof(*type->st_mags) * D_SLAB_MAG_NR);
+		if (!type->st_mags) {
+			D_MUTEX_DESTROY(&type->st_lock);
+			D_FREE(type);
+			return -DER_NOMEM;
+		}
+	}
+
 	create_many(type);
 	create_many(type);
 
@@ -286,6 +401,7 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d
 		 * test.
 		 */
 		D_MUTEX_DESTROY(&type->st_lock);
+		D_FREE(type->st_mags);
 		D_FREE(type);
 		return -DER_INVAL;
 	}
@@ -301,18 +417,32 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d
 /* Acquire a new object.
  *
  * This is to be considered on the critical path so should be as lightweight
- * as posslble.
+ * as posslble.  Objects are taken from the thread's magazine without locking
+ * where possible, an empty magazine is refilled with up to D_SLAB_MAG_BATCH
+ * objects from the free list.
  */
 void *
 d_slab_acquire(struct d_slab_type *type)
 {
-	void     *ptr = NULL;
-	d_list_t *entry;
-	bool      at_limit = false;
+	struct d_slab_mag *mag;
+	void              *ptr = NULL;
+	d_list_t          *entry;
+	bool               at_limit = false;
+
+	mag = mag_get(type);
+	if (mag && mag->sm_free_count > 0) {
+		ptr = mag->sm_free[--mag->sm_free_count];
+		mag->sm_acquire_count++;
+		mag_put(mag);
+		D_TRACE_DEBUG(DB_ANY, type, "Using %p", ptr);
+		return ptr;
+	}
 
 	D_MUTEX_LOCK(&type->st_lock);
 
 	type->st_no_restock++;
+	if (type->st_mags && !mag)
+		type->st_mag_busy++;
 
 	if (type->st_free_count == 0) {
 		int count = restock(type, 1);
@@ -327,7 +457,23 @@ d_slab_acquire(struct d_slab_type *type)
 		entry->prev = NULL;
 		type->st_free_count--;
 		ptr = (void *)entry - type->st_reg.sr_offset;
+
+		if (mag) {
+			type->st_depot_hit++;
+			/* Count the refill as acquires so restock() keeps enough objects */
+			while (mag->sm_free_count < D_SLAB_MAG_BATCH &&
+			       !d_list_empty(&type->st_free_list)) {
+				entry = type->st_free_list.next;
+				d_list_del(entry);
+				type->st_free_count--;
+				type->st_no_restock++;
+				mag->sm_free[mag->sm_free_count++] =
+				    (void *)entry - type->st_reg.sr_offset;
+			}
+		}
 	} else {
+		if (mag)
+			type->st_depot_miss++;
 		if (!type->st_reg.sr_max_desc || type->st_count < type->st_reg.sr_max_desc) {
 			type->st_op_init++;
 			ptr = create(type);
@@ -338,6 +484,9 @@ d_slab_acquire(struct d_slab_type *type)
 
 	D_MUTEX_UNLOCK(&type->st_lock);
 
+	if (mag)
+		mag_put(mag);
+
 	if (ptr)
 		D_TRACE_DEBUG(DB_ANY, type, "Using %p", ptr);
 	else if (at_limit)
@@ -356,9 +505,25 @@ d_slab_acquire(struct d_slab_type *type)
 void
 d_slab_release(struct d_slab_type *type, void *ptr)
 {
-	d_list_t *entry = ptr + type->st_reg.sr_offset;
+	struct d_slab_mag *mag;
+	d_list_t          *entry = ptr + type->st_reg.sr_offset;
+
+	mag = mag_get(type);
+	if (mag) {
+		if (mag->sm_pending_count == D_SLAB_MAG_SIZE) {
+			D_MUTEX_LOCK(&type->st_lock);
+			mag_flush(type, mag);
+			D_MUTEX_UNLOCK(&type->st_lock);
+		}
+		mag->sm_pending[mag->sm_pending_count++] = ptr;
+		mag->sm_release_count++;
+		mag_put(mag);
+		return;
+	}
 
 	D_MUTEX_LOCK(&type->st_lock);
+	if (type->st_mags)
+		type->st_mag_busy++;
 	type->st_pending_count++;
 	d_list_add_tail(entry, &type->st_pending_list);
 	D_MUTEX_UNLOCK(&type->st_lock);
@@ -378,11 +543,19 @@ d_slab_release(struct d_slab_type *type, void *ptr)
 void
 d_slab_restock(struct d_slab_type *type)
 {
+	struct d_slab_mag *mag;
+
 	D_TRACE_DEBUG(DB_ANY, type, "Count (%d/%d/%d)", type->st_pending_count, type->st_free_count,
 		      type->st_count);
 
+	/* Objects released by this thread are made available for reset */
+	mag = mag_get(type);
+
 	D_MUTEX_LOCK(&type->st_lock);
 
+	if (mag)
+		mag_flush(type, mag);
+
 	/* Update restock hwm metrics */
 	if (type->st_no_restock > type->st_no_restock_hwm)
 		type->st_no_restock_hwm = type->st_no_restock;
@@ -395,4 +568,7 @@ d_slab_restock(struct d_slab_type *type)
 		create_many(type);
 
 	D_MUTEX_UNLOCK(&type->st_lock);
+
+	if (mag)
+		mag_put(mag);
 }
@@ -84,10 +84,16 @@ static struct d_tm_shmem {
 	int			 id; /** Instance ID */
 } tm_shmem;
 
+/** Shard of the sharded metrics the calling thread updates, -1 until assigned */
+static __thread int	tm_shard_id = -1;
+/** Next shard handed out to a thread that did not pick one with d_tm_set_shard() */
+static _Atomic int	tm_shard_next;
+
 /* Internal helper functions */
 static int allocate_shared_memory(int srv_idx, size_t mem_size,
 				  struct d_tm_shmem_hdr **shmem);
 static void *shmalloc(struct d_tm_shmem_hdr *region, int length);
+static void *shmalloc_aligned(struct d_tm_shmem_hdr *region, int length, int align);
 static bool validate_shmem_ptr(struct d_tm_shmem_hdr *shmem_root,
 			       void *ptr);
 static void *conv_ptr(struct d_tm_shmem_hdr *shmem_root, void *ptr);
@@ -1314,6 +1320,28 @@ d_tm_print_metadata(char *desc, char *units, int format, FILE *stream)
 static int
 d_tm_get_meminfo(struct d_tm_context *ctx, struct d_tm_meminfo_t *meminfo,
 		 struct d_tm_node_t *node);
+
+/** Print the main percentiles of the log-linear histogram of \a node, if any */
+static void
+d_tm_print_percentiles(struct d_tm_context *ctx, struct d_tm_node_t *node, int format,
+		       FILE *stream)
+{
+	static const double	percentiles[] = {50, 99, 99.9};
+	uint64_t		val;
+	int			i;
+
+	/** not printed in CSV, to keep the same columns for all the gauges */
+	if (format != D_TM_STANDARD)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(percentiles); i++) {
+		if (d_tm_get_percentile(ctx, &val, percentiles[i], node) != DER_SUCCESS)
+			return;
+		fprintf(stream, "%sp%g: " DF_U64, i == 0 ? " [" : ", ", percentiles[i], val);
+	}
+	fprintf(stream, "]");
+}
+
 /**
  * Prints a single \a node.
  * Used as a convenience function to demonstrate usage for the client
@@ -1447,6 +1475,7 @@ d_tm_print_node(struct d_tm_context *ctx, struct d_tm_node_t *node, int level,
 		}
 		d_tm_print_duration(&tms, &stats, name, node->dtn_type, format,
 				    opt_fields, stream);
+		d_tm_print_percentiles(ctx, node, format, stream);
 		if (stats.sample_size > 0)
 			stats_printed = true;
 		break;
@@ -1459,6 +1488,7 @@ d_tm_print_node(struct d_tm_context *ctx, struct d_tm_node_t *node, int level,
 		}
 		d_tm_print_gauge(val, &stats, name, format, units, opt_fields,
 				 stream);
+		d_tm_print_percentiles(ctx, node, format, stream);
 		if (stats.sample_size > 0)
 			stats_printed = true;
 		break;
@@ -1551,6 +1581,21 @@ d_tm_print_stats(FILE *stream, struct d_tm_stats_t *stats, int format)
 	fprintf(stream, ", samples: %lu]", stats->sample_size);
 }
 
+static void
+shards_reset(struct d_tm_shard_t *shards, int shard_nr)
+{
+	int i;
+
+	for (i = 0; i < shard_nr; i++) {
+		atomic_store_relaxed(&shards[i].dts_value, 0);
+		atomic_store_relaxed(&shards[i].dts_min, UINT64_MAX);
+		atomic_store_relaxed(&shards[i].dts_max, 0);
+		atomic_store_relaxed(&shards[i].dts_sum, 0);
+		atomic_store_relaxed(&shards[i].dts_sum_of_squares, 0);
+		atomic_store_relaxed(&shards[i].dts_sample_size, 0);
+	}
+}
+
 static int
 _reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node)
 {
@@ -1578,6 +1623,25 @@ _reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node)
 	if (dtm_stats != NULL)
 		memset(dtm_stats, 0, sizeof(*dtm_stats));
 
+	if (metric_data->dtm_shards != NULL) {
+		struct d_tm_shard_t *shards = conv_ptr(shmem, metric_data->dtm_shards);
+
+		if (shards != NULL)
+			shards_reset(shards, metric_data->dtm_shard_nr);
+	}
+
+	if (metric_data->dtm_hdr != NULL) {
+		struct d_tm_hdr_histogram_t	*hdr = conv_ptr(shmem, metric_data->dtm_hdr);
+		_Atomic uint64_t		*counts;
+		int				 i;
+
+		counts = hdr != NULL ? conv_ptr(shmem, hdr->dhh_counts) : NULL;
+		for (i = 0; counts != NULL && i < hdr->dhh_bucket_nr; i++)
+			atomic_store_relaxed(&counts[i], 0);
+		if (hdr != NULL)
+			atomic_store_relaxed(&hdr->dhh_max, 0);
+	}
+
 	if (dtm_histogram != NULL) {
 		int i;
 
@@ -1815,6 +1879,55 @@ d_tm_compute_stats(struct d_tm_node_t *node, uint64_t value)
 		dtm_stats->dtm_min = value;
 }
 
+static inline int
+hdr_bucket(struct d_tm_hdr_histogram_t *hdr, uint64_t value)
+{
+	int	sub_bits = hdr->dhh_sub_bits;
+	int	msb;
+
+	if (value < (1ULL << sub_bits))
+		return value;
+
+	if (value >> hdr->dhh_max_bits)
+		return hdr->dhh_bucket_nr - 1;
+
+	msb = 63 - __builtin_clzll(value);
+	return ((msb - sub_bits + 1) << sub_bits) +
+	       (int)((value >> (msb - sub_bits)) - (1ULL << sub_bits));
+}
+
+/** Highest value counted in bucket \a idx */
+static uint64_t
+hdr_bucket_max(int sub_bits, int idx)
+{
+	int		group = idx >> sub_bits;
+	uint64_t	sub = idx & ((1 << sub_bits) - 1);
+
+	if (group == 0)
+		return idx;
+
+	return (((1ULL << sub_bits) + sub + 1) << (group - 1)) - 1;
+}
+
+/*
+ * Count \a value in the log-linear histogram of \a node, if any. Its buckets
+ * and maximum are atomics, so it is called after the node lock is dropped.
+ */
+static void
+d_tm_compute_hdr(struct d_tm_node_t *node, uint64_t value)
+{
+	struct d_tm_hdr_histogram_t	*hdr = node->dtn_metric->dtm_hdr;
+	uint64_t			 max;
+
+	if (hdr == NULL)
+		return;
+
+	max = atomic_load_relaxed(&hdr->dhh_max);
+	atomic_fetch_add_relaxed(&hdr->dhh_counts[hdr_bucket(hdr, value)], 1);
+	while (value > max && !atomic_compare_exchange(&hdr->dhh_max, max, value))
+		;
+}
+
 /**
  * Computes the histogram for this metric by finding the bucket that corresponds
  * to the \a value given, and increments the counter for that bucket.
@@ -1843,6 +1956,86 @@ d_tm_compute_histogram(struct d_tm_node_t *node, uint64_t value)
 	}
 }
 
+/**
+ * Select the shard of the sharded metrics updated by the calling thread. Threads that do not
+ * call this get one assigned round-robin on their first update. Writers using distinct shards
+ * (modulo the shard count of a metric) never contend on the same cache line.
+ *
+ * \param[in]	shard	Shard index, typically the xstream or thread index of the caller
+ */
+void
+d_tm_set_shard(int shard)
+{
+	tm_shard_id = shard;
+}
+
+static inline _Atomic uint64_t *
+shard_self(struct d_tm_metric_t *metric)
+{
+	if (unlikely(tm_shard_id < 0))
+		tm_shard_id = atomic_fetch_add_relaxed(&tm_shard_next, 1) & INT_MAX;
+
+	return &metric->dtm_shards[tm_shard_id % metric->dtm_shard_nr].dts_value;
+}
+
+static uint64_t
+shards_sum(struct d_tm_shard_t *shards, int shard_nr)
+{
+	uint64_t	sum = 0;
+	int		i;
+
+	for (i = 0; i < shard_nr; i++)
+		sum += atomic_load_relaxed(&shards[i].dts_value);
+
+	return sum;
+}
+
+/* Per-shard counterpart of d_tm_compute_stats(), merged by d_tm_get_gauge() */
+static void
+shard_compute_stats(_Atomic uint64_t *slot, uint64_t value)
+{
+	struct d_tm_shard_t	*shard = container_of(slot, struct d_tm_shard_t, dts_value);
+	uint64_t		 cur;
+
+	atomic_fetch_add_relaxed(&shard->dts_sample_size, 1);
+	atomic_fetch_add_relaxed(&shard->dts_sum, value);
+	atomic_fetch_add_relaxed(&shard->dts_sum_of_squares, value * value);
+
+	cur = atomic_load_relaxed(&shard->dts_max);
+	while (value > cur && !atomic_compare_exchange(&shard->dts_max, cur, value))
+		;
+	cur = atomic_load_relaxed(&shard->dts_min);
+	while (value < cur && !atomic_compare_exchange(&shard->dts_min, cur, value))
+		;
+}
+
+static void
+shards_stats(struct d_tm_shard_t *shards, int shard_nr, struct d_tm_stats_t *stats)
+{
+	uint64_t	min = UINT64_MAX;
+	uint64_t	nr;
+	int		i;
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < shard_nr; i++) {
+		nr = atomic_load_relaxed(&shards[i].dts_sample_size);
+		if (nr == 0)
+			continue;
+		stats->sample_size += nr;
+		stats->dtm_sum += atomic_load_relaxed(&shards[i].dts_sum);
+		stats->sum_of_squares += atomic_load_relaxed(&shards[i].dts_sum_of_squares);
+		stats->dtm_max = max(stats->dtm_max, atomic_load_relaxed(&shards[i].dts_max));
+		min = min(min, atomic_load_relaxed(&shards[i].dts_min));
+	}
+	if (stats->sample_size == 0)
+		return;
+
+	stats->dtm_min = min;
+	stats->mean = (double)stats->dtm_sum / stats->sample_size;
+	stats->std_dev = d_tm_compute_standard_dev(stats->sum_of_squares, stats->sample_size,
+						   stats->mean);
+}
+
 /**
  * Set the given counter to the specified \a value
  *
@@ -1861,6 +2054,17 @@ d_tm_set_counter(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		struct d_tm_metric_t	*data = metric->dtn_metric;
+		int			 i;
+
+		/** not atomic with respect to concurrent increments from other shards */
+		for (i = 0; i < data->dtm_shard_nr; i++)
+			atomic_store_relaxed(&data->dtm_shards[i].dts_value, 0);
+		atomic_store_relaxed(shard_self(data), value);
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value = value;
 	d_tm_node_unlock(metric);
@@ -1884,6 +2088,11 @@ d_tm_inc_counter(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		atomic_fetch_add_relaxed(shard_self(metric->dtn_metric), value);
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value += value;
 	d_tm_node_unlock(metric);
@@ -2033,6 +2242,7 @@ d_tm_mark_duration_end(struct d_tm_node_t *metric)
 	d_tm_compute_stats(metric, us);
 	d_tm_compute_histogram(metric, us);
 	d_tm_node_unlock(metric);
+	d_tm_compute_hdr(metric, us);
 }
 
 static bool
@@ -2074,6 +2284,17 @@ d_tm_set_gauge(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		_Atomic uint64_t *slot = shard_self(metric->dtn_metric);
+
+		atomic_store_relaxed(slot, value);
+		if (has_stats(metric)) {
+			shard_compute_stats(slot, value);
+			d_tm_compute_hdr(metric, value);
+		}
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value = value;
 	if (has_stats(metric)) {
@@ -2081,6 +2302,8 @@ d_tm_set_gauge(struct d_tm_node_t *metric, uint64_t value)
 		d_tm_compute_histogram(metric, value);
 	}
 	d_tm_node_unlock(metric);
+	if (has_stats(metric))
+		d_tm_compute_hdr(metric, value);
 }
 
 /**
@@ -2102,6 +2325,18 @@ d_tm_inc_gauge(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		_Atomic uint64_t *slot = shard_self(metric->dtn_metric);
+		uint64_t	  cur;
+
+		cur = atomic_fetch_add_relaxed(slot, value) + value;
+		if (has_stats(metric)) {
+			shard_compute_stats(slot, cur);
+			d_tm_compute_hdr(metric, value);
+		}
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value += value;
 	if (has_stats(metric)) {
@@ -2109,6 +2344,8 @@ d_tm_inc_gauge(struct d_tm_node_t *metric, uint64_t value)
 		d_tm_compute_histogram(metric, value);
 	}
 	d_tm_node_unlock(metric);
+	if (has_stats(metric))
+		d_tm_compute_hdr(metric, value);
 }
 
 /**
@@ -2130,6 +2367,18 @@ d_tm_dec_gauge(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		_Atomic uint64_t *slot = shard_self(metric->dtn_metric);
+		uint64_t	  cur;
+
+		cur = atomic_fetch_sub_relaxed(slot, value) - value;
+		if (has_stats(metric)) {
+			shard_compute_stats(slot, cur);
+			d_tm_compute_hdr(metric, value);
+		}
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value -= value;
 	if (has_stats(metric)) {
@@ -2137,6 +2386,8 @@ d_tm_dec_gauge(struct d_tm_node_t *metric, uint64_t value)
 		d_tm_compute_histogram(metric, value);
 	}
 	d_tm_node_unlock(metric);
+	if (has_stats(metric))
+		d_tm_compute_hdr(metric, value);
 }
 
 /**
@@ -2264,7 +2515,7 @@ get_last_token(const char *path)
 
 static int
 add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
-	   char *desc, char *units, char *path)
+	   int nr_shards, char *desc, char *units, char *path)
 {
 	pthread_mutexattr_t	mattr;
 	struct d_tm_node_t	*parent_node;
@@ -2314,7 +2565,7 @@ add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
 
 	metric            = conv_ptr(shmem, temp->dtn_metric);
 	metric->dtm_stats = NULL;
-	if (has_stats(temp)) {
+	if (has_stats(temp) && nr_shards == 0) {
 		metric->dtm_stats = shmalloc(shmem, sizeof(struct d_tm_stats_t));
 		if (metric->dtm_stats == NULL) {
 			rc = -DER_NO_SHMEM;
@@ -2322,6 +2573,19 @@ add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
 		}
 	}
 
+	metric->dtm_shards   = NULL;
+	metric->dtm_shard_nr = 0;
+	if (nr_shards > 0) {
+		metric->dtm_shards = shmalloc_aligned(shmem, nr_shards * sizeof(struct d_tm_shard_t),
+						      D_TM_SHARD_ALIGN);
+		if (metric->dtm_shards == NULL) {
+			rc = -DER_NO_SHMEM;
+			goto out;
+		}
+		metric->dtm_shard_nr = nr_shards;
+		shards_reset(conv_ptr(shmem, metric->dtm_shards), nr_shards);
+	}
+
 	buff_len = 0;
 	if (desc != NULL)
 		buff_len = strnlen(desc, D_TM_MAX_DESC_LEN);
@@ -2384,8 +2648,9 @@ add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
 		metric->dtm_units = NULL;
 	}
 
+	/** sharded metrics are updated and read without the node lock */
 	temp->dtn_protect = false;
-	if (tm_shmem.sync_access &&
+	if (tm_shmem.sync_access && nr_shards == 0 &&
 	    (temp->dtn_type != D_TM_DIRECTORY)) {
 		rc = pthread_mutexattr_init(&mattr);
 		if (rc != 0) {
@@ -2421,42 +2686,13 @@ out:
 	return rc;
 }
 
-/**
- * Adds a new metric at the specified path, with the given \a metric_type.
- * An optional description and unit name may be added at this time.
- * This function may be called by the developer to initialize a metric at init
- * time in order to avoid the overhead of creating the metric at a more
- * critical time.
- *
- * \param[out]	node		Points to the new metric if supplied
- * \param[in]	metric_type	One of the corresponding d_tm_metric_types
- * \param[in]	desc		A description of the metric containing
- *				D_TM_MAX_DESC_LEN - 1 characters maximum
- * \param[in]	units		A string defining the units of the metric
- *				containing D_TM_UNIT_LEN - 1 characters maximum
- * \param[in]	fmt		Format specifier for the name and full path of
- *				the new metric followed by optional args to
- *				populate the string, printf style.
- * \return			DER_SUCCESS		Success
- *				-DER_NO_SHMEM		Out of shared memory
- *				-DER_NOMEM		Out of global heap
- *				-DER_EXCEEDS_PATH_LEN	node name exceeds
- *							path len or \a units
- *							exceeds length
- *				-DER_INVAL		node is invalid or
- *							invalid units were
- *							specified for the metric
- *							type
- *				-DER_ADD_METRIC_FAILED	Operation failed
- *				-DER_UNINIT		API not initialized
- */
-int d_tm_add_metric(struct d_tm_node_t **node, int metric_type, char *desc,
-		    char *units, const char *fmt, ...)
+static int
+add_metric_fmt(struct d_tm_node_t **node, int metric_type, int nr_shards, char *desc,
+	       char *units, const char *fmt, va_list args)
 {
 	struct d_tm_node_t	*tmp_node = NULL;
 	char			 path[D_TM_MAX_NAME_LEN] = {};
 	int			 rc;
-	va_list			 args;
 
 	if (!is_initialized())
 		return -DER_UNINIT;
@@ -2464,9 +2700,7 @@ int d_tm_add_metric(struct d_tm_node_t **node, int metric_type, char *desc,
 	if (fmt == NULL)
 		return -DER_INVAL;
 
-	va_start(args, fmt);
 	rc = parse_path_fmt(path, sizeof(path), fmt, args);
-	va_end(args);
 	if (rc != 0)
 		goto failure;
 
@@ -2490,7 +2724,7 @@ int d_tm_add_metric(struct d_tm_node_t **node, int metric_type, char *desc,
 		return DER_SUCCESS;
 	}
 
-	rc = add_metric(tm_shmem.ctx, node, metric_type, desc, units, path);
+	rc = add_metric(tm_shmem.ctx, node, metric_type, nr_shards, desc, units, path);
 	if (rc != 0)
 		D_GOTO(failure, rc);
 
@@ -2504,6 +2738,95 @@ failure:
 	return rc;
 }
 
+/**
+ * Adds a new metric at the specified path, with the given \a metric_type.
+ * An optional description and unit name may be added at this time.
+ * This function may be called by the developer to initialize a metric at init
+ * time in order to avoid the overhead of creating the metric at a more
+ * critical time.
+ *
+ * \param[out]	node		Points to the new metric if supplied
+ * \param[in]	metric_type	One of the corresponding d_tm_metric_types
+ * \param[in]	desc		A description of the metric containing
+ *				D_TM_MAX_DESC_LEN - 1 characters maximum
+ * \param[in]	units		A string defining the units of the metric
+ *				containing D_TM_UNIT_LEN - 1 characters maximum
+ * \param[in]	fmt		Format specifier for the name and full path of
+ *				the new metric followed by optional args to
+ *				populate the string, printf style.
+ * \return			DER_SUCCESS		Success
+ *				-DER_NO_SHMEM		Out of shared memory
+ *				-DER_NOMEM		Out of global heap
+ *				-DER_EXCEEDS_PATH_LEN	node name exceeds
+ *							path len or \a units
+ *							exceeds length
+ *				-DER_INVAL		node is invalid or
+ *							invalid units were
+ *							specified for the metric
+ *							type
+ *				-DER_ADD_METRIC_FAILED	Operation failed
+ *				-DER_UNINIT		API not initialized
+ */
+int d_tm_add_metric(struct d_tm_node_t **node, int metric_type, char *desc,
+		    char *units, const char *fmt, ...)
+{
+	va_list	args;
+	int	rc;
+
+	va_start(args, fmt);
+	rc = add_metric_fmt(node, metric_type, 0, desc, units, fmt, args);
+	va_end(args);
+
+	return rc;
+}
+
+/**
+ * Adds a new sharded counter or gauge at the specified path. A sharded metric
+ * holds one cache line padded slot per shard: writers update the slot of
+ * their shard (see d_tm_set_shard()) with a relaxed atomic operation, without
+ * taking the node lock, and readers report the sum of all the slots. The
+ * value of a sharded gauge is thus the sum of the values set by each shard.
+ * The statistics of a sharded D_TM_STATS_GAUGE are kept per shard, over the
+ * values of the shard, and merged by d_tm_get_gauge(). Sharded metrics support
+ * d_tm_init_hdr_histogram() but not d_tm_init_histogram().
+ *
+ * \param[out]	node		Points to the new metric if supplied
+ * \param[in]	metric_type	D_TM_COUNTER, D_TM_GAUGE or D_TM_STATS_GAUGE
+ * \param[in]	nr_shards	Number of shards, typically the number of
+ *				writer threads, at most D_TM_SHARDS_MAX
+ * \param[in]	desc		A description of the metric containing
+ *				D_TM_MAX_DESC_LEN - 1 characters maximum
+ * \param[in]	units		A string defining the units of the metric
+ *				containing D_TM_UNIT_LEN - 1 characters maximum
+ * \param[in]	fmt		Format specifier for the name and full path of
+ *				the new metric followed by optional args to
+ *				populate the string, printf style.
+ * \return			DER_SUCCESS		Success
+ *				-DER_INVAL		Invalid metric type or
+ *							number of shards
+ *				Other errors as d_tm_add_metric()
+ */
+int
+d_tm_add_sharded_metric(struct d_tm_node_t **node, int metric_type, int nr_shards, char *desc,
+			char *units, const char *fmt, ...)
+{
+	va_list	args;
+	int	rc;
+
+	if (metric_type != D_TM_COUNTER && metric_type != D_TM_GAUGE &&
+	    metric_type != D_TM_STATS_GAUGE)
+		return -DER_INVAL;
+
+	if (nr_shards <= 0 || nr_shards > D_TM_SHARDS_MAX)
+		return -DER_INVAL;
+
+	va_start(args, fmt);
+	rc = add_metric_fmt(node, metric_type, nr_shards, desc, units, fmt, args);
+	va_end(args);
+
+	return rc;
+}
+
 static void
 invalidate_link_node(struct d_tm_shmem_hdr *parent, struct d_tm_node_t *node)
 {
@@ -2696,7 +3019,7 @@ attach_path_segment(key_t key, char *path)
 	}
 
 	/* Add a link to the new region */
-	rc = add_metric(ctx, &link_node, D_TM_LINK, NULL, NULL, path);
+	rc = add_metric(ctx, &link_node, D_TM_LINK, 0, NULL, NULL, path);
 	if (unlikely(rc != 0)) {
 		D_ERROR("can't set up the link node, " DF_RC "\n", DP_RC(rc));
 		D_GOTO(fail, rc);
@@ -3134,7 +3457,8 @@ node_is_readable(struct d_tm_node_t *node)
  *							initial_width or
  *							multiplier is invalid.
  *				-DER_OP_NOT_PERMITTED	Node was not a gauge
- *							or duration.
+ *							or duration, or is
+ *							sharded.
  *				-DER_NO_SHMEM		Out of shared memory
  *				-DER_NOMEM		Out of heap
  */
@@ -3169,7 +3493,8 @@ d_tm_init_histogram(struct d_tm_node_t *node, char *path, int num_buckets,
 	if (multiplier < 1)
 		return -DER_INVAL;
 
-	if (!has_stats(node))
+	/** the buckets are counters updated under the node lock */
+	if (!has_stats(node) || node->dtn_metric->dtm_shards != NULL)
 		return -DER_OP_NOT_PERMITTED;
 
 	shmem = get_shmem_for_key(tm_shmem.ctx, node->dtn_shmem_key);
@@ -3258,6 +3583,74 @@ failure:
 	return rc;
 }
 
+/**
+ * Attach a log-linear (HDR-like) histogram to a gauge with stats or a duration.
+ * Every value recorded by the metric is then counted in the histogram with an
+ * atomic increment, after the node lock taken for the value and the stats is
+ * released, and the consumers can query its percentiles with
+ * d_tm_get_percentile(). Unlike d_tm_init_histogram(), the buckets are not
+ * exported as individual metrics, so the histogram takes 8 bytes per bucket,
+ * see D_TM_HDR_SIZE().
+ *
+ * \param[in]	node		Pointer to a gauge with stats or a duration
+ * \param[in]	sub_bits	Buckets per power of two range are 2^sub_bits,
+ *				between 1 and 7, D_TM_HDR_SUB_BITS by default.
+ * \param[in]	max_bits	Values up to 2^max_bits are told apart,
+ *				D_TM_HDR_MAX_BITS by default.
+ *
+ * \return			DER_SUCCESS		Success
+ *				-DER_INVAL		Invalid input
+ *				-DER_OP_NOT_PERMITTED	Node has no stats
+ *				-DER_NO_SHMEM		Out of shared memory
+ */
+int
+d_tm_init_hdr_histogram(struct d_tm_node_t *node, int sub_bits, int max_bits)
+{
+	struct d_tm_hdr_histogram_t	*hdr;
+	struct d_tm_shmem_hdr		*shmem;
+	int				 bucket_nr;
+	int				 rc;
+
+	if (node == NULL || node->dtn_metric == NULL)
+		return -DER_INVAL;
+
+	if (sub_bits < 1 || sub_bits > 7 || max_bits <= sub_bits || max_bits > 63)
+		return -DER_INVAL;
+
+	if (!has_stats(node))
+		return -DER_OP_NOT_PERMITTED;
+
+	if (node->dtn_metric->dtm_hdr != NULL)
+		return DER_SUCCESS;
+
+	shmem = get_shmem_for_key(tm_shmem.ctx, node->dtn_shmem_key);
+	if (shmem == NULL)
+		return -DER_NO_SHMEM;
+
+	rc = d_tm_lock_shmem();
+	if (rc != 0) {
+		D_ERROR("Failed to get mutex: " DF_RC "\n", DP_RC(rc));
+		return rc;
+	}
+
+	bucket_nr = D_TM_HDR_BUCKET_NR(sub_bits, max_bits);
+	hdr = shmalloc(shmem, sizeof(*hdr));
+	if (hdr == NULL)
+		D_GOTO(out, rc = -DER_NO_SHMEM);
+
+	hdr->dhh_counts = shmalloc(shmem, bucket_nr * sizeof(uint64_t));
+	if (hdr->dhh_counts == NULL)
+		D_GOTO(out, rc = -DER_NO_SHMEM);
+
+	hdr->dhh_sub_bits  = sub_bits;
+	hdr->dhh_max_bits  = max_bits;
+	hdr->dhh_bucket_nr = bucket_nr;
+	node->dtn_metric->dtm_hdr = hdr;
+out:
+	d_tm_unlock_shmem();
+	return rc;
+}
+
 /**
  * Retrieves the histogram creation data for the given node, which includes
  * the number of buckets, initial width and multiplier used to create the
@@ -3385,6 +3778,94 @@ d_tm_get_bucket_range(struct d_tm_context *ctx, struct d_tm_bucket_t *bucket,
 	return DER_SUCCESS;
 }
 
+/**
+ * Client function to read a percentile of the values recorded by the
+ * log-linear histogram attached to a gauge or duration with
+ * d_tm_init_hdr_histogram(). The value returned is the highest value of the
+ * bucket holding the percentile, bounded by the largest recorded value. It is
+ * 0 when nothing was recorded.
+ *
+ * \param[in]	ctx		Client context
+ * \param[out]	val		The percentile value is stored here
+ * \param[in]	percentile	Percentile to read, in (0, 100]
+ * \param[in]	node		Pointer to the stored metric node
+ *
+ * \return	DER_SUCCESS		Success
+ *		-DER_INVAL		Invalid input
+ *		-DER_METRIC_NOT_FOUND	Metric not found
+ *		-DER_OP_NOT_PERMITTED	Metric has no log-linear histogram
+ */
+int
+d_tm_get_percentile(struct d_tm_context *ctx, uint64_t *val, double percentile,
+		    struct d_tm_node_t *node)
+{
+	struct d_tm_hdr_histogram_t	*hdr;
+	struct d_tm_metric_t		*metric_data;
+	struct d_tm_shmem_hdr		*shmem = NULL;
+	_Atomic uint64_t		*counts;
+	uint64_t			 total = 0;
+	uint64_t			 target;
+	uint64_t			 sum = 0;
+	int				 i;
+	int				 rc;
+
+	if (ctx == NULL || val == NULL || node == NULL)
+		return -DER_INVAL;
+
+	if (!(percentile > 0 && percentile <= 100))
+		return -DER_INVAL;
+
+	rc = validate_node_ptr(ctx, node, &shmem);
+	if (rc != 0)
+		return rc;
+
+	if (!has_stats(node))
+		return -DER_OP_NOT_PERMITTED;
+
+	if (unlikely(!node_is_readable(node)))
+		return -DER_AGAIN;
+
+	metric_data = conv_ptr(shmem, node->dtn_metric);
+	if (metric_data == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	if (metric_data->dtm_hdr == NULL)
+		return -DER_OP_NOT_PERMITTED;
+
+	hdr = conv_ptr(shmem, metric_data->dtm_hdr);
+	if (hdr == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	counts = conv_ptr(shmem, hdr->dhh_counts);
+	if (counts == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	for (i = 0; i < hdr->dhh_bucket_nr; i++)
+		total += atomic_load_relaxed(&counts[i]);
+
+	*val = 0;
+	if (total == 0)
+		return DER_SUCCESS;
+
+	target = ceil(total * percentile / 100);
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < hdr->dhh_bucket_nr; i++) {
+		sum += atomic_load_relaxed(&counts[i]);
+		if (sum >= target)
+			break;
+	}
+
+	/** the last bucket also counts the values beyond the histogram range */
+	if (i >= hdr->dhh_bucket_nr - 1)
+		*val = atomic_load_relaxed(&hdr->dhh_max);
+	else
+		*val = min(hdr_bucket_max(hdr->dhh_sub_bits, i),
+			   atomic_load_relaxed(&hdr->dhh_max));
+	return DER_SUCCESS;
+}
+
 /**
  * Read the specified counter.
  *
@@ -3428,6 +3909,17 @@ d_tm_get_counter(struct d_tm_context *ctx, uint64_t *val,
 			return -DER_METRIC_NOT_FOUND;
 	}
 
+	if (metric_data->dtm_shards != NULL) {
+		struct d_tm_shard_t *shards = metric_data->dtm_shards;
+
+		if (ctx != NULL)
+			shards = conv_ptr(shmem, shards);
+		if (shards == NULL)
+			return -DER_METRIC_NOT_FOUND;
+		*val = shards_sum(shards, metric_data->dtm_shard_nr);
+		return DER_SUCCESS;
+	}
+
 	d_tm_node_lock(node);
 	*val = metric_data->dtm_data.value;
 	d_tm_node_unlock(node);
@@ -3667,7 +4159,15 @@ d_tm_get_gauge(struct d_tm_context *ctx, uint64_t *val,
 		return -DER_AGAIN;
 
 	metric_data = conv_ptr(shmem, node->dtn_metric);
-	if (metric_data != NULL) {
+	if (metric_data != NULL && metric_data->dtm_shards != NULL) {
+		struct d_tm_shard_t *shards = conv_ptr(shmem, metric_data->dtm_shards);
+
+		if (shards == NULL)
+			return -DER_METRIC_NOT_FOUND;
+		*val = shards_sum(shards, metric_data->dtm_shard_nr);
+		if (has_stats(node) && stats != NULL)
+			shards_stats(shards, metric_data->dtm_shard_nr, stats);
+	} else if (metric_data != NULL) {
 		dtm_stats = conv_ptr(shmem, metric_data->dtm_stats);
 		d_tm_node_lock(node);
 		*val = metric_data->dtm_data.value;
@@ -4129,6 +4629,37 @@ shmalloc(struct d_tm_shmem_hdr *shmem, int length)
 	return new_mem;
 }
 
+/**
+ * Allocates memory from within the shared memory pool, aligned to \a align
+ * bytes. The padding skipped to reach the alignment is not reclaimed.
+ *
+ * param[in]	shmem	The shmem pool in which to alloc
+ * param[in]	length	Size in bytes of the region to allocate
+ * param[in]	align	Alignment in bytes, a power of two
+ *
+ * \return		Address of the allocated memory
+ *			NULL if there was no more memory available
+ */
+static void *
+shmalloc_aligned(struct d_tm_shmem_hdr *shmem, int length, int align)
+{
+	uint64_t pad;
+
+	if (shmem == NULL || length == 0)
+		return NULL;
+
+	D_ASSERT(align > 0 && (align & (align - 1)) == 0);
+	pad = -(uintptr_t)shmem->sh_free_addr & (align - 1);
+	if (pad + length > shmem->sh_bytes_free) {
+		D_CRIT("Shared memory allocation failure!\n");
+		return NULL;
+	}
+
+	shmem->sh_bytes_free -= pad;
+	shmem->sh_free_addr += pad;
+	return shmalloc(shmem, length);
+}
+
 /**
  * Validates that the pointer resides within the address space
  * of the client's shared memory region.
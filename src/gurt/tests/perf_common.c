@@ -0,0 +1,177 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/*
+ * Shared harness of the *_perf microbenchmarks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <gurt/common.h>
+
+#include "perf_common.h"
+
+/* Common options, the tool ones go after them */
+#define PERF_OPTS_MAX	16
+
+struct perf_thread {
+	pthread_t		 pt_thread;
+	pthread_barrier_t	*pt_barrier;
+	perf_func_t		 pt_func;
+	void			*pt_arg;
+	int			 pt_idx;
+	int			 pt_nr;
+	int			 pt_rc;
+};
+
+static void *
+perf_thread(void *data)
+{
+	struct perf_thread *thread = data;
+
+	pthread_barrier_wait(thread->pt_barrier);
+	thread->pt_rc = thread->pt_func(thread->pt_arg, thread->pt_idx, thread->pt_nr);
+	return NULL;
+}
+
+int
+perf_threads_run(int nr, perf_func_t func, void *arg, uint64_t *ns)
+{
+	struct perf_thread	threads[PERF_MAX_THREADS];
+	pthread_barrier_t	barrier;
+	struct timespec		start, end;
+	int			i;
+	int			rc;
+
+	D_ASSERT(nr > 0 && nr <= PERF_MAX_THREADS);
+	pthread_barrier_init(&barrier, NULL, nr + 1);
+	for (i = 0; i < nr; i++) {
+		threads[i].pt_barrier = &barrier;
+		threads[i].pt_func    = func;
+		threads[i].pt_arg     = arg;
+		threads[i].pt_idx     = i;
+		threads[i].pt_nr      = nr;
+		threads[i].pt_rc      = 0;
+		rc = pthread_create(&threads[i].pt_thread, NULL, perf_thread, &threads[i]);
+		D_ASSERT(rc == 0);
+	}
+
+	d_gettime(&start);
+	pthread_barrier_wait(&barrier);
+	rc = 0;
+	for (i = 0; i < nr; i++) {
+		pthread_join(threads[i].pt_thread, NULL);
+		if (rc == 0)
+			rc = threads[i].pt_rc;
+	}
+	d_gettime(&end);
+	pthread_barrier_destroy(&barrier);
+
+	if (ns != NULL)
+		*ns = d_timediff_ns(&start, &end);
+	return rc;
+}
+
+static void
+print_usage(const struct perf_tool *tool, char *name)
+{
+	const struct perf_opt	*opt;
+	char			 buf[64];
+	int			 i;
+
+	printf("usage: %s [OPTIONS] ...\n\n", name);
+	printf("\t-t THREADS, --threads=THREADS\tNumber of threads (max %d).\n"
+	       "\t\t\t\t\tDefault: ", PERF_MAX_THREADS);
+	for (i = 0; tool->pt_threads[i] != 0; i++)
+		printf("%s%d", i == 0 ? "" : tool->pt_threads[i + 1] == 0 ? " and " : ", ",
+		       tool->pt_threads[i]);
+	printf("\n");
+	printf("\t-n LOOPS, --loops=LOOPS\t\t%s. Default: " DF_U64 "\n", tool->pt_loops_help,
+	       tool->pt_loops);
+	for (opt = tool->pt_opts; opt != NULL && opt->po_name != NULL; opt++) {
+		snprintf(buf, sizeof(buf), "-%c %s, --%s=%s", opt->po_val, opt->po_arg,
+			 opt->po_name, opt->po_arg);
+		printf("\t%-31s %s\n", buf, opt->po_help);
+	}
+	printf("\t-h, --help\t\t\tShow this message\n");
+}
+
+int
+perf_main(const struct perf_tool *tool, int argc, char **argv)
+{
+	struct option		 l_opts[PERF_OPTS_MAX] = {
+		{"threads",	required_argument,	NULL, 't'},
+		{"loops",	required_argument,	NULL, 'n'},
+		{"help",	no_argument,		NULL, 'h'},
+	};
+	const struct perf_opt	*popt;
+	char			 s_opts[PERF_OPTS_MAX * 2 + 1] = "t:n:h";
+	uint64_t		 loops = tool->pt_loops;
+	int			 nr_threads = 0;
+	int			 nr;
+	int			 opt;
+	int			 i;
+	int			 rc;
+
+	for (popt = tool->pt_opts, i = 3; popt != NULL && popt->po_name != NULL; popt++, i++) {
+		D_ASSERT(i < PERF_OPTS_MAX - 1);
+		l_opts[i].name    = popt->po_name;
+		l_opts[i].has_arg = required_argument;
+		l_opts[i].val     = popt->po_val;
+		s_opts[strlen(s_opts)] = popt->po_val;
+		s_opts[strlen(s_opts)] = ':';
+	}
+
+	while ((opt = getopt_long(argc, argv, s_opts, l_opts, NULL)) != -1) {
+		switch (opt) {
+		case 't':
+			nr_threads = atoi(optarg);
+			rc = nr_threads <= 0 || nr_threads > PERF_MAX_THREADS ? -DER_INVAL : 0;
+			break;
+		case 'n':
+			loops = strtoull(optarg, NULL, 0);
+			rc = loops == 0 ? -DER_INVAL : 0;
+			break;
+		case 'h':
+			print_usage(tool, argv[0]);
+			return 0;
+		case '?':
+			rc = -DER_INVAL;
+			break;
+		default:
+			rc = tool->pt_parse(opt, optarg);
+			break;
+		}
+		if (rc != 0) {
+			print_usage(tool, argv[0]);
+			return rc;
+		}
+	}
+
+	rc = d_log_init();
+	if (rc != 0)
+		return rc;
+
+	if (tool->pt_init != NULL) {
+		rc = tool->pt_init();
+		if (rc != 0)
+			goto out;
+	}
+
+	for (i = 0; tool->pt_threads[i] != 0 && rc == 0; i++) {
+		nr = nr_threads ?: tool->pt_threads[i];
+		rc = tool->pt_run(nr, loops);
+		if (nr_threads != 0)
+			break;
+	}
+
+	if (tool->pt_fini != NULL)
+		tool->pt_fini();
+out:
+	d_log_fini();
+	return rc;
+}
@@ -0,0 +1,81 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/*
+ * Shared harness of the *_perf microbenchmarks. It parses the common options,
+ * runs the workload of the tool for each number of threads, starts the threads
+ * together and times them. A tool only supplies its workload.
+ */
+#ifndef __PERF_COMMON_H__
+#define __PERF_COMMON_H__
+
+#include <stdint.h>
+
+#define PERF_MAX_THREADS	64
+
+/**
+ * Workload of thread \a idx out of \a nr, called once all the threads are
+ * started.
+ *
+ * \param[in]	arg	Argument given to perf_threads_run()
+ * \param[in]	idx	Index of the thread, from 0 to \a nr - 1
+ * \param[in]	nr	Number of threads
+ *
+ * \return		0 on success, negative DER error otherwise
+ */
+typedef int (*perf_func_t)(void *arg, int idx, int nr);
+
+/** Option of a tool, besides --threads, --loops and --help */
+struct perf_opt {
+	/** long name, the short one is \a po_val */
+	const char	*po_name;
+	int		 po_val;
+	/** name of the argument in the usage */
+	const char	*po_arg;
+	/** usage, may span several lines */
+	const char	*po_help;
+};
+
+struct perf_tool {
+	/** options of the tool, ends with a NULL \a po_name, may be NULL */
+	const struct perf_opt	*pt_opts;
+	/** parse option \a opt of \a pt_opts, returns 0 or -DER_INVAL */
+	int			(*pt_parse)(int opt, const char *arg);
+	/** usage of --loops and its default */
+	const char		*pt_loops_help;
+	uint64_t		 pt_loops;
+	/** default numbers of threads, ends with 0 */
+	const int		*pt_threads;
+	/** optional, called once before and after all the runs */
+	int			(*pt_init)(void);
+	void			(*pt_fini)(void);
+	/** run the workload on \a nr threads, \a loops iterations each */
+	int			(*pt_run)(int nr, uint64_t loops);
+};
+
+/**
+ * Run \a func on \a nr threads started together and wait for all of them.
+ *
+ * \param[in]	nr	Number of threads, at most PERF_MAX_THREADS
+ * \param[in]	func	Workload of each thread
+ * \param[in]	arg	Argument of \a func
+ * \param[out]	ns	Time from the start of the threads to the end of the
+ *			last one, may be NULL
+ *
+ * \return		0 on success, the first error of \a func otherwise
+ */
+int
+perf_threads_run(int nr, perf_func_t func, void *arg, uint64_t *ns);
+
+/**
+ * Main of a tool: parse the options, then call \a pt_run for each number of
+ * threads, the default ones or the one given with --threads.
+ *
+ * \return		0 on success, negative DER error otherwise
+ */
+int
+perf_main(const struct perf_tool *tool, int argc, char **argv);
+
+#endif /* __PERF_COMMON_H__ */
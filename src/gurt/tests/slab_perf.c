@@ -0,0 +1,164 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/*
+ * Microbenchmark of the d_slab allocator with a number of threads sharing one type, each
+ * acquiring a few objects, releasing them and periodically calling restock as dfuse does:
+ *  - locked:   the type is registered with sr_no_mag, every call takes the type lock.
+ *  - magazine: acquire and release go through the per-thread magazines.
+ * Every object handed out is checked to have been reset since it was last released.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gurt/common.h>
+#include <gurt/slab.h>
+
+#include "perf_common.h"
+
+#define PERF_MAX_HELD		64
+
+enum perf_mode {
+	PERF_LOCKED,
+	PERF_MAGAZINE,
+	PERF_MODE_MAX,
+};
+
+static const char *perf_mode_str[] = {"locked", "magazine"};
+
+enum perf_state {
+	PERF_STATE_READY = 1,
+	PERF_STATE_USED,
+};
+
+struct perf_desc {
+	d_list_t	pd_list;
+	int		pd_state;
+	char		pd_buf[64];
+};
+
+struct perf_args {
+	struct d_slab_type	*pa_type;
+	uint64_t		 pa_loops;
+};
+
+static int perf_held    = 4;
+static int perf_restock = 16;
+
+static bool
+perf_reset(void *desc)
+{
+	struct perf_desc *pd = desc;
+
+	pd->pd_state = PERF_STATE_READY;
+	return true;
+}
+
+static int
+perf_func(void *arg, int idx, int nr)
+{
+	struct perf_args	*args = arg;
+	struct perf_desc	*held[PERF_MAX_HELD];
+	uint64_t		 i;
+	int			 j;
+
+	for (i = 0; i < args->pa_loops; i++) {
+		for (j = 0; j < perf_held; j++) {
+			held[j] = d_slab_acquire(args->pa_type);
+			if (held[j] == NULL || held[j]->pd_state != PERF_STATE_READY)
+				return -DER_MISC;
+			held[j]->pd_state = PERF_STATE_USED;
+		}
+		for (j = 0; j < perf_held; j++)
+			d_slab_release(args->pa_type, held[j]);
+		if (perf_restock != 0 && i % perf_restock == 0)
+			d_slab_restock(args->pa_type);
+	}
+	return 0;
+}
+
+static int
+perf_run_mode(enum perf_mode mode, int nr_threads, uint64_t loops)
+{
+	struct d_slab_reg	reg = {.sr_reset  = perf_reset,
+				       .sr_no_mag = mode == PERF_LOCKED,
+				       POOL_TYPE_INIT(perf_desc, pd_list)};
+	struct perf_args	args = {.pa_loops = loops};
+	struct d_slab		slab = {0};
+	uint64_t		ops;
+	uint64_t		ns;
+	int			rc;
+
+	rc = d_slab_init(&slab, NULL);
+	if (rc != 0)
+		return rc;
+
+	rc = d_slab_register(&slab, &reg, NULL, &args.pa_type);
+	if (rc != 0)
+		goto out;
+
+	rc = perf_threads_run(nr_threads, perf_func, &args, &ns);
+
+	/* Every object was released so none should be reported as in use */
+	if (d_slab_reclaim(&slab) && rc == 0)
+		rc = -DER_BUSY;
+
+	ops = (uint64_t)nr_threads * loops * perf_held;
+	printf("%-8s threads %3d: %8.2f ns/op, %12.0f ops/s, %d created%s\n", perf_mode_str[mode],
+	       nr_threads, (double)ns * nr_threads / ops, ops * 1e9 / (ns ?: 1),
+	       args.pa_type->st_init_count, rc == 0 ? "" : " FAILED");
+out:
+	d_slab_destroy(&slab);
+	return rc;
+}
+
+static int
+perf_run(int nr_threads, uint64_t loops)
+{
+	int mode;
+	int rc = 0;
+
+	for (mode = 0; mode < PERF_MODE_MAX && rc == 0; mode++)
+		rc = perf_run_mode(mode, nr_threads, loops);
+	return rc;
+}
+
+static int
+perf_parse(int opt, const char *arg)
+{
+	switch (opt) {
+	case 'o':
+		perf_held = atoi(arg);
+		return perf_held <= 0 || perf_held > PERF_MAX_HELD ? -DER_INVAL : 0;
+	case 'r':
+		perf_restock = atoi(arg);
+		return perf_restock < 0 ? -DER_INVAL : 0;
+	default:
+		return -DER_INVAL;
+	}
+}
+
+static const struct perf_opt perf_opts[] = {
+	{"held",	'o',	"HELD",	"Objects held per iteration (max 64). Default: 4"},
+	{"restock",	'r',	"NR",	"Restock every NR iterations, 0 to never. Default: 16"},
+	{NULL},
+};
+
+static const int perf_threads[] = {1, 2, 4, 8, 16, 0};
+
+static const struct perf_tool perf_tool = {
+	.pt_opts	= perf_opts,
+	.pt_parse	= perf_parse,
+	.pt_loops_help	= "Iterations per thread",
+	.pt_loops	= 200000,
+	.pt_threads	= perf_threads,
+	.pt_run		= perf_run,
+};
+
+int
+main(int argc, char **argv)
+{
+	return perf_main(&perf_tool, argc, argv);
+}
@@ -0,0 +1,133 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/*
+ * Microbenchmark of the telemetry counter update cost, with a number of threads updating:
+ *  - private: one regular counter per thread, the per-target layout used by the engine.
+ *  - locked:  one regular counter shared by all threads, serialized by the node lock.
+ *  - sharded: one sharded counter shared by all threads, each thread updating its own shard.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gurt/common.h>
+#include <gurt/telemetry_common.h>
+#include <gurt/telemetry_producer.h>
+#include <gurt/telemetry_consumer.h>
+
+#include "perf_common.h"
+
+#define PERF_IDX	(98)
+
+enum perf_mode {
+	PERF_PRIVATE,
+	PERF_LOCKED,
+	PERF_SHARDED,
+	PERF_MODE_MAX,
+};
+
+static const char *perf_mode_str[] = {"private", "locked", "sharded"};
+
+struct perf_args {
+	struct d_tm_node_t	*pa_counters[PERF_MAX_THREADS];
+	uint64_t		 pa_loops;
+};
+
+static int
+perf_func(void *arg, int idx, int nr)
+{
+	struct perf_args	*args = arg;
+	struct d_tm_node_t	*counter = args->pa_counters[idx];
+	uint64_t		 i;
+
+	d_tm_set_shard(idx);
+	for (i = 0; i < args->pa_loops; i++)
+		d_tm_inc_counter(counter, 1);
+	return 0;
+}
+
+static int
+perf_run_mode(enum perf_mode mode, int nr_threads, uint64_t loops)
+{
+	struct perf_args	args = {.pa_loops = loops};
+	struct d_tm_node_t	*counter = NULL;
+	uint64_t		total = 0;
+	uint64_t		val;
+	uint64_t		ns;
+	int			i;
+	int			rc;
+
+	rc = d_tm_init(PERF_IDX, D_TM_SHARED_MEMORY_SIZE,
+		       mode == PERF_LOCKED ? D_TM_SERIALIZATION : D_TM_SERVER_PROCESS);
+	if (rc != 0)
+		return rc;
+
+	if (mode == PERF_SHARDED)
+		rc = d_tm_add_sharded_metric(&counter, D_TM_COUNTER, nr_threads, NULL, NULL,
+					     "perf/counter");
+	else if (mode == PERF_LOCKED)
+		rc = d_tm_add_metric(&counter, D_TM_COUNTER, NULL, NULL, "perf/counter");
+	if (rc != 0)
+		goto out;
+
+	for (i = 0; i < nr_threads; i++) {
+		if (mode == PERF_PRIVATE) {
+			rc = d_tm_add_metric(&counter, D_TM_COUNTER, NULL, NULL,
+					     "perf/counter/tgt_%d", i);
+			if (rc != 0)
+				goto out;
+		}
+		args.pa_counters[i] = counter;
+	}
+
+	rc = perf_threads_run(nr_threads, perf_func, &args, &ns);
+	if (rc != 0)
+		goto out;
+
+	for (i = 0; i < nr_threads; i++) {
+		rc = d_tm_get_counter(NULL, &val, args.pa_counters[i]);
+		if (rc != 0)
+			goto out;
+		total += val;
+		if (mode != PERF_PRIVATE)
+			break;
+	}
+
+	printf("%-8s threads %3d: %8.2f ns/update, %12.0f updates/s%s\n", perf_mode_str[mode],
+	       nr_threads, (double)ns / loops,
+	       nr_threads * loops * 1e9 / (ns ?: 1),
+	       total == nr_threads * loops ? "" : " LOST UPDATES");
+	if (total != nr_threads * loops)
+		rc = -DER_MISC;
+out:
+	d_tm_fini();
+	return rc;
+}
+
+static int
+perf_run(int nr_threads, uint64_t loops)
+{
+	int mode;
+	int rc = 0;
+
+	for (mode = 0; mode < PERF_MODE_MAX && rc == 0; mode++)
+		rc = perf_run_mode(mode, nr_threads, loops);
+	return rc;
+}
+
+static const int perf_threads[] = {1, 2, 4, 8, 16, 0};
+
+static const struct perf_tool perf_tool = {
+	.pt_loops_help	= "Updates per thread",
+	.pt_loops	= 1000000,
+	.pt_threads	= perf_threads,
+	.pt_run		= perf_run,
+};
+
+int
+main(int argc, char **argv)
+{
+	return perf_main(&perf_tool, argc, argv);
+}
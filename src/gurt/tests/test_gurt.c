@@ -1436,10 +1436,14 @@ _test_gurt_hash_threaded_same_operations(void *(*fn)(struct hash_thread_arg *),
  *
  * Each type of operation gets TEST_GURT_HASH_NUM_THREADS threads.
  */
+/* resizable tables start small and grow with the inserted entries */
+#define TEST_GURT_HASH_BITS(feats)	\
+	(((feats) & D_HASH_FT_RESIZE) ? 1 : TEST_GURT_HASH_NUM_BITS)
+
 static void
 test_gurt_hash_threaded_same_operations(uint32_t ht_feats)
 {
-	const int		  num_bits = TEST_GURT_HASH_NUM_BITS;
+	const int		  num_bits = TEST_GURT_HASH_BITS(ht_feats);
 	struct d_hash_table	 *thtab;
 	int			  rc;
 	struct test_hash_entry	**entries;
@@ -1494,7 +1498,7 @@ test_gurt_hash_threaded_same_operations(uint32_t ht_feats)
 static void
 test_gurt_hash_threaded_concurrent_operations(uint32_t ht_feats)
 {
-	const int		  num_bits = TEST_GURT_HASH_NUM_BITS;
+	const int		  num_bits = TEST_GURT_HASH_BITS(ht_feats);
 	struct d_hash_table	 *thtab;
 	struct test_hash_entry	**entries;
 	pthread_t		  thread_ids[4][TEST_GURT_HASH_NUM_THREADS];
@@ -1643,7 +1647,7 @@ static void test_gurt_hash_refcount(struct test_hash_entry **entries,
 static void
 _test_gurt_hash_parallel_refcounting(uint32_t ht_feats)
 {
-	const int		  num_bits = TEST_GURT_HASH_NUM_BITS;
+	const int		  num_bits = TEST_GURT_HASH_BITS(ht_feats);
 	struct d_hash_table	 *thtab;
 	int			  rc;
 	struct test_hash_entry	**entries;
@@ -1746,6 +1750,9 @@ test_gurt_hash_parallel_same_operations(void **state)
 	test_gurt_hash_threaded_same_operations(D_HASH_FT_RWLOCK
 						| D_HASH_FT_EPHEMERAL);
 	test_gurt_hash_threaded_same_operations(D_HASH_FT_LRU);
+	test_gurt_hash_threaded_same_operations(D_HASH_FT_RESIZE);
+	test_gurt_hash_threaded_same_operations(D_HASH_FT_RESIZE
+						| D_HASH_FT_RWLOCK);
 }
 
 static void
@@ -1757,6 +1764,9 @@ test_gurt_hash_parallel_different_operations(void **state)
 	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_RWLOCK
 						      | D_HASH_FT_EPHEMERAL);
 	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_LRU);
+	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_RESIZE);
+	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_RESIZE
+						      | D_HASH_FT_RWLOCK);
 }
 
 static void
@@ -1768,6 +1778,72 @@ test_gurt_hash_parallel_refcounting(void **state)
 	_test_gurt_hash_parallel_refcounting(D_HASH_FT_RWLOCK
 					     | D_HASH_FT_EPHEMERAL);
 	_test_gurt_hash_parallel_refcounting(D_HASH_FT_LRU);
+	_test_gurt_hash_parallel_refcounting(D_HASH_FT_RESIZE
+					     | D_HASH_FT_EPHEMERAL);
+}
+
+static void
+test_gurt_hash_resize(void **state)
+{
+	struct d_hash_table	 *thtab;
+	struct test_hash_entry	**entries;
+	d_list_t		 *test;
+	int			  expected_count;
+	int			  i;
+	int			  rc;
+
+	entries = test_gurt_hash_alloc_items(TEST_GURT_HASH_NUM_ENTRIES);
+	assert_non_null(entries);
+
+	/* no hop_rec_hash, the records can't be moved */
+	rc = d_hash_table_create(D_HASH_FT_RESIZE, 4, NULL,
+				 &(d_hash_table_ops_t){
+				 .hop_key_cmp = test_gurt_hash_op_key_cmp},
+				 &thtab);
+	assert_int_equal(rc, -DER_INVAL);
+
+	rc = d_hash_table_create(D_HASH_FT_RESIZE, 1, NULL, &th_ops, &thtab);
+	assert_int_equal(rc, 0);
+	assert_int_equal(thtab->ht_bits, D_HASH_STRIPE_BITS);
+
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		rc = d_hash_rec_insert(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &entries[i]->tl_link, true);
+		assert_int_equal(rc, 0);
+	}
+
+	/* lookups move the buckets left by the inserts and finish the resize */
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		test = d_hash_rec_find(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN);
+		assert_ptr_equal(test, &entries[i]->tl_link);
+	}
+	assert_false(thtab->ht_resizing);
+	assert_true(TEST_GURT_HASH_NUM_ENTRIES <= (2U << thtab->ht_bits));
+	assert_true(thtab->ht_bits > D_HASH_STRIPE_BITS ||
+		    TEST_GURT_HASH_NUM_ENTRIES <= (2U << D_HASH_STRIPE_BITS));
+
+	expected_count = TEST_GURT_HASH_NUM_ENTRIES;
+	rc = d_hash_table_traverse(thtab, test_gurt_hash_traverse_count_cb,
+				   &expected_count);
+	assert_int_equal(rc, 0);
+	assert_int_equal(expected_count, 0);
+
+	/* the table shrinks back to its initial size */
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++)
+		assert_true(d_hash_rec_delete(thtab, entries[i]->tl_key,
+					      TEST_GURT_HASH_KEY_LEN));
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++)
+		assert_null(d_hash_rec_find(thtab, entries[i]->tl_key,
+					    TEST_GURT_HASH_KEY_LEN));
+	assert_false(thtab->ht_resizing);
+	assert_int_equal(thtab->ht_bits, D_HASH_STRIPE_BITS);
+
+	rc = d_hash_table_destroy(thtab, false);
+	assert_int_equal(rc, 0);
+
+	test_gurt_hash_free_items(entries, TEST_GURT_HASH_NUM_ENTRIES);
 }
 
 
@@ -1996,6 +2072,120 @@ test_hash_perf(void **state)
 		hash_perf(HASH_JCH, 1 << i, el << i);
 }
 
+#define HASH_MT_PERF_THREADS	16
+#define HASH_MT_PERF_LOOKUPS	4
+
+struct hash_mt_perf_arg {
+	struct d_hash_table	 *pa_htab;
+	struct test_hash_entry	**pa_entries;
+	pthread_barrier_t	 *pa_barrier;
+	int			  pa_nr;
+};
+
+/* insert, look up several times and delete the entries owned by the thread */
+static void *
+hash_mt_perf_thread(void *data)
+{
+	struct hash_mt_perf_arg	*arg = data;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	pthread_barrier_wait(arg->pa_barrier);
+	for (i = 0; i < arg->pa_nr; i++) {
+		rc = d_hash_rec_insert(arg->pa_htab, arg->pa_entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &arg->pa_entries[i]->tl_link, false);
+		TEST_THREAD_ASSERT(rc == 0);
+	}
+	for (j = 0; j < HASH_MT_PERF_LOOKUPS; j++) {
+		for (i = 0; i < arg->pa_nr; i++)
+			TEST_THREAD_ASSERT(d_hash_rec_find(arg->pa_htab,
+							   arg->pa_entries[i]->tl_key,
+							   TEST_GURT_HASH_KEY_LEN) != NULL);
+	}
+	for (i = 0; i < arg->pa_nr; i++)
+		TEST_THREAD_ASSERT(d_hash_rec_delete(arg->pa_htab,
+						     arg->pa_entries[i]->tl_key,
+						     TEST_GURT_HASH_KEY_LEN));
+	return NULL;
+}
+
+static void
+hash_mt_perf(const char *name, uint32_t feats, uint32_t bits, int nr_threads,
+	     struct test_hash_entry **entries, int nr_entries)
+{
+	struct hash_mt_perf_arg	 args[HASH_MT_PERF_THREADS];
+	pthread_t		 threads[HASH_MT_PERF_THREADS];
+	pthread_barrier_t	 barrier;
+	struct d_hash_table	*htab;
+	struct timespec		 then;
+	struct timespec		 now;
+	void			*result;
+	uint64_t		 ops;
+	int			 per_thread = nr_entries / nr_threads;
+	int			 i;
+	int			 rc;
+
+	rc = d_hash_table_create(feats, bits, NULL, &th_ops, &htab);
+	assert_int_equal(rc, 0);
+
+	rc = pthread_barrier_init(&barrier, NULL, nr_threads + 1);
+	assert_int_equal(rc, 0);
+	for (i = 0; i < nr_threads; i++) {
+		args[i].pa_htab	   = htab;
+		args[i].pa_entries = &entries[i * per_thread];
+		args[i].pa_barrier = &barrier;
+		args[i].pa_nr	   = per_thread;
+		rc = pthread_create(&threads[i], NULL, hash_mt_perf_thread, &args[i]);
+		assert_int_equal(rc, 0);
+	}
+
+	d_gettime(&then);
+	pthread_barrier_wait(&barrier);
+	for (i = 0; i < nr_threads; i++) {
+		rc = pthread_join(threads[i], &result);
+		assert_int_equal(rc, 0);
+		assert_null(result);
+	}
+	d_gettime(&now);
+	pthread_barrier_destroy(&barrier);
+
+	ops = (uint64_t)per_thread * nr_threads * (HASH_MT_PERF_LOOKUPS + 2);
+	fprintf(stdout, "Hash table: %-14s threads: %2d, entries: %d, rate: %F ops/s\n",
+		name, nr_threads, per_thread * nr_threads,
+		(double)ops * NSEC_PER_SEC / d_timediff_ns(&then, &now));
+
+	rc = d_hash_table_destroy(htab, false);
+	assert_int_equal(rc, 0);
+}
+
+/*
+ * Concurrent throughput of insert/lookup/delete, with an undersized and a well
+ * sized fixed table, and a resizable table starting at the same undersized size.
+ */
+static void
+test_hash_mt_perf(void **state)
+{
+	int			  nr_entries = D_ON_VALGRIND ? 1 << 8 : 1 << 14;
+	int			  threads[] = {1, 4, HASH_MT_PERF_THREADS};
+	struct test_hash_entry	**entries;
+	int			  i;
+
+	entries = test_gurt_hash_alloc_items(nr_entries);
+	assert_non_null(entries);
+
+	for (i = 0; i < ARRAY_SIZE(threads); i++) {
+		hash_mt_perf("fixed/small", 0, 6, threads[i], entries, nr_entries);
+		hash_mt_perf("fixed/large", 0, 16, threads[i], entries, nr_entries);
+		hash_mt_perf("resize", D_HASH_FT_RESIZE, 6, threads[i], entries, nr_entries);
+		hash_mt_perf("resize/rwlock", D_HASH_FT_RESIZE | D_HASH_FT_RWLOCK, 6,
+			     threads[i], entries, nr_entries);
+	}
+
+	test_gurt_hash_free_items(entries, nr_entries);
+}
+
 static void
 verify_rank_list_dup_uniq(int *src_ranks, int num_src_ranks,
 			  int *exp_ranks, int num_exp_ranks)
@@ -2712,10 +2902,12 @@ main(int argc, char **argv)
 	    cmocka_unit_test(test_gurt_hash_parallel_same_operations),
 	    cmocka_unit_test(test_gurt_hash_parallel_different_operations),
 	    cmocka_unit_test(test_gurt_hash_parallel_refcounting),
+	    cmocka_unit_test(test_gurt_hash_resize),
 	    cmocka_unit_test(test_gurt_atomic),
 	    cmocka_unit_test(test_gurt_string_buffer),
 	    cmocka_unit_test(test_d_rank_list_dup_sort_uniq),
 	    cmocka_unit_test(test_hash_perf),
+	    cmocka_unit_test(test_hash_mt_perf),
 	    cmocka_unit_test_setup_teardown(test_d_getenv_str, setup_getenv_mocks,
 					    teardown_getenv_mocks),
 	    cmocka_unit_test_setup_teardown(test_d_agetenv_str, setup_getenv_mocks,
@@ -127,6 +127,119 @@ test_gauge(void **state)
 	assert_int_equal(val, init_val + inc_count - dec_count);
 }
 
+#define SHARD_THREADS	4
+#define SHARD_LOOPS	10000
+
+struct shard_arg {
+	struct d_tm_node_t	*sa_counter;
+	struct d_tm_node_t	*sa_gauge;
+	int			 sa_shard;
+};
+
+static void *
+shard_writer(void *data)
+{
+	struct shard_arg	*arg = data;
+	int			 i;
+
+	d_tm_set_shard(arg->sa_shard);
+	for (i = 0; i < SHARD_LOOPS; i++) {
+		d_tm_inc_counter(arg->sa_counter, 1);
+		d_tm_inc_gauge(arg->sa_gauge, 2);
+		d_tm_dec_gauge(arg->sa_gauge, 1);
+	}
+	return NULL;
+}
+
+static void
+test_sharded_metrics(void **state)
+{
+	struct d_tm_node_t	*counter;
+	struct d_tm_node_t	*gauge;
+	struct shard_arg	 args[SHARD_THREADS];
+	pthread_t		 threads[SHARD_THREADS];
+	struct d_tm_stats_t	 stats = {0};
+	uint64_t		 val;
+	int			 rc;
+	int			 i;
+
+	rc = d_tm_add_sharded_metric(&counter, D_TM_DURATION, 2, NULL, NULL,
+				     "gurt/tests/telem/sharded invalid");
+	assert_rc_equal(rc, -DER_INVAL);
+
+	rc = d_tm_add_sharded_metric(&counter, D_TM_COUNTER, 0, NULL, NULL,
+				     "gurt/tests/telem/sharded invalid");
+	assert_rc_equal(rc, -DER_INVAL);
+
+	/* fewer shards than writers, some of them share a shard */
+	rc = d_tm_add_sharded_metric(&counter, D_TM_COUNTER, SHARD_THREADS - 1, NULL, NULL,
+				     "gurt/tests/telem/sharded counter");
+	assert_rc_equal(rc, 0);
+
+	rc = d_tm_add_sharded_metric(&gauge, D_TM_GAUGE, SHARD_THREADS, NULL, NULL,
+				     "gurt/tests/telem/sharded gauge");
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < SHARD_THREADS; i++) {
+		args[i].sa_counter = counter;
+		args[i].sa_gauge   = gauge;
+		args[i].sa_shard   = i;
+		rc = pthread_create(&threads[i], NULL, shard_writer, &args[i]);
+		assert_int_equal(rc, 0);
+	}
+	for (i = 0; i < SHARD_THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	rc = d_tm_get_counter(cli_ctx, &val, srv_to_cli_node(counter));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, SHARD_THREADS * SHARD_LOOPS);
+
+	/* server side fast read */
+	rc = d_tm_get_counter(NULL, &val, counter);
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, SHARD_THREADS * SHARD_LOOPS);
+
+	rc = d_tm_get_gauge(cli_ctx, &val, NULL, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, SHARD_THREADS * SHARD_LOOPS);
+
+	/* a sharded gauge reports the sum of the values set by each shard */
+	d_tm_set_shard(0);
+	d_tm_set_gauge(gauge, 5);
+	rc = d_tm_get_gauge(cli_ctx, &val, NULL, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, (SHARD_THREADS - 1) * SHARD_LOOPS + 5);
+
+	d_tm_set_counter(counter, 42);
+	rc = d_tm_get_counter(cli_ctx, &val, srv_to_cli_node(counter));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, 42);
+
+	/* the statistics of the shards are merged on read */
+	rc = d_tm_add_sharded_metric(&gauge, D_TM_STATS_GAUGE, 2, NULL, NULL,
+				     "gurt/tests/telem/sharded stats gauge");
+	assert_rc_equal(rc, 0);
+
+	rc = d_tm_init_histogram(gauge, "gurt/tests/telem/sharded stats gauge", 4, 10, 2);
+	assert_rc_equal(rc, -DER_OP_NOT_PERMITTED);
+
+	d_tm_set_shard(0);
+	d_tm_set_gauge(gauge, 10);
+	d_tm_set_gauge(gauge, 20);
+	d_tm_set_shard(1);
+	d_tm_set_gauge(gauge, 30);
+
+	rc = d_tm_get_gauge(cli_ctx, &val, &stats, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, 50);
+	assert_int_equal(stats.dtm_min, 10);
+	assert_int_equal(stats.dtm_max, 30);
+	assert_int_equal(stats.dtm_sum, 60);
+	assert_int_equal(stats.sample_size, 3);
+	assert_true(stats.mean == 20);
+	assert_true(stats.sum_of_squares == 1400);
+}
+
 static void
 test_record_timestamp(void **state)
 {
@@ -622,6 +735,63 @@ test_gauge_with_histogram_multiplier_2(void **state)
 	check_histogram_metadata(path);
 }
 
+static void
+test_gauge_with_hdr_histogram(void **state)
+{
+	struct d_tm_node_t	*gauge;
+	struct d_tm_node_t	*counter;
+	uint64_t		 val;
+	int			 rc;
+	int			 i;
+
+	rc = d_tm_add_metric(&gauge, D_TM_STATS_GAUGE, "A gauge with log-linear histogram", "us",
+			     "gurt/tests/telem/gauge-hdr");
+	assert_rc_equal(rc, 0);
+
+	rc = d_tm_get_percentile(cli_ctx, &val, 50, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, -DER_OP_NOT_PERMITTED);
+
+	rc = d_tm_init_hdr_histogram(gauge, 0, D_TM_HDR_MAX_BITS);
+	assert_rc_equal(rc, -DER_INVAL);
+
+	rc = d_tm_add_metric(&counter, D_TM_COUNTER, NULL, NULL, "gurt/tests/telem/counter-hdr");
+	assert_rc_equal(rc, 0);
+	rc = d_tm_init_hdr_histogram(counter, D_TM_HDR_SUB_BITS, D_TM_HDR_MAX_BITS);
+	assert_rc_equal(rc, -DER_OP_NOT_PERMITTED);
+
+	rc = d_tm_init_hdr_histogram(gauge, D_TM_HDR_SUB_BITS, D_TM_HDR_MAX_BITS);
+	assert_rc_equal(rc, 0);
+
+	rc = d_tm_get_percentile(cli_ctx, &val, 50, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, 0);
+	assert_int_equal(val, 0);
+
+	/* 1 .. 10000, then a single outlier beyond the histogram range */
+	for (i = 1; i <= 10000; i++)
+		d_tm_set_gauge(gauge, i);
+	d_tm_set_gauge(gauge, 1ULL << 40);
+
+	rc = d_tm_get_percentile(cli_ctx, &val, 0, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, -DER_INVAL);
+
+	/* values are bounded by the relative error of the buckets, 1/2^D_TM_HDR_SUB_BITS */
+	rc = d_tm_get_percentile(cli_ctx, &val, 50, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, 0);
+	assert_true(val >= 5000 && val <= 5000 + 5000 / (1 << D_TM_HDR_SUB_BITS));
+
+	rc = d_tm_get_percentile(cli_ctx, &val, 99, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, 0);
+	assert_true(val >= 9900 && val <= 9900 + 9900 / (1 << D_TM_HDR_SUB_BITS));
+
+	rc = d_tm_get_percentile(cli_ctx, &val, 100, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, 0);
+	assert_int_equal(val, 1ULL << 40);
+
+	rc = d_tm_get_percentile(cli_ctx, &val, 1, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, 0);
+	assert_true(val >= 100 && val <= 100 + 100 / (1 << D_TM_HDR_SUB_BITS));
+}
+
 static void
 test_units(void **state)
 {
@@ -1187,9 +1357,9 @@ test_verify_object_count(void **state)
 {
 	struct d_tm_node_t	*node;
 	int			num;
-	int			exp_num_ctr = 20;
-	int			exp_num_gauge = 3;
-	int			exp_num_gauge_stats = 3;
+	int			exp_num_ctr = 22;
+	int			exp_num_gauge = 4;
+	int			exp_num_gauge_stats = 4;
 	int			exp_num_dur = 2;
 	int			exp_num_timestamp = 2;
 	int			exp_num_snap = 2;
@@ -1356,12 +1526,14 @@ main(int argc, char **argv)
 		cmocka_unit_test(test_increment_counter),
 		cmocka_unit_test(test_add_to_counter),
 		cmocka_unit_test(test_gauge),
+		cmocka_unit_test(test_sharded_metrics),
 		cmocka_unit_test(test_record_timestamp),
 		cmocka_unit_test(test_interval_timer),
 		cmocka_unit_test(test_gauge_stats),
 		cmocka_unit_test(test_duration_stats),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_1),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_2),
+		cmocka_unit_test(test_gauge_with_hdr_histogram),
 		cmocka_unit_test(test_units),
 		cmocka_unit_test(test_ephemeral_simple),
 		cmocka_unit_test(test_ephemeral_nested),
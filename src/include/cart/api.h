@@ -1151,19 +1151,31 @@ enum crt_tree_type {
 	CRT_TREE_FLAT		= 1,
 	CRT_TREE_KARY		= 2,
 	CRT_TREE_KNOMIAL	= 3,
-	CRT_TREE_MAX		= 3,
+	/*
+	 * Two level tree following the fault domains set by
+	 * crt_group_domains_set(): the root reaches one leader per domain, and
+	 * each leader reaches the other members of its domain, so that only
+	 * (number of domains - 1) edges cross domains. Both levels are knomial
+	 * trees, their ratio is raised from the requested one as needed to keep
+	 * each level within CRT_TREE_DOMAIN_LEVEL_DEPTH hops. Without domains
+	 * only the member level is left, so it is a knomial tree whose ratio may
+	 * be higher than the requested one, unlike CRT_TREE_KNOMIAL.
+	 */
+	CRT_TREE_DOMAIN		= 4,
+	CRT_TREE_MAX		= 4,
 };
 
 #define CRT_TREE_TYPE_SHIFT	(16U)
 #define CRT_TREE_MAX_RATIO	(64)
 #define CRT_TREE_MIN_RATIO	(2)
+#define CRT_TREE_DOMAIN_LEVEL_DEPTH	(3)
 
 /*
  * Calculate the tree topology. Can only be called on the server side.
  *
  * \param[in] tree_type        tree type
  * \param[in] branch_ratio     branch ratio, be ignored for CRT_TREE_FLAT.
- *                             for KNOMIAL tree or KARY tree, the valid value
+ *                             for KNOMIAL, KARY or DOMAIN tree, the valid value
  *                             should within the range of
  *                             [CRT_TREE_MIN_RATIO, CRT_TREE_MAX_RATIO], or
  *                             will be treated as invalid parameter.
@@ -2278,6 +2290,34 @@ int crt_group_secondary_modify(crt_group_t *grp, d_rank_list_t *sec_ranks,
 			d_rank_list_t *prim_ranks, crt_group_mod_op_t op,
 			uint32_t version);
 
+/**
+ * Set the fault domain of the members of a group, used to build the
+ * CRT_TREE_DOMAIN trees. This replaces the domains previously set, members
+ * without a domain are all considered to be in the same one.
+ *
+ * The domains take effect together with the membership update of \a grp to
+ * \a version, e.g. by crt_group_secondary_modify(), or immediately if \a grp
+ * is already at \a version. All the members of the group have to set the same
+ * domains for the same version, otherwise the trees they compute differ. Can
+ * only be called on the server side.
+ *
+ * A domain of CRT_NO_DOMAIN leaves the rank without a domain.
+ *
+ * \param[in] grp                Group handle, NULL for the default primary group
+ * \param[in] ranks              Member ranks, as in the membership list of \a grp,
+ *                               NULL to clear the domains
+ * \param[in] domains            Domain ID of each rank of \a ranks
+ * \param[in] version            Group version the domains are used from
+ *
+ * \return                       DER_SUCCESS on success, negative value on
+ *                               failure.
+ */
+int crt_group_domains_set(crt_group_t *grp, d_rank_list_t *ranks, uint32_t *domains,
+			  uint32_t version);
+
+/** Domain of the group members without one, see crt_group_domains_set() */
+#define CRT_NO_DOMAIN	(UINT32_MAX)
+
 /**
  * Initialize swim on the specified context index.
  *
@@ -304,6 +304,15 @@ typedef enum {
  */
 #define CRT_RPC_FEAT_QUEUE_FRONT	(1U << 3)
 
+/**
+ * Allow small requests of this opcode to the same endpoint to be packed with
+ * others into one wire message, and their replies to be packed on the way back.
+ * Only applies to RPCs with a reply, not collective, whose encoded input is at
+ * most 1 KiB. Such requests are held until the next crt_progress() call on the
+ * context, at most D_RPC_COALESCE_MAX of them go in one message (0 disables it).
+ */
+#define CRT_RPC_FEAT_COALESCE		(1U << 4)
+
 typedef void *crt_bulk_opid_t;
 
 /** Bulk transfer permissions */
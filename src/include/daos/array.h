@@ -13,6 +13,8 @@
 #include <daos_types.h>
 #include <daos/tse.h>
 
+int dc_array_init(void);
+
 /* task functions for array operations */
 int dc_array_create(tse_task_t *task);
 int dc_array_open(tse_task_t *task);
@@ -24,6 +26,7 @@ int dc_array_read(tse_task_t *task);
 int dc_array_write(tse_task_t *task);
 int dc_array_punch(tse_task_t *task);
 int dc_array_get_size(tse_task_t *task);
+int dc_array_get_size_multi(tse_task_t *task);
 int dc_array_stat(tse_task_t *task);
 int dc_array_set_size(tse_task_t *task);
 int dc_array_local2global(daos_handle_t oh, d_iov_t *glob);
@@ -95,6 +95,8 @@ extern btr_ops_t dbtree_recx_ops;
 
 /**
  * The key is dtx_cos_key: oid + dkey_hash
+ * The DTX CoS is indexed by a hash table now, the class is only used by
+ * dtx_cos_perf as the baseline.
  */
 #define DBTREE_CLASS_DTX_COS (DBTREE_DSM_BEGIN + 7)
 
@@ -905,6 +905,8 @@ enum {
 
 #define DAOS_POOL_EVICT_FAIL		(DAOS_FAIL_UNIT_TEST_GROUP_LOC | 0xa0)
 #define DAOS_POOL_RFCHECK_FAIL		(DAOS_FAIL_UNIT_TEST_GROUP_LOC | 0xa1)
+#define DAOS_ARRAY_IO_DEPTH_CHECK	(DAOS_FAIL_UNIT_TEST_GROUP_LOC | 0xa2)
+#define DAOS_ARRAY_SIZE_CACHE_TMO	(DAOS_FAIL_UNIT_TEST_GROUP_LOC | 0xa3)
 
 #define DAOS_CHK_CONT_ORPHAN		(DAOS_FAIL_UNIT_TEST_GROUP_LOC | 0xb0)
 #define DAOS_CHK_CONT_BAD_LABEL		(DAOS_FAIL_UNIT_TEST_GROUP_LOC | 0xb1)
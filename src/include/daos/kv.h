@@ -20,6 +20,8 @@ int dc_kv_close_direct(daos_handle_t oh);
 int dc_kv_destroy(tse_task_t *task);
 int dc_kv_get(tse_task_t *task);
 int dc_kv_put(tse_task_t *task);
+int dc_kv_get_multi(tse_task_t *task);
+int dc_kv_put_multi(tse_task_t *task);
 int dc_kv_remove(tse_task_t *task);
 int dc_kv_list(tse_task_t *task);
 daos_handle_t daos_kv2objhandle(daos_handle_t oh);
@@ -84,6 +84,8 @@ daos_opc_to_module_str(uint32_t daos_opc)
 enum daos_rpc_flags {
 	/** flag of reply disabled */
 	DAOS_RPC_NO_REPLY	= CRT_RPC_FEAT_NO_REPLY,
+	/** flag of small requests packed with others to the same target */
+	DAOS_RPC_COALESCE	= CRT_RPC_FEAT_COALESCE,
 };
 
 struct daos_rpc_handler {
@@ -16,7 +16,9 @@
 
 /** Flags in rsvc_hint::sh_flags (opaque) */
 enum rsvc_hint_flag {
-	RSVC_HINT_VALID	= 1	/* sh_term and sh_rank contain valid info */
+	RSVC_HINT_VALID		= 1,	/* sh_term and sh_rank contain valid info */
+	RSVC_HINT_READS		= 2,	/* queries may be sent to any replica */
+	RSVC_HINT_FOLLOWER	= 4	/* reply from a replica other than sh_rank */
 };
 
 /** Leadership information (opaque) */
@@ -34,6 +36,7 @@ struct rsvc_client {
 	uint64_t	sc_leader_term;
 	int		sc_leader_index;	/* in sc_ranks */
 	int		sc_next;		/* in sc_ranks */
+	bool		sc_follower_reads;	/* RSVC_HINT_READS seen */
 };
 
 /** Return code of rsvc_client_complete_rpc() */
@@ -45,6 +48,7 @@ enum rsvc_client_complete_rpc_rc {
 int rsvc_client_init(struct rsvc_client *client, const d_rank_list_t *ranks);
 void rsvc_client_fini(struct rsvc_client *client);
 int rsvc_client_choose(struct rsvc_client *client, crt_endpoint_t *ep);
+int rsvc_client_choose_read(struct rsvc_client *client, crt_endpoint_t *ep);
 int rsvc_client_complete_rpc(struct rsvc_client *client,
 			     const crt_endpoint_t *ep, int rc_crt, int rc_svc,
 			     const struct rsvc_hint *hint);
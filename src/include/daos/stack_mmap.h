@@ -68,6 +68,8 @@ struct stack_pool {
 	d_list_t		sp_stack_free_list;
 	/* nb of free stacks in pool/list */
 	uint64_t		sp_free_stacks;
+	/* preferred NUMA node of the stacks mmap()'ed for this pool, -1 for none */
+	int			sp_numa_node;
 };
 
 /* since being allocated before start of stack its size must be a
@@ -103,6 +105,8 @@ int mmap_stack_thread_create_on_xstream(struct stack_pool *sp_alloc, void (*free
 
 int stack_pool_create(struct stack_pool **sp);
 
+int stack_pool_create_numa(struct stack_pool **sp, int numa_node);
+
 void stack_pool_destroy(struct stack_pool *sp);
 
 #define daos_abt_thread_create mmap_stack_thread_create
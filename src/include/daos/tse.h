@@ -86,6 +86,29 @@ int
 tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
 		void *udata);
 
+/** maximum number of run queues of a scheduler */
+#define TSE_SCHED_RUNQ_MAX	64
+
+/**
+ * Initialize the scheduler with per-thread run queues. Ready tasks are queued on the run queue
+ * of the thread that schedules them or that completes their last dependency, and a thread
+ * progressing the scheduler runs the tasks of its own queue before stealing from the other
+ * ones. This avoids serializing multiple threads sharing the scheduler on its lock.
+ * tse_sched_init() uses \a nr_runq from the DAOS_TSE_RUNQ_NR environment variable (0 if unset).
+ *
+ * \param[in] sched		scheduler to be initialized.
+ * \param[in] comp_cb		Optional callback to be called when scheduler is done.
+ * \param[in] udata		Optional pointer to user data, see tse_sched_init().
+ * \param[in] nr_runq		Number of run queues, 0 to use a single scheduler list.
+ *				At most TSE_SCHED_RUNQ_MAX.
+ *
+ * \return			0 if initialization succeeds.
+ * \return			negative errno if initialization fails.
+ */
+int
+tse_sched_init_runq(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb, void *udata,
+		    uint32_t nr_runq);
+
 /**
  * Finish the scheduler.
  *
@@ -324,6 +324,32 @@ daos_array_write(daos_handle_t oh, daos_handle_t th, daos_array_iod_t *iod,
 int
 daos_array_get_size(daos_handle_t oh, daos_handle_t th, daos_size_t *size, daos_event_t *ev);
 
+/** Maximum number of arrays in one daos_array_get_size_multi() call */
+#define DAOS_ARRAY_GET_SIZE_MULTI_MAX	4096
+
+/**
+ * Query the size of many arrays at once. The size queries of all arrays are issued concurrently
+ * and complete \a ev once all are done. Sizes cached on the array handles are returned without
+ * a query if still valid (see DAOS_ARRAY_SIZE_CACHE_TIMEOUT).
+ *
+ * \param[in]	nr	Number of arrays, at most DAOS_ARRAY_GET_SIZE_MULTI_MAX.
+ * \param[in]	ohs	Array of \a nr array object open handles.
+ * \param[in]	th	Transaction handle.
+ * \param[out]	sizes	Array of \a nr returned sizes in number of records.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode (the first error hit by any of the arrays):
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_UNREACH	Network is unreachable
+ */
+int
+daos_array_get_size_multi(uint32_t nr, daos_handle_t *ohs, daos_handle_t th, daos_size_t *sizes,
+			  daos_event_t *ev);
+
 /**
  * Stat array to retrieve size and mtime.
  *
@@ -142,6 +142,78 @@ int
 daos_kv_get(daos_handle_t oh, daos_handle_t th, uint64_t flags, const char *key,
 	    daos_size_t *size, void *buf, daos_event_t *ev);
 
+/** Maximum number of keys in one daos_kv_put_multi() or daos_kv_get_multi() call */
+#define DAOS_KV_MULTI_MAX	4096
+
+/**
+ * Insert or update multiple KV pairs with a single call and completion event. The per-key
+ * updates are issued concurrently.
+ *
+ * This is a client-side fan-out: each key is still sent in its own object update RPC, keys
+ * headed for the same target are not batched into one RPC. It saves the per-call overhead
+ * of the API and of the event, not network round trips.
+ *
+ * \param[in]	oh	Object open handle.
+ * \param[in]	th	Transaction handle.
+ * \param[in]	flags	Update flags, applied to all keys.
+ * \param[in]	nr	Number of keys, at most DAOS_KV_MULTI_MAX.
+ * \param[in]	keys	Array of \a nr keys.
+ * \param[in]	sizes	Array of \a nr value sizes.
+ * \param[in]	bufs	Array of \a nr value buffers.
+ * \param[out]	rcs	Optional array of \a nr per-key return codes. If provided, the failure of
+ *			a key is only reported in its entry and does not fail the whole call.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_NO_PERM	Permission denied
+ *			-DER_UNREACH	Network is unreachable
+ *			-DER_EP_RO	Epoch is read-only
+ */
+int
+daos_kv_put_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags, unsigned int nr,
+		  const char **keys, const daos_size_t *sizes, const void **bufs, int *rcs,
+		  daos_event_t *ev);
+
+/**
+ * Fetch the values of multiple keys with a single call and completion event. The per-key
+ * fetches are issued concurrently.
+ *
+ * As for daos_kv_put_multi(), this is a client-side fan-out of one object fetch RPC per key.
+ *
+ * \param[in]	oh	Object open handle.
+ * \param[in]	th	Transaction handle.
+ * \param[in]	flags	Fetch flags, applied to all keys.
+ * \param[in]	nr	Number of keys, at most DAOS_KV_MULTI_MAX.
+ * \param[in]	keys	Array of \a nr keys.
+ * \param[in,out]
+ *		sizes	[in]: Array of \a nr user buffer sizes (DAOS_REC_ANY if unknown).
+ *			[out]: The actual sizes of the values.
+ * \param[out]	bufs	Array of \a nr user buffers. If NULL, or for NULL entries, only the
+ *			size is returned.
+ * \param[out]	rcs	Optional array of \a nr per-key return codes. If provided, the failure of
+ *			a key is only reported in its entry and does not fail the whole call.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_NO_PERM	Permission denied
+ *			-DER_UNREACH	Network is unreachable
+ *			-DER_REC2BIG	Record does not fit in buffer
+ *			-DER_EP_RO	Epoch is read-only
+ */
+int
+daos_kv_get_multi(daos_handle_t oh, daos_handle_t th, uint64_t flags, unsigned int nr,
+		  const char **keys, daos_size_t *sizes, void **bufs, int *rcs, daos_event_t *ev);
+
 /**
  * Remove a Key and it's value from the KV store
  *
@@ -107,6 +107,10 @@ struct ds_cont_child {
 
 	uint32_t		 sc_dtx_committable_count;
 	uint32_t		 sc_dtx_committable_coll_count;
+	/* Committable count that triggers DTX batched commit, adjusted by the controller. */
+	uint32_t		 sc_dtx_cmt_thd;
+	/* How many times readers had to refresh DTX status on this container. */
+	uint64_t		 sc_dtx_refresh_cnt;
 
 	/* The global minimum EC aggregation epoch, which will be upper
 	 * limit for VOS aggregation, i.e. EC object VOS aggregation can
@@ -126,10 +130,8 @@ struct ds_cont_child {
 	 */
 	uint64_t		sc_ec_update_timestamp;
 
-	/* The objects with committable DTXs in DRAM. */
-	daos_handle_t		 sc_dtx_cos_hdl;
-	/* The DTX COS-btree. */
-	struct btr_root		 sc_dtx_cos_btr;
+	/* The index of the objects with committable DTXs in DRAM. */
+	struct dtx_cos_tab	*sc_dtx_cos_tab;
 	/* The global list for committable non-collective DTXs. */
 	d_list_t		 sc_dtx_cos_list;
 	/* The global list for committable collective DTXs. */
@@ -62,7 +62,8 @@
  * A query sees all (conflicting) updates committed (successfully) before its
  * rdb_tx_begin(). It may or may not see updates committed after its
  * rdb_tx_begin(). And, it currently does not see uncommitted updates, even
- * those in the same TX.
+ * those in the same TX. The same holds for query-only TXs begun on followers
+ * with rdb_tx_begin_follower(), if the database allows them.
  *
  * Updates in a TX are queued, not revealed to queries, until rdb_tx_commit().
  * They are applied sequentially. If one update fails to apply, then the TX is
@@ -186,6 +187,7 @@ void rdb_stop_and_close(struct rdb *db);
 void rdb_resign(struct rdb *db, uint64_t term);
 int rdb_campaign(struct rdb *db);
 bool rdb_is_leader(struct rdb *db, uint64_t *term);
+bool rdb_follower_reads_enabled(struct rdb *db);
 int rdb_get_leader(struct rdb *db, uint64_t *term, d_rank_t *rank);
 int rdb_get_ranks(struct rdb *db, d_rank_list_t **ranksp);
 int rdb_get_size(struct rdb *db, size_t *sizep);
@@ -263,6 +265,7 @@ struct rdb_tx {
 /** TX methods */
 int rdb_tx_begin(struct rdb *db, uint64_t term, struct rdb_tx *tx);
 int rdb_tx_begin_local(struct rdb_storage *storage, struct rdb_tx *tx);
+int rdb_tx_begin_follower(struct rdb *db, struct rdb_tx *tx);
 void rdb_tx_discard(struct rdb_tx *tx);
 int rdb_tx_commit(struct rdb_tx *tx);
 void rdb_tx_end(struct rdb_tx *tx);
@@ -933,6 +933,18 @@ typedef struct {
 	daos_size_t		*size;
 } daos_array_get_size_t;
 
+/** Array get size of multiple arrays args */
+typedef struct {
+	/** Number of arrays. */
+	uint32_t		nr;
+	/** Array open handles. */
+	daos_handle_t		*ohs;
+	/** Transaction open handle. */
+	daos_handle_t		th;
+	/** Returned array sizes in number of records. */
+	daos_size_t		*sizes;
+} daos_array_get_size_multi_t;
+
 /** Array stat args */
 typedef struct {
 	/** Array open handle. */
@@ -1019,6 +1031,26 @@ typedef struct {
 	const void		*buf;
 } daos_kv_put_t;
 
+/** KV multi-key get/put args */
+typedef struct {
+	/** KV open handle. */
+	daos_handle_t		oh;
+	/** Transaction open handle. */
+	daos_handle_t		th;
+	/** Operation flags. */
+	uint64_t		flags;
+	/** Number of keys. */
+	uint32_t		nr;
+	/** Keys. */
+	const char		**keys;
+	/** Value sizes, updated with the actual value sizes on get. */
+	daos_size_t		*sizes;
+	/** Value buffers. */
+	void			**bufs;
+	/** Optional per-key return codes. */
+	int			*rcs;
+} daos_kv_multi_t;
+
 /** KV remove args */
 typedef struct {
 	/** KV open handle. */
@@ -63,6 +63,12 @@ extern void (*d_alt_assert)(const int, const char*, const char*, const int);
 /**< Env to specify stderr merge with logfile*/
 #define D_LOG_STDERR_IN_LOG_ENV	"D_LOG_STDERR_IN_LOG"
 
+/**< Env to enable the asynchronous log writer */
+#define D_LOG_ASYNC_ENV			"D_LOG_ASYNC"
+
+/**< Env to specify the per-thread ring size of the asynchronous log writer */
+#define D_LOG_ASYNC_RING_SIZE_ENV	"D_LOG_ASYNC_RING_SIZE"
+
 /* Enable shadow warning where users use same variable name in nested scope.  This enables use of a
  * variable in the macro below and is just good coding practice.
  */
@@ -447,6 +447,13 @@ void d_log_add_cache(int *cache, int nr);
  */
 void d_log_sync(void);
 
+/**
+ * Return the number of messages dropped by the asynchronous log writer
+ * because the ring of the logging thread was full. Always 0 when the
+ * log is written synchronously.
+ */
+uint64_t d_log_dropped(void);
+
 /**
  * disable logging by resetting fd for logging
  */
@@ -205,6 +205,19 @@ enum d_hash_feats {
 	 */
 	D_HASH_FT_NO_KEYINIT_LOCK	= (1 << 5),
 
+	/**
+	 * The hash table grows and shrinks with the number of records, it
+	 * never shrinks below the size given at creation. Buckets are moved
+	 * to the resized table incrementally by the operations on the table,
+	 * and the table is protected by a fixed number of lock stripes
+	 * instead of per-bucket locks.
+	 *
+	 * hop_rec_hash() is mandatory, and hop_key_hash()/hop_rec_hash()
+	 * should return the full hash value without masking it with ht_bits,
+	 * which changes as the table is resized.
+	 */
+	D_HASH_FT_RESIZE		= (1 << 6),
+
 	/**
 	 * Use Global Table Lock instead of per bucket locking.
 	 * TODO: should be removed when all will use per bucket locking.
@@ -225,6 +238,11 @@ struct d_hash_bucket {
 #endif
 };
 
+/** D_HASH_FT_RESIZE: bits of the number of lock stripes */
+#define D_HASH_STRIPE_BITS	6
+/** D_HASH_FT_RESIZE: the table never grows beyond power2(D_HASH_BITS_MAX) buckets */
+#define D_HASH_BITS_MAX		26
+
 struct d_hash_table {
 	/** different type of locks based on ht_feats */
 	union d_hash_lock	 ht_lock;
@@ -232,6 +250,24 @@ struct d_hash_table {
 	uint32_t		 ht_bits;
 	/** feature bits */
 	uint32_t		 ht_feats;
+	/** bits to generate number of locks, same as ht_bits w/o D_HASH_FT_RESIZE */
+	uint32_t		 ht_lock_bits;
+	/** D_HASH_FT_RESIZE: the table never shrinks below power2(ht_min_bits) */
+	uint32_t		 ht_min_bits;
+	/** D_HASH_FT_RESIZE: number of records */
+	ATOMIC uint32_t		 ht_rec_nr;
+	/** D_HASH_FT_RESIZE: a resize is in progress */
+	ATOMIC bool		 ht_resizing;
+	/** resizing: next lock stripe to move to the new buckets */
+	ATOMIC uint32_t		 ht_move_next;
+	/** resizing: number of lock stripes moved to the new buckets */
+	ATOMIC uint32_t		 ht_move_done;
+	/** resizing: bits of the new table */
+	uint32_t		 ht_new_bits;
+	/** resizing: array of new buckets */
+	struct d_hash_bucket	*ht_new_buckets;
+	/** resizing: per lock stripe, buckets of the stripe are in ht_new_buckets */
+	bool			*ht_moved;
 #if D_HASH_DEBUG
 	/** maximum search depth ever */
 	unsigned int		 ht_dep_max;
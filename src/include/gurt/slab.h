@@ -10,6 +10,7 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 
 /* A data structure used to describe and register a type */
 struct d_slab_reg {
@@ -32,6 +33,8 @@ struct d_slab_reg {
 	int   sr_max_desc;
 	/* Maximum number of descriptors to exist on the free_list */
 	int   sr_max_free_desc;
+	/* Do not use per-thread magazines, serialize every call on the type lock */
+	bool  sr_no_mag;
 };
 
 /* If max_desc is non-zero then at most max_desc descriptors can exist
@@ -40,6 +43,32 @@ struct d_slab_reg {
  * however once max_desc is reached no more descriptors will be created.
  */
 
+/* Unless max_desc is set or sr_no_mag is requested, each type also keeps
+ * D_SLAB_MAG_NR magazines, small stacks of objects which threads use without
+ * taking the type lock.  A thread picks one magazine on first use, acquire()
+ * pops from its free stack and release() pushes to its pending stack, and only
+ * an empty free stack or a full pending stack is exchanged with the shared
+ * free and pending lists (the depot) in a batch under the lock.  Objects
+ * cached in magazines are not counted in free_count/pending_count, so up to
+ * D_SLAB_MAG_NR * D_SLAB_MAG_SIZE objects may be held beyond max_free_desc.
+ */
+#define D_SLAB_MAG_NR    64
+#define D_SLAB_MAG_SIZE  16
+/* Number of objects moved from the depot to refill an empty magazine */
+#define D_SLAB_MAG_BATCH 8
+
+struct d_slab_mag {
+	/* Set while a thread is using the magazine */
+	ATOMIC bool sm_busy;
+	int         sm_free_count;
+	int         sm_pending_count;
+	/* Statistics counters, calls served without the type lock */
+	int         sm_acquire_count;
+	int         sm_release_count;
+	void       *sm_free[D_SLAB_MAG_SIZE];
+	void       *sm_pending[D_SLAB_MAG_SIZE];
+} __attribute__((aligned(64)));
+
 #define POOL_TYPE_INIT(itype, imember)                                                             \
 	.sr_size = sizeof(struct itype), .sr_offset = offsetof(struct itype, imember),             \
 	.sr_name = #itype,
@@ -55,6 +84,8 @@ struct d_slab_type {
 	pthread_mutex_t   st_lock;
 	struct d_slab    *st_slab;
 	void             *st_arg;
+	/* Per-thread magazines, NULL if disabled for this type */
+	struct d_slab_mag *st_mags;
 
 	/* Counters for current number of objects */
 	int               st_count;         /* Total currently created */
@@ -72,6 +103,11 @@ struct d_slab_type {
 	/* Number of sequental calls to acquire() without a call to restock() */
 	int               st_no_restock;     /* Current count */
 	int               st_no_restock_hwm; /* High water mark */
+	/* Magazine exchanges with the depot */
+	int               st_depot_hit;   /* Refills served from the free list */
+	int               st_depot_miss;  /* Refills which had to create an object */
+	int               st_depot_flush; /* Pending stacks returned to the depot */
+	int               st_mag_busy;    /* Calls which found their magazine in use */
 };
 
 struct d_slab {
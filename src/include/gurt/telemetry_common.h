@@ -16,6 +16,8 @@
 #define D_TM_MAX_UNIT_LEN		32
 #define D_TM_TIME_BUFF_LEN		26
 
+#define D_TM_SHARDS_MAX			1024
+
 #define D_TM_SHARED_MEMORY_KEY		0x10242048
 #define D_TM_SHARED_MEMORY_SIZE		(1024 * 1024)
 
@@ -210,6 +212,29 @@ struct d_tm_histogram_t {
 	int			dth_value_multiplier;
 };
 
+/** Default precision and range of log-linear histograms, 12.5% error up to 2^25 (~33s in us) */
+#define D_TM_HDR_SUB_BITS		3
+#define D_TM_HDR_MAX_BITS		25
+
+#define D_TM_HDR_BUCKET_NR(sub_bits, max_bits)	(((max_bits) - (sub_bits) + 1) << (sub_bits))
+#define D_TM_HDR_SIZE(sub_bits, max_bits)					\
+	(sizeof(struct d_tm_hdr_histogram_t) +					\
+	 D_TM_HDR_BUCKET_NR(sub_bits, max_bits) * sizeof(uint64_t))
+
+/**
+ * Log-linear (HDR-like) histogram: values below 2^sub_bits have one bucket
+ * each, then every power of two range is split into 2^sub_bits buckets, which
+ * bounds the relative error of the reported percentiles by 2^-sub_bits.
+ * Values of 2^max_bits and beyond are counted in the last bucket.
+ */
+struct d_tm_hdr_histogram_t {
+	_Atomic uint64_t	*dhh_counts;
+	_Atomic uint64_t	dhh_max; /** largest recorded value */
+	int			dhh_sub_bits;
+	int			dhh_max_bits;
+	int			dhh_bucket_nr;
+};
+
 struct d_tm_meminfo_t {
 	uint64_t arena;
 	uint64_t ordblks;
@@ -217,6 +242,24 @@ struct d_tm_meminfo_t {
 	uint64_t fordblks;
 };
 
+/** Cache line size the slots of a sharded metric are padded and aligned to */
+#define D_TM_SHARD_ALIGN		64
+
+/**
+ * Per-writer slot of a sharded counter or gauge. Each slot spans a cache line so that writers
+ * updating different slots never share one.
+ */
+struct d_tm_shard_t {
+	_Atomic uint64_t	dts_value;
+	/** statistics of the values set by this shard, for D_TM_STATS_GAUGE */
+	_Atomic uint64_t	dts_min;
+	_Atomic uint64_t	dts_max;
+	_Atomic uint64_t	dts_sum;
+	_Atomic uint64_t	dts_sum_of_squares;
+	_Atomic uint64_t	dts_sample_size;
+	uint64_t		dts_pad[D_TM_SHARD_ALIGN / sizeof(uint64_t) - 6];
+} __attribute__((__aligned__(D_TM_SHARD_ALIGN)));
+
 struct d_tm_metric_t {
 	union data {
 		uint64_t	value;
@@ -225,8 +268,11 @@ struct d_tm_metric_t {
 	}			dtm_data;
 	struct d_tm_stats_t	*dtm_stats;
 	struct d_tm_histogram_t	*dtm_histogram;
+	struct d_tm_hdr_histogram_t *dtm_hdr; /** log-linear histogram */
 	char			*dtm_desc;
 	char			*dtm_units;
+	struct d_tm_shard_t	*dtm_shards; /** per-writer slots, NULL if not sharded */
+	int			dtm_shard_nr;
 };
 
 struct d_tm_node_t {
@@ -254,6 +300,9 @@ struct d_tm_nodeList_t {
 			  D_TM_MAX_DESC_LEN + D_TM_MAX_NAME_LEN + D_TM_MAX_UNIT_LEN + \
 			  sizeof(struct d_tm_stats_t))
 
+/** Size of the slots of a sharded metric, with the padding aligning them */
+#define D_TM_SHARDS_SIZE(nr_shards) (((nr_shards) + 1) * sizeof(struct d_tm_shard_t))
+
 /** Context for a telemetry instance */
 struct d_tm_context;
 
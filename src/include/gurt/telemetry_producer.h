@@ -27,8 +27,12 @@ int
     d_tm_init_with_name(int id, uint64_t mem_size, int flags, const char *root_name);
 int d_tm_init_histogram(struct d_tm_node_t *node, char *path, int num_buckets,
 			int initial_width, int multiplier);
+int d_tm_init_hdr_histogram(struct d_tm_node_t *node, int sub_bits, int max_bits);
 int d_tm_add_metric(struct d_tm_node_t **node, int metric_type, char *desc,
 		    char *units, const char *fmt, ...);
+int d_tm_add_sharded_metric(struct d_tm_node_t **node, int metric_type, int nr_shards,
+			    char *desc, char *units, const char *fmt, ...);
+void d_tm_set_shard(int shard);
 int d_tm_add_ephemeral_dir(struct d_tm_node_t **node, size_t size_bytes,
 			   const char *fmt, ...);
 int
@@ -40,9 +40,9 @@ dc_obj_tls_init(int tags, int xs_id, int pid)
 	/** register different per-opcode sensors */
 	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
 		/** Start with number of active requests, of type gauge */
-		rc = d_tm_add_metric(&tls->cot_op_active[opc], D_TM_STATS_GAUGE,
-				     "number of active object RPCs", "ops", "%lu/io/ops/%s/active",
-				     tid, obj_opc_to_str(opc));
+		rc = d_tm_add_sharded_metric(&tls->cot_op_active[opc], D_TM_STATS_GAUGE, 1,
+					     "number of active object RPCs", "ops",
+					     "%lu/io/ops/%s/active", tid, obj_opc_to_str(opc));
 		if (rc) {
 			D_WARN("Failed to create active counter: " DF_RC "\n", DP_RC(rc));
 			D_GOTO(out, rc);
@@ -54,13 +54,14 @@ dc_obj_tls_init(int tags, int xs_id, int pid)
 			continue;
 
 		/** And finally the per-opcode latency, of type gauge */
-		rc = d_tm_add_metric(&tls->cot_op_lat[opc], D_TM_STATS_GAUGE,
-				     "object RPC processing time", "us", "%lu/io/ops/%s/latency",
-				     tid, obj_opc_to_str(opc));
+		rc = d_tm_add_sharded_metric(&tls->cot_op_lat[opc], D_TM_STATS_GAUGE, 1,
+					     "object RPC processing time", "us",
+					     "%lu/io/ops/%s/latency", tid, obj_opc_to_str(opc));
 		if (rc) {
 			D_WARN("Failed to create latency sensor: " DF_RC "\n", DP_RC(rc));
 			D_GOTO(out, rc);
 		}
+		obj_latency_hdr_init(tls->cot_op_lat[opc]);
 	}
 
 	/**
@@ -79,6 +80,11 @@ dc_obj_tls_init(int tags, int xs_id, int pid)
 	if (rc)
 		D_GOTO(out, rc);
 
+	for (opc = 0; opc < NR_LATENCY_BUCKETS; opc++) {
+		obj_latency_hdr_init(tls->cot_update_lat[opc]);
+		obj_latency_hdr_init(tls->cot_fetch_lat[opc]);
+	}
+
 out:
 	if (rc) {
 		D_FREE(tls);
@@ -642,6 +642,8 @@ struct dc_obj_tls {
 int
 obj_latency_tm_init(uint32_t opc, int tgt_id, struct d_tm_node_t **tm, char *op, char *desc,
 		    bool server);
+void
+obj_latency_hdr_init(struct d_tm_node_t *tm);
 extern struct daos_module_key dc_obj_module_key;
 
 static inline struct dc_obj_tls *
@@ -654,6 +656,9 @@ dc_obj_tls_get()
 	return daos_module_key_get(dtls, &dc_obj_module_key);
 }
 
+/** Shards of the object pool metrics of a client, updated by all its threads */
+#define OBJ_CLI_METRICS_SHARDS	8
+
 struct obj_pool_metrics {
 	/** Count number of total per-opcode requests (type = counter) */
 	struct d_tm_node_t *opm_total[OBJ_PROTO_CLI_COUNT];
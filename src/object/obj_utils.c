@@ -127,7 +127,8 @@ obj_latency_tm_init(uint32_t opc, int tgt_id, struct d_tm_node_t **tm, char *op,
 			else /** >4MB */
 				D_ASPRINTF(path, "%lu/io/latency/%s/GT4MB", tid, op);
 		}
-		rc = d_tm_add_metric(&tm[i], D_TM_STATS_GAUGE, desc, "us", path);
+		/** a single writer, the target xstream or the client thread */
+		rc = d_tm_add_sharded_metric(&tm[i], D_TM_STATS_GAUGE, 1, desc, "us", "%s", path);
 		if (rc)
 			D_WARN("Failed to create per-I/O size latency "
 			       "sensor: " DF_RC "\n",
@@ -140,6 +141,25 @@ obj_latency_tm_init(uint32_t opc, int tgt_id, struct d_tm_node_t **tm, char *op,
 	return rc;
 }
 
+/**
+ * Attach a log-linear histogram to a latency sensor, so that its tail
+ * percentiles can be queried. It is optional: the sensor keeps reporting its
+ * stats when the telemetry region is too small to hold the histogram.
+ */
+void
+obj_latency_hdr_init(struct d_tm_node_t *tm)
+{
+	int rc;
+
+	/** sensor creation failed and was already reported */
+	if (tm == NULL)
+		return;
+
+	rc = d_tm_init_hdr_histogram(tm, D_TM_HDR_SUB_BITS, D_TM_HDR_MAX_BITS);
+	if (rc)
+		D_WARN("Failed to create latency histogram: " DF_RC "\n", DP_RC(rc));
+}
+
 void
 obj_metrics_free(void *data)
 {
@@ -158,13 +178,21 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	struct obj_pool_metrics *metrics;
 	char                     tgt_path[32];
 	uint32_t                 opc;
+	int                      shards;
 	int                      rc;
 
+	/**
+	 * The engine metrics are per target, only updated by its xstream, while those of a client
+	 * are shared by all the threads of the process.
+	 */
 	D_ASSERT(tgt_id >= 0);
-	if (server)
+	if (server) {
 		snprintf(tgt_path, sizeof(tgt_path), "/tgt_%u", tgt_id);
-	else
+		shards = 1;
+	} else {
 		tgt_path[0] = '\0';
+		shards = OBJ_CLI_METRICS_SHARDS;
+	}
 
 	D_ALLOC_PTR(metrics);
 	if (metrics == NULL) {
@@ -175,68 +203,68 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	/** register different per-opcode counters */
 	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
 		/** Then the total number of requests, of type counter */
-		rc = d_tm_add_metric(&metrics->opm_total[opc], D_TM_COUNTER,
-				     "total number of processed object RPCs", "ops", "%s/ops/%s%s",
-				     path, obj_opc_to_str(opc), tgt_path);
+		rc = d_tm_add_sharded_metric(&metrics->opm_total[opc], D_TM_COUNTER, shards,
+					     "total number of processed object RPCs", "ops",
+					     "%s/ops/%s%s", path, obj_opc_to_str(opc), tgt_path);
 		if (rc)
 			D_WARN("Failed to create total counter: " DF_RC "\n", DP_RC(rc));
 	}
 
 	/** Total number of silently restarted updates, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_restart, D_TM_COUNTER,
-			     "total number of restarted update ops", "updates", "%s/restarted%s",
-			     path, tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_update_restart, D_TM_COUNTER, shards,
+				     "total number of restarted update ops", "updates",
+				     "%s/restarted%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create restarted counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of resent updates, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_resent, D_TM_COUNTER,
-			     "total number of resent update RPCs", "updates", "%s/resent%s", path,
-			     tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_update_resent, D_TM_COUNTER, shards,
+				     "total number of resent update RPCs", "updates",
+				     "%s/resent%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create resent counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of retry updates locally, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_retry, D_TM_COUNTER,
-			     "total number of retried update RPCs", "updates", "%s/retry%s", path,
-			     tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_update_retry, D_TM_COUNTER, shards,
+				     "total number of retried update RPCs", "updates",
+				     "%s/retry%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create retry cnt sensor: " DF_RC "\n", DP_RC(rc));
 
 	/** Total bytes read */
-	rc = d_tm_add_metric(&metrics->opm_fetch_bytes, D_TM_COUNTER,
-			     "total number of bytes fetched/read", "bytes", "%s/xferred/fetch%s",
-			     path, tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_fetch_bytes, D_TM_COUNTER, shards,
+				     "total number of bytes fetched/read", "bytes",
+				     "%s/xferred/fetch%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create bytes fetch counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total bytes written */
-	rc = d_tm_add_metric(&metrics->opm_update_bytes, D_TM_COUNTER,
-			     "total number of bytes updated/written", "bytes",
-			     "%s/xferred/update%s", path, tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_update_bytes, D_TM_COUNTER, shards,
+				     "total number of bytes updated/written", "bytes",
+				     "%s/xferred/update%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create bytes update counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of EC full-stripe update operations, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_ec_full, D_TM_COUNTER,
-			     "total number of EC full-stripe updates", "updates",
-			     "%s/EC_update/full_stripe%s", path, tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_update_ec_full, D_TM_COUNTER, shards,
+				     "total number of EC full-stripe updates", "updates",
+				     "%s/EC_update/full_stripe%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create EC full stripe update counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of EC partial update operations, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_ec_partial, D_TM_COUNTER,
-			     "total number of EC partial updates", "updates",
-			     "%s/EC_update/partial%s", path, tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_update_ec_partial, D_TM_COUNTER, shards,
+				     "total number of EC partial updates", "updates",
+				     "%s/EC_update/partial%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create EC partial update counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of times EC aggregation conflicts with discard or VOS
 	 * aggregation
 	 */
-	rc = d_tm_add_metric(&metrics->opm_ec_agg_blocked, D_TM_COUNTER,
-			     "total number of EC agg pauses due to VOS discard or agg", NULL,
-			     "%s/EC_agg/blocked%s", path, tgt_path);
+	rc = d_tm_add_sharded_metric(&metrics->opm_ec_agg_blocked, D_TM_COUNTER, shards,
+				     "total number of EC agg pauses due to VOS discard or agg",
+				     NULL, "%s/EC_agg/blocked%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create EC agg blocked counter: " DF_RC "\n", DP_RC(rc));
 
@@ -98,10 +98,10 @@ obj_tls_init(int tags, int xs_id, int tgt_id)
 	/** register different per-opcode sensors */
 	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
 		/** Start with number of active requests, of type gauge */
-		rc = d_tm_add_metric(&tls->ot_op_active[opc], D_TM_STATS_GAUGE,
-				     "number of active object RPCs", "ops",
-				     "io/ops/%s/active/tgt_%u",
-				     obj_opc_to_str(opc), tgt_id);
+		rc = d_tm_add_sharded_metric(&tls->ot_op_active[opc], D_TM_STATS_GAUGE, 1,
+					     "number of active object RPCs", "ops",
+					     "io/ops/%s/active/tgt_%u",
+					     obj_opc_to_str(opc), tgt_id);
 		if (rc)
 			D_WARN("Failed to create active counter: "DF_RC"\n",
 			       DP_RC(rc));
@@ -113,13 +113,15 @@ obj_tls_init(int tags, int xs_id, int tgt_id)
 			continue;
 
 		/** And finally the per-opcode latency, of type gauge */
-		rc = d_tm_add_metric(&tls->ot_op_lat[opc], D_TM_STATS_GAUGE,
-				     "object RPC processing time", "us",
-				     "io/ops/%s/latency/tgt_%u",
-				     obj_opc_to_str(opc), tgt_id);
+		rc = d_tm_add_sharded_metric(&tls->ot_op_lat[opc], D_TM_STATS_GAUGE, 1,
+					     "object RPC processing time", "us",
+					     "io/ops/%s/latency/tgt_%u",
+					     obj_opc_to_str(opc), tgt_id);
 		if (rc)
 			D_WARN("Failed to create latency sensor: "DF_RC"\n",
 			       DP_RC(rc));
+		else
+			obj_latency_hdr_init(tls->ot_op_lat[opc]);
 	}
 
 	/**
@@ -136,6 +138,12 @@ obj_tls_init(int tags, int xs_id, int tgt_id)
 	obj_latency_tm_init(DAOS_OBJ_RPC_TGT_UPDATE, tgt_id, tls->ot_tgt_update_lat,
 			    obj_opc_to_str(DAOS_OBJ_RPC_TGT_UPDATE),
 			    "update tgt RPC processing time", true);
+	for (opc = 0; opc < NR_LATENCY_BUCKETS; opc++) {
+		obj_latency_hdr_init(tls->ot_update_lat[opc]);
+		obj_latency_hdr_init(tls->ot_fetch_lat[opc]);
+		obj_latency_hdr_init(tls->ot_tgt_update_lat[opc]);
+	}
+
 	obj_latency_tm_init(DAOS_OBJ_RPC_UPDATE, tgt_id, tls->ot_update_bulk_lat, "bulk_update",
 			    "Bulk update processing time", true);
 	obj_latency_tm_init(DAOS_OBJ_RPC_FETCH, tgt_id, tls->ot_fetch_bulk_lat, "bulk_fetch",
@@ -430,12 +430,13 @@ failed:
 
 /* Choose a pool service replica rank by label or UUID. If the rsvc module
  * indicates DER_NOTREPLICA, (clients only) try to refresh the list by querying
- * the MS.
+ * the MS. For query-only RPCs, \a read allows any replica to be chosen if the
+ * service serves queries on followers.
  */
-int
-dc_pool_choose_svc_rank(const char *label, uuid_t puuid,
-			struct rsvc_client *cli, pthread_mutex_t *cli_lock,
-			struct dc_mgmt_sys *sys, crt_endpoint_t *ep)
+static int
+choose_svc_rank(const char *label, uuid_t puuid, struct rsvc_client *cli,
+		pthread_mutex_t *cli_lock, struct dc_mgmt_sys *sys, bool read,
+		crt_endpoint_t *ep)
 {
 	int			rc;
 	int			i;
@@ -443,7 +444,10 @@ dc_pool_choose_svc_rank(const char *label, uuid_t puuid,
 	if (cli_lock)
 		D_MUTEX_LOCK(cli_lock);
 choose:
-	rc = rsvc_client_choose(cli, ep);
+	if (read)
+		rc = rsvc_client_choose_read(cli, ep);
+	else
+		rc = rsvc_client_choose(cli, ep);
 	if ((rc == -DER_NOTREPLICA) && !sys->sy_server) {
 		d_rank_list_t *ranklist = NULL;
 
@@ -480,6 +484,14 @@ choose:
 	return rc;
 }
 
+int
+dc_pool_choose_svc_rank(const char *label, uuid_t puuid,
+			struct rsvc_client *cli, pthread_mutex_t *cli_lock,
+			struct dc_mgmt_sys *sys, crt_endpoint_t *ep)
+{
+	return choose_svc_rank(label, puuid, cli, cli_lock, sys, false /* read */, ep);
+}
+
 struct subtract_rsvc_rank_arg {
 	struct pool_domain *srra_nodes;
 	int                 srra_nodes_len;
@@ -1892,9 +1904,10 @@ dc_pool_query(tse_task_t *task)
 		args->ranks, args->info);
 
 	ep.ep_grp = pool->dp_sys->sy_group;
-	rc = dc_pool_choose_svc_rank(NULL /* label */, pool->dp_pool,
-				     &pool->dp_client, &pool->dp_client_lock,
-				     pool->dp_sys, &ep);
+	/* Only the leader tracks the rebuild status. */
+	rc = choose_svc_rank(NULL /* label */, pool->dp_pool, &pool->dp_client,
+			     &pool->dp_client_lock, pool->dp_sys,
+			     args->info == NULL || !(args->info->pi_bits & DPI_REBUILD_STATUS), &ep);
 	if (rc != 0) {
 		D_ERROR(DF_UUID": cannot find pool service: "DF_RC"\n",
 			DP_UUID(pool->dp_pool), DP_RC(rc));
@@ -259,9 +259,7 @@ int ds_pool_iv_init(void);
 int ds_pool_iv_fini(void);
 void ds_pool_map_refresh_ult(void *arg);
 
-int ds_pool_iv_conn_hdl_update(struct ds_pool *pool, uuid_t hdl_uuid,
-			       uint64_t flags, uint64_t capas, d_iov_t *cred,
-			       uint32_t global_ver, uint32_t obj_layout_ver);
+int ds_pool_iv_conn_hdls_update(struct ds_pool *pool, struct pool_iv_conn **conns, int nr);
 
 int ds_pool_iv_srv_hdl_update(struct ds_pool *pool, uuid_t pool_hdl_uuid,
 			      uuid_t cont_hdl_uuid);
@@ -1262,37 +1262,38 @@ ds_pool_iv_map_update(struct ds_pool *pool, struct pool_buf *buf, uint32_t map_v
 	return rc;
 }
 
+/* Distribute the \a nr pool handles in \a conns with one IV update. */
 int
-ds_pool_iv_conn_hdl_update(struct ds_pool *pool, uuid_t hdl_uuid,
-			   uint64_t flags, uint64_t sec_capas,
-			   d_iov_t *cred, uint32_t global_ver, uint32_t layout_ver)
+ds_pool_iv_conn_hdls_update(struct ds_pool *pool, struct pool_iv_conn **conns, int nr)
 {
 	struct pool_iv_entry	*iv_entry;
 	daos_size_t		iv_entry_size;
 	struct pool_iv_conn	*pic;
+	int			i;
 	int			rc;
 
-	iv_entry_size = pool_iv_conn_ent_size(cred->iov_len);
+	D_ASSERT(nr > 0);
+	iv_entry_size = sizeof(*iv_entry);
+	for (i = 0; i < nr; i++)
+		iv_entry_size += pool_iv_conn_size(conns[i]->pic_cred_size);
 	D_ALLOC(iv_entry, iv_entry_size);
 	if (iv_entry == NULL)
 		return -DER_NOMEM;
 
-	iv_entry->piv_conn_hdls.pic_size = pool_iv_conn_size(cred->iov_len);
-	iv_entry->piv_conn_hdls.pic_buf_size = pool_iv_conn_size(cred->iov_len);
+	iv_entry->piv_conn_hdls.pic_size = iv_entry_size - sizeof(*iv_entry);
+	iv_entry->piv_conn_hdls.pic_buf_size = iv_entry_size - sizeof(*iv_entry);
 	pic = &iv_entry->piv_conn_hdls.pic_conns[0];
-	uuid_copy(pic->pic_hdl, hdl_uuid);
-	pic->pic_flags = flags;
-	pic->pic_capas = sec_capas;
-	pic->pic_cred_size = cred->iov_len;
-	pic->pic_global_ver = global_ver;
-	pic->pic_obj_ver = layout_ver;
-	memcpy(&pic->pic_creds[0], cred->iov_buf, cred->iov_len);
-
-	rc = pool_iv_update(pool->sp_iv_ns, IV_POOL_CONN, hdl_uuid,
+	for (i = 0; i < nr; i++) {
+		memcpy(pic, conns[i], pool_iv_conn_size(conns[i]->pic_cred_size));
+		pic = pool_iv_conn_next(pic);
+	}
+
+	/* Keyed by the first handle, only used for invalidations. */
+	rc = pool_iv_update(pool->sp_iv_ns, IV_POOL_CONN, conns[0]->pic_hdl,
 			    iv_entry, iv_entry_size, CRT_IV_SHORTCUT_NONE,
 			    CRT_IV_SYNC_EAGER, false);
-	D_DEBUG(DB_MD, DF_UUID" distribute hdl "DF_UUID" capas "DF_U64" %d\n",
-		DP_UUID(pool->sp_uuid), DP_UUID(hdl_uuid), sec_capas, rc);
+	D_DEBUG(DB_MD, DF_UUID" distribute %d hdls from "DF_UUID": %d\n",
+		DP_UUID(pool->sp_uuid), nr, DP_UUID(conns[0]->pic_hdl), rc);
 
 	D_FREE(iv_entry);
 	return rc;
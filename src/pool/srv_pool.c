@@ -190,6 +190,14 @@ sched_cancel_and_wait(struct pool_svc_sched *sched)
 	sched_wait(sched);
 }
 
+/* Connect requests waiting to be handled in batches, see pool_connect_submit */
+struct pool_svc_connects {
+	ABT_mutex	pcs_mutex;
+	ABT_cond	pcs_cv;
+	d_list_t	pcs_queue;	/* of pool_connect_req */
+	bool		pcs_busy;	/* a batch is being handled */
+};
+
 /* Pool service */
 struct pool_svc {
 	struct ds_rsvc		ps_rsvc;
@@ -207,6 +215,7 @@ struct pool_svc {
 	bool                    ps_force_notify; /* MS of PS membership */
 	struct pool_svc_sched	ps_reconf_sched;
 	struct pool_svc_sched   ps_rfcheck_sched;      /* Check all containers RF for the pool */
+	struct pool_svc_connects ps_connects;
 	uint32_t                ps_ops_enabled;        /* cached ds_pool_prop_svc_ops_enabled */
 	uint32_t                ps_ops_max;            /* cached ds_pool_prop_svc_ops_max */
 	uint32_t                ps_ops_age;            /* cached ds_pool_prop_svc_ops_age */
@@ -1280,14 +1289,31 @@ pool_svc_alloc_cb(d_iov_t *id, struct ds_rsvc **rsvc)
 	if (rc != 0)
 		goto err_sched;
 
+	D_INIT_LIST_HEAD(&svc->ps_connects.pcs_queue);
+	rc = ABT_mutex_create(&svc->ps_connects.pcs_mutex);
+	if (rc != ABT_SUCCESS) {
+		rc = dss_abterr2der(rc);
+		goto err_cont_rf_sched;
+	}
+
+	rc = ABT_cond_create(&svc->ps_connects.pcs_cv);
+	if (rc != ABT_SUCCESS) {
+		rc = dss_abterr2der(rc);
+		goto err_connects_mutex;
+	}
+
 	rc = ds_cont_svc_init(&svc->ps_cont_svc, svc->ps_uuid, 0 /* id */,
 			      &svc->ps_rsvc);
 	if (rc != 0)
-		goto err_cont_rf_sched;
+		goto err_connects_cv;
 
 	*rsvc = &svc->ps_rsvc;
 	return 0;
 
+err_connects_cv:
+	ABT_cond_free(&svc->ps_connects.pcs_cv);
+err_connects_mutex:
+	ABT_mutex_free(&svc->ps_connects.pcs_mutex);
 err_cont_rf_sched:
 	sched_fini(&svc->ps_rfcheck_sched);
 err_sched:
@@ -1782,6 +1808,9 @@ pool_svc_free_cb(struct ds_rsvc *rsvc)
 	struct pool_svc *svc = pool_svc_obj(rsvc);
 
 	ds_cont_svc_fini(&svc->ps_cont_svc);
+	D_ASSERT(d_list_empty(&svc->ps_connects.pcs_queue));
+	ABT_cond_free(&svc->ps_connects.pcs_cv);
+	ABT_mutex_free(&svc->ps_connects.pcs_mutex);
 	sched_fini(&svc->ps_reconf_sched);
 	sched_fini(&svc->ps_rfcheck_sched);
 	ABT_cond_free(&svc->ps_events.pse_cv);
@@ -2507,6 +2536,27 @@ pool_svc_put_leader(struct pool_svc *svc)
 	ds_rsvc_put_leader(&svc->ps_rsvc);
 }
 
+/*
+ * Look up a non-leader replica that may serve queries with
+ * rdb_tx_begin_follower. Put it with ds_rsvc_put.
+ */
+static int
+pool_svc_lookup_follower(uuid_t uuid, struct pool_svc **svcp)
+{
+	struct pool_svc	*svc;
+	int		 rc;
+
+	rc = pool_svc_lookup(uuid, &svc);
+	if (rc != 0)
+		return rc;
+	if (svc->ps_rsvc.s_stop || !rdb_follower_reads_enabled(svc->ps_rsvc.s_db)) {
+		ds_rsvc_put(&svc->ps_rsvc);
+		return -DER_NOTLEADER;
+	}
+	*svcp = svc;
+	return 0;
+}
+
 int
 ds_pool_svc_lookup_leader(uuid_t uuid, struct ds_pool_svc **ds_svcp, struct rsvc_hint *hint)
 {
@@ -3502,9 +3552,26 @@ out:
 	return rc;
 }
 
-int
-ds_pool_svc_ops_save(struct rdb_tx *tx, void *pool_svc, uuid_t pool_uuid, uuid_t *cli_uuidp,
-		     uint64_t cli_time, bool dup_op, int rc_in, struct ds_pool_svc_op_val *op_valp)
+/*
+ * Operations whose results are saved in one TX. Since TX queries do not see the updates of the
+ * TX, svc_ops_num is carried here from one operation to the next, and the oldest entries are
+ * deleted and svc_ops_num updated once by pool_op_batch_end.
+ */
+struct pool_op_batch {
+	uint32_t	pob_ops_num_old;	/* svc_ops_num before the batch */
+	uint32_t	pob_ops_num;		/* svc_ops_num including the batch */
+	int		pob_nr;			/* number of operations saved */
+	bool		pob_loaded;		/* svc_ops_num looked up */
+};
+
+/*
+ * Without \a batch, a failed operation discards the updates in \a tx first. The operations of a
+ * batch, which share \a tx, make no updates when they fail.
+ */
+static int
+pool_svc_ops_save(struct rdb_tx *tx, void *pool_svc, uuid_t pool_uuid, uuid_t *cli_uuidp,
+		  uint64_t cli_time, bool dup_op, int rc_in, struct ds_pool_svc_op_val *op_valp,
+		  struct pool_op_batch *batch)
 {
 	struct pool_svc          *svc          = pool_svc;
 	bool                      need_put_svc = false;
@@ -3528,17 +3595,25 @@ ds_pool_svc_ops_save(struct rdb_tx *tx, void *pool_svc, uuid_t pool_uuid, uuid_t
 		goto out_svc;
 
 	/* Get number of entries in the KVS for incrementing/decrementing as applicable below */
-	d_iov_set(&val, &svc_ops_num, sizeof(svc_ops_num));
-	rc = rdb_tx_lookup(tx, &svc->ps_root, &ds_pool_prop_svc_ops_num, &val);
-	if (rc != 0) {
-		DL_ERROR(rc, DF_UUID ": failed to lookup svc_ops_num", DP_UUID(pool_uuid));
-		goto out_svc;
+	if (batch != NULL && batch->pob_loaded) {
+		svc_ops_num = batch->pob_ops_num;
+	} else {
+		d_iov_set(&val, &svc_ops_num, sizeof(svc_ops_num));
+		rc = rdb_tx_lookup(tx, &svc->ps_root, &ds_pool_prop_svc_ops_num, &val);
+		if (rc != 0) {
+			DL_ERROR(rc, DF_UUID ": failed to lookup svc_ops_num", DP_UUID(pool_uuid));
+			goto out_svc;
+		}
+		if (batch != NULL) {
+			batch->pob_ops_num_old = svc_ops_num;
+			batch->pob_loaded      = true;
+		}
 	}
 	new_svc_ops_num = svc_ops_num;
 
 	if (!dup_op && !daos_rpc_retryable_rc(op_valp->ov_rc)) {
 		/* If the write operation failed, discard its (unwanted) updates first. */
-		if (op_valp->ov_rc != 0)
+		if (op_valp->ov_rc != 0 && batch == NULL)
 			rdb_tx_discard(tx);
 
 		/* Construct (encoded) client ID key, insert an entry into ps_ops */
@@ -3558,6 +3633,12 @@ ds_pool_svc_ops_save(struct rdb_tx *tx, void *pool_svc, uuid_t pool_uuid, uuid_t
 		new_svc_ops_num++;
 	}
 
+	if (batch != NULL) {
+		batch->pob_ops_num = new_svc_ops_num;
+		batch->pob_nr++;
+		goto out_enc;
+	}
+
 	rc = pool_op_check_delete_oldest(tx, svc, dup_op, &new_svc_ops_num);
 	if (rc != 0) {
 		DL_ERROR(rc, DF_UUID ": failed pool_op_check_delete_oldest()", DP_UUID(pool_uuid));
@@ -3583,12 +3664,94 @@ out:
 	return rc;
 }
 
+int
+ds_pool_svc_ops_save(struct rdb_tx *tx, void *pool_svc, uuid_t pool_uuid, uuid_t *cli_uuidp,
+		     uint64_t cli_time, bool dup_op, int rc_in, struct ds_pool_svc_op_val *op_valp)
+{
+	return pool_svc_ops_save(tx, pool_svc, pool_uuid, cli_uuidp, cli_time, dup_op, rc_in,
+				 op_valp, NULL /* batch */);
+}
+
+struct pool_op_delete_arg {
+	struct rdb_tx	*oda_tx;
+	struct pool_svc	*oda_svc;
+	uint32_t	 oda_ops_num;
+	int		 oda_nr;
+};
+
+static int
+pool_op_delete_oldest_cb(daos_handle_t ih, d_iov_t *key_enc, d_iov_t *val, void *varg)
+{
+	struct pool_op_delete_arg	*arg = varg;
+	struct pool_svc			*svc = arg->oda_svc;
+	struct ds_pool_svc_op_key	 op_key;
+	uint64_t			 age_sec;
+	int				 rc;
+
+	if (arg->oda_nr == 0)
+		return 1;
+
+	rc = ds_pool_svc_op_key_decode(key_enc, &op_key);
+	if (rc != 0) {
+		DL_ERROR(rc, "key decode failed");
+		return rc;
+	}
+
+	age_sec = d_hlc2sec(d_hlc_get()) - d_hlc2sec(op_key.ok_client_time);
+	if ((arg->oda_ops_num < svc->ps_ops_max) && (age_sec <= svc->ps_ops_age))
+		return 1;
+
+	rc = rdb_tx_delete(arg->oda_tx, &svc->ps_ops, key_enc);
+	if (rc != 0) {
+		DL_ERROR(rc, "failed to delete oldest entry in ps_ops");
+		return rc;
+	}
+
+	arg->oda_ops_num--;
+	arg->oda_nr--;
+	return 0;
+}
+
+/*
+ * Finish saving the results of \a batch: as each of its operations would have, delete an entry
+ * from the oldest ones if there are too many or it is too old. Then update svc_ops_num.
+ */
+static int
+pool_op_batch_end(struct rdb_tx *tx, struct pool_svc *svc, struct pool_op_batch *batch)
+{
+	struct pool_op_delete_arg	arg;
+	d_iov_t				val;
+	int				rc;
+
+	if (!batch->pob_loaded)
+		return 0;
+
+	arg.oda_tx      = tx;
+	arg.oda_svc     = svc;
+	arg.oda_ops_num = batch->pob_ops_num;
+	arg.oda_nr      = batch->pob_nr;
+	rc = rdb_tx_iterate(tx, &svc->ps_ops, false /* backward */, pool_op_delete_oldest_cb, &arg);
+	if (rc != 0) {
+		DL_ERROR(rc, DF_UUID ": failed to delete oldest entries", DP_UUID(svc->ps_uuid));
+		return rc;
+	}
+
+	if (arg.oda_ops_num != batch->pob_ops_num_old) {
+		d_iov_set(&val, &arg.oda_ops_num, sizeof(arg.oda_ops_num));
+		rc = rdb_tx_update(tx, &svc->ps_root, &ds_pool_prop_svc_ops_num, &val);
+		if (rc != 0)
+			DL_ERROR(rc, DF_UUID ": failed to update svc_ops_num", DP_UUID(svc->ps_uuid));
+	}
+	return rc;
+}
+
 /* Save results of the (new, not duplicate) operation in svc_ops KVS, if applicable.
  * And delete oldest entry if KVS has reached maximum number, or oldest exceeds age limit.
  */
 static int
-pool_op_save(struct rdb_tx *tx, struct pool_svc *svc, crt_rpc_t *rpc, int pool_proto_ver,
-	     bool dup_op, int rc_in, struct ds_pool_svc_op_val *op_valp)
+pool_op_save_internal(struct rdb_tx *tx, struct pool_svc *svc, crt_rpc_t *rpc,
+		      int pool_proto_ver, bool dup_op, int rc_in,
+		      struct ds_pool_svc_op_val *op_valp, struct pool_op_batch *batch)
 {
 	struct pool_op_v6_in *in6 = crt_req_get(rpc);
 	crt_opcode_t          opc = opc_get(rpc->cr_opc);
@@ -3605,13 +3768,21 @@ pool_op_save(struct rdb_tx *tx, struct pool_svc *svc, crt_rpc_t *rpc, int pool_p
 	if (!pool_op_is_write(opc))
 		goto out;
 
-	rc = ds_pool_svc_ops_save(tx, svc, svc->ps_uuid, &in6->pi_cli_id, in6->pi_time, dup_op,
-				  rc_in, op_valp);
+	rc = pool_svc_ops_save(tx, svc, svc->ps_uuid, &in6->pi_cli_id, in6->pi_time, dup_op,
+			       rc_in, op_valp, batch);
 
 out:
 	return rc;
 }
 
+static int
+pool_op_save(struct rdb_tx *tx, struct pool_svc *svc, crt_rpc_t *rpc, int pool_proto_ver,
+	     bool dup_op, int rc_in, struct ds_pool_svc_op_val *op_valp)
+{
+	return pool_op_save_internal(tx, svc, rpc, pool_proto_ver, dup_op, rc_in, op_valp,
+				     NULL /* batch */);
+}
+
 /*
  * We use this RPC to not only create the pool metadata but also initialize the
  * pool/container service DB.
@@ -3772,25 +3943,22 @@ out:
 }
 
 static int
-pool_connect_iv_dist(struct pool_svc *svc, uuid_t pool_hdl,
-		     uint64_t flags, uint64_t sec_capas, d_iov_t *cred,
-		     uint32_t global_ver, uint32_t layout_ver)
+pool_connect_iv_dist(struct pool_svc *svc, struct pool_iv_conn **conns, int nr)
 {
 	d_rank_t rank;
 	int	 rc;
 
-	D_DEBUG(DB_MD, DF_UUID": bcasting\n", DP_UUID(svc->ps_uuid));
+	D_DEBUG(DB_MD, DF_UUID": bcasting %d hdls\n", DP_UUID(svc->ps_uuid), nr);
 
 	rc = crt_group_rank(svc->ps_pool->sp_group, &rank);
 	if (rc != 0)
 		D_GOTO(out, rc);
 
-	rc = ds_pool_iv_conn_hdl_update(svc->ps_pool, pool_hdl, flags,
-					sec_capas, cred, global_ver, layout_ver);
+	rc = ds_pool_iv_conn_hdls_update(svc->ps_pool, conns, nr);
 	if (rc) {
 		if (rc == -DER_SHUTDOWN) {
-			D_DEBUG(DB_MD, DF_UUID":"DF_UUID" some ranks stop.\n",
-				DP_UUID(svc->ps_uuid), DP_UUID(pool_hdl));
+			D_DEBUG(DB_MD, DF_UUID": some ranks stop.\n",
+				DP_UUID(svc->ps_uuid));
 			rc = 0;
 		}
 		D_GOTO(out, rc);
@@ -3814,116 +3982,131 @@ bulk_cb(const struct crt_bulk_cb_info *cb_info)
 /* Currently we only maintain compatibility between 2 metadata layout versions */
 #define NUM_POOL_VERSIONS	2
 
+/* Maximum number of connect requests handled in one batch */
+#define POOL_CONNECT_BATCH_MAX	128
+
+/* Pool map read by a connect batch, shared by its requests */
+struct pool_connect_map {
+	struct pool_buf	*pcm_buf;
+	uint32_t	 pcm_version;
+	int		 pcm_ref;	/* no atomics, all on the PS xstream */
+};
+
+/* Connect request, handled by pool_connect_batch */
+struct pool_connect_req {
+	d_list_t			 pcr_link;
+	crt_rpc_t			*pcr_rpc;
+	int				 pcr_handler_version;
+	d_iov_t				*pcr_cred;
+	uint64_t			 pcr_flags;
+	uint32_t			 pcr_cli_version;
+	bool				 pcr_fi_fail;	/* DAOS_MD_OP_FAIL_NOREPLY{,_NEWLDR} */
+	/* Filled by the batch */
+	struct pool_hdl			*pcr_hdl;	/* new handle to write */
+	struct pool_iv_conn		*pcr_conn;	/* new handle to distribute */
+	struct pool_connect_map		*pcr_map;	/* map to transfer */
+	struct pool_connect_req		*pcr_twin;	/* earlier request for the same handle */
+	struct ds_pool_svc_op_val	 pcr_op_val;
+	bool				 pcr_dup_op;
+	bool				 pcr_save;	/* result to save in ps_ops */
+	bool				 pcr_done;
+	int				 pcr_rc;
+};
+
+/* State shared by the requests of a connect batch */
+struct pool_connect_batch {
+	struct rdb_tx		 pcb_tx;
+	d_list_t		*pcb_reqs;
+	daos_prop_t		*pcb_prop;
+	struct pool_connect_map	*pcb_map;
+	uint32_t		 pcb_nhandles;	/* including the new ones of the batch */
+	bool			 pcb_ex;	/* an exclusive handle exists */
+};
+
 static void
-ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
+pool_connect_map_put(struct pool_connect_map *map)
 {
-	struct pool_connect_in         *in  = crt_req_get(rpc);
-	struct pool_connect_out        *out = crt_reply_get(rpc);
-	struct pool_svc		       *svc;
-	struct pool_buf		       *map_buf = NULL;
-	uint32_t			map_version;
-	uint32_t			connectable;
-	uint32_t			global_ver;
-	uint32_t			obj_layout_ver;
-	struct rdb_tx			tx;
-	d_iov_t				key;
-	d_iov_t				value;
+	D_ASSERT(map->pcm_ref > 0);
+	if (--map->pcm_ref > 0)
+		return;
+	D_FREE(map->pcm_buf);
+	D_FREE(map);
+}
+
+/*
+ * Check connect request \a req against the pool and the requests before it in \a batch, and
+ * prepare the new handle if it does not exist yet. Makes no updates, so that a failed request
+ * does not affect the others.
+ */
+static int
+pool_connect_prepare(struct pool_svc *svc, struct pool_connect_batch *batch,
+		     struct pool_connect_req *req)
+{
+	struct pool_connect_in	       *in = crt_req_get(req->pcr_rpc);
+	struct pool_connect_req	       *prev;
 	struct pool_hdl		       *hdl = NULL;
-	uint32_t			nhandles;
-	int				skip_update = 0;
-	int				rc;
-	daos_prop_t		       *prop = NULL;
-	uint64_t			prop_bits;
+	struct pool_iv_conn	       *conn = NULL;
 	struct daos_prop_entry	       *acl_entry;
 	struct d_ownership		owner;
 	struct daos_prop_entry	       *owner_entry, *global_ver_entry;
 	struct daos_prop_entry	       *owner_grp_entry;
 	struct daos_prop_entry	       *obj_ver_entry;
+	uint32_t			global_ver;
+	uint32_t			obj_layout_ver;
+	uint32_t			cli_pool_version = req->pcr_cli_version;
+	uint64_t			flags = req->pcr_flags;
 	uint64_t			sec_capas = 0;
-	struct pool_metrics	       *metrics;
 	char			       *machine = NULL;
-	d_iov_t                        *credp;
-	uint64_t                        flags;
-	uint64_t                        query_bits;
-	crt_bulk_t                      bulk;
-	uint32_t                        cli_pool_version;
-	bool                            dup_op = false;
-	struct ds_pool_svc_op_val       op_val;
-	bool                            transfer_map    = false;
-	bool                            fi_pass_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_PASS_NOREPLY);
-	bool                            fi_fail_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_FAIL_NOREPLY);
-	bool                            fi_pass_nl_noreply;
-	bool                            fi_fail_nl_noreply;
-
-	D_DEBUG(DB_MD, DF_UUID ": processing rpc: %p hdl=" DF_UUID "\n",
-		DP_UUID(in->pci_op.pi_uuid), rpc, DP_UUID(in->pci_op.pi_hdl));
-
-	fi_pass_nl_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_PASS_NOREPLY_NEWLDR);
-	fi_fail_nl_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_FAIL_NOREPLY_NEWLDR);
-
-	rc = pool_svc_lookup_leader(in->pci_op.pi_uuid, &svc,
-				    &out->pco_op.po_hint);
-	if (rc != 0)
-		D_GOTO(out, rc);
-
-	pool_connect_in_get_cred(rpc, &credp);
-	pool_connect_in_get_data(rpc, &flags, &query_bits, &bulk, &cli_pool_version);
-
-	if (query_bits & DAOS_PO_QUERY_REBUILD_STATUS) {
-		rc = ds_rebuild_query(in->pci_op.pi_uuid, &out->pco_rebuild_st);
-		if (rc != 0)
-			D_GOTO(out_svc, rc);
-	}
-
-	rc = rdb_tx_begin(svc->ps_rsvc.s_db, svc->ps_rsvc.s_term, &tx);
-	if (rc != 0)
-		D_GOTO(out_svc, rc);
-
-	ABT_rwlock_wrlock(svc->ps_lock);
+	d_iov_t				key;
+	d_iov_t				value;
+	bool				skip_update = false;
+	int				diff;
+	int				rc;
 
-	rc = pool_op_lookup(&tx, svc, rpc, handler_version, &dup_op, &op_val);
+	rc = pool_op_lookup(&batch->pcb_tx, svc, req->pcr_rpc, req->pcr_handler_version,
+			    &req->pcr_dup_op, &req->pcr_op_val);
 	if (rc != 0)
-		goto out_lock;
-	else if (dup_op)
+		return rc;
+	else if (req->pcr_dup_op)
 		skip_update = true;
-	if (fi_fail_noreply || fi_fail_nl_noreply)
-		goto out_map_version;
-
-	/* Check if pool is being destroyed and not accepting connections */
-	d_iov_set(&value, &connectable, sizeof(connectable));
-	rc = rdb_tx_lookup(&tx, &svc->ps_root,
-			   &ds_pool_prop_connectable, &value);
-	if (rc != 0)
-		goto out_lock;
-	if (!connectable) {
-		D_ERROR(DF_UUID": being destroyed, not accepting connections\n",
-			DP_UUID(in->pci_op.pi_uuid));
-		D_GOTO(out_lock, rc = -DER_BUSY);
-	}
-
-	/*
-	 * NOTE: Under check mode, there is a small race window between ds_pool_mark_connectable()
-	 *	 and PS restart with full service. If some client tries to connect the pool during
-	 *	 such internal, it will get -DER_BUSY temporarily.
-	 */
-	if (unlikely(ds_pool_skip_for_check(svc->ps_pool))) {
-		rc = -DER_BUSY;
-		D_ERROR(DF_UUID " is not ready for full pool service: " DF_RC "\n",
-			DP_UUID(in->pci_op.pi_uuid), DP_RC(rc));
-		goto out_lock;
+	if (req->pcr_fi_fail) {
+		req->pcr_save = true;
+		return req->pcr_dup_op ? 0 : -DER_MISC;
 	}
 
 	if (svc->ps_pool->sp_immutable && flags != DAOS_PC_RO) {
 		rc = -DER_NO_PERM;
 		D_ERROR(DF_UUID " failed to connect immutable pool, flags " DF_X64 ": " DF_RC "\n",
 			DP_UUID(in->pci_op.pi_uuid), flags, DP_RC(rc));
-		goto out_lock;
+		return rc;
+	}
+
+	/*
+	 * A request for a handle being connected earlier in the batch, e.g., a resent one, gets
+	 * the result of the earlier request.
+	 */
+	d_list_for_each_entry(prev, batch->pcb_reqs, pcr_link) {
+		struct pool_connect_in *prev_in = crt_req_get(prev->pcr_rpc);
+
+		if (prev == req)
+			break;
+		if (prev->pcr_hdl == NULL || uuid_compare(prev_in->pci_op.pi_hdl, in->pci_op.pi_hdl))
+			continue;
+		if (prev->pcr_flags != flags) {
+			D_ERROR(DF_UUID": found conflicting pool handle\n",
+				DP_UUID(in->pci_op.pi_uuid));
+			return -DER_EXIST;
+		}
+		req->pcr_twin = prev;
+		req->pcr_map  = batch->pcb_map;
+		req->pcr_map->pcm_ref++;
+		return 0;
 	}
 
 	/* Check existing pool handles. */
 	d_iov_set(&key, in->pci_op.pi_hdl, sizeof(uuid_t));
 	d_iov_set(&value, NULL, 0);
-	rc = rdb_tx_lookup(&tx, &svc->ps_handles, &key, &value);
+	rc = rdb_tx_lookup(&batch->pcb_tx, &svc->ps_handles, &key, &value);
 	if (rc == 0) {
 		/* found it */
 		if (((struct pool_hdl *)value.iov_buf)->ph_flags == flags) {
@@ -3931,36 +4114,27 @@ ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
 			 * The handle already exists; only do the pool map
 			 * transfer.
 			 */
-			skip_update = 1;
+			skip_update = true;
 		} else {
 			/* The existing one does not match the new one. */
 			D_ERROR(DF_UUID": found conflicting pool handle\n",
 				DP_UUID(in->pci_op.pi_uuid));
-			D_GOTO(out_lock, rc = -DER_EXIST);
+			return -DER_EXIST;
 		}
 	} else if (rc != -DER_NONEXIST) {
-		goto out_lock;
+		return rc;
 	}
 
-	/* Fetch properties, the  ACL and ownership info for access check,
-	 * all properties will update to IV.
-	 */
-	prop_bits = DAOS_PO_QUERY_PROP_ALL;
-	rc = pool_prop_read(&tx, svc, prop_bits, &prop);
-	if (rc != 0) {
-		D_ERROR(DF_UUID": cannot get access data for pool, "
-			"rc="DF_RC"\n", DP_UUID(in->pci_op.pi_uuid), DP_RC(rc));
-		D_GOTO(out_map_version, rc);
-	}
-	D_ASSERT(prop != NULL);
+	/* From here on, the result is saved in ps_ops. */
+	req->pcr_save = true;
 
-	global_ver_entry = daos_prop_entry_get(prop, DAOS_PROP_PO_GLOBAL_VERSION);
+	global_ver_entry = daos_prop_entry_get(batch->pcb_prop, DAOS_PROP_PO_GLOBAL_VERSION);
 	D_ASSERT(global_ver_entry != NULL);
 	global_ver = global_ver_entry->dpe_val;
 	/*
 	 * Reject pool connection if old clients try to connect new format pool.
 	 */
-	int diff = DAOS_POOL_GLOBAL_VERSION - cli_pool_version;
+	diff = DAOS_POOL_GLOBAL_VERSION - cli_pool_version;
 	if (cli_pool_version <= DAOS_POOL_GLOBAL_VERSION) {
 		if (diff >= NUM_POOL_VERSIONS) {
 			rc = -DER_NOTSUPPORTED;
@@ -3971,7 +4145,7 @@ ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
 					 "try to upgrade client firstly",
 				 DP_UUID(in->pci_op.pi_uuid), cli_pool_version,
 				 NUM_POOL_VERSIONS - 1, DAOS_POOL_GLOBAL_VERSION);
-			goto out_map_version;
+			return rc;
 		}
 
 		if (global_ver > cli_pool_version) {
@@ -3981,7 +4155,7 @@ ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
 					 "max client supported pool layout version(%u), "
 					 "try to upgrade client firstly",
 				 DP_UUID(in->pci_op.pi_uuid), global_ver, cli_pool_version);
-			goto out_map_version;
+			return rc;
 		}
 	} else {
 		diff = -diff;
@@ -3994,27 +4168,27 @@ ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
 					 "try to upgrade server firstly",
 				 DP_UUID(in->pci_op.pi_uuid), cli_pool_version,
 				 NUM_POOL_VERSIONS - 1, DAOS_POOL_GLOBAL_VERSION);
-			goto out_map_version;
+			return rc;
 		}
 		/* New clients should be able to access old pools without problem */
 	}
 
-	acl_entry = daos_prop_entry_get(prop, DAOS_PROP_PO_ACL);
+	acl_entry = daos_prop_entry_get(batch->pcb_prop, DAOS_PROP_PO_ACL);
 	D_ASSERT(acl_entry != NULL);
 	D_ASSERT(acl_entry->dpe_val_ptr != NULL);
 
-	owner_entry = daos_prop_entry_get(prop, DAOS_PROP_PO_OWNER);
+	owner_entry = daos_prop_entry_get(batch->pcb_prop, DAOS_PROP_PO_OWNER);
 	D_ASSERT(owner_entry != NULL);
 	D_ASSERT(owner_entry->dpe_str != NULL);
 
-	owner_grp_entry = daos_prop_entry_get(prop, DAOS_PROP_PO_OWNER_GROUP);
+	owner_grp_entry = daos_prop_entry_get(batch->pcb_prop, DAOS_PROP_PO_OWNER_GROUP);
 	D_ASSERT(owner_grp_entry != NULL);
 	D_ASSERT(owner_grp_entry->dpe_str != NULL);
 
 	owner.user = owner_entry->dpe_str;
 	owner.group = owner_grp_entry->dpe_str;
 
-	obj_ver_entry = daos_prop_entry_get(prop, DAOS_PROP_PO_OBJ_VERSION);
+	obj_ver_entry = daos_prop_entry_get(batch->pcb_prop, DAOS_PROP_PO_OBJ_VERSION);
 	D_ASSERT(obj_ver_entry != NULL);
 	obj_layout_ver = obj_ver_entry->dpe_val;
 
@@ -4022,62 +4196,40 @@ ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
 	 * Security capabilities determine the access control policy on this
 	 * pool handle.
 	 */
-	rc = ds_sec_pool_get_capabilities(flags, credp, &owner, acl_entry->dpe_val_ptr, &sec_capas);
+	rc = ds_sec_pool_get_capabilities(flags, req->pcr_cred, &owner, acl_entry->dpe_val_ptr,
+					  &sec_capas);
 	if (rc != 0) {
 		DL_ERROR(rc, DF_UUID ": refusing connect attempt for " DF_X64,
 			 DP_UUID(in->pci_op.pi_uuid), flags);
-		D_GOTO(out_map_version, rc);
+		return rc;
 	}
 
-	rc = ds_sec_cred_get_origin(credp, &machine);
-
+	rc = ds_sec_cred_get_origin(req->pcr_cred, &machine);
 	if (rc != 0) {
 		DL_ERROR(rc, DF_UUID ": unable to retrieve origin", DP_UUID(in->pci_op.pi_uuid));
-		D_GOTO(out_map_version, rc);
+		return rc;
 	}
 
 	if (!ds_sec_pool_can_connect(sec_capas)) {
 		rc = -DER_NO_PERM;
 		DL_ERROR(rc, DF_UUID ": permission denied for connect attempt for " DF_X64,
 			 DP_UUID(in->pci_op.pi_uuid), flags);
-		goto out_map_version;
+		goto out;
 	}
 
-	rc = read_map_buf(&tx, &svc->ps_root, &map_buf, &map_version);
-	if (rc != 0) {
-		D_ERROR(DF_UUID": failed to read pool map: "DF_RC"\n",
-			DP_UUID(svc->ps_uuid), DP_RC(rc));
-		D_GOTO(out_map_version, rc);
-	}
-	transfer_map = true;
+	req->pcr_map = batch->pcb_map;
+	req->pcr_map->pcm_ref++;
 	if (skip_update)
-		D_GOTO(out_map_version, rc = 0);
-
-	d_iov_set(&value, &nhandles, sizeof(nhandles));
-	rc = rdb_tx_lookup(&tx, &svc->ps_root, &ds_pool_prop_nhandles, &value);
-	if (rc != 0)
-		D_GOTO(out_map_version, rc);
+		D_GOTO(out, rc = 0);
 
-	/* Take care of exclusive handles. */
-	if (nhandles != 0) {
-		if (flags & DAOS_PC_EX) {
-			D_DEBUG(DB_MD, DF_UUID": others already connected\n",
-				DP_UUID(in->pci_op.pi_uuid));
-			D_GOTO(out_map_version, rc = -DER_BUSY);
-		} else {
-			/*
-			 * If there is a non-exclusive handle, then all handles
-			 * are non-exclusive.
-			 */
-			d_iov_set(&value, NULL, 0);
-			rc = rdb_tx_fetch(&tx, &svc->ps_handles,
-					  RDB_PROBE_FIRST, NULL /* key_in */,
-					  NULL /* key_out */, &value);
-			if (rc != 0)
-				D_GOTO(out_map_version, rc);
-			if (((struct pool_hdl *)value.iov_buf)->ph_flags & DAOS_PC_EX)
-				D_GOTO(out_map_version, rc = -DER_BUSY);
-		}
+	/*
+	 * Take care of exclusive handles. If there is a non-exclusive handle, then all handles
+	 * are non-exclusive.
+	 */
+	if (batch->pcb_nhandles != 0 && ((flags & DAOS_PC_EX) || batch->pcb_ex)) {
+		D_DEBUG(DB_MD, DF_UUID": others already connected\n",
+			DP_UUID(in->pci_op.pi_uuid));
+		D_GOTO(out, rc = -DER_BUSY);
 	}
 
 	D_DEBUG(DB_MD, DF_UUID "/" DF_UUID ": connecting to %s pool with flags "
@@ -4085,88 +4237,359 @@ ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
 		DP_UUID(in->pci_op.pi_uuid), DP_UUID(in->pci_op.pi_hdl),
 		svc->ps_pool->sp_immutable ? "immutable" : "regular", flags, sec_capas);
 
-	rc = pool_connect_iv_dist(svc, in->pci_op.pi_hdl, flags, sec_capas, credp, global_ver,
-				  obj_layout_ver);
-	if (rc == 0 && DAOS_FAIL_CHECK(DAOS_POOL_CONNECT_FAIL_CORPC)) {
-		D_DEBUG(DB_MD, DF_UUID": fault injected: DAOS_POOL_CONNECT_FAIL_CORPC\n",
-			DP_UUID(in->pci_op.pi_uuid));
-		rc = -DER_TIMEDOUT;
-	}
-	if (rc != 0) {
-		D_ERROR(DF_UUID": failed to connect to targets: "DF_RC"\n",
-			DP_UUID(in->pci_op.pi_uuid), DP_RC(rc));
-		D_GOTO(out_map_version, rc);
-	}
-
 	/* handle did not exist so create it */
 	/* XXX may be can check pool version to avoid allocating too much ? */
-	D_ALLOC(hdl, sizeof(*hdl) + credp->iov_len);
+	D_ALLOC(hdl, sizeof(*hdl) + req->pcr_cred->iov_len);
 	if (hdl == NULL)
-		D_GOTO(out_map_version, rc = -DER_NOMEM);
+		D_GOTO(out, rc = -DER_NOMEM);
 
 	hdl->ph_flags     = flags;
 	hdl->ph_sec_capas = sec_capas;
 	/* XXX may be can check pool version to avoid initializing 3 following hdl fields ? */
 	strncpy(hdl->ph_machine, machine, MAXHOSTNAMELEN);
-	hdl->ph_cred_len = credp->iov_len;
-	memcpy(&hdl->ph_cred[0], credp->iov_buf, credp->iov_len);
+	hdl->ph_cred_len = req->pcr_cred->iov_len;
+	memcpy(&hdl->ph_cred[0], req->pcr_cred->iov_buf, req->pcr_cred->iov_len);
 
-	nhandles++;
-	d_iov_set(&key, in->pci_op.pi_hdl, sizeof(uuid_t));
-	d_iov_set(&value, hdl,
-		  svc->ps_global_version >= DAOS_POOL_GLOBAL_VERSION_WITH_HDL_CRED ?
-		  sizeof(struct pool_hdl) + hdl->ph_cred_len : sizeof(struct pool_hdl_v0));
-	D_DEBUG(DB_MD, "writing a pool connect handle in db, size %zu, pool version %u\n",
-		value.iov_len, svc->ps_global_version);
-	rc = rdb_tx_update(&tx, &svc->ps_handles, &key, &value);
+	D_ALLOC(conn, sizeof(*conn) + req->pcr_cred->iov_len);
+	if (conn == NULL) {
+		D_FREE(hdl);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	uuid_copy(conn->pic_hdl, in->pci_op.pi_hdl);
+	conn->pic_flags      = flags;
+	conn->pic_capas      = sec_capas;
+	conn->pic_cred_size  = req->pcr_cred->iov_len;
+	conn->pic_global_ver = global_ver;
+	conn->pic_obj_ver    = obj_layout_ver;
+	memcpy(&conn->pic_creds[0], req->pcr_cred->iov_buf, req->pcr_cred->iov_len);
+
+	req->pcr_hdl  = hdl;
+	req->pcr_conn = conn;
+	batch->pcb_nhandles++;
+	if (flags & DAOS_PC_EX)
+		batch->pcb_ex = true;
+out:
+	D_FREE(machine);
+	return rc;
+}
+
+/*
+ * Handle the connect requests in \a reqs with one TX and one IV update for all their new
+ * handles, setting pcr_rc of each request.
+ */
+static void
+pool_connect_batch(struct pool_svc *svc, d_list_t *reqs)
+{
+	struct pool_connect_batch	batch = {0};
+	struct pool_connect_req	       *req;
+	struct pool_connect_in	       *in;
+	struct pool_iv_conn	      **conns = NULL;
+	struct pool_op_batch		op_batch = {0};
+	struct pool_metrics	       *metrics;
+	uint32_t			connectable;
+	uint32_t			nhandles;
+	d_iov_t				key;
+	d_iov_t				value;
+	int				nconns = 0;
+	int				i;
+	int				rc;
+
+	batch.pcb_reqs = reqs;
+
+	rc = rdb_tx_begin(svc->ps_rsvc.s_db, svc->ps_rsvc.s_term, &batch.pcb_tx);
+	if (rc != 0)
+		goto out;
+
+	ABT_rwlock_wrlock(svc->ps_lock);
+
+	/* Check if pool is being destroyed and not accepting connections */
+	d_iov_set(&value, &connectable, sizeof(connectable));
+	rc = rdb_tx_lookup(&batch.pcb_tx, &svc->ps_root, &ds_pool_prop_connectable, &value);
 	if (rc != 0)
-		D_GOTO(out_map_version, rc);
+		goto out_lock;
+	if (!connectable) {
+		D_ERROR(DF_UUID": being destroyed, not accepting connections\n",
+			DP_UUID(svc->ps_uuid));
+		D_GOTO(out_lock, rc = -DER_BUSY);
+	}
+
+	/*
+	 * NOTE: Under check mode, there is a small race window between ds_pool_mark_connectable()
+	 *	 and PS restart with full service. If some client tries to connect the pool during
+	 *	 such internal, it will get -DER_BUSY temporarily.
+	 */
+	if (unlikely(ds_pool_skip_for_check(svc->ps_pool))) {
+		rc = -DER_BUSY;
+		D_ERROR(DF_UUID " is not ready for full pool service: " DF_RC "\n",
+			DP_UUID(svc->ps_uuid), DP_RC(rc));
+		goto out_lock;
+	}
+
+	/* Fetch properties, the  ACL and ownership info for access check,
+	 * all properties will update to IV.
+	 */
+	rc = pool_prop_read(&batch.pcb_tx, svc, DAOS_PO_QUERY_PROP_ALL, &batch.pcb_prop);
+	if (rc != 0) {
+		D_ERROR(DF_UUID": cannot get access data for pool, "
+			"rc="DF_RC"\n", DP_UUID(svc->ps_uuid), DP_RC(rc));
+		goto out_lock;
+	}
+	D_ASSERT(batch.pcb_prop != NULL);
+
+	D_ALLOC_PTR(batch.pcb_map);
+	if (batch.pcb_map == NULL)
+		D_GOTO(out_lock, rc = -DER_NOMEM);
+	batch.pcb_map->pcm_ref = 1;
+	rc = read_map_buf(&batch.pcb_tx, &svc->ps_root, &batch.pcb_map->pcm_buf,
+			  &batch.pcb_map->pcm_version);
+	if (rc != 0) {
+		D_ERROR(DF_UUID": failed to read pool map: "DF_RC"\n",
+			DP_UUID(svc->ps_uuid), DP_RC(rc));
+		goto out_lock;
+	}
 
 	d_iov_set(&value, &nhandles, sizeof(nhandles));
-	rc = rdb_tx_update(&tx, &svc->ps_root, &ds_pool_prop_nhandles, &value);
+	rc = rdb_tx_lookup(&batch.pcb_tx, &svc->ps_root, &ds_pool_prop_nhandles, &value);
 	if (rc != 0)
-		D_GOTO(out_map_version, rc);
+		goto out_lock;
+	if (nhandles != 0) {
+		d_iov_set(&value, NULL, 0);
+		rc = rdb_tx_fetch(&batch.pcb_tx, &svc->ps_handles, RDB_PROBE_FIRST,
+				  NULL /* key_in */, NULL /* key_out */, &value);
+		if (rc != 0)
+			goto out_lock;
+		batch.pcb_ex = ((struct pool_hdl *)value.iov_buf)->ph_flags & DAOS_PC_EX;
+	}
+	batch.pcb_nhandles = nhandles;
 
-out_map_version:
-	out->pco_op.po_map_version = ds_pool_get_version(svc->ps_pool);
+	d_list_for_each_entry(req, reqs, pcr_link) {
+		req->pcr_rc = pool_connect_prepare(svc, &batch, req);
+		if (req->pcr_conn != NULL)
+			nconns++;
+	}
+
+	/* Distribute all the new handles to the targets at once. */
+	if (nconns > 0) {
+		D_ALLOC_ARRAY(conns, nconns);
+		if (conns == NULL)
+			D_GOTO(out_lock, rc = -DER_NOMEM);
+		i = 0;
+		d_list_for_each_entry(req, reqs, pcr_link) {
+			if (req->pcr_conn != NULL)
+				conns[i++] = req->pcr_conn;
+		}
+
+		rc = pool_connect_iv_dist(svc, conns, nconns);
+		if (rc == 0 && DAOS_FAIL_CHECK(DAOS_POOL_CONNECT_FAIL_CORPC)) {
+			D_DEBUG(DB_MD, DF_UUID": fault injected: DAOS_POOL_CONNECT_FAIL_CORPC\n",
+				DP_UUID(svc->ps_uuid));
+			rc = -DER_TIMEDOUT;
+		}
+		if (rc != 0) {
+			D_ERROR(DF_UUID": failed to connect %d handles to targets: "DF_RC"\n",
+				DP_UUID(svc->ps_uuid), nconns, DP_RC(rc));
+			d_list_for_each_entry(req, reqs, pcr_link) {
+				if (req->pcr_conn != NULL) {
+					req->pcr_rc = rc;
+					D_FREE(req->pcr_hdl);
+				}
+			}
+			rc = 0;
+		}
+	}
+
+	d_list_for_each_entry(req, reqs, pcr_link) {
+		if (req->pcr_hdl == NULL)
+			continue;
+		in = crt_req_get(req->pcr_rpc);
+		d_iov_set(&key, in->pci_op.pi_hdl, sizeof(uuid_t));
+		d_iov_set(&value, req->pcr_hdl,
+			  svc->ps_global_version >= DAOS_POOL_GLOBAL_VERSION_WITH_HDL_CRED ?
+			  sizeof(struct pool_hdl) + req->pcr_hdl->ph_cred_len :
+			  sizeof(struct pool_hdl_v0));
+		D_DEBUG(DB_MD, "writing a pool connect handle in db, size %zu, pool version %u\n",
+			value.iov_len, svc->ps_global_version);
+		rc = rdb_tx_update(&batch.pcb_tx, &svc->ps_handles, &key, &value);
+		if (rc != 0)
+			goto out_lock;
+		nhandles++;
+	}
+
+	if (nhandles != batch.pcb_nhandles - nconns) {
+		d_iov_set(&value, &nhandles, sizeof(nhandles));
+		rc = rdb_tx_update(&batch.pcb_tx, &svc->ps_root, &ds_pool_prop_nhandles, &value);
+		if (rc != 0)
+			goto out_lock;
+	}
 
-	D_DEBUG(DB_MD, DF_UUID ": rc=%d, dup_op=%d\n", DP_UUID(in->pci_op.pi_uuid), rc, dup_op);
 	/* If meets criteria (not dup, write op, definitive rc, etc.), store result in ps_ops KVS */
-	if ((rc == 0) && !dup_op && (fi_fail_noreply || fi_fail_nl_noreply))
-		rc = -DER_MISC;
-	rc = pool_op_save(&tx, svc, rpc, handler_version, dup_op, rc, &op_val);
+	d_list_for_each_entry(req, reqs, pcr_link) {
+		if (!req->pcr_save)
+			continue;
+		rc = pool_op_save_internal(&batch.pcb_tx, svc, req->pcr_rpc,
+					   req->pcr_handler_version, req->pcr_dup_op, req->pcr_rc,
+					   &req->pcr_op_val, &op_batch);
+		if (rc != 0)
+			goto out_lock;
+	}
+	rc = pool_op_batch_end(&batch.pcb_tx, svc, &op_batch);
 	if (rc != 0)
 		goto out_lock;
-	rc = rdb_tx_commit(&tx);
+
+	rc = rdb_tx_commit(&batch.pcb_tx);
 	if (rc != 0)
 		goto out_lock;
 
-	rc = op_val.ov_rc;
-	if ((rc == 0) && !dup_op) {
-		/** update metric */
-		metrics = svc->ps_pool->sp_metrics[DAOS_POOL_MODULE];
-		d_tm_inc_counter(metrics->connect_total, 1);
-		d_tm_inc_gauge(metrics->open_handles, 1);
+	metrics = svc->ps_pool->sp_metrics[DAOS_POOL_MODULE];
+	d_list_for_each_entry(req, reqs, pcr_link) {
+		if (req->pcr_save)
+			req->pcr_rc = req->pcr_op_val.ov_rc;
+		else if (req->pcr_twin != NULL)
+			req->pcr_rc = req->pcr_twin->pcr_rc;
+		/* A twin shares the handle of the earlier request, which already counted it. */
+		if ((req->pcr_rc == 0) && !req->pcr_dup_op && req->pcr_twin == NULL) {
+			/** update metric */
+			d_tm_inc_counter(metrics->connect_total, 1);
+			d_tm_inc_gauge(metrics->open_handles, 1);
+		}
+	}
+
+out_lock:
+	ABT_rwlock_unlock(svc->ps_lock);
+	rdb_tx_end(&batch.pcb_tx);
+out:
+	D_DEBUG(DB_MD, DF_UUID ": connect batch of %d new handles: "DF_RC"\n",
+		DP_UUID(svc->ps_uuid), nconns, DP_RC(rc));
+	d_list_for_each_entry(req, reqs, pcr_link) {
+		/* A failure of the batch fails all its requests. */
+		if (rc != 0)
+			req->pcr_rc = rc;
+		if (req->pcr_rc != 0 && req->pcr_map != NULL) {
+			pool_connect_map_put(req->pcr_map);
+			req->pcr_map = NULL;
+		}
+		D_FREE(req->pcr_hdl);
+		D_FREE(req->pcr_conn);
+	}
+	D_FREE(conns);
+	if (batch.pcb_map != NULL)
+		pool_connect_map_put(batch.pcb_map);
+	if (batch.pcb_prop != NULL)
+		daos_prop_free(batch.pcb_prop);
+}
+
+/*
+ * Queue \a req and wait until it is handled. Connect requests are handled in batches, so that a
+ * storm of them commits a few TXs and IV updates rather than one of each per request: whoever
+ * finds no batch in progress handles the queued requests, up to POOL_CONNECT_BATCH_MAX of them,
+ * while those arriving meanwhile queue up for the next batch. Requests are never delayed to
+ * form a batch.
+ */
+static void
+pool_connect_submit(struct pool_svc *svc, struct pool_connect_req *req)
+{
+	struct pool_svc_connects	*pcs = &svc->ps_connects;
+	struct pool_connect_req		*tmp;
+	struct pool_connect_req		*next;
+	d_list_t			 reqs;
+	int				 n;
+
+	/*
+	 * The CV requires a mutex. We don't otherwise need it for ULTs within
+	 * the same xstream.
+	 */
+	ABT_mutex_lock(pcs->pcs_mutex);
+	d_list_add_tail(&req->pcr_link, &pcs->pcs_queue);
+	while (!req->pcr_done) {
+		if (pcs->pcs_busy) {
+			ABT_cond_wait(pcs->pcs_cv, pcs->pcs_mutex);
+			continue;
+		}
+
+		D_INIT_LIST_HEAD(&reqs);
+		n = 0;
+		d_list_for_each_entry_safe(tmp, next, &pcs->pcs_queue, pcr_link) {
+			if (n == POOL_CONNECT_BATCH_MAX)
+				break;
+			d_list_move_tail(&tmp->pcr_link, &reqs);
+			n++;
+		}
+		pcs->pcs_busy = true;
+		ABT_mutex_unlock(pcs->pcs_mutex);
+
+		D_DEBUG(DB_MD, DF_UUID ": handling %d connect requests\n", DP_UUID(svc->ps_uuid),
+			n);
+		pool_connect_batch(svc, &reqs);
+
+		ABT_mutex_lock(pcs->pcs_mutex);
+		d_list_for_each_entry_safe(tmp, next, &reqs, pcr_link) {
+			d_list_del_init(&tmp->pcr_link);
+			tmp->pcr_done = true;
+		}
+		pcs->pcs_busy = false;
+		ABT_cond_broadcast(pcs->pcs_cv);
+	}
+	ABT_mutex_unlock(pcs->pcs_mutex);
+}
+
+static void
+ds_pool_connect_handler(crt_rpc_t *rpc, int handler_version)
+{
+	struct pool_connect_in         *in  = crt_req_get(rpc);
+	struct pool_connect_out        *out = crt_reply_get(rpc);
+	struct pool_svc		       *svc;
+	struct pool_connect_req		req = {0};
+	uint64_t                        query_bits;
+	crt_bulk_t                      bulk;
+	bool                            dup_op = false;
+	bool                            fi_pass_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_PASS_NOREPLY);
+	bool                            fi_fail_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_FAIL_NOREPLY);
+	bool                            fi_pass_nl_noreply;
+	bool                            fi_fail_nl_noreply;
+	int				rc;
+
+	D_DEBUG(DB_MD, DF_UUID ": processing rpc: %p hdl=" DF_UUID "\n",
+		DP_UUID(in->pci_op.pi_uuid), rpc, DP_UUID(in->pci_op.pi_hdl));
+
+	fi_pass_nl_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_PASS_NOREPLY_NEWLDR);
+	fi_fail_nl_noreply = DAOS_FAIL_CHECK(DAOS_MD_OP_FAIL_NOREPLY_NEWLDR);
+
+	rc = pool_svc_lookup_leader(in->pci_op.pi_uuid, &svc,
+				    &out->pco_op.po_hint);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	pool_connect_in_get_cred(rpc, &req.pcr_cred);
+	pool_connect_in_get_data(rpc, &req.pcr_flags, &query_bits, &bulk, &req.pcr_cli_version);
+
+	if (query_bits & DAOS_PO_QUERY_REBUILD_STATUS) {
+		rc = ds_rebuild_query(in->pci_op.pi_uuid, &out->pco_rebuild_st);
+		if (rc != 0)
+			D_GOTO(out_svc, rc);
 	}
 
+	req.pcr_rpc             = rpc;
+	req.pcr_handler_version = handler_version;
+	req.pcr_fi_fail         = fi_fail_noreply || fi_fail_nl_noreply;
+	pool_connect_submit(svc, &req);
+	rc     = req.pcr_rc;
+	dup_op = req.pcr_dup_op;
+
+	out->pco_op.po_map_version = ds_pool_get_version(svc->ps_pool);
+	D_DEBUG(DB_MD, DF_UUID ": rc=%d, dup_op=%d\n", DP_UUID(in->pci_op.pi_uuid), rc, dup_op);
+
 	if ((rc == 0) && (query_bits & DAOS_PO_QUERY_SPACE))
 		rc = pool_space_query_bcast(rpc->cr_ctx, svc, in->pci_op.pi_hdl, &out->pco_space);
 
-out_lock:
-	ABT_rwlock_unlock(svc->ps_lock);
-	rdb_tx_end(&tx);
-	if (rc == 0 && transfer_map) {
-		rc = ds_pool_transfer_map_buf(map_buf, map_version, rpc, bulk,
-					      &out->pco_map_buf_size);
+	if (req.pcr_map != NULL) {
+		if (rc == 0)
+			rc = ds_pool_transfer_map_buf(req.pcr_map->pcm_buf,
+						      req.pcr_map->pcm_version, rpc, bulk,
+						      &out->pco_map_buf_size);
 		/** TODO: roll back tx if transfer fails? Perhaps rdb_tx_discard()? */
+		pool_connect_map_put(req.pcr_map);
 	}
-	if (rc == 0)
-		rc = op_val.ov_rc;
-	D_FREE(map_buf);
-	D_FREE(hdl);
-	D_FREE(machine);
-	if (prop)
-		daos_prop_free(prop);
 out_svc:
 	ds_rsvc_set_hint(&svc->ps_rsvc, &out->pco_op.po_hint);
 	pool_svc_put_leader(svc);
@@ -4936,26 +5359,36 @@ ds_pool_query_handler(crt_rpc_t *rpc, int handler_version)
 	d_iov_t			  value;
 	crt_bulk_t                bulk;
 	uint64_t                  query_bits;
+	bool			  follower = false;
 	int			  rc;
 	struct daos_prop_entry	 *entry;
 
 	D_DEBUG(DB_MD, DF_UUID ": processing rpc: %p hdl=" DF_UUID "\n",
 		DP_UUID(in->pqi_op.pi_uuid), rpc, DP_UUID(in->pqi_op.pi_hdl));
 
+	pool_query_in_get_data(rpc, &bulk, &query_bits);
+
 	rc = pool_svc_lookup_leader(in->pqi_op.pi_uuid, &svc,
 				    &out->pqo_op.po_hint);
+	/* The rebuild status is only tracked by the leader. */
+	if (rc == -DER_NOTLEADER && !(query_bits & DAOS_PO_QUERY_REBUILD_STATUS) &&
+	    pool_svc_lookup_follower(in->pqi_op.pi_uuid, &svc) == 0) {
+		follower = true;
+		rc = 0;
+	}
 	if (rc != 0)
 		D_GOTO(out, rc);
 
-	pool_query_in_get_data(rpc, &bulk, &query_bits);
-
 	if (query_bits & DAOS_PO_QUERY_REBUILD_STATUS) {
 		rc = ds_rebuild_query(in->pqi_op.pi_uuid, &out->pqo_rebuild_st);
 		if (rc != 0)
 			D_GOTO(out_svc, rc);
 	}
 
-	rc = rdb_tx_begin(svc->ps_rsvc.s_db, svc->ps_rsvc.s_term, &tx);
+	if (follower)
+		rc = rdb_tx_begin_follower(svc->ps_rsvc.s_db, &tx);
+	else
+		rc = rdb_tx_begin(svc->ps_rsvc.s_db, svc->ps_rsvc.s_term, &tx);
 	if (rc != 0)
 		D_GOTO(out_svc, rc);
 
@@ -5127,7 +5560,12 @@ out_svc:
 	else
 		out->pqo_op.po_map_version = map_version;
 	ds_rsvc_set_hint(&svc->ps_rsvc, &out->pqo_op.po_hint);
-	pool_svc_put_leader(svc);
+	if (follower) {
+		out->pqo_op.po_hint.sh_flags |= RSVC_HINT_FOLLOWER;
+		ds_rsvc_put(&svc->ps_rsvc);
+	} else {
+		pool_svc_put_leader(svc);
+	}
 out:
 	out->pqo_op.po_rc = rc;
 	D_DEBUG(DB_MD, DF_UUID ": replying rpc: %p " DF_RC "\n", DP_UUID(in->pqi_op.pi_uuid), rpc,
@@ -1390,7 +1390,7 @@ static d_hash_table_ops_t pool_hdl_hash_ops = {
 int
 ds_pool_hdl_hash_init(void)
 {
-	return d_hash_table_create(0 /* feats */, 4 /* bits */, NULL /* priv */,
+	return d_hash_table_create(D_HASH_FT_RESIZE, 4 /* bits */, NULL /* priv */,
 				   &pool_hdl_hash_ops, &pool_hdl_hash);
 }
 
@@ -1756,6 +1756,72 @@ ds_pool_tgt_disconnect_aggregator(crt_rpc_t *source, crt_rpc_t *result,
 	return 0;
 }
 
+/*
+ * Set the top level domains of the pool map as the fault domains of the pool
+ * group members, for the CRT_TREE_DOMAIN trees. Every engine derives them from
+ * the same map version, and they take effect with the group update to that
+ * version, so that they all compute the same trees.
+ */
+static int
+update_pool_group_domains(struct ds_pool *pool, struct pool_map *map,
+			  d_rank_list_t *ranks)
+{
+	struct pool_domain	*root;
+	struct pool_domain	*dom;
+	struct pool_target	*tgt;
+	d_rank_list_t		*sorted = NULL;
+	uint32_t		*domains = NULL;
+	uint32_t		 version = pool_map_get_version(map);
+	uint32_t		 lo, hi, mid;
+	d_rank_t		 rank;
+	int			 i, j;
+	int			 rc;
+
+	rc = pool_map_find_domain(map, PO_COMP_TP_ROOT, PO_COMP_ID_ALL, &root);
+	if (rc <= 0 || root->do_child_nr == 0 ||
+	    root->do_children[0].do_comp.co_type == PO_COMP_TP_RANK)
+		/* Flat map, only one fault domain */
+		return crt_group_domains_set(pool->sp_group, NULL, NULL, version);
+
+	/* Sorted once, then the rank of each target is found by binary search. */
+	rc = d_rank_list_dup_sort_uniq(&sorted, ranks);
+	if (rc != 0)
+		return rc;
+
+	D_ALLOC_ARRAY(domains, sorted->rl_nr);
+	if (domains == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+	for (i = 0; i < sorted->rl_nr; i++)
+		domains[i] = CRT_NO_DOMAIN;
+
+	for (i = 0; i < root->do_child_nr; i++) {
+		dom = &root->do_children[i];
+		for (j = 0; j < dom->do_target_nr; j++) {
+			tgt = &dom->do_targets[j];
+			rank = tgt->ta_comp.co_rank;
+			lo = 0;
+			hi = sorted->rl_nr;
+			while (lo < hi) {
+				mid = lo + (hi - lo) / 2;
+				if (sorted->rl_ranks[mid] < rank) {
+					lo = mid + 1;
+				} else if (sorted->rl_ranks[mid] > rank) {
+					hi = mid;
+				} else {
+					domains[mid] = dom->do_comp.co_id;
+					break;
+				}
+			}
+		}
+	}
+
+	rc = crt_group_domains_set(pool->sp_group, sorted, domains, version);
+out:
+	D_FREE(domains);
+	d_rank_list_free(sorted);
+	return rc;
+}
+
 static int
 update_pool_group(struct ds_pool *pool, struct pool_map *map)
 {
@@ -1772,6 +1838,12 @@ update_pool_group(struct ds_pool *pool, struct pool_map *map)
 	if (rc != 0)
 		return rc;
 
+	/* Staged for the new version, installed with the membership below. */
+	rc = update_pool_group_domains(pool, map, &ranks);
+	if (rc != 0)
+		D_WARN(DF_UUID": failed to set fault domains: "DF_RC"\n",
+		       DP_UUID(pool->sp_uuid), DP_RC(rc));
+
 	/* Let secondary rank == primary rank. */
 	rc = crt_group_secondary_modify(pool->sp_group, &ranks, &ranks,
 					CRT_GROUP_MOD_OP_REPLACE,
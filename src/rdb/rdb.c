@@ -499,6 +499,16 @@ rdb_get_use_leases(void)
 	return value;
 }
 
+static bool
+rdb_get_follower_reads(void)
+{
+	char   *name = "RDB_FOLLOWER_READS";
+	bool	value = false;
+
+	d_getenv_bool(name, &value);
+	return value;
+}
+
 /**
  * Glance at \a storage and return \a clue. Callers are responsible for freeing
  * \a clue->bcl_replicas with d_rank_list_free.
@@ -620,8 +630,10 @@ rdb_start(struct rdb_storage *storage, struct rdb **dbp)
 	}
 
 	db->d_use_leases = rdb_get_use_leases();
+	db->d_follower_reads = rdb_get_follower_reads();
 
-	D_DEBUG(DB_MD, DF_DB": started db %p: use_leases=%d\n", DP_DB(db), db, db->d_use_leases);
+	D_DEBUG(DB_MD, DF_DB": started db %p: use_leases=%d follower_reads=%d\n", DP_DB(db), db,
+		db->d_use_leases, db->d_follower_reads);
 	*dbp = db;
 	return 0;
 }
@@ -841,6 +853,18 @@ rdb_is_leader(struct rdb *db, uint64_t *term)
 	return is_leader;
 }
 
+/**
+ * Does this replica serve queries when it is not the leader? See
+ * rdb_tx_begin_follower.
+ *
+ * \param[in]	db	database
+ */
+bool
+rdb_follower_reads_enabled(struct rdb *db)
+{
+	return db->d_follower_reads;
+}
+
 /**
  * Get a hint of the current leader, if available.
  *
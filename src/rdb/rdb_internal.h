@@ -69,7 +69,8 @@ struct rdb_chkpt_record {
  *  d_mutex: for RPC mgmt and ref count:
  *    d_requests, d_replies/cv, d_ref/cv
  *  d_raft_mutex: for raft state
- *    d_lc_record, d_applied/cv, d_events[]/cv, d_nevents, d_compact_cv
+ *    d_lc_record, d_slc_record/cv, d_applied/cv, d_events[]/cv, d_nevents,
+ *    d_compact_cv, d_ri_*
  *
  * TODO: locking for d_stop
  */
@@ -93,6 +94,7 @@ struct rdb {
 	uint64_t		d_nospc_ts;	/* last time commit observed low/no space (usec) */
 	bool			d_new;		/* for skipping lease recovery */
 	bool			d_use_leases;	/* when verifying leadership */
+	bool			d_follower_reads; /* serve queries on followers */
 
 	/* rdb_raft fields */
 	raft_server_t	       *d_raft;
@@ -102,9 +104,15 @@ struct rdb {
 	struct rdb_lc_record	d_lc_record;	/* of d_lc */
 	daos_handle_t		d_slc;		/* staging log container */
 	struct rdb_lc_record    d_slc_record;   /* of d_slc */
+	ABT_cond		d_slc_cv;	/* for d_slc_record updates */
 	uint64_t		d_applied;	/* last applied index */
 	uint64_t		d_debut;	/* first entry in a term */
-	ABT_cond		d_applied_cv;	/* for d_applied updates */
+	ABT_cond		d_applied_cv;	/* for d_applied and d_ri_* updates */
+	uint64_t		d_ri_started;	/* read index rounds started */
+	uint64_t		d_ri_done;	/* read index rounds done */
+	uint64_t		d_ri_index;	/* result of the last round done */
+	int			d_ri_rc;	/* result of the last round done */
+	bool			d_ri_inflight;	/* a read index round in flight */
 	struct d_hash_table	d_results;	/* rdb_raft_result hash */
 	d_list_t		d_requests;	/* RPCs waiting for replies */
 	d_list_t		d_replies;	/* RPCs received replies */
@@ -122,6 +130,9 @@ struct rdb {
 	ABT_thread		d_compactd;
 	size_t			d_ae_max_size;
 	unsigned int		d_ae_max_entries;
+	unsigned int		d_ae_max_inflight; /* AEs in flight per follower */
+	size_t			d_is_chunk_size; /* IS chunk data size */
+	unsigned int		d_is_max_inflight; /* IS chunks in flight per follower */
 };
 
 /* thresholds of free space for a leader to avoid appending new log entries (4 MiB)
@@ -161,12 +172,16 @@ struct rdb *rdb_lookup(const uuid_t uuid);
  * Per-raft_node_t INSTALLSNAPSHOT state
  *
  * dis_seq and dis_anchor track the last chunk successfully received by the
- * follower.
+ * follower. dis_sent_seq and dis_sent_anchor track the last chunk sent, which
+ * is ahead of the former by the dis_inflight chunks in flight.
  */
 struct rdb_raft_is {
 	uint64_t		dis_index;	/* snapshot index */
 	uint64_t		dis_seq;	/* last sequence number */
 	struct rdb_anchor	dis_anchor;	/* last anchor */
+	uint64_t		dis_sent_seq;	/* last sequence number sent */
+	struct rdb_anchor	dis_sent_anchor; /* last anchor sent */
+	unsigned int		dis_inflight;	/* chunks in flight */
 };
 
 /* Per-raft_node_t data */
@@ -176,6 +191,9 @@ struct rdb_raft_node {
 	/* Leader fields */
 	uint64_t		dn_term;	/* of leader */
 	struct rdb_raft_is	dn_is;
+	uint64_t		dn_ae_term;	/* of the AEs below */
+	uint64_t		dn_ae_sent;	/* last entry index sent */
+	unsigned int		dn_ae_inflight;	/* AEs in flight */
 };
 
 void rdb_raft_module_init(void);
@@ -196,11 +214,14 @@ int rdb_raft_remove_replica(struct rdb *db, d_rank_t rank);
 int rdb_raft_append_apply(struct rdb *db, void *entry, size_t size,
 			  void *result);
 int rdb_raft_wait_applied(struct rdb *db, uint64_t index, uint64_t term);
+int rdb_raft_read_index(struct rdb *db);
 int rdb_raft_get_ranks(struct rdb *db, d_rank_list_t **ranksp);
 void rdb_requestvote_handler(crt_rpc_t *rpc);
 void rdb_appendentries_handler(crt_rpc_t *rpc);
 void rdb_installsnapshot_handler(crt_rpc_t *rpc);
+void rdb_readindex_handler(crt_rpc_t *rpc);
 void rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc);
+void rdb_raft_process_failure(struct rdb *db, crt_rpc_t *rpc, int error);
 void rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc);
 int rdb_raft_trigger_compaction(struct rdb *db, bool compact_all, uint64_t *idx);
 
@@ -219,7 +240,8 @@ int rdb_raft_trigger_compaction(struct rdb *db, bool compact_all, uint64_t *idx)
 #define RDB_PROTO_SRV_RPC_LIST                                                                     \
 	X(RDB_REQUESTVOTE, 0, &CQF_rdb_requestvote, rdb_requestvote_handler, NULL)                 \
 	X(RDB_APPENDENTRIES, 0, &CQF_rdb_appendentries, rdb_appendentries_handler, NULL)           \
-	X(RDB_INSTALLSNAPSHOT, 0, &CQF_rdb_installsnapshot, rdb_installsnapshot_handler, NULL)
+	X(RDB_INSTALLSNAPSHOT, 0, &CQF_rdb_installsnapshot, rdb_installsnapshot_handler, NULL)     \
+	X(RDB_READINDEX, 0, &CQF_rdb_readindex, rdb_readindex_handler, NULL)
 
 /* Define for RPC enum population below */
 #define X(a, ...) a,
@@ -293,6 +315,16 @@ struct rdb_local {
 CRT_RPC_DECLARE(rdb_installsnapshot, DAOS_ISEQ_RDB_INSTALLSNAPSHOT,
 		DAOS_OSEQ_RDB_INSTALLSNAPSHOT)
 
+#define DAOS_ISEQ_RDB_READINDEX	/* input fields */		 \
+	((struct rdb_op_in)	(rii_op)		CRT_VAR)
+
+#define DAOS_OSEQ_RDB_READINDEX	/* output fields */		 \
+	((struct rdb_op_out)	(rio_op)		CRT_VAR) \
+	/* commit index of the leader */			 \
+	((uint64_t)		(rio_index)		CRT_VAR)
+
+CRT_RPC_DECLARE(rdb_readindex, DAOS_ISEQ_RDB_READINDEX, DAOS_OSEQ_RDB_READINDEX)
+
 int rdb_create_raft_rpc(crt_opcode_t opc, raft_node_t *node, crt_rpc_t **rpc);
 int rdb_send_raft_rpc(crt_rpc_t *rpc, struct rdb *db);
 int rdb_abort_raft_rpcs(struct rdb *db);
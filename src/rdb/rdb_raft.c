@@ -34,9 +34,21 @@
 #include <daos_srv/vos.h>
 #include <daos_srv/object.h>
 #include <daos/object.h>
+#include <gurt/telemetry_producer.h>
 #include "rdb_internal.h"
 #include "rdb_layout.h"
 
+/* Engine-wide INSTALLSNAPSHOT metrics */
+static struct {
+	struct d_tm_node_t     *is_chunks_sent;
+	struct d_tm_node_t     *is_bytes_sent;
+	struct d_tm_node_t     *is_inflight;
+	struct d_tm_node_t     *is_chunks_recvd;
+	struct d_tm_node_t     *is_bytes_recvd;
+	struct d_tm_node_t     *is_chunks_stored;
+	struct d_tm_node_t     *is_installed;
+} rdb_raft_metrics;
+
 static int rdb_raft_create_lc(daos_handle_t pool, daos_handle_t mc,
 			      d_iov_t *key, uint64_t base,
 			      uint64_t base_term, uint64_t term,
@@ -178,20 +190,118 @@ rdb_raft_clone_ae(struct rdb *db, const msg_appendentries_t *ae, msg_appendentri
 	return 0;
 }
 
+/*
+ * Pipelining: When d_ae_max_inflight > 1, up to that many AEs may be in flight
+ * to each follower. After sending entries, we advance the next index of the
+ * follower past them, so that raft sends new entries right away instead of
+ * waiting for the response. The entries raft sends again (e.g., after a
+ * response moves the next index back to the follower's last entry) are
+ * skipped if they are still in flight. When the window is full, entries
+ * accumulate until a response frees a slot, and then go in one AE, up to
+ * d_ae_max_entries and d_ae_max_size.
+ *
+ * Returns true if \a msg shall be sent, after trimming the entries in flight
+ * off the front of \a msg.
+ */
+static bool
+rdb_raft_ae_pipeline(struct rdb *db, struct rdb_raft_node *rdb_node,
+		     msg_appendentries_t *msg)
+{
+	uint64_t	last = msg->prev_log_idx + msg->n_entries;
+	uint64_t	skip;
+
+	if (db->d_ae_max_inflight <= 1)
+		return true;
+
+	if (rdb_node->dn_ae_term != msg->term) {
+		rdb_node->dn_ae_term = msg->term;
+		rdb_node->dn_ae_sent = 0;
+		rdb_node->dn_ae_inflight = 0;
+	}
+
+	if (rdb_node->dn_ae_inflight == 0)
+		return true;
+
+	/* Nothing new; the AEs in flight serve as heartbeats too. */
+	if (last <= rdb_node->dn_ae_sent)
+		return false;
+
+	/* Window full; a response will send the accumulated entries. */
+	if (rdb_node->dn_ae_inflight >= db->d_ae_max_inflight)
+		return false;
+
+	if (msg->prev_log_idx < rdb_node->dn_ae_sent) {
+		skip = rdb_node->dn_ae_sent - msg->prev_log_idx;
+		msg->prev_log_idx = rdb_node->dn_ae_sent;
+		msg->prev_log_term = msg->entries[skip - 1].term;
+		msg->entries += skip;
+		msg->n_entries -= skip;
+	}
+	return true;
+}
+
+/* Account for an AE sent to \a node with the entries up to \a last. */
+static void
+rdb_raft_ae_sent(struct rdb *db, raft_node_t *node, uint64_t last)
+{
+	struct rdb_raft_node *rdb_node = raft_node_get_udata(node);
+
+	if (db->d_ae_max_inflight <= 1)
+		return;
+
+	rdb_node->dn_ae_inflight++;
+	if (last > rdb_node->dn_ae_sent) {
+		rdb_node->dn_ae_sent = last;
+		if (raft_node_get_next_idx(node) <= last)
+			raft_node_set_next_idx(node, last + 1);
+	}
+}
+
+/*
+ * Account for the completion of an AE to \a node. If the AE failed, or the
+ * follower rejected it, stop skipping the entries in flight, which raft shall
+ * send again. If the AE failed, also move the next index of the follower back
+ * to its last known entry, for we may have advanced it optimistically.
+ */
+static void
+rdb_raft_ae_done(struct rdb *db, raft_node_t *node, bool failed, bool rejected)
+{
+	struct rdb_raft_node *rdb_node = raft_node_get_udata(node);
+
+	if (db->d_ae_max_inflight <= 1)
+		return;
+
+	if (rdb_node->dn_ae_inflight > 0)
+		rdb_node->dn_ae_inflight--;
+	if (failed || rejected)
+		rdb_node->dn_ae_sent = 0;
+	if (failed && raft_is_leader(db->d_raft))
+		raft_node_set_next_idx(node, raft_node_get_match_idx(node) + 1);
+}
+
 static int
 rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 			       raft_node_t *node, msg_appendentries_t *msg)
 {
 	struct rdb		       *db = arg;
 	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
+	msg_appendentries_t		ae = *msg;
 	crt_rpc_t		       *rpc;
 	struct rdb_appendentries_in    *in;
 	int				rc;
 
 	D_ASSERT(db->d_raft == raft);
+
+	if (!rdb_raft_ae_pipeline(db, rdb_node, &ae)) {
+		D_DEBUG(DB_TRACE, DF_DB": not sending ae to rank %u: inflight=%u sent="DF_U64"\n",
+			DP_DB(db), rdb_node->dn_rank, rdb_node->dn_ae_inflight,
+			rdb_node->dn_ae_sent);
+		return 0;
+	}
+
 	D_DEBUG(DB_TRACE, DF_DB": sending ae to node %u rank %u: term=%ld\n",
 		DP_DB(db), raft_node_get_id(node), rdb_node->dn_rank,
-		msg->term);
+		ae.term);
 
 	if (DAOS_FAIL_CHECK(DAOS_RDB_SKIP_APPENDENTRIES_FAIL))
 		D_GOTO(err, rc = 0);
@@ -204,7 +314,7 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 	}
 	in = crt_req_get(rpc);
 	uuid_copy(in->aei_op.ri_uuid, db->d_uuid);
-	rc = rdb_raft_clone_ae(db, msg, &in->aei_msg);
+	rc = rdb_raft_clone_ae(db, &ae, &in->aei_msg);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to allocate entry array\n", DP_DB(db));
 		D_GOTO(err_rpc, rc);
@@ -216,6 +326,7 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 			DP_DB(db), raft_node_get_id(node), rc);
 		D_GOTO(err_in, rc);
 	}
+	rdb_raft_ae_sent(db, node, in->aei_msg.prev_log_idx + in->aei_msg.n_entries);
 	return 0;
 
 err_in:
@@ -376,6 +487,7 @@ rdb_raft_unload_snapshot(struct rdb *db)
 		raft_remove_node(db->d_raft, raft_get_node_from_idx(db->d_raft, 0));
 }
 
+/* Pack the chunk following \a is->dis_sent_anchor, reporting its end in \a anchor. */
 static int
 rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 		    d_iov_t *data, struct rdb_anchor *anchor)
@@ -391,7 +503,7 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 	 * is->dis_index.
 	 */
 	param.ip_hdl = lc;
-	rdb_anchor_to_hashes(&is->dis_anchor, &anchors.ia_obj, &anchors.ia_dkey,
+	rdb_anchor_to_hashes(&is->dis_sent_anchor, &anchors.ia_obj, &anchors.ia_dkey,
 			     &anchors.ia_akey, &anchors.ia_ev, &anchors.ia_sv);
 	param.ip_epr.epr_lo = is->dis_index;
 	param.ip_epr.epr_hi = is->dis_index;
@@ -408,7 +520,7 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 
 	arg.copy_data_cb = vos_iter_copy;
 	/* Attempt to inline all values until recx bulks are implemented. */
-	arg.inline_thres = 1 * 1024 * 1024;
+	arg.inline_thres = data->iov_buf_len;
 
 	/* Enumerate from the object level. */
 	rc = ds_obj_enum_pack(&param, VOS_ITER_OBJ, true, &anchors, &arg,
@@ -434,10 +546,8 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 }
 
 static int
-rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
-				 raft_node_t *node, msg_installsnapshot_t *msg)
+rdb_raft_send_is_chunk(struct rdb *db, raft_node_t *node, msg_installsnapshot_t *msg)
 {
-	struct rdb		       *db = arg;
 	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
 	struct rdb_raft_is	       *is = &rdb_node->dn_is;
 	crt_rpc_t		       *rpc;
@@ -462,36 +572,26 @@ rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
 
 	/*
 	 * Allocate the data buffers. The sizes mustn't change during the term
-	 * of the leadership.
+	 * of the leadership. Scale the key descriptor buffer with the data
+	 * buffer (4 KiB per MiB), so that KVSs of small values fill chunks as
+	 * well as KVSs of large ones.
 	 */
-	kds.iov_buf_len = 4 * 1024;
+	kds.iov_buf_len = max(db->d_is_chunk_size >> 8, 4 * 1024);
 	kds.iov_len = 0;
 	D_ALLOC(kds.iov_buf, kds.iov_buf_len);
 	if (kds.iov_buf == NULL)
-		goto err_rpc;
-	data.iov_buf_len = 1 * 1024 * 1024;
+		D_GOTO(err_rpc, rc = -DER_NOMEM);
+	data.iov_buf_len = db->d_is_chunk_size;
 	data.iov_len = 0;
 	D_ALLOC(data.iov_buf, data.iov_buf_len);
 	if (data.iov_buf == NULL)
-		goto err_kds;
-
-	/*
-	 * If the INSTALLSNAPSHOT state tracks a different term or snapshot,
-	 * reinitialize it for the current term and snapshot.
-	 */
-	if (rdb_node->dn_term != raft_get_current_term(raft) ||
-	    is->dis_index != msg->last_idx) {
-		rdb_node->dn_term = raft_get_current_term(raft);
-		is->dis_index = msg->last_idx;
-		is->dis_seq = 0;
-		rdb_anchor_set_zero(&is->dis_anchor);
-	}
+		D_GOTO(err_kds, rc = -DER_NOMEM);
 
 	/* Pack the chunk's data, anchor, and seq. */
 	rc = rdb_raft_pack_chunk(db->d_lc, is, &kds, &data, &in->isi_anchor);
 	if (rc != 0)
 		goto err_data;
-	in->isi_seq = is->dis_seq + 1;
+	in->isi_seq = is->dis_sent_seq + 1;
 
 	/*
 	 * Create bulks for the buffers. crt_bulk_create looks at iov_buf_len
@@ -526,12 +626,19 @@ rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
 		goto err_data_bulk;
 	}
 
+	is->dis_sent_seq = in->isi_seq;
+	is->dis_sent_anchor = in->isi_anchor;
+	is->dis_inflight++;
+	d_tm_inc_counter(rdb_raft_metrics.is_chunks_sent, 1);
+	d_tm_inc_counter(rdb_raft_metrics.is_bytes_sent, kds.iov_len + data.iov_len);
+	d_tm_inc_gauge(rdb_raft_metrics.is_inflight, 1);
+
 	D_DEBUG(DB_TRACE,
 		DF_DB": sent is to node %u rank %u: term=%ld last_idx=%ld seq="
-		DF_U64" kds.len="DF_U64" data.len="DF_U64"\n",
+		DF_U64" kds.len="DF_U64" data.len="DF_U64" inflight=%u\n",
 		DP_DB(db), raft_node_get_id(node), rdb_node->dn_rank,
 		in->isi_msg.term, in->isi_msg.last_idx, in->isi_seq,
-		kds.iov_len, data.iov_len);
+		kds.iov_len, data.iov_len, is->dis_inflight);
 	return 0;
 
 err_data_bulk:
@@ -548,6 +655,76 @@ err:
 	return rc;
 }
 
+/*
+ * Send up to d_is_max_inflight chunks to the follower, so that the follower
+ * may receive the next chunks while storing the current one. When no chunk is
+ * in flight, start again from the last chunk the follower has reported.
+ */
+static int
+rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
+				 raft_node_t *node, msg_installsnapshot_t *msg)
+{
+	struct rdb		       *db = arg;
+	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
+	struct rdb_raft_is	       *is = &rdb_node->dn_is;
+	int				rc;
+
+	/*
+	 * If the INSTALLSNAPSHOT state tracks a different term or snapshot,
+	 * reinitialize it for the current term and snapshot.
+	 */
+	if (rdb_node->dn_term != raft_get_current_term(raft) ||
+	    is->dis_index != msg->last_idx) {
+		rdb_node->dn_term = raft_get_current_term(raft);
+		is->dis_index = msg->last_idx;
+		is->dis_seq = 0;
+		rdb_anchor_set_zero(&is->dis_anchor);
+		is->dis_inflight = 0;
+	}
+
+	if (is->dis_inflight == 0) {
+		is->dis_sent_seq = is->dis_seq;
+		is->dis_sent_anchor = is->dis_anchor;
+	} else if (is->dis_inflight >= db->d_is_max_inflight ||
+		   rdb_anchor_is_eof(&is->dis_sent_anchor)) {
+		return 0;
+	}
+
+	do {
+		rc = rdb_raft_send_is_chunk(db, node, msg);
+		if (rc != 0)
+			/* Report the error only if no chunk is in flight. */
+			return is->dis_inflight == 0 ? rc : 0;
+	} while (is->dis_inflight < db->d_is_max_inflight &&
+		 !rdb_anchor_is_eof(&is->dis_sent_anchor));
+
+	return 0;
+}
+
+/*
+ * Account for the completion of an IS chunk \a in to \a node. If the chunk
+ * failed, or the follower did not store it, send again from the last chunk
+ * the follower has reported.
+ */
+static void
+rdb_raft_is_done(struct rdb *db, raft_node_t *node, struct rdb_installsnapshot_in *in,
+		 bool failed)
+{
+	struct rdb_raft_node   *rdb_node = raft_node_get_udata(node);
+	struct rdb_raft_is     *is = &rdb_node->dn_is;
+
+	/* Of a previous term or snapshot, already forgotten. */
+	if (rdb_node->dn_term != in->isi_msg.term || is->dis_index != in->isi_msg.last_idx ||
+	    is->dis_inflight == 0)
+		return;
+
+	is->dis_inflight--;
+	if (failed) {
+		is->dis_sent_seq = is->dis_seq;
+		is->dis_sent_anchor = is->dis_anchor;
+	}
+}
+
 struct rdb_raft_bulk {
 	ABT_eventual	drb_eventual;
 	int		drb_n;
@@ -844,7 +1021,7 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_anchor = slc_record->dlr_anchor;
 		return 0;
 	} else if (in->isi_seq > slc_record->dlr_seq + 1) {
-		/* Chunks are sent one by one for now. */
+		/* See rdb_raft_wait_is_chunk. */
 		D_ERROR(DF_DB": might have lost chunks: "DF_U64" > "DF_U64"\n",
 			DP_DB(db), in->isi_seq, slc_record->dlr_seq);
 		return -DER_IO;
@@ -902,6 +1079,8 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_success = 1;
 		out->iso_seq = lc_record->dlr_seq;
 		out->iso_anchor = lc_record->dlr_anchor;
+		d_tm_inc_counter(rdb_raft_metrics.is_chunks_stored, 1);
+		d_tm_inc_counter(rdb_raft_metrics.is_installed, 1);
 
 		/* Load this snapshot. */
 		rc = rdb_raft_load_snapshot(db);
@@ -937,6 +1116,7 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_success = 1;
 		out->iso_seq = slc_record->dlr_seq;
 		out->iso_anchor = slc_record->dlr_anchor;
+		d_tm_inc_counter(rdb_raft_metrics.is_chunks_stored, 1);
 	}
 
 	return rc;
@@ -1007,6 +1187,12 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 	is->dis_seq = out->iso_seq;
 	is->dis_anchor = out->iso_anchor;
 
+	/* If the follower has fast-forwarded past the chunks sent, follow. */
+	if (is->dis_sent_seq < is->dis_seq) {
+		is->dis_sent_seq = is->dis_seq;
+		is->dis_sent_anchor = is->dis_anchor;
+	}
+
 	return 0;
 }
 
@@ -2600,6 +2786,55 @@ rdb_raft_get_ae_max_entries(void)
 	return value;
 }
 
+static unsigned int
+rdb_raft_get_ae_max_inflight(void)
+{
+	char	       *name = "RDB_AE_MAX_INFLIGHT";
+	unsigned int	default_value = 8;
+	unsigned int	value = default_value;
+
+	d_getenv_uint(name, &value);
+	if (value == 0) {
+		D_WARN("%s not in (0, %u] (defaulting to %u)\n", name, UINT_MAX, default_value);
+		value = default_value;
+	}
+	return value;
+}
+
+static unsigned int
+rdb_raft_get_is_max_inflight(void)
+{
+	char	       *name = "RDB_IS_MAX_INFLIGHT";
+	unsigned int	default_value = 4;
+	unsigned int	value = default_value;
+
+	d_getenv_uint(name, &value);
+	if (value == 0) {
+		D_WARN("%s not in (0, %u] (defaulting to %u)\n", name, UINT_MAX, default_value);
+		value = default_value;
+	}
+	return value;
+}
+
+static size_t
+rdb_raft_get_is_chunk_size(void)
+{
+	char	       *name = "RDB_IS_CHUNK_SIZE";
+	uint64_t	min_value = (1ULL << 16);
+	uint64_t	max_value = (1ULL << 30);
+	uint64_t	default_value = (1ULL << 22);
+	uint64_t	value = default_value;
+	int		rc;
+
+	rc = d_getenv_uint64_t(name, &value);
+	if ((rc != -DER_NONEXIST && rc != 0) || value < min_value || value > max_value) {
+		D_WARN("%s not in ["DF_U64", "DF_U64"] (defaulting to "DF_U64")\n", name,
+		       min_value, max_value, default_value);
+		value = default_value;
+	}
+	return value;
+}
+
 static size_t
 rdb_raft_get_ae_max_size(void)
 {
@@ -2745,6 +2980,9 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 	db->d_compact_thres = rdb_raft_get_compact_thres();
 	db->d_ae_max_size = rdb_raft_get_ae_max_size();
 	db->d_ae_max_entries = rdb_raft_get_ae_max_entries();
+	db->d_ae_max_inflight = rdb_raft_get_ae_max_inflight();
+	db->d_is_chunk_size = rdb_raft_get_is_chunk_size();
+	db->d_is_max_inflight = rdb_raft_get_is_max_inflight();
 
 	rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK, 4 /* bits */,
 					 NULL /* priv */,
@@ -2793,6 +3031,13 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 		goto err_compact_cv;
 	}
 
+	rc = ABT_cond_create(&db->d_slc_cv);
+	if (rc != ABT_SUCCESS) {
+		D_ERROR(DF_DB": failed to create SLC CV: %d\n", DP_DB(db), rc);
+		rc = dss_abterr2der(rc);
+		goto err_compacted_cv;
+	}
+
 	if (caller_term != RDB_NIL_TERM) {
 		uint64_t	term;
 		d_iov_t		value;
@@ -2802,13 +3047,13 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 		if (rc == -DER_NONEXIST)
 			term = 0;
 		else if (rc != 0)
-			goto err_compacted_cv;
+			goto err_slc_cv;
 
 		if (caller_term < term) {
 			D_DEBUG(DB_MD, DF_DB": stale caller term: "DF_X64" < "DF_X64"\n", DP_DB(db),
 				caller_term, term);
 			rc = -DER_STALE;
-			goto err_compacted_cv;
+			goto err_slc_cv;
 		} else if (caller_term > term) {
 			D_DEBUG(DB_MD, DF_DB": updating term: "DF_X64" -> "DF_X64"\n", DP_DB(db),
 				term, caller_term);
@@ -2816,16 +3061,18 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 			rc = rdb_mc_update(db->d_mc, RDB_MC_ATTRS, 1 /* n */, &rdb_mc_term, &value,
 					   NULL /* vtx */);
 			if (rc != 0)
-				goto err_compacted_cv;
+				goto err_slc_cv;
 		}
 	}
 
 	rc = rdb_raft_open_lc(db);
 	if (rc != 0)
-		goto err_compacted_cv;
+		goto err_slc_cv;
 
 	return 0;
 
+err_slc_cv:
+	ABT_cond_free(&db->d_slc_cv);
 err_compacted_cv:
 	ABT_cond_free(&db->d_compacted_cv);
 err_compact_cv:
@@ -2847,6 +3094,7 @@ rdb_raft_close(struct rdb *db)
 {
 	D_ASSERT(db->d_raft == NULL);
 	rdb_raft_close_lc(db);
+	ABT_cond_free(&db->d_slc_cv);
 	ABT_cond_free(&db->d_compacted_cv);
 	ABT_cond_free(&db->d_compact_cv);
 	ABT_cond_free(&db->d_replies_cv);
@@ -2970,9 +3218,11 @@ rdb_raft_start(struct rdb *db)
 	D_DEBUG(DB_MD,
 		DF_DB": raft started: election_timeout=%dms request_timeout=%dms "
 		"lease_maintenance_grace=%dms compact_thres="DF_U64" ae_max_entries=%u "
-		"ae_max_size="DF_U64"\n", DP_DB(db), election_timeout, request_timeout,
+		"ae_max_size="DF_U64" ae_max_inflight=%u is_chunk_size="DF_U64" "
+		"is_max_inflight=%u\n", DP_DB(db), election_timeout, request_timeout,
 		lease_maintenance_grace, db->d_compact_thres, db->d_ae_max_entries,
-		db->d_ae_max_size);
+		db->d_ae_max_size, db->d_ae_max_inflight, db->d_is_chunk_size,
+		db->d_is_max_inflight);
 	return 0;
 
 err_callbackd:
@@ -3014,6 +3264,7 @@ rdb_raft_stop(struct rdb *db)
 	ABT_cond_broadcast(db->d_applied_cv);
 	ABT_cond_broadcast(db->d_events_cv);
 	ABT_cond_broadcast(db->d_compact_cv);
+	ABT_cond_broadcast(db->d_slc_cv);
 	ABT_mutex_unlock(db->d_raft_mutex);
 
 	ABT_mutex_lock(db->d_mutex);
@@ -3161,6 +3412,118 @@ rdb_raft_wait_applied(struct rdb *db, uint64_t index, uint64_t term)
 	return rc;
 }
 
+/*
+ * Get a commit index that covers all entries committed before this call, if
+ * this replica is the leader of the current term. Caller holds d_raft_mutex.
+ */
+static int
+rdb_raft_leader_read_index(struct rdb *db, uint64_t *index)
+{
+	uint64_t	term = raft_get_current_term(db->d_raft);
+	int		rc;
+
+	if (!raft_is_leader(db->d_raft))
+		return -DER_NOTLEADER;
+	rc = rdb_raft_wait_applied(db, db->d_debut, term);
+	if (rc != 0)
+		return rc;
+	rc = rdb_raft_verify_leadership(db);
+	if (rc != 0)
+		return rc;
+	*index = raft_get_commit_idx(db->d_raft);
+	return 0;
+}
+
+/*
+ * Get the commit index from the current leader, or locally if this replica is
+ * the leader. Caller holds d_raft_mutex, which may be released temporarily.
+ */
+static int
+rdb_raft_read_index_round(struct rdb *db, uint64_t *index)
+{
+	struct rdb_readindex_in	       *in;
+	struct rdb_readindex_out       *out;
+	raft_node_t		       *node;
+	crt_rpc_t		       *rpc;
+	int				rc;
+
+	if (raft_is_leader(db->d_raft))
+		return rdb_raft_leader_read_index(db, index);
+
+	node = raft_get_current_leader_node(db->d_raft);
+	if (node == NULL)
+		return -DER_NOTLEADER;
+	rc = rdb_create_raft_rpc(RDB_READINDEX, node, &rpc);
+	if (rc != 0)
+		return rc;
+	in = crt_req_get(rpc);
+	uuid_copy(in->rii_op.ri_uuid, db->d_uuid);
+
+	ABT_mutex_unlock(db->d_raft_mutex);
+	rc = dss_rpc_send(rpc);
+	if (rc == 0) {
+		out = crt_reply_get(rpc);
+		rc = out->rio_op.ro_rc;
+		if (rc == 0)
+			*index = out->rio_index;
+	}
+	crt_req_decref(rpc);
+	ABT_mutex_lock(db->d_raft_mutex);
+	return rc;
+}
+
+/*
+ * Wait until this replica, whether the leader or a follower, has applied all
+ * entries committed before this call, so that its queries are linearizable.
+ * Concurrent callers share read index rounds: A caller joins the next round to
+ * start, as the one in flight may have started before the call. Caller holds
+ * d_raft_mutex.
+ */
+int
+rdb_raft_read_index(struct rdb *db)
+{
+	uint64_t	round = db->d_ri_started + 1;
+	uint64_t	index = 0;
+	int		rc;
+
+	for (;;) {
+		if (db->d_stop)
+			return -DER_CANCELED;
+		if (db->d_ri_done >= round) {
+			rc = db->d_ri_rc;
+			index = db->d_ri_index;
+			break;
+		}
+		if (!db->d_ri_inflight) {
+			db->d_ri_inflight = true;
+			db->d_ri_started++;
+			rc = rdb_raft_read_index_round(db, &index);
+			db->d_ri_done = db->d_ri_started;
+			db->d_ri_index = index;
+			db->d_ri_rc = rc;
+			db->d_ri_inflight = false;
+			ABT_cond_broadcast(db->d_applied_cv);
+			continue;
+		}
+		ABT_cond_wait(db->d_applied_cv, db->d_raft_mutex);
+	}
+	if (rc != 0) {
+		D_DEBUG(DB_MD, DF_DB": read index round "DF_U64": "DF_RC"\n", DP_DB(db), round,
+			DP_RC(rc));
+		/* Let the client try another replica. */
+		return rc == -DER_CANCELED ? rc : -DER_NOTLEADER;
+	}
+
+	D_DEBUG(DB_TRACE, DF_DB": waiting for read index "DF_U64" to be applied\n", DP_DB(db),
+		index);
+	while (db->d_applied < index) {
+		if (db->d_stop)
+			return -DER_CANCELED;
+		ABT_cond_wait(db->d_applied_cv, db->d_raft_mutex);
+	}
+	return 0;
+}
+
 int
 rdb_raft_get_ranks(struct rdb *db, d_rank_list_t **ranksp)
 {
@@ -3291,6 +3654,52 @@ out:
 			srcrank, rc);
 }
 
+/* Whether the chunks preceding \a in are yet to be stored. */
+static bool
+rdb_raft_is_chunk_early(struct rdb *db, struct rdb_installsnapshot_in *in)
+{
+	struct rdb_lc_record *slc_record = &db->d_slc_record;
+
+	if (in->isi_seq <= 1 || db->d_lc_record.dlr_base >= in->isi_msg.last_idx)
+		return false;
+	/* The first chunk, which creates the SLC, is yet to be stored. */
+	if (daos_handle_is_inval(db->d_slc) || slc_record->dlr_term != in->isi_msg.term ||
+	    slc_record->dlr_base != in->isi_msg.last_idx)
+		return true;
+	return in->isi_seq > slc_record->dlr_seq + 1;
+}
+
+/*
+ * The leader sends several chunks at once, whose transfers may complete out of
+ * order. Wait for the preceding chunks to be stored, so that the chunks are
+ * stored in order while the following ones are being transferred. The leader
+ * times out the chunk RPC after max(request timeout, 1 s), counted from before
+ * the transfer of the chunk; reply well before, within half of that since
+ * \a start, the arrival of the request. If the preceding chunks are still
+ * missing, they must have been lost, which rdb_raft_cb_recv_installsnapshot
+ * reports to the leader so that it resends them. Caller holds d_raft_mutex.
+ */
+static void
+rdb_raft_wait_is_chunk(struct rdb *db, struct rdb_installsnapshot_in *in,
+		       const struct timespec *start)
+{
+	struct timespec	deadline = *start;
+	int		timeout = max(raft_get_request_timeout(db->d_raft) / 1000, 1) * 1000;
+	int		rc;
+
+	deadline.tv_sec += timeout / 2 / 1000;
+	deadline.tv_nsec += (timeout / 2 % 1000) * NSEC_PER_MSEC;
+	if (deadline.tv_nsec >= NSEC_PER_SEC) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= NSEC_PER_SEC;
+	}
+	while (!db->d_stop && rdb_raft_is_chunk_early(db, in)) {
+		rc = ABT_cond_timedwait(db->d_slc_cv, db->d_raft_mutex, &deadline);
+		if (rc == ABT_ERR_COND_TIMEDOUT)
+			break;
+	}
+}
+
 void
 rdb_installsnapshot_handler(crt_rpc_t *rpc)
 {
@@ -3298,9 +3707,13 @@ rdb_installsnapshot_handler(crt_rpc_t *rpc)
 	struct rdb_installsnapshot_out *out = crt_reply_get(rpc);
 	struct rdb		       *db;
 	struct rdb_raft_state		state;
+	struct timespec			start;
 	d_rank_t			srcrank;
 	int				rc;
 
+	/* See rdb_chkptd for why CLOCK_REALTIME. */
+	clock_gettime(CLOCK_REALTIME_COARSE, &start);
+
 	rc = crt_req_src_rank_get(rpc, &srcrank);
 	D_ASSERTF(rc == 0, ""DF_RC"\n", DP_RC(rc));
 
@@ -3327,12 +3740,19 @@ rdb_installsnapshot_handler(crt_rpc_t *rpc)
 		goto out_db;
 	}
 
+	d_tm_inc_counter(rdb_raft_metrics.is_chunks_recvd, 1);
+	d_tm_inc_counter(rdb_raft_metrics.is_bytes_recvd,
+			 in->isi_local.rl_kds_iov.iov_len + in->isi_local.rl_data_iov.iov_len);
+
 	ABT_mutex_lock(db->d_raft_mutex);
+	rdb_raft_wait_is_chunk(db, in, &start);
 	rdb_raft_save_state(db, &state);
 	rc = raft_recv_installsnapshot(db->d_raft,
 				       raft_get_node(db->d_raft, srcrank),
 				       &in->isi_msg, &out->iso_msg);
 	rc = rdb_raft_check_state(db, &state, rc);
+	/* Wake up the chunks waiting for this one. */
+	ABT_cond_broadcast(db->d_slc_cv);
 	ABT_mutex_unlock(db->d_raft_mutex);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to process INSTALLSNAPSHOT from rank "
@@ -3356,6 +3776,39 @@ out:
 			srcrank, rc);
 }
 
+void
+rdb_readindex_handler(crt_rpc_t *rpc)
+{
+	struct rdb_readindex_in	       *in = crt_req_get(rpc);
+	struct rdb_readindex_out       *out = crt_reply_get(rpc);
+	struct rdb		       *db;
+	d_rank_t			srcrank;
+	int				rc;
+
+	rc = crt_req_src_rank_get(rpc, &srcrank);
+	D_ASSERTF(rc == 0, ""DF_RC"\n", DP_RC(rc));
+
+	db = rdb_lookup(in->rii_op.ri_uuid);
+	if (db == NULL)
+		D_GOTO(out, rc = -DER_NONEXIST);
+	if (db->d_stop)
+		D_GOTO(out_db, rc = -DER_CANCELED);
+
+	D_DEBUG(DB_TRACE, DF_DB": handling read index from rank %u\n", DP_DB(db), srcrank);
+	ABT_mutex_lock(db->d_raft_mutex);
+	rc = rdb_raft_leader_read_index(db, &out->rio_index);
+	ABT_mutex_unlock(db->d_raft_mutex);
+
+out_db:
+	rdb_put(db);
+out:
+	out->rio_op.ro_rc = rc;
+	rc = crt_reply_send(rpc);
+	if (rc != 0)
+		D_ERROR(DF_UUID": failed to send READINDEX reply to rank %u: %d\n",
+			DP_UUID(in->rii_op.ri_uuid), srcrank, rc);
+}
+
 void
 rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 {
@@ -3380,6 +3833,7 @@ rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 	if (rc != 0) {
 		D_DEBUG(DB_MD, DF_DB": opc %u failed: %d\n", DP_DB(db), opc,
 			rc);
+		rdb_raft_process_failure(db, rpc, rc);
 		return;
 	}
 
@@ -3403,6 +3857,7 @@ rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 		if (*lease < adjustment) {
 			D_ERROR(DF_DB": dropping %s response from rank %u: invalid lease: %ld\n",
 				DP_DB(db), opc == RDB_APPENDENTRIES ? "AE" : "IS", rank, *lease);
+			rdb_raft_process_failure(db, rpc, -DER_PROTO);
 			return;
 		}
 		*lease -= adjustment;
@@ -3424,10 +3879,12 @@ rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 		break;
 	case RDB_APPENDENTRIES:
 		out_ae = out;
+		rdb_raft_ae_done(db, node, false /* failed */, !out_ae->aeo_msg.success);
 		rc = raft_recv_appendentries_response(db->d_raft, node, &out_ae->aeo_msg);
 		break;
 	case RDB_INSTALLSNAPSHOT:
 		out_is = out;
+		rdb_raft_is_done(db, node, crt_req_get(rpc), !out_is->iso_success);
 		rc = raft_recv_installsnapshot_response(db->d_raft, node, &out_is->iso_msg);
 		break;
 	default:
@@ -3442,6 +3899,32 @@ out_mutex:
 	ABT_mutex_unlock(db->d_raft_mutex);
 }
 
+/* Process the failure of a request, which will not get a reply. */
+void
+rdb_raft_process_failure(struct rdb *db, crt_rpc_t *rpc, int error)
+{
+	crt_opcode_t	opc = opc_get(rpc->cr_opc);
+	raft_node_t    *node;
+	d_rank_t	rank;
+	int		rc;
+
+	if (opc != RDB_APPENDENTRIES && opc != RDB_INSTALLSNAPSHOT)
+		return;
+
+	rc = crt_req_dst_rank_get(rpc, &rank);
+	D_ASSERTF(rc == 0, ""DF_RC"\n", DP_RC(rc));
+
+	ABT_mutex_lock(db->d_raft_mutex);
+	node = raft_get_node(db->d_raft, rank);
+	if (node != NULL && opc == RDB_APPENDENTRIES)
+		rdb_raft_ae_done(db, node, true /* failed */, false /* rejected */);
+	else if (node != NULL)
+		rdb_raft_is_done(db, node, crt_req_get(rpc), true /* failed */);
+	ABT_mutex_unlock(db->d_raft_mutex);
+	D_DEBUG(DB_MD, DF_DB": %s to rank %u failed: "DF_RC"\n", DP_DB(db),
+		opc == RDB_APPENDENTRIES ? "AE" : "IS", rank, DP_RC(error));
+}
+
 /* The buffer belonging to bulk must a single d_iov_t. */
 static void
 rdb_raft_free_bulk_and_buffer(crt_bulk_t bulk)
@@ -3487,6 +3970,7 @@ rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc)
 		in_is = crt_req_get(rpc);
 		rdb_raft_free_bulk_and_buffer(in_is->isi_data);
 		rdb_raft_free_bulk_and_buffer(in_is->isi_kds);
+		d_tm_dec_gauge(rdb_raft_metrics.is_inflight, 1);
 		break;
 	default:
 		D_ASSERTF(0, DF_DB": unexpected opc: %u\n", DP_DB(db), opc);
@@ -3496,7 +3980,51 @@ rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc)
 void
 rdb_raft_module_init(void)
 {
+	int rc;
+
 	raft_set_log_level(RAFT_LOG_DEBUG);
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_chunks_sent, D_TM_COUNTER,
+			     "Total number of snapshot chunks sent to followers", "chunks",
+			     "rdb/is/chunks_sent");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS chunks sent counter");
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_bytes_sent, D_TM_COUNTER,
+			     "Total size of snapshot chunks sent to followers", "bytes",
+			     "rdb/is/bytes_sent");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS bytes sent counter");
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_inflight, D_TM_GAUGE,
+			     "Snapshot chunks in flight to followers", "chunks",
+			     "rdb/is/inflight");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS inflight gauge");
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_chunks_recvd, D_TM_COUNTER,
+			     "Total number of snapshot chunks received from leaders", "chunks",
+			     "rdb/is/chunks_recvd");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS chunks received counter");
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_bytes_recvd, D_TM_COUNTER,
+			     "Total size of snapshot chunks received from leaders", "bytes",
+			     "rdb/is/bytes_recvd");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS bytes received counter");
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_chunks_stored, D_TM_COUNTER,
+			     "Total number of snapshot chunks stored", "chunks",
+			     "rdb/is/chunks_stored");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS chunks stored counter");
+
+	rc = d_tm_add_metric(&rdb_raft_metrics.is_installed, D_TM_COUNTER,
+			     "Total number of snapshots installed", "snapshots",
+			     "rdb/is/installed");
+	if (rc != 0)
+		DL_WARN(rc, "Failed to create IS installed counter");
 }
 
 void
@@ -193,6 +193,7 @@ CRT_RPC_DEFINE(rdb_appendentries, DAOS_ISEQ_RDB_APPENDENTRIES,
 		DAOS_OSEQ_RDB_APPENDENTRIES)
 CRT_RPC_DEFINE(rdb_installsnapshot, DAOS_ISEQ_RDB_INSTALLSNAPSHOT,
 		DAOS_OSEQ_RDB_INSTALLSNAPSHOT)
+CRT_RPC_DEFINE(rdb_readindex, DAOS_ISEQ_RDB_READINDEX, DAOS_OSEQ_RDB_READINDEX)
 
 /* Define for cont_rpcs[] array population below.
  * See RDB_PROTO_*_RPC_LIST macro definition
@@ -236,6 +237,7 @@ struct rdb_raft_rpc {
 	crt_rpc_t      *drc_rpc;
 	struct rdb     *drc_db;
 	double		drc_sent;
+	int		drc_rc;		/* RPC error, if any */
 };
 
 static struct rdb_raft_rpc *
@@ -299,7 +301,9 @@ rdb_recvd(void *arg)
 		 * the processing but still free the RPCs until the queue
 		 * become empty.
 		 */
-		if (!stop)
+		if (!stop && rrpc->drc_rc != 0)
+			rdb_raft_process_failure(db, rrpc->drc_rpc, rrpc->drc_rc);
+		else if (!stop)
 			rdb_raft_process_reply(db, rrpc->drc_rpc);
 		rdb_raft_free_request(db, rrpc->drc_rpc);
 		rdb_free_raft_rpc(rrpc);
@@ -324,11 +328,17 @@ rdb_raft_rpc_cb(const struct crt_cb_info *cb_info)
 	D_DEBUG(DB_MD, DF_DB": opc=%u rank=%u rtt=%f\n", DP_DB(db), opc,
 		dstrank, ABT_get_wtime() - rrpc->drc_sent);
 	ABT_mutex_lock(db->d_mutex);
-	if (rc != 0 || db->d_stop) {
-		if (rc != -DER_CANCELED)
-			D_ERROR(DF_DB": RPC %x to rank %u failed: "DF_RC"\n",
-				DP_DB(rrpc->drc_db), opc,
-				dstrank, DP_RC(rc));
+	if (rc != 0 && rc != -DER_CANCELED)
+		D_ERROR(DF_DB": RPC %x to rank %u failed: "DF_RC"\n",
+			DP_DB(rrpc->drc_db), opc, dstrank, DP_RC(rc));
+	if (rc != 0 && !db->d_stop &&
+	    (opc == RDB_APPENDENTRIES || opc == RDB_INSTALLSNAPSHOT)) {
+		/*
+		 * Let rdb_recvd() account for this AE or IS in the pipeline to
+		 * the follower (see rdb_raft_process_failure()).
+		 */
+		rrpc->drc_rc = rc;
+	} else if (rc != 0 || db->d_stop) {
 		/*
 		 * Drop this RPC, assuming that raft will make a new one. If we
 		 * are stopping, rdb_recvd() might have already stopped. Hence,
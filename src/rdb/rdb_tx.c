@@ -24,6 +24,7 @@
 
 /* Flags for rdb_tx.dt_flags */
 #define RDB_TX_LOCAL	(1U << 0)	/* local and query-only */
+#define RDB_TX_FOLLOWER	(1U << 1)	/* on any replica and query-only */
 
 /* Check leadership locally. Caller must hold d_raft_mutex lock. */
 static inline int
@@ -106,6 +107,41 @@ rdb_tx_begin_local(struct rdb_storage *storage, struct rdb_tx *tx)
 	return 0;
 }
 
+/**
+ * Initialize and begin a query-only \a tx on any replica, including followers,
+ * if enabled with RDB_FOLLOWER_READS. The resulting \a tx sees all updates
+ * committed before this call, as this replica first catches up with the
+ * commit index of the leader. May Argobots-block. Updates in \a tx fail with
+ * -DER_NOTLEADER.
+ *
+ * \param[in]	db	database
+ * \param[out]	tx	transaction
+ *
+ * \retval -DER_NOTLEADER	follower reads disabled or leader unavailable
+ */
+int
+rdb_tx_begin_follower(struct rdb *db, struct rdb_tx *tx)
+{
+	struct rdb_tx	t = {};
+	int		rc;
+
+	if (!db->d_follower_reads)
+		return -DER_NOTLEADER;
+
+	ABT_mutex_lock(db->d_raft_mutex);
+	rc = rdb_raft_read_index(db);
+	ABT_mutex_unlock(db->d_raft_mutex);
+	if (rc != 0)
+		return rc;
+	rdb_get(db);
+	t.dt_db = db;
+	/* Fails the leader checks of updates. */
+	t.dt_term = RDB_NIL_TERM;
+	t.dt_flags = RDB_TX_FOLLOWER;
+	*tx = t;
+	return 0;
+}
+
 /**
  * End and finalize \a tx. If \a tx is not committed, then all updates in \a tx
  * are discarded.
@@ -1106,6 +1142,8 @@ rdb_tx_query_pre(struct rdb_tx *tx, const rdb_path_t *path,
 	ABT_mutex_lock(tx->dt_db->d_raft_mutex);
 	if (tx->dt_flags & RDB_TX_LOCAL) {
 		i = tx->dt_db->d_lc_record.dlr_tail - 1;
+	} else if (tx->dt_flags & RDB_TX_FOLLOWER) {
+		i = tx->dt_db->d_applied;
 	} else {
 		i = tx->dt_db->d_applied;
 		rc = rdb_tx_leader_check(tx);
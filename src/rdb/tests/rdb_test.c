@@ -880,6 +880,109 @@ rdbt_dictate_handler(crt_rpc_t *rpc)
 	crt_reply_send(rpc);
 }
 
+struct rdbt_bench_arg {
+	struct rdbt_svc	       *ba_svc;
+	uint64_t		ba_key;		/* first key of this ULT */
+	uint32_t		ba_ntxs;
+	int			ba_rc;
+};
+
+/* Commit ba_ntxs TXs, each updating one key in "kvs1". */
+static void
+rdbt_bench_ult(void *varg)
+{
+	struct rdbt_bench_arg  *arg = varg;
+	struct rdb_tx		tx;
+	d_iov_t			key;
+	d_iov_t			value;
+	uint64_t		k;
+	uint32_t		i;
+	int			rc = 0;
+
+	for (i = 0; i < arg->ba_ntxs; i++) {
+		k = arg->ba_key + i;
+		rc = rdb_tx_begin(arg->ba_svc->rt_rsvc.s_db, RDB_NIL_TERM, &tx);
+		if (rc != 0)
+			break;
+		d_iov_set(&key, &k, sizeof(k));
+		d_iov_set(&value, &i, sizeof(i));
+		rc = rdb_tx_update(&tx, &arg->ba_svc->rt_kvs1_path, &key, &value);
+		if (rc == 0)
+			rc = rdb_tx_commit(&tx);
+		rdb_tx_end(&tx);
+		if (rc != 0)
+			break;
+	}
+	arg->ba_rc = rc;
+}
+
+/*
+ * Measure the commit throughput of the leader with nults ULTs committing
+ * concurrently, which lets the leader replicate several entries per AE.
+ */
+static int
+rdbt_bench(uint32_t nults, uint32_t ntxs, uint64_t *ns, struct rsvc_hint *hintp)
+{
+	struct ds_rsvc	       *rsvc;
+	struct rdbt_bench_arg  *args;
+	ABT_thread	       *ults;
+	uint64_t		start;
+	uint32_t		i;
+	int			rc;
+
+	D_WARN("lookup leader\n");
+	rc = ds_rsvc_lookup_leader(DS_RSVC_CLASS_TEST, &test_svc_id, &rsvc, hintp);
+	if (rc != 0) {
+		D_WARN("not leader or not a replica, rc=%d\n", rc);
+		return rc;
+	}
+
+	D_ALLOC_ARRAY(args, nults);
+	D_ALLOC_ARRAY(ults, nults);
+	if (args == NULL || ults == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	D_WARN("committing %u TXs with %u ULTs\n", ntxs, nults);
+	start = daos_get_ntime();
+	for (i = 0; i < nults; i++) {
+		args[i].ba_svc = rdbt_svc_obj(rsvc);
+		args[i].ba_key = (uint64_t)(i + 1) << 32; /* clear of the test keys */
+		args[i].ba_ntxs = ntxs / nults + (i < ntxs % nults ? 1 : 0);
+		MUST(dss_ult_create(rdbt_bench_ult, &args[i], DSS_XS_SELF, 0, 0, &ults[i]));
+	}
+	for (i = 0; i < nults; i++) {
+		ABT_thread_free(&ults[i]);
+		if (rc == 0)
+			rc = args[i].ba_rc;
+	}
+	*ns = daos_get_ntime() - start;
+	D_WARN("committed %u TXs in "DF_U64" ns: rc=%d\n", ntxs, *ns, rc);
+
+out:
+	D_FREE(ults);
+	D_FREE(args);
+	ds_rsvc_put_leader(rsvc);
+	return rc;
+}
+
+static void
+rdbt_bench_handler(crt_rpc_t *rpc)
+{
+	struct rdbt_bench_in	*in = crt_req_get(rpc);
+	struct rdbt_bench_out	*out = crt_reply_get(rpc);
+	d_rank_t		 rank;
+	int			 rc;
+
+	MUST(crt_group_rank(NULL /* grp */, &rank));
+	if (in->tbi_nults == 0 || in->tbi_ntxs == 0)
+		rc = -DER_INVAL;
+	else
+		rc = rdbt_bench(in->tbi_nults, in->tbi_ntxs, &out->tbo_ns, &out->tbo_hint);
+	D_WARN("rpc reply from rank %u: rc=%d\n", rank, rc);
+	out->tbo_rc = rc;
+	crt_reply_send(rpc);
+}
+
 /* Define for cont_rpcs[] array population below.
  * See RDBT_PROTO_*_RPC_LIST macro definition
  */
@@ -36,6 +36,7 @@ commands:\n\
   test		invoke tests on a specified replica rank\n\
   test-multi	invoke tests (on discovered leader)\n\
   destroy	destroy KV stores (on discovered leader)\n\
+  bench		measure TX commit throughput (on discovered leader)\n\
   fini		finalize a replica\n\
   help		print this message and exit\n");
 	printf("\
@@ -55,6 +56,13 @@ test options:\n\
   --rank=RANK	rank to invoke tests on (0)\n\
   --update	update (otherwise verify)\n");
 	printf("\
+bench options:\n\
+  --group=GROUP	server group \n\
+  --replicas=N	number of replicas (1)\n\
+  --nranks=R	number of server ranks (1)\n\
+  --ults=U	number of concurrent ULTs committing TXs (16)\n\
+  --txs=T	total number of TXs to commit (10000)\n");
+	printf("\
 fini options:\n\
   --group=GROUP	server group \n\
   --rank=RANK	rank to finalize (0)\n");
@@ -1441,6 +1449,96 @@ destroy_hdlr(int argc, char *argv[])
 	return rdbt_destroy_multi(sys->sy_group, g_nranks, g_nreps);
 }
 
+/**** bench command functions ****/
+
+static int
+rdbt_bench_multi(crt_group_t *grp, uint32_t nranks, uint32_t nreplicas, uint32_t nults,
+		 uint32_t ntxs)
+{
+	crt_rpc_t	       *rpc;
+	struct rdbt_bench_in   *in;
+	struct rdbt_bench_out  *out;
+	d_rank_t		ldr_rank;
+	uint64_t		term;
+	int			rc;
+
+	rc = rdbt_find_leader(grp, nranks, nreplicas, &ldr_rank, &term);
+	if (rc) {
+		fprintf(stderr, "ERR: RDB find leader failed\n");
+		return rc;
+	}
+	printf("Discovered leader %u, term="DF_U64"\n", ldr_rank, term);
+
+	printf("===== Commit %u TXs with %u ULTs on leader %u\n", ntxs, nults, ldr_rank);
+	rpc = create_rpc(RDBT_BENCH, grp, ldr_rank);
+	in = crt_req_get(rpc);
+	in->tbi_nults = nults;
+	in->tbi_ntxs = ntxs;
+	rc = invoke_rpc(rpc);
+	D_ASSERTF(rc == 0, "%d\n", rc);
+	out = crt_reply_get(rpc);
+	rc = out->tbo_rc;
+	if (rc) {
+		fprintf(stderr, "ERR: bench failed RPC to rank %u: "DF_RC", hint:(r=%u, t="DF_U64")\n",
+			ldr_rank, DP_RC(rc), out->tbo_hint.sh_rank, out->tbo_hint.sh_term);
+	} else {
+		printf("Committed %u TXs in %.3f s: %.0f TX/s, %.1f us/TX\n", ntxs,
+		       out->tbo_ns / 1e9, ntxs * 1e9 / (out->tbo_ns ?: 1),
+		       out->tbo_ns / 1e3 / ntxs);
+	}
+	destroy_rpc(rpc);
+	return rc;
+}
+
+static int
+bench_hdlr(int argc, char *argv[])
+{
+	struct option		options[] = {
+		{"group",	required_argument,	NULL,	'g'},
+		{"nranks",	required_argument,	NULL,	'n'},
+		{"replicas",	required_argument,	NULL,	'R'},
+		{"ults",	required_argument,	NULL,	'u'},
+		{"txs",		required_argument,	NULL,	't'},
+		{NULL,		0,			NULL,	0}
+	};
+	uint32_t		nults = 16;
+	uint32_t		ntxs = 10000;
+	int			rc;
+
+	while ((rc = getopt_long(argc, argv, "", options, NULL)) != -1) {
+		switch (rc) {
+		case 'g':
+			group_id = optarg;
+			break;
+		case 'n':
+			g_nranks = atoi(optarg);
+			break;
+		case 'R':
+			g_nreps = atoi(optarg);
+			break;
+		case 'u':
+			nults = atoi(optarg);
+			break;
+		case 't':
+			ntxs = atoi(optarg);
+			break;
+		default:
+			return 2;
+		}
+	}
+
+	if (nults == 0 || ntxs == 0) {
+		fprintf(stderr, "ERR: --ults and --txs must be positive\n");
+		return 2;
+	}
+
+	rc = dc_mgmt_sys_attach(group_id, &sys);
+	if (rc != 0)
+		return rc;
+
+	return rdbt_bench_multi(sys->sy_group, g_nranks, g_nreps, nults, ntxs);
+}
+
 /**** fini command functions ****/
 
 static int
@@ -1510,6 +1608,8 @@ main(int argc, char *argv[])
 		hdlr = destroy_hdlr;
 	else if (strcmp(argv[1], "fini") == 0)
 		hdlr = fini_hdlr;
+	else if (strcmp(argv[1], "bench") == 0)
+		hdlr = bench_hdlr;
 
 	if (hdlr == NULL || hdlr == help_hdlr) {
 		help_hdlr(argc, argv);
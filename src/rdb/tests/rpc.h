@@ -15,7 +15,7 @@
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See src/include/daos/rpc.h.
  */
-#define DAOS_RDBT_VERSION 3
+#define DAOS_RDBT_VERSION 4
 /* LIST of internal RPCS in form of:
  * OPCODE, flags, FMT, handler, corpc_hdlr,
  */
@@ -49,7 +49,10 @@
 		rdbt_start_election_handler, NULL),			\
 	X(RDBT_DICTATE,							\
 		0, &CQF_rdbt_dictate,					\
-		rdbt_dictate_handler, NULL)
+		rdbt_dictate_handler, NULL),				\
+	X(RDBT_BENCH,							\
+		0, &CQF_rdbt_bench,					\
+		rdbt_bench_handler, NULL)
 
 /* Define for RPC enum population below */
 #define X(a, b, c, d, e) a
@@ -180,4 +183,15 @@ CRT_RPC_DECLARE(rdbt_start_election, DAOS_ISEQ_RDBT_START_ELECTION,
 CRT_RPC_DECLARE(rdbt_dictate, DAOS_ISEQ_RDBT_DICTATE,
 		DAOS_OSEQ_RDBT_DICTATE)
 
+#define DAOS_ISEQ_RDBT_BENCH /* input fields */		\
+	((uint32_t)		(tbi_nults)		CRT_VAR)\
+	((uint32_t)		(tbi_ntxs)		CRT_VAR)
+
+#define DAOS_OSEQ_RDBT_BENCH /* output fields */		\
+	((struct rsvc_hint)	(tbo_hint)		CRT_VAR)\
+	((uint64_t)		(tbo_ns)		CRT_VAR)\
+	((int32_t)		(tbo_rc)		CRT_VAR)
+
+CRT_RPC_DECLARE(rdbt_bench, DAOS_ISEQ_RDBT_BENCH, DAOS_OSEQ_RDBT_BENCH)
+
 #endif /* RDB_TESTS_RPC_H */
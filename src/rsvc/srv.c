@@ -326,6 +326,8 @@ ds_rsvc_set_hint(struct ds_rsvc *svc, struct rsvc_hint *hint)
 	if (rc != 0)
 		return;
 	hint->sh_flags |= RSVC_HINT_VALID;
+	if (rdb_follower_reads_enabled(svc->s_db))
+		hint->sh_flags |= RSVC_HINT_READS;
 }
 
 static void
@@ -29,12 +29,19 @@ init(void)
 	if (rc < 0) {
 		return rc;
 	}
-	return 0;
+
+	rc = ds_sec_acl_cache_init();
+	if (rc != 0) {
+		free(ds_sec_server_socket_path);
+		ds_sec_server_socket_path = NULL;
+	}
+	return rc;
 }
 
 static int
 fini(void)
 {
+	ds_sec_acl_cache_fini();
 	free(ds_sec_server_socket_path);
 	ds_sec_server_socket_path = NULL;
 	return 0;
@@ -11,6 +11,7 @@
 #include <daos/drpc.h>
 #include <daos/drpc_modules.h>
 #include <daos/container.h>
+#include <daos/lru.h>
 
 #include <daos_srv/pool.h>
 #include <daos_srv/security.h>
@@ -106,6 +107,226 @@ ds_sec_alloc_default_daos_pool_acl(void)
 	return acl;
 }
 
+/*
+ * Cache of the capabilities evaluated for a credential against an ACL. It spares
+ * the ACL validation, the unpacking of the credential and the walk of the ACEs to
+ * the storms of pool connects and container opens. The key is made of everything
+ * the evaluation depends on, the ACL and the ownership included, hence a change of
+ * the ACL or owner property just misses the former entries, which age out of the
+ * LRU. Nothing is cached until ds_sec_acl_cache_init() is called.
+ */
+#define SEC_ACL_CACHE_BITS	10
+/* Huge ACLs are not cached, to bound the footprint of the cache. */
+#define SEC_ACL_CACHE_KEY_MAX	16384
+
+enum sec_acl_cache_type {
+	/* The validated AUTH_SYS token of a pool connect */
+	SEC_ACL_CACHE_POOL,
+	/* The packed credential of a container open */
+	SEC_ACL_CACHE_CONT,
+};
+
+struct sec_acl_cache_hdr {
+	uint32_t	sch_type;
+	uint32_t	sch_cred_len;
+	uint32_t	sch_user_len;
+	uint32_t	sch_group_len;
+	uint32_t	sch_acl_len;
+	uint32_t	sch_padding;
+	uint64_t	sch_owner_min_perms;
+};
+
+struct sec_acl_cache_ent {
+	struct daos_llink	sce_llink;
+	uint64_t		sce_capas;
+	uint32_t		sce_hash;
+	uint32_t		sce_key_len;
+	uint8_t			sce_key[];
+};
+
+static struct daos_lru_cache	*sec_acl_cache;
+static pthread_mutex_t		 sec_acl_cache_lock;
+
+static inline struct sec_acl_cache_ent *
+sec_acl_cache_obj(struct daos_llink *llink)
+{
+	return container_of(llink, struct sec_acl_cache_ent, sce_llink);
+}
+
+static int
+sec_acl_cache_alloc_ref(void *key, unsigned int ksize, void *args, struct daos_llink **link)
+{
+	struct sec_acl_cache_ent	*ent;
+
+	D_ALLOC(ent, sizeof(*ent) + ksize);
+	if (ent == NULL)
+		return -DER_NOMEM;
+
+	memcpy(ent->sce_key, key, ksize);
+	ent->sce_key_len = ksize;
+	ent->sce_hash = d_hash_string_u32(key, ksize);
+	ent->sce_capas = *(uint64_t *)args;
+
+	*link = &ent->sce_llink;
+	return 0;
+}
+
+static void
+sec_acl_cache_free_ref(struct daos_llink *llink)
+{
+	struct sec_acl_cache_ent *ent = sec_acl_cache_obj(llink);
+
+	D_FREE(ent);
+}
+
+static bool
+sec_acl_cache_cmp_keys(const void *key, unsigned int ksize, struct daos_llink *llink)
+{
+	struct sec_acl_cache_ent *ent = sec_acl_cache_obj(llink);
+
+	return ksize == ent->sce_key_len && memcmp(key, ent->sce_key, ksize) == 0;
+}
+
+static uint32_t
+sec_acl_cache_rec_hash(struct daos_llink *llink)
+{
+	return sec_acl_cache_obj(llink)->sce_hash;
+}
+
+static struct daos_llink_ops sec_acl_cache_ops = {
+	.lop_alloc_ref	= sec_acl_cache_alloc_ref,
+	.lop_free_ref	= sec_acl_cache_free_ref,
+	.lop_cmp_keys	= sec_acl_cache_cmp_keys,
+	.lop_rec_hash	= sec_acl_cache_rec_hash,
+};
+
+int
+ds_sec_acl_cache_init(void)
+{
+	int rc;
+
+	rc = D_MUTEX_INIT(&sec_acl_cache_lock, NULL);
+	if (rc != 0)
+		return rc;
+
+	rc = daos_lru_cache_create(SEC_ACL_CACHE_BITS, D_HASH_FT_NOLOCK, &sec_acl_cache_ops,
+				   &sec_acl_cache);
+	if (rc != 0) {
+		DL_ERROR(rc, "Failed to create ACL cache");
+		D_MUTEX_DESTROY(&sec_acl_cache_lock);
+	}
+
+	return rc;
+}
+
+void
+ds_sec_acl_cache_fini(void)
+{
+	if (sec_acl_cache == NULL)
+		return;
+
+	daos_lru_cache_destroy(sec_acl_cache);
+	sec_acl_cache = NULL;
+	D_MUTEX_DESTROY(&sec_acl_cache_lock);
+}
+
+/*
+ * Build the cache key of the evaluation in \a key, left empty if there is no cache
+ * or the key is too large. The ACL is not validated yet, its size is only trusted
+ * up to SEC_ACL_CACHE_KEY_MAX.
+ */
+static int
+sec_acl_cache_key(enum sec_acl_cache_type type, void *cred_buf, size_t cred_len,
+		  struct d_ownership *ownership, struct daos_acl *acl, uint64_t owner_min_perms,
+		  d_iov_t *key)
+{
+	struct sec_acl_cache_hdr	*hdr;
+	uint8_t				*buf;
+	size_t				 user_len;
+	size_t				 group_len;
+	size_t				 acl_len;
+	size_t				 len;
+
+	d_iov_set(key, NULL, 0);
+	if (sec_acl_cache == NULL)
+		return 0;
+
+	user_len = strnlen(ownership->user, DAOS_ACL_MAX_PRINCIPAL_BUF_LEN);
+	group_len = strnlen(ownership->group, DAOS_ACL_MAX_PRINCIPAL_BUF_LEN);
+	acl_len = daos_acl_get_size(acl);
+	if (acl_len > SEC_ACL_CACHE_KEY_MAX || cred_len > SEC_ACL_CACHE_KEY_MAX)
+		return 0;
+
+	len = sizeof(*hdr) + cred_len + user_len + group_len + acl_len;
+	if (len > SEC_ACL_CACHE_KEY_MAX)
+		return 0;
+
+	D_ALLOC(buf, len);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	hdr = (struct sec_acl_cache_hdr *)buf;
+	hdr->sch_type = type;
+	hdr->sch_cred_len = cred_len;
+	hdr->sch_user_len = user_len;
+	hdr->sch_group_len = group_len;
+	hdr->sch_acl_len = acl_len;
+	hdr->sch_owner_min_perms = owner_min_perms;
+
+	len = sizeof(*hdr);
+	memcpy(buf + len, cred_buf, cred_len);
+	len += cred_len;
+	memcpy(buf + len, ownership->user, user_len);
+	len += user_len;
+	memcpy(buf + len, ownership->group, group_len);
+	len += group_len;
+	memcpy(buf + len, acl, acl_len);
+	len += acl_len;
+
+	d_iov_set(key, buf, len);
+	return 0;
+}
+
+static bool
+sec_acl_cache_find(d_iov_t *key, uint64_t *capas)
+{
+	struct daos_llink	*llink;
+	int			 rc;
+
+	if (key->iov_buf == NULL)
+		return false;
+
+	D_MUTEX_LOCK(&sec_acl_cache_lock);
+	rc = daos_lru_ref_hold(sec_acl_cache, key->iov_buf, key->iov_len, NULL, &llink);
+	if (rc == 0) {
+		*capas = sec_acl_cache_obj(llink)->sce_capas;
+		daos_lru_ref_release(sec_acl_cache, llink);
+	}
+	D_MUTEX_UNLOCK(&sec_acl_cache_lock);
+
+	return rc == 0;
+}
+
+static void
+sec_acl_cache_add(d_iov_t *key, uint64_t capas)
+{
+	struct daos_llink	*llink;
+	int			 rc;
+
+	if (key->iov_buf == NULL)
+		return;
+
+	D_MUTEX_LOCK(&sec_acl_cache_lock);
+	rc = daos_lru_ref_hold(sec_acl_cache, key->iov_buf, key->iov_len, &capas, &llink);
+	if (rc == 0)
+		daos_lru_ref_release(sec_acl_cache, llink);
+	D_MUTEX_UNLOCK(&sec_acl_cache_lock);
+
+	/* Not fatal, the next evaluation just misses the cache. */
+	if (rc != 0)
+		DL_WARN(rc, "Failed to cache ACL capabilities");
+}
+
 static Auth__Token *
 auth_token_dup(Auth__Token *orig)
 {
@@ -463,6 +684,7 @@ ds_sec_pool_get_capabilities(uint64_t flags, d_iov_t *cred,
 			     struct daos_acl *acl, uint64_t *capas)
 {
 	struct drpc_alloc	alloc = PROTO_ALLOCATOR_INIT(alloc);
+	d_iov_t			key;
 	int			rc;
 	Auth__Token		*token;
 
@@ -485,23 +707,39 @@ ds_sec_pool_get_capabilities(uint64_t flags, d_iov_t *cred,
 		return rc;
 	}
 
-	rc = daos_acl_validate(acl);
-	if (rc != -DER_SUCCESS) {
-		DL_ERROR(rc, "Invalid ACL");
-		return rc;
-	}
-
 	rc = ds_sec_validate_credentials(cred, &token);
 	if (rc != 0) {
 		DL_ERROR(rc, "Failed to validate credentials");
 		return rc;
 	}
 
-	rc = get_sec_capas_for_token(token, ownership, acl, 0 /* no special owner perms */,
-				     pool_capas_from_perms, capas);
-	if (rc == 0)
-		filter_pool_capas_based_on_flags(flags, capas);
+	/* Only the AUTH_SYS payload is evaluated, the other flavors fail below. */
+	if (token->flavor == AUTH__FLAVOR__AUTH_SYS)
+		rc = sec_acl_cache_key(SEC_ACL_CACHE_POOL, token->data.data, token->data.len,
+				       ownership, acl, 0, &key);
+	else
+		d_iov_set(&key, NULL, 0);
+	if (rc != 0)
+		goto out;
+
+	if (!sec_acl_cache_find(&key, capas)) {
+		rc = daos_acl_validate(acl);
+		if (rc != -DER_SUCCESS) {
+			DL_ERROR(rc, "Invalid ACL");
+			goto out;
+		}
+
+		rc = get_sec_capas_for_token(token, ownership, acl, 0 /* no special owner perms */,
+					     pool_capas_from_perms, capas);
+		if (rc != 0)
+			goto out;
+
+		sec_acl_cache_add(&key, *capas);
+	}
 
+	filter_pool_capas_based_on_flags(flags, capas);
+out:
+	D_FREE(key.iov_buf);
 	auth__token__free_unpacked(token, &alloc.alloc);
 	return rc;
 }
@@ -589,6 +827,7 @@ ds_sec_cont_get_capabilities(uint64_t flags, d_iov_t *cred, struct d_ownership *
 {
 	struct drpc_alloc alloc = PROTO_ALLOCATOR_INIT(alloc);
 	Auth__Token      *token;
+	d_iov_t           key;
 	int               rc;
 	uint64_t          owner_min_perms = CONT_OWNER_MIN_PERMS;
 
@@ -607,31 +846,44 @@ ds_sec_cont_get_capabilities(uint64_t flags, d_iov_t *cred, struct d_ownership *
 		return -DER_INVAL;
 	}
 
-	rc = daos_acl_validate(acl);
-	if (rc != -DER_SUCCESS) {
-		DL_ERROR(rc, "Invalid ACL");
-		return rc;
-	}
-
 	if (cred->iov_buf == NULL) {
 		D_ERROR("Credential data is NULL\n");
 		return -DER_INVAL;
 	}
 
+	rc = sec_acl_cache_key(SEC_ACL_CACHE_CONT, cred->iov_buf, cred->iov_buf_len, ownership,
+			       acl, owner_min_perms, &key);
+	if (rc != 0)
+		return rc;
+
+	if (sec_acl_cache_find(&key, capas))
+		goto filter;
+
+	rc = daos_acl_validate(acl);
+	if (rc != -DER_SUCCESS) {
+		DL_ERROR(rc, "Invalid ACL");
+		goto out;
+	}
+
 	rc = unpack_token_from_cred(cred, &token);
 	if (rc != -DER_SUCCESS)
-		return rc;
+		goto out;
 
 	/* The credential has already been validated at pool connect. */
 	if (token == NULL)
-		return -DER_INVAL;
+		D_GOTO(out, rc = -DER_INVAL);
 
 	rc = get_sec_capas_for_token(token, ownership, acl, owner_min_perms, cont_capas_from_perms,
 				     capas);
-	if (rc == 0)
-		filter_cont_capas_based_on_flags(flags, capas);
-
 	auth__token__free_unpacked(token, &alloc.alloc);
+	if (rc != 0)
+		goto out;
+
+	sec_acl_cache_add(&key, *capas);
+filter:
+	filter_cont_capas_based_on_flags(flags, capas);
+out:
+	D_FREE(key.iov_buf);
 	return rc;
 }
 
@@ -62,4 +62,8 @@ extern char *ds_sec_server_socket_path;
 
 int ds_sec_validate_credentials(d_iov_t *creds, Auth__Token **token);
 
+/* Cache of the capabilities evaluated from the pool and container ACLs */
+int ds_sec_acl_cache_init(void);
+void ds_sec_acl_cache_fini(void);
+
 #endif /* __SECURITY_SRV_INTERNAL_H__ */
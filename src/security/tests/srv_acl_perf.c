@@ -0,0 +1,268 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Microbenchmark of the container ACL evaluation, as done for each container
+ * open. A number of users, each of them in a few groups, open containers with
+ * ACLs of several sizes made of user and group entries. The evaluation is
+ * measured with and without the capability cache, shared by all the threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <daos/common.h>
+#include <daos_srv/security.h>
+
+#include "../srv_internal.h"
+#include "perf_common.h"
+
+/* Not used by the container ACL evaluation */
+char *ds_sec_server_socket_path = "/fake/socket/path";
+
+#define PERF_GROUPS	8
+
+struct perf_args {
+	struct daos_acl		*pa_acl;
+	d_iov_t			*pa_creds;
+	uint64_t		 pa_opens;
+	ATOMIC uint64_t		 pa_granted;
+};
+
+static uint32_t perf_aces;
+static uint32_t perf_users = 64;
+
+static int
+perf_cred_init(d_iov_t *cred, uint32_t uid, uint32_t nr_users)
+{
+	Auth__Credential	 new_cred = AUTH__CREDENTIAL__INIT;
+	Auth__Token		 token = AUTH__TOKEN__INIT;
+	Auth__Sys		 authsys = AUTH__SYS__INIT;
+	char			 user[DAOS_ACL_MAX_PRINCIPAL_BUF_LEN];
+	char			 group[DAOS_ACL_MAX_PRINCIPAL_BUF_LEN];
+	char			 groups[PERF_GROUPS][DAOS_ACL_MAX_PRINCIPAL_BUF_LEN];
+	char			*grp_list[PERF_GROUPS];
+	uint8_t			*buf;
+	size_t			 len;
+	int			 i;
+
+	snprintf(user, sizeof(user), "user%u@", uid);
+	snprintf(group, sizeof(group), "group%u@", uid % 16);
+	for (i = 0; i < PERF_GROUPS; i++) {
+		snprintf(groups[i], sizeof(groups[i]), "group%u@", (uid + i * 7) % nr_users);
+		grp_list[i] = groups[i];
+	}
+
+	authsys.user = user;
+	authsys.group = group;
+	authsys.groups = grp_list;
+	authsys.n_groups = PERF_GROUPS;
+	authsys.machinename = "perfhost";
+
+	len = auth__sys__get_packed_size(&authsys);
+	D_ALLOC(token.data.data, len);
+	if (token.data.data == NULL)
+		return -DER_NOMEM;
+	auth__sys__pack(&authsys, token.data.data);
+	token.data.len = len;
+	token.flavor = AUTH__FLAVOR__AUTH_SYS;
+
+	new_cred.token = &token;
+	len = auth__credential__get_packed_size(&new_cred);
+	D_ALLOC(buf, len);
+	if (buf != NULL)
+		auth__credential__pack(&new_cred, buf);
+	D_FREE(token.data.data);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	d_iov_set(cred, buf, len);
+	return 0;
+}
+
+/*
+ * Owner and owner group, @nr_aces named users and groups with various
+ * permissions, and everyone else.
+ */
+static struct daos_acl *
+perf_acl_create(uint32_t nr_aces)
+{
+	struct daos_ace	**aces;
+	struct daos_acl	 *acl = NULL;
+	char		  name[DAOS_ACL_MAX_PRINCIPAL_BUF_LEN];
+	uint64_t	  perms[] = {DAOS_ACL_PERM_READ,
+				     DAOS_ACL_PERM_READ | DAOS_ACL_PERM_WRITE,
+				     DAOS_ACL_PERM_READ | DAOS_ACL_PERM_GET_PROP |
+				     DAOS_ACL_PERM_GET_ACL,
+				     DAOS_ACL_PERM_CONT_ALL};
+	uint32_t	  nr = nr_aces + 3;
+	uint32_t	  i;
+
+	D_ALLOC_ARRAY(aces, nr);
+	if (aces == NULL)
+		return NULL;
+
+	aces[0] = daos_ace_create(DAOS_ACL_OWNER, NULL);
+	aces[1] = daos_ace_create(DAOS_ACL_OWNER_GROUP, NULL);
+	aces[2] = daos_ace_create(DAOS_ACL_EVERYONE, NULL);
+	for (i = 0; i < nr_aces; i++) {
+		snprintf(name, sizeof(name), i % 4 == 3 ? "group%u@" : "user%u@", i);
+		aces[i + 3] = daos_ace_create(i % 4 == 3 ? DAOS_ACL_GROUP : DAOS_ACL_USER, name);
+	}
+
+	for (i = 0; i < nr; i++) {
+		if (aces[i] == NULL)
+			goto out;
+		aces[i]->dae_access_types = DAOS_ACL_ACCESS_ALLOW;
+		aces[i]->dae_allow_perms = i < 3 ? DAOS_ACL_PERM_READ : perms[i % ARRAY_SIZE(perms)];
+	}
+
+	acl = daos_acl_create(aces, nr);
+out:
+	for (i = 0; i < nr; i++)
+		daos_ace_free(aces[i]);
+	D_FREE(aces);
+	return acl;
+}
+
+static int
+perf_func(void *arg, int idx, int nr)
+{
+	struct d_ownership	 ownership = {.user = "owner@", .group = "ownergroup@"};
+	struct perf_args	*args = arg;
+	uint64_t		 capas;
+	uint64_t		 granted = 0;
+	uint64_t		 i;
+	int			 rc;
+
+	/* each thread starts with a different user */
+	for (i = idx; i < args->pa_opens + idx; i++) {
+		rc = ds_sec_cont_get_capabilities(DAOS_COO_RO, &args->pa_creds[i % perf_users],
+						  &ownership, args->pa_acl, &capas);
+		if (rc != 0)
+			return rc;
+		if (ds_sec_cont_can_open(capas))
+			granted++;
+	}
+	atomic_fetch_add(&args->pa_granted, granted);
+	return 0;
+}
+
+static int
+perf_run_cache(bool cache, int nr_threads, uint32_t nr_aces, uint64_t opens)
+{
+	struct perf_args	 args = {.pa_opens = opens};
+	uint64_t		 ns;
+	uint64_t		 nr_ops = nr_threads * opens;
+	uint32_t		 i;
+	int			 rc = 0;
+
+	D_ALLOC_ARRAY(args.pa_creds, perf_users);
+	if (args.pa_creds == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < perf_users && rc == 0; i++)
+		rc = perf_cred_init(&args.pa_creds[i], i, perf_users);
+	if (rc != 0)
+		goto out;
+
+	args.pa_acl = perf_acl_create(nr_aces);
+	if (args.pa_acl == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	if (cache) {
+		rc = ds_sec_acl_cache_init();
+		if (rc != 0)
+			goto out_acl;
+	}
+
+	rc = perf_threads_run(nr_threads, perf_func, &args, &ns);
+
+	if (cache)
+		ds_sec_acl_cache_fini();
+	if (rc != 0)
+		goto out_acl;
+
+	printf("%-7s threads %3d aces %5u users %5u: %7.1f ns/open, %10.0f opens/s, "
+	       "%u%% granted\n", cache ? "cache" : "nocache", nr_threads, nr_aces, perf_users,
+	       (double)ns * nr_threads / nr_ops, nr_ops * 1e9 / (ns ?: 1),
+	       (uint32_t)(args.pa_granted * 100 / nr_ops));
+
+out_acl:
+	daos_acl_free(args.pa_acl);
+out:
+	for (i = 0; i < perf_users; i++)
+		daos_iov_free(&args.pa_creds[i]);
+	D_FREE(args.pa_creds);
+	if (rc != 0)
+		printf("%-7s threads %3d aces %5u users %5u: FAILED "DF_RC"\n",
+		       cache ? "cache" : "nocache", nr_threads, nr_aces, perf_users, DP_RC(rc));
+	return rc;
+}
+
+static int
+perf_run(int nr_threads, uint64_t opens)
+{
+	uint32_t	nr_aces[] = {4, 16, 64, 256};
+	uint32_t	i;
+	int		rc = 0;
+
+	for (i = 0; i < ARRAY_SIZE(nr_aces) && rc == 0; i++) {
+		rc = perf_run_cache(false, nr_threads, perf_aces ?: nr_aces[i], opens);
+		if (rc == 0)
+			rc = perf_run_cache(true, nr_threads, perf_aces ?: nr_aces[i], opens);
+		if (perf_aces != 0)
+			break;
+	}
+	return rc;
+}
+
+static int
+perf_parse(int opt, const char *arg)
+{
+	switch (opt) {
+	case 'a':
+		perf_aces = strtoul(arg, NULL, 0);
+		return 0;
+	case 'u':
+		perf_users = strtoul(arg, NULL, 0);
+		return perf_users == 0 ? -DER_INVAL : 0;
+	default:
+		return -DER_INVAL;
+	}
+}
+
+static int
+perf_init(void)
+{
+	return daos_debug_init(DAOS_LOG_DEFAULT);
+}
+
+static const struct perf_opt perf_opts[] = {
+	{"aces",	'a',	"ACES",
+	 "Number of named user and group entries.\n"
+	 "\t\t\t\t\tDefault: 4, 16, 64 and 256"},
+	{"users",	'u',	"USERS",	"Number of users opening. Default: 64"},
+	{NULL},
+};
+
+static const int perf_threads[] = {1, 4, 16, 0};
+
+static const struct perf_tool perf_tool = {
+	.pt_opts	= perf_opts,
+	.pt_parse	= perf_parse,
+	.pt_loops_help	= "Opens per thread",
+	.pt_loops	= 100000,
+	.pt_threads	= perf_threads,
+	.pt_init	= perf_init,
+	.pt_fini	= daos_debug_fini,
+	.pt_run		= perf_run,
+};
+
+int
+main(int argc, char **argv)
+{
+	return perf_main(&perf_tool, argc, argv);
+}
@@ -1850,6 +1850,93 @@ test_cont_get_capas_owner_implicit_acl_access(void **state)
 					   CONT_CAPAS_ALL);
 }
 
+static void
+test_cont_get_capas_cached(void **state)
+{
+	struct daos_acl		*acl;
+	d_iov_t			cred;
+	struct d_ownership	ownership;
+	uint64_t		result = -1;
+
+	assert_rc_equal(ds_sec_acl_cache_init(), 0);
+
+	init_valid_cred(&cred, "specificuser@", TEST_GROUP, NULL, 0,
+			TEST_HOST);
+	acl = get_user_acl_with_perms("specificuser@",
+				      DAOS_ACL_PERM_READ | DAOS_ACL_PERM_WRITE);
+	init_default_ownership(&ownership);
+
+	assert_rc_equal(ds_sec_cont_get_capabilities(DAOS_COO_RO, &cred, &ownership, acl,
+						     &result), 0);
+	assert_int_equal(result, CONT_CAPA_READ_DATA);
+
+	/* Cached, still filtered by the flags */
+	assert_rc_equal(ds_sec_cont_get_capabilities(DAOS_COO_RO, &cred, &ownership, acl,
+						     &result), 0);
+	assert_int_equal(result, CONT_CAPA_READ_DATA);
+	assert_rc_equal(ds_sec_cont_get_capabilities(DAOS_COO_RW, &cred, &ownership, acl,
+						     &result), 0);
+	assert_int_equal(result, CONT_CAPA_READ_DATA | CONT_CAPA_WRITE_DATA);
+
+	/* Updated ACL */
+	daos_acl_free(acl);
+	acl = get_user_acl_with_perms("specificuser@", DAOS_ACL_PERM_READ);
+	assert_rc_equal(ds_sec_cont_get_capabilities(DAOS_COO_RW, &cred, &ownership, acl,
+						     &result), 0);
+	assert_int_equal(result, 0);
+
+	/* Updated owner */
+	ownership.user = "specificuser@";
+	assert_rc_equal(ds_sec_cont_get_capabilities(DAOS_COO_RO, &cred, &ownership, acl,
+						     &result), 0);
+	assert_true(result & CONT_CAPA_GET_ACL);
+
+	/* Never cached */
+	assert_rc_equal(ds_sec_cont_get_capabilities(DAOS_COO_RO, &cred, &ownership, NULL,
+						     &result), -DER_INVAL);
+
+	daos_acl_free(acl);
+	daos_iov_free(&cred);
+	ds_sec_acl_cache_fini();
+}
+
+static void
+test_pool_get_capas_cached(void **state)
+{
+	struct daos_acl		*acl;
+	d_iov_t			cred;
+	struct d_ownership	ownership;
+	uint64_t		result = -1;
+
+	assert_rc_equal(ds_sec_acl_cache_init(), 0);
+
+	init_valid_cred(&cred, TEST_USER, "somerandomgroup@", NULL, 0,
+			TEST_HOST);
+	acl = get_acl_with_perms(DAOS_ACL_PERM_READ | DAOS_ACL_PERM_WRITE, 0);
+
+	expect_pool_capas_with_acl(acl, &cred, DAOS_PC_RW, POOL_CAPAS_ALL);
+	/* Cached, still filtered by the flags */
+	expect_pool_capas_with_acl(acl, &cred, DAOS_PC_RW, POOL_CAPAS_ALL);
+	expect_pool_capas_with_acl(acl, &cred, DAOS_PC_RO, POOL_CAPA_READ);
+
+	/* Updated ACL */
+	daos_acl_free(acl);
+	acl = get_acl_with_perms(DAOS_ACL_PERM_READ, 0);
+	expect_pool_capas_with_acl(acl, &cred, DAOS_PC_RW, 0);
+	expect_pool_capas_with_acl(acl, &cred, DAOS_PC_RO, POOL_CAPA_READ);
+
+	/* The credential is still validated */
+	init_default_ownership(&ownership);
+	drpc_call_return = -DER_MISC;
+	drpc_call_resp_return_ptr = NULL;
+	assert_rc_equal(ds_sec_pool_get_capabilities(DAOS_PC_RO, &cred, &ownership, acl,
+						     &result), drpc_call_return);
+
+	daos_acl_free(acl);
+	daos_iov_free(&cred);
+	ds_sec_acl_cache_fini();
+}
+
 /*
  * Pool access tests
  */
@@ -2210,6 +2297,8 @@ main(void)
 		ACL_UTEST(test_cont_get_capas_success),
 		ACL_UTEST(test_cont_get_capas_denied),
 		ACL_UTEST(test_cont_get_capas_owner_implicit_acl_access),
+		ACL_UTEST(test_cont_get_capas_cached),
+		ACL_UTEST(test_pool_get_capas_cached),
 		cmocka_unit_test(test_pool_can_connect),
 		cmocka_unit_test(test_pool_can_create_cont),
 		cmocka_unit_test(test_pool_can_delete_cont),
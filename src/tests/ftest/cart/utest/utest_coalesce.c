@@ -0,0 +1,183 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It checks that requests of an opcode
+ * registered with CRT_RPC_FEAT_COALESCE and sent to the same endpoint before
+ * the next progress call share a single HG request.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define TEST_COAL_BASE	0x01000000
+#define TEST_COAL_VER	0
+#define TEST_COAL_NR	4
+
+#define CRT_ISEQ_COAL_PING	/* input fields */		 \
+	((uint32_t)		(cpi_idx)		CRT_VAR)
+
+#define CRT_OSEQ_COAL_PING	/* output fields */		 \
+	((uint32_t)		(cpo_idx)		CRT_VAR)
+
+CRT_RPC_DECLARE(coal_ping, CRT_ISEQ_COAL_PING, CRT_OSEQ_COAL_PING)
+CRT_RPC_DEFINE(coal_ping, CRT_ISEQ_COAL_PING, CRT_OSEQ_COAL_PING)
+
+/* HG request each request arrived with, the carrier when it was coalesced */
+static hg_handle_t		 test_hdl[TEST_COAL_NR];
+static struct crt_rpc_priv	*test_parent[TEST_COAL_NR];
+static int			 test_done;
+
+static void
+coal_ping_hdlr(crt_rpc_t *rpc)
+{
+	struct crt_rpc_priv	*rpc_priv = container_of(rpc, struct crt_rpc_priv, crp_pub);
+	struct coal_ping_in	*in = crt_req_get(rpc);
+	struct coal_ping_out	*out = crt_reply_get(rpc);
+	int			 rc;
+
+	D_ASSERT(in->cpi_idx < TEST_COAL_NR);
+	test_hdl[in->cpi_idx]    = rpc_priv->crp_hg_hdl;
+	test_parent[in->cpi_idx] = rpc_priv->crp_coal_parent;
+
+	out->cpo_idx = in->cpi_idx;
+	rc = crt_reply_send(rpc);
+	D_ASSERTF(rc == 0, "crt_reply_send() failed, " DF_RC "\n", DP_RC(rc));
+}
+
+static struct crt_proto_rpc_format test_coal_rpcs[] = {
+	{
+		.prf_flags	= CRT_RPC_FEAT_COALESCE,
+		.prf_req_fmt	= &CQF_coal_ping,
+		.prf_hdlr	= coal_ping_hdlr,
+		.prf_co_ops	= NULL,
+	}
+};
+
+static struct crt_proto_format test_coal_proto = {
+	.cpf_name	= "utest-coalesce",
+	.cpf_ver	= TEST_COAL_VER,
+	.cpf_count	= ARRAY_SIZE(test_coal_rpcs),
+	.cpf_prf	= test_coal_rpcs,
+	.cpf_base	= TEST_COAL_BASE,
+};
+
+static void
+coal_ping_cb(const struct crt_cb_info *cb_info)
+{
+	struct coal_ping_in	*in = crt_req_get(cb_info->cci_rpc);
+	struct coal_ping_out	*out = crt_reply_get(cb_info->cci_rpc);
+
+	assert_int_equal(cb_info->cci_rc, 0);
+	assert_int_equal(out->cpo_idx, in->cpi_idx);
+	test_done++;
+}
+
+static void
+coal_ping_send(crt_context_t ctx, uint32_t idx)
+{
+	crt_endpoint_t		 ep = {0};
+	crt_rpc_t		*rpc;
+	struct coal_ping_in	*in;
+	int			 rc;
+
+	ep.ep_rank = 0;
+	ep.ep_tag  = 0;
+	rc = crt_req_create(ctx, &ep, CRT_PROTO_OPC(TEST_COAL_BASE, TEST_COAL_VER, 0), &rpc);
+	assert_int_equal(rc, 0);
+
+	in          = crt_req_get(rpc);
+	in->cpi_idx = idx;
+	rc = crt_req_send(rpc, coal_ping_cb, NULL);
+	assert_int_equal(rc, 0);
+}
+
+static void
+coal_ping_wait(crt_context_t ctx, int nr)
+{
+	int i;
+
+	for (i = 0; i < 1000 && test_done < nr; i++)
+		crt_progress(ctx, 1000);
+	assert_int_equal(test_done, nr);
+}
+
+static void
+test_coalesce(void **state)
+{
+	crt_context_t		 ctx;
+	struct crt_context	*ctx_priv;
+	int			 rc;
+
+	rc = crt_init(NULL, CRT_FLAG_BIT_SERVER | CRT_FLAG_BIT_AUTO_SWIM_DISABLE);
+	assert_int_equal(rc, 0);
+
+	rc = crt_context_create(&ctx);
+	assert_int_equal(rc, 0);
+	ctx_priv = ctx;
+
+	rc = crt_rank_self_set(0, 1 /* group_version_min */);
+	assert_int_equal(rc, 0);
+
+	rc = crt_proto_register(&test_coal_proto);
+	assert_int_equal(rc, 0);
+
+	/* a lone request is sent as is */
+	coal_ping_send(ctx, 0);
+	assert_int_equal(atomic_load_relaxed(&ctx_priv->cc_coal_nr), 1);
+	coal_ping_wait(ctx, 1);
+	assert_null(test_parent[0]);
+
+	/* two requests to the same endpoint go in one batch, so one HG send */
+	coal_ping_send(ctx, 1);
+	coal_ping_send(ctx, 2);
+	assert_int_equal(atomic_load_relaxed(&ctx_priv->cc_coal_nr), 1);
+	coal_ping_wait(ctx, 3);
+	assert_non_null(test_parent[1]);
+	assert_ptr_equal(test_parent[1], test_parent[2]);
+	assert_ptr_equal(test_hdl[1], test_hdl[2]);
+
+	rc = crt_context_destroy(ctx, false);
+	assert_int_equal(rc, 0);
+
+	rc = crt_finalize();
+	assert_int_equal(rc, 0);
+}
+
+static int
+init_tests(void **state)
+{
+	d_setenv("D_PROVIDER", "ofi+tcp", 1);
+	d_setenv("D_INTERFACE", "lo", 1);
+	d_setenv("D_RPC_COALESCE_MAX", "16", 1);
+
+	return 0;
+}
+
+static int
+fini_tests(void **state)
+{
+	return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_coalesce),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_coalesce", tests, init_tests, fini_tests);
+}
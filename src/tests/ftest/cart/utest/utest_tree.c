@@ -0,0 +1,230 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It simulates the collective RPC trees
+ * of a large group spread over fault domains, and compares the fault domain
+ * aware tree to the knomial one.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define TREE_GRP_SIZE	10000
+#define TREE_NDOMS	100
+#define TREE_RATIO	4
+
+struct tree_stats {
+	uint32_t	ts_depth;
+	uint32_t	ts_cross;
+};
+
+/* Children of grp_self, returns their number */
+typedef uint32_t (*tree_children_fn_t)(void *arg, uint32_t grp_self, uint32_t *children);
+typedef int (*tree_parent_fn_t)(void *arg, uint32_t grp_self, uint32_t *parent);
+
+struct tree_knomial {
+	uint32_t	tk_size;
+	uint32_t	tk_ratio;
+	uint32_t	tk_root;
+};
+
+static uint32_t
+knomial_children(void *arg, uint32_t grp_self, uint32_t *children)
+{
+	struct tree_knomial	*tk = arg;
+	uint32_t		 nr;
+	int			 rc;
+
+	rc = crt_knomial_ops.to_get_children_cnt(tk->tk_size, tk->tk_ratio, tk->tk_root, grp_self,
+						 &nr);
+	assert_int_equal(rc, 0);
+	if (nr > 0) {
+		rc = crt_knomial_ops.to_get_children(tk->tk_size, tk->tk_ratio, tk->tk_root,
+						     grp_self, children);
+		assert_int_equal(rc, 0);
+	}
+	return nr;
+}
+
+static int
+knomial_parent(void *arg, uint32_t grp_self, uint32_t *parent)
+{
+	struct tree_knomial *tk = arg;
+
+	return crt_knomial_ops.to_get_parent(tk->tk_size, tk->tk_ratio, tk->tk_root, grp_self,
+					     parent);
+}
+
+static uint32_t
+domain_children(void *arg, uint32_t grp_self, uint32_t *children)
+{
+	struct crt_tree_dom_layout	*layout = arg;
+	uint32_t			 nr;
+
+	nr = crt_tree_dom_get_children(layout, grp_self, NULL);
+	assert_int_equal(crt_tree_dom_get_children(layout, grp_self, children), nr);
+	return nr;
+}
+
+static int
+domain_parent(void *arg, uint32_t grp_self, uint32_t *parent)
+{
+	return crt_tree_dom_get_parent(arg, grp_self, parent);
+}
+
+/*
+ * Walk the tree from the root, checking that every rank is reached once and
+ * that the parent of each child is the rank it was reached from.
+ */
+static void
+tree_walk(uint32_t grp_size, uint32_t grp_root, const uint32_t *domains,
+	  tree_children_fn_t children_fn, tree_parent_fn_t parent_fn, void *arg,
+	  struct tree_stats *stats)
+{
+	uint32_t	*queue;
+	uint32_t	*depth;
+	uint32_t	*children;
+	uint32_t	 head = 0;
+	uint32_t	 tail = 0;
+	uint32_t	 parent;
+	uint32_t	 self;
+	uint32_t	 nr;
+	uint32_t	 i;
+
+	D_ALLOC_ARRAY(queue, grp_size);
+	D_ALLOC_ARRAY(depth, grp_size);
+	D_ALLOC_ARRAY(children, grp_size);
+	assert_non_null(queue);
+	assert_non_null(depth);
+	assert_non_null(children);
+
+	for (i = 0; i < grp_size; i++)
+		depth[i] = UINT32_MAX;
+	memset(stats, 0, sizeof(*stats));
+
+	assert_int_equal(parent_fn(arg, grp_root, &parent), -DER_INVAL);
+	depth[grp_root] = 0;
+	queue[tail++]   = grp_root;
+	while (head < tail) {
+		self = queue[head++];
+		nr   = children_fn(arg, self, children);
+		for (i = 0; i < nr; i++) {
+			assert_true(children[i] < grp_size);
+			assert_int_equal(depth[children[i]], UINT32_MAX);
+			assert_int_equal(parent_fn(arg, children[i], &parent), 0);
+			assert_int_equal(parent, self);
+
+			depth[children[i]] = depth[self] + 1;
+			queue[tail++]      = children[i];
+			if (depth[children[i]] > stats->ts_depth)
+				stats->ts_depth = depth[children[i]];
+			if (domains != NULL && domains[children[i]] != domains[self])
+				stats->ts_cross++;
+		}
+	}
+	assert_int_equal(tail, grp_size);
+
+	D_FREE(queue);
+	D_FREE(depth);
+	D_FREE(children);
+}
+
+static void
+tree_compare(uint32_t grp_size, uint32_t grp_root, const uint32_t *domains, uint32_t ndoms)
+{
+	struct tree_knomial		tk = {grp_size, TREE_RATIO, grp_root};
+	struct crt_tree_dom_layout	layout;
+	struct tree_stats		knomial;
+	struct tree_stats		domain;
+	int				rc;
+
+	rc = crt_tree_dom_layout_init(&layout, grp_size, TREE_RATIO, domains, grp_root);
+	assert_int_equal(rc, 0);
+	assert_int_equal(layout.tdl_ndoms, ndoms);
+
+	tree_walk(grp_size, grp_root, domains, knomial_children, knomial_parent, &tk, &knomial);
+	tree_walk(grp_size, grp_root, domains, domain_children, domain_parent, &layout, &domain);
+	crt_tree_dom_layout_fini(&layout);
+
+	fprintf(stdout, "%u ranks, %u domains, root %u: knomial depth %u, %u cross domain edges; "
+		"domain depth %u, %u cross domain edges\n", grp_size, ndoms, grp_root,
+		knomial.ts_depth, knomial.ts_cross, domain.ts_depth, domain.ts_cross);
+
+	/* One edge to reach each of the other domains, each level bounded */
+	if (domains != NULL)
+		assert_int_equal(domain.ts_cross, ndoms - 1);
+	assert_true(domain.ts_depth <= (ndoms > 1 ? 2 : 1) * CRT_TREE_DOMAIN_LEVEL_DEPTH);
+}
+
+static void
+test_tree_domain(void **state)
+{
+	uint32_t	*domains;
+	uint32_t	 i;
+
+	D_ALLOC_ARRAY(domains, TREE_GRP_SIZE);
+	assert_non_null(domains);
+
+	/* Ranks interleaved over the domains, the worst case for knomial */
+	for (i = 0; i < TREE_GRP_SIZE; i++)
+		domains[i] = i % TREE_NDOMS;
+	tree_compare(TREE_GRP_SIZE, 0, domains, TREE_NDOMS);
+	tree_compare(TREE_GRP_SIZE, 4321, domains, TREE_NDOMS);
+
+	/* Contiguous domains of decreasing sizes, sparse IDs */
+	for (i = 0; i < TREE_GRP_SIZE; i++)
+		domains[i] = i * i / (TREE_GRP_SIZE * TREE_GRP_SIZE / TREE_NDOMS) * 7919;
+	tree_compare(TREE_GRP_SIZE, TREE_GRP_SIZE - 1, domains, TREE_NDOMS);
+
+	/* Some ranks without a domain are considered in the same one */
+	for (i = 0; i < TREE_GRP_SIZE; i++)
+		domains[i] = i % 3 == 0 ? CRT_NO_DOMAIN : i % TREE_NDOMS;
+	tree_compare(TREE_GRP_SIZE, 1, domains, TREE_NDOMS + 1);
+
+	D_FREE(domains);
+}
+
+static void
+test_tree_no_domain(void **state)
+{
+	uint32_t grp_size;
+
+	for (grp_size = 1; grp_size <= TREE_GRP_SIZE; grp_size *= 10)
+		tree_compare(grp_size, grp_size / 2, NULL, 1);
+}
+
+static int
+init_tests(void **state)
+{
+	return d_log_init();
+}
+
+static int
+fini_tests(void **state)
+{
+	d_log_fini();
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_tree_domain),
+		cmocka_unit_test(test_tree_no_domain),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_tree", tests, init_tests,
+		fini_tests);
+}
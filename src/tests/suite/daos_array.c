@@ -1103,6 +1103,77 @@ truncate_array(void **state)
 	par_barrier(PAR_COMM_WORLD);
 } /* End truncate_array */
 
+#define SIZE_MULTI_NR	16
+
+static void
+get_size_multi(void **state)
+{
+	test_arg_t		*arg = *state;
+	daos_obj_id_t		oid;
+	daos_handle_t		ohs[SIZE_MULTI_NR];
+	daos_size_t		sizes[SIZE_MULTI_NR];
+	daos_array_iod_t	iod = {};
+	daos_range_t		rg = {};
+	d_iov_t			iov = {};
+	d_sg_list_t		sgl = {};
+	char			buf[SIZE_MULTI_NR];
+	int			i;
+	int			rc;
+
+	par_barrier(PAR_COMM_WORLD);
+
+	memset(buf, 'a', sizeof(buf));
+	iod.arr_nr = 1;
+	iod.arr_rgs = &rg;
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+
+	/** create arrays of different sizes, array i has size i * chunk_size + i */
+	for (i = 0; i < SIZE_MULTI_NR; i++) {
+		oid = daos_test_oid_gen(arg->coh, OC_SX, typeb, 0, arg->myrank);
+		rc = daos_array_create(arg->coh, oid, DAOS_TX_NONE, 1, 4, &ohs[i], NULL);
+		assert_rc_equal(rc, 0);
+
+		if (i == 0)
+			continue;
+		rg.rg_idx = i * 4;
+		rg.rg_len = i;
+		d_iov_set(&iov, buf, i);
+		rc = daos_array_write(ohs[i], DAOS_TX_NONE, &iod, &sgl, NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	memset(sizes, 0xff, sizeof(sizes));
+	rc = daos_array_get_size_multi(SIZE_MULTI_NR, ohs, DAOS_TX_NONE, sizes, NULL);
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < SIZE_MULTI_NR; i++)
+		assert_int_equal(sizes[i], i == 0 ? 0 : i * 4 + i);
+
+	/** sizes must follow local truncates */
+	for (i = 0; i < SIZE_MULTI_NR; i++) {
+		rc = daos_array_set_size(ohs[i], DAOS_TX_NONE, i, NULL);
+		assert_rc_equal(rc, 0);
+	}
+	rc = daos_array_get_size_multi(SIZE_MULTI_NR, ohs, DAOS_TX_NONE, sizes, NULL);
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < SIZE_MULTI_NR; i++)
+		assert_int_equal(sizes[i], i);
+
+	/** empty and invalid batches */
+	rc = daos_array_get_size_multi(0, NULL, DAOS_TX_NONE, NULL, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_get_size_multi(DAOS_ARRAY_GET_SIZE_MULTI_MAX + 1, ohs, DAOS_TX_NONE, sizes,
+				       NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+
+	for (i = 0; i < SIZE_MULTI_NR; i++) {
+		rc = daos_array_close(ohs[i], NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	par_barrier(PAR_COMM_WORLD);
+} /* End get_size_multi */
+
 #define DFS_ITER_NR		128
 #define DFS_ITER_DKEY_BUF	(DFS_ITER_NR * sizeof(uint64_t))
 
@@ -1210,6 +1281,179 @@ ec_array_key_query(void **state)
 	par_barrier(PAR_COMM_WORLD);
 } /* End ec_array_key_query */
 
+/** number of chunks of an I/O, more than the default depth of the array I/O window */
+#define WINDOW_CHUNK_NR		256
+#define WINDOW_CHUNK_SIZE	1024
+
+static void
+io_window(void **state)
+{
+	test_arg_t		*arg = *state;
+	daos_obj_id_t		oid;
+	daos_handle_t		oh;
+	daos_array_iod_t	iod = {};
+	daos_range_t		rg = {};
+	d_iov_t			iov = {};
+	d_sg_list_t		sgl = {};
+	daos_size_t		size;
+	char			*wbuf;
+	char			*rbuf;
+	daos_size_t		len = WINDOW_CHUNK_NR * WINDOW_CHUNK_SIZE;
+	daos_size_t		i;
+	int			rc;
+
+	par_barrier(PAR_COMM_WORLD);
+
+	D_ALLOC(wbuf, len);
+	assert_non_null(wbuf);
+	D_ALLOC(rbuf, len);
+	assert_non_null(rbuf);
+	for (i = 0; i < len; i++)
+		wbuf[i] = i % 251;
+
+	oid = daos_test_oid_gen(arg->coh, OC_SX, typeb, 0, arg->myrank);
+	rc = daos_array_create(arg->coh, oid, DAOS_TX_NONE, 1, WINDOW_CHUNK_SIZE, &oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	iod.arr_nr = 1;
+	iod.arr_rgs = &rg;
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+
+	/** one dkey per chunk, the I/O fails if more than the window are in flight */
+	daos_fail_loc_set(DAOS_ARRAY_IO_DEPTH_CHECK | DAOS_FAIL_ALWAYS);
+
+	/** start in the middle of a chunk, so that the first and last dkey I/Os are partial */
+	rg.rg_idx = WINDOW_CHUNK_SIZE / 2;
+	rg.rg_len = len;
+	d_iov_set(&iov, wbuf, len);
+	rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+
+	d_iov_set(&iov, rbuf, len);
+	rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(wbuf, rbuf, len);
+
+	/** short read past the end of the array */
+	memset(rbuf, 0, len);
+	rg.rg_idx = WINDOW_CHUNK_SIZE;
+	rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(wbuf + WINDOW_CHUNK_SIZE / 2, rbuf, len - WINDOW_CHUNK_SIZE / 2);
+
+	daos_fail_loc_set(0);
+
+	rc = daos_array_get_size(oh, DAOS_TX_NONE, &size, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(size, len + WINDOW_CHUNK_SIZE / 2);
+
+	rc = daos_array_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+	D_FREE(rbuf);
+	D_FREE(wbuf);
+
+	par_barrier(PAR_COMM_WORLD);
+} /* End io_window */
+
+/** cache timeout of the size cache test, in ms */
+#define SIZE_CACHE_TMO		3000
+#define SIZE_CACHE_CHUNK	1024
+
+/** write one byte at \a idx, the array size becomes at least \a idx + 1 */
+static void
+size_cache_write(daos_handle_t oh, daos_size_t idx)
+{
+	daos_array_iod_t	iod = {};
+	daos_range_t		rg = {};
+	d_iov_t			iov = {};
+	d_sg_list_t		sgl = {};
+	char			buf = 'a';
+	int			rc;
+
+	iod.arr_nr = 1;
+	iod.arr_rgs = &rg;
+	rg.rg_idx = idx;
+	rg.rg_len = 1;
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+	d_iov_set(&iov, &buf, 1);
+	rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+}
+
+static void
+size_cache_check(daos_handle_t oh, daos_size_t expected)
+{
+	daos_size_t	size;
+	int		rc;
+
+	rc = daos_array_get_size(oh, DAOS_TX_NONE, &size, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(size, expected);
+}
+
+/*
+ * The size cached on a handle is not refreshed by the writes of another handle, which tells a
+ * cache hit from a query of the servers.
+ */
+static void
+size_cache(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_obj_id_t	oid;
+	daos_handle_t	oh;
+	daos_handle_t	oh2;
+	int		rc;
+
+	par_barrier(PAR_COMM_WORLD);
+
+	oid = daos_test_oid_gen(arg->coh, OC_SX, typeb, 0, arg->myrank);
+	rc = daos_array_create(arg->coh, oid, DAOS_TX_NONE, 1, SIZE_CACHE_CHUNK, &oh, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_open_with_attr(arg->coh, oid, DAOS_TX_NONE, DAOS_OO_RW, 1,
+				       SIZE_CACHE_CHUNK, &oh2, NULL);
+	assert_rc_equal(rc, 0);
+
+	/** the environment is only read at init, enable the cache through the fault */
+	daos_fail_value_set(SIZE_CACHE_TMO);
+	daos_fail_loc_set(DAOS_ARRAY_SIZE_CACHE_TMO | DAOS_FAIL_ALWAYS);
+
+	/** the size queried from the servers is cached */
+	size_cache_write(oh, 99);
+	size_cache_check(oh, 100);
+	size_cache_write(oh2, 199);
+	size_cache_check(oh2, 200);
+	size_cache_check(oh, 100);
+
+	/** a write past the end raises the cached size */
+	size_cache_write(oh, 4999);
+	size_cache_check(oh, 5000);
+	size_cache_write(oh2, 5999);
+	size_cache_check(oh, 5000);
+
+	/** set_size replaces the cached size */
+	rc = daos_array_set_size(oh, DAOS_TX_NONE, 50, NULL);
+	assert_rc_equal(rc, 0);
+	size_cache_check(oh, 50);
+	size_cache_write(oh2, 6999);
+	size_cache_check(oh, 50);
+
+	/** and the size is queried again once it expired */
+	sleep(SIZE_CACHE_TMO / 1000 + 1);
+	size_cache_check(oh, 7000);
+
+	daos_fail_loc_set(0);
+	daos_fail_value_set(0);
+
+	rc = daos_array_close(oh2, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	par_barrier(PAR_COMM_WORLD);
+} /* End size_cache */
+
 static const struct CMUnitTest array_api_tests[] = {
 	{"Array 0 API: create/open/close (blocking)",
 	 simple_array_mgmt, async_disable, NULL},
@@ -1235,6 +1479,12 @@ static const struct CMUnitTest array_api_tests[] = {
 	 truncate_array, async_disable, NULL},
 	{"Array 11: EC Array Key Query",
 	 ec_array_key_query, async_disable, NULL},
+	{"Array 12 API: batched size query",
+	 get_size_multi, async_disable, NULL},
+	{"Array 13 API: I/O larger than the I/O window",
+	 io_window, async_disable, NULL},
+	{"Array 14 API: size cache on the array handle",
+	 size_cache, async_disable, NULL},
 };
 
 static int
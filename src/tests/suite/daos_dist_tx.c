@@ -3047,6 +3047,167 @@ dtx_41(void **state)
 	dtx_uncertainty_miss_request(*state, DAOS_DTX_MISS_ABORT, true, true);
 }
 
+#define DTX_RESYNC_CNT	2000
+
+static void
+dtx_42(void **state)
+{
+	test_arg_t	*arg = *state;
+	const char	*akey = dts_dtx_akey;
+	char		 dkey[16];
+	daos_obj_id_t	 oids[2];
+	struct ioreq	 reqs[2];
+	uint64_t	 val;
+	daos_handle_t	 th = { 0 };
+	d_rank_t	 kill_rank = CRT_NO_RANK;
+	int		 i;
+
+	FAULT_INJECTION_REQUIRED();
+
+	print_message("DTX42: resync - thousands of in-flight DTXs\n");
+
+	if (!test_runable(arg, 4))
+		skip();
+
+	if (arg->myrank == 0) {
+		for (i = 0; i < 2; i++) {
+			oids[i] = daos_test_oid_gen(arg->coh, OC_RP_3G1, 0, 0, arg->myrank);
+			ioreq_init(&reqs[i], arg->coh, oids[i], DAOS_IOD_SINGLE, arg);
+		}
+
+		/* Use the shard 0 of oids[0] as the leader for all the TXs. Do not mark
+		 * them as committable, then they are still 'prepared' everywhere when the
+		 * leader is excluded. The new leader needs to resolve them via DTX resync.
+		 */
+		daos_fail_loc_set(DAOS_DTX_SPEC_LEADER | DAOS_FAIL_ALWAYS);
+		daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC,
+				      DAOS_DTX_NO_COMMITTABLE | DAOS_FAIL_ALWAYS, 0, NULL);
+
+		print_message("Generating %d in-flight TXs\n", DTX_RESYNC_CNT);
+
+		for (i = 0; i < DTX_RESYNC_CNT; i++) {
+			sprintf(dkey, "dkey_%d", i);
+			val = i + 1;
+
+			MUST(daos_tx_open(arg->coh, &th, 0, NULL));
+			insert_single(dkey, akey, 0, &val, sizeof(val), th, &reqs[0]);
+			insert_single(dkey, akey, 0, &val, sizeof(val), th, &reqs[1]);
+			MUST(daos_tx_commit(th, NULL));
+			MUST(daos_tx_close(th, NULL));
+		}
+
+		daos_fail_loc_set(0);
+
+		kill_rank = get_rank_by_oid_shard(arg, oids[0], 0);
+		print_message("Exclude the leader rank %d to trigger DTX resync\n", kill_rank);
+	}
+	par_barrier(PAR_COMM_WORLD);
+
+	rebuild_single_pool_rank(arg, kill_rank, false);
+
+	par_barrier(PAR_COMM_WORLD);
+	if (arg->myrank == 0) {
+		daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC, 0, 0, NULL);
+
+		print_message("Verifying data after DTX resync...\n");
+
+		for (i = 0; i < DTX_RESYNC_CNT; i++) {
+			sprintf(dkey, "dkey_%d", i);
+
+			val = 0;
+			lookup_single(dkey, akey, 0, &val, sizeof(val), DAOS_TX_NONE, &reqs[0]);
+			assert_int_equal(val, i + 1);
+
+			val = 0;
+			lookup_single(dkey, akey, 0, &val, sizeof(val), DAOS_TX_NONE, &reqs[1]);
+			assert_int_equal(val, i + 1);
+		}
+
+		ioreq_fini(&reqs[0]);
+		ioreq_fini(&reqs[1]);
+	}
+	par_barrier(PAR_COMM_WORLD);
+
+	reintegrate_single_pool_rank(arg, kill_rank, false);
+}
+
+static void
+dtx_43(void **state)
+{
+	test_arg_t	*arg = *state;
+	const char	*dkey1 = "a_dkey_1";
+	const char	*dkey2 = "b_dkey_2";
+	const char	*akey = dts_dtx_akey;
+	daos_handle_t	 th = { 0 };
+	daos_obj_id_t	 oids[DTX_NC_CNT];
+	struct ioreq	 reqs[DTX_NC_CNT];
+	uint32_t	 val;
+	int		 i;
+	int		 j;
+
+	FAULT_INJECTION_REQUIRED();
+
+	print_message("DTX43: single RDG TX - committed before reply\n");
+
+	if (!test_runable(arg, 2))
+		skip();
+
+	par_barrier(PAR_COMM_WORLD);
+	if (arg->myrank == 0)
+		daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC,
+				      DAOS_DTX_NO_BATCHED_CMT | DAOS_FAIL_ALWAYS, 0, NULL);
+	par_barrier(PAR_COMM_WORLD);
+
+	print_message("Transactional update within single RDG without batched commit\n");
+
+	for (i = 0, val = 1; i < DTX_NC_CNT; i++, val++) {
+		oids[i] = daos_test_oid_gen(arg->coh, OC_RP_2G1, 0, 0, arg->myrank);
+		ioreq_init(&reqs[i], arg->coh, oids[i], DAOS_IOD_ARRAY, arg);
+
+		MUST(daos_tx_open(arg->coh, &th, 0, NULL));
+
+		/* Base value: i + 1 */
+		insert_single(dkey1, akey, 0, &val, sizeof(val), th, &reqs[i]);
+		insert_single(dkey2, akey, 0, &val, sizeof(val), th, &reqs[i]);
+
+		MUST(daos_tx_commit(th, NULL));
+		MUST(daos_tx_close(th, NULL));
+	}
+
+	/* Any DTX refresh from now on will fail with -DER_TX_UNCERTAIN. */
+	par_barrier(PAR_COMM_WORLD);
+	if (arg->myrank == 0)
+		daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC,
+				      DAOS_DTX_UNCERTAIN | DAOS_FAIL_ALWAYS, 0, NULL);
+	par_barrier(PAR_COMM_WORLD);
+
+	print_message("Verify update result on each replica without DTX refresh\n");
+
+	/* Fetch from each replica, the non-leader must have committed the DTX already. */
+	daos_fail_loc_set(DAOS_OBJ_SPECIAL_SHARD | DAOS_FAIL_ALWAYS);
+	for (i = 0; i < DTX_NC_CNT; i++) {
+		for (j = 0; j < 2; j++) {
+			daos_fail_value_set(j);
+
+			val = 0;
+			lookup_single(dkey1, akey, 0, &val, sizeof(val), DAOS_TX_NONE, &reqs[i]);
+			assert_int_equal(val, i + 1);
+
+			val = 0;
+			lookup_single(dkey2, akey, 0, &val, sizeof(val), DAOS_TX_NONE, &reqs[i]);
+			assert_int_equal(val, i + 1);
+		}
+
+		ioreq_fini(&reqs[i]);
+	}
+	daos_fail_loc_set(0);
+
+	par_barrier(PAR_COMM_WORLD);
+	if (arg->myrank == 0)
+		daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC, 0, 0, NULL);
+	par_barrier(PAR_COMM_WORLD);
+}
+
 static test_arg_t *saved_dtx_arg;
 
 static int
@@ -3193,6 +3354,10 @@ static const struct CMUnitTest dtx_tests[] = {
 	 dtx_40, NULL, test_case_teardown},
 	{"DTX41: uncertain check - miss abort with delay",
 	 dtx_41, NULL, test_case_teardown},
+	{"DTX42: resync - thousands of in-flight DTXs",
+	 dtx_42, dtx_sub_rf1_setup, dtx_sub_teardown},
+	{"DTX43: single RDG TX - committed before reply",
+	 dtx_43, NULL, test_case_teardown},
 };
 
 static int
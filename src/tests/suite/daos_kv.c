@@ -352,6 +352,113 @@ kv_cond_ops(void **state)
 	print_message("all good\n");
 } /* End simple_put_get */
 
+#define MULTI_NUM_KEYS	256
+#define MULTI_VAL_SIZE	64
+
+static void
+kv_multi_put_get(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_obj_id_t	oid;
+	daos_handle_t	oh;
+	char		*keys[MULTI_NUM_KEYS];
+	daos_size_t	sizes[MULTI_NUM_KEYS];
+	void		*bufs[MULTI_NUM_KEYS];
+	void		*bufs_out[MULTI_NUM_KEYS];
+	int		rcs[MULTI_NUM_KEYS];
+	uint64_t	start, single_ns, multi_ns;
+	int		i;
+	int		rc;
+
+	oid = dts_oid_gen(arg->myrank);
+	daos_obj_generate_oid(arg->coh, &oid, type, OC_SX, 0, 0);
+
+	rc = daos_kv_open(arg->coh, oid, DAOS_OO_RW, &oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < MULTI_NUM_KEYS; i++) {
+		D_ASPRINTF(keys[i], "multi_key%d", i);
+		assert_non_null(keys[i]);
+		D_ALLOC(bufs[i], MULTI_VAL_SIZE);
+		assert_non_null(bufs[i]);
+		dts_buf_render(bufs[i], MULTI_VAL_SIZE);
+		D_ALLOC(bufs_out[i], MULTI_VAL_SIZE);
+		assert_non_null(bufs_out[i]);
+		sizes[i] = MULTI_VAL_SIZE;
+	}
+
+	print_message("Invalid batches\n");
+	rc = daos_kv_put_multi(oh, DAOS_TX_NONE, 0, DAOS_KV_MULTI_MAX + 1, (const char **)keys,
+			       sizes, (const void **)bufs, NULL, NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+	rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, MULTI_NUM_KEYS, NULL, sizes, bufs_out,
+			       NULL, NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+
+	print_message("Inserting %d Keys one at a time\n", MULTI_NUM_KEYS);
+	start = daos_get_ntime();
+	for (i = 0; i < MULTI_NUM_KEYS; i++) {
+		rc = daos_kv_put(oh, DAOS_TX_NONE, 0, keys[i], sizes[i], bufs[i], NULL);
+		assert_rc_equal(rc, 0);
+	}
+	single_ns = daos_get_ntime() - start;
+
+	print_message("Inserting %d Keys in one batch\n", MULTI_NUM_KEYS);
+	start = daos_get_ntime();
+	rc = daos_kv_put_multi(oh, DAOS_TX_NONE, 0, MULTI_NUM_KEYS, (const char **)keys, sizes,
+			       (const void **)bufs, rcs, NULL);
+	multi_ns = daos_get_ntime() - start;
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < MULTI_NUM_KEYS; i++)
+		assert_rc_equal(rcs[i], 0);
+	print_message("put: %.1f keys/s single, %.1f keys/s batched\n",
+		      MULTI_NUM_KEYS * 1e9 / (single_ns ?: 1), MULTI_NUM_KEYS * 1e9 / (multi_ns ?: 1));
+
+	print_message("Reading %d Keys one at a time\n", MULTI_NUM_KEYS);
+	start = daos_get_ntime();
+	for (i = 0; i < MULTI_NUM_KEYS; i++) {
+		daos_size_t size = MULTI_VAL_SIZE;
+
+		rc = daos_kv_get(oh, DAOS_TX_NONE, 0, keys[i], &size, bufs_out[i], NULL);
+		assert_rc_equal(rc, 0);
+	}
+	single_ns = daos_get_ntime() - start;
+
+	print_message("Reading %d Keys in one batch\n", MULTI_NUM_KEYS);
+	for (i = 0; i < MULTI_NUM_KEYS; i++)
+		memset(bufs_out[i], 0, MULTI_VAL_SIZE);
+	/** replace one key by a missing one, it must not fail the others */
+	D_FREE(keys[MULTI_NUM_KEYS - 1]);
+	D_ASPRINTF(keys[MULTI_NUM_KEYS - 1], "missing_key");
+	assert_non_null(keys[MULTI_NUM_KEYS - 1]);
+	start = daos_get_ntime();
+	rc = daos_kv_get_multi(oh, DAOS_TX_NONE, 0, MULTI_NUM_KEYS, (const char **)keys, sizes,
+			       bufs_out, rcs, NULL);
+	multi_ns = daos_get_ntime() - start;
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < MULTI_NUM_KEYS - 1; i++) {
+		assert_rc_equal(rcs[i], 0);
+		assert_int_equal(sizes[i], MULTI_VAL_SIZE);
+		assert_memory_equal(bufs[i], bufs_out[i], MULTI_VAL_SIZE);
+	}
+	assert_rc_equal(rcs[MULTI_NUM_KEYS - 1], 0);
+	assert_int_equal(sizes[MULTI_NUM_KEYS - 1], 0);
+	print_message("get: %.1f keys/s single, %.1f keys/s batched\n",
+		      MULTI_NUM_KEYS * 1e9 / (single_ns ?: 1), MULTI_NUM_KEYS * 1e9 / (multi_ns ?: 1));
+
+	rc = daos_kv_destroy(oh, DAOS_TX_NONE, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_kv_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < MULTI_NUM_KEYS; i++) {
+		D_FREE(keys[i]);
+		D_FREE(bufs[i]);
+		D_FREE(bufs_out[i]);
+	}
+	print_message("all good\n");
+}
+
 static const struct CMUnitTest kv_tests[] = {
 	{"KV: Object Put/GET (blocking)",
 	 simple_put_get, async_disable, NULL},
@@ -361,6 +468,8 @@ static const struct CMUnitTest kv_tests[] = {
 	 simple_put_get, async_enable, NULL},
 	{"KV: Object Conditional Ops (blocking)",
 	 kv_cond_ops, async_disable, NULL},
+	{"KV: Multi-key Put/GET (blocking)",
+	 kv_multi_put_get, async_disable, NULL},
 };
 
 int
@@ -2297,6 +2297,52 @@ pool_map_refreshes_fallback(void **state)
 	pool_map_refreshes_common(state, true /* fall_back */);
 }
 
+#define POOL_CONNECT_STORM_NR	64
+
+/** many concurrent connects from every rank, which the pool service handles in batches */
+static void
+pool_connect_storm(void **state)
+{
+	test_arg_t	*arg = *state;
+	daos_handle_t	 poh[POOL_CONNECT_STORM_NR];
+	daos_event_t	 ev[POOL_CONNECT_STORM_NR];
+	daos_event_t	*evp;
+	uint64_t	 t_begin;
+	int		 i;
+	int		 rc;
+
+	par_barrier(PAR_COMM_WORLD);
+
+	print_message("rank %d connecting to pool %d times concurrently ... ", arg->myrank,
+		      POOL_CONNECT_STORM_NR);
+	t_begin = daos_get_ntime();
+	for (i = 0; i < POOL_CONNECT_STORM_NR; i++) {
+		rc = daos_event_init(&ev[i], arg->eq, NULL);
+		assert_rc_equal(rc, 0);
+		rc = daos_pool_connect(arg->pool.pool_str, arg->group, DAOS_PC_RW, &poh[i],
+				       NULL /* info */, &ev[i]);
+		assert_rc_equal(rc, 0);
+	}
+	for (i = 0; i < POOL_CONNECT_STORM_NR; i++) {
+		rc = daos_eq_poll(arg->eq, 0, DAOS_EQ_WAIT, 1, &evp);
+		assert_int_equal(rc, 1);
+		assert_rc_equal(evp->ev_error, 0);
+	}
+	print_message("success in " DF_U64 " us\n", (daos_get_ntime() - t_begin) / 1000);
+
+	par_barrier(PAR_COMM_WORLD);
+
+	print_message("rank %d disconnecting from pool %d times ... ", arg->myrank,
+		      POOL_CONNECT_STORM_NR);
+	for (i = 0; i < POOL_CONNECT_STORM_NR; i++) {
+		rc = daos_pool_disconnect(poh[i], NULL /* ev */);
+		assert_rc_equal(rc, 0);
+		rc = daos_event_fini(&ev[i]);
+		assert_rc_equal(rc, 0);
+	}
+	print_message("success\n");
+}
+
 static const struct CMUnitTest pool_tests[] = {
 	{ "POOL1: connect to non-existing pool",
 	  pool_connect_nonexist, NULL, test_case_teardown},
@@ -2336,6 +2382,8 @@ static const struct CMUnitTest pool_tests[] = {
 	  filter_containers_test, setup_zerocontainers, teardown_containers},
 	{ "POOL19: pool filter containers (many)",
 	  filter_containers_test, setup_manycontainers, teardown_containers},
+	{ "POOL20: connect storm",
+	  pool_connect_storm, NULL, test_case_teardown},
 };
 
 int
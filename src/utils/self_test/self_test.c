@@ -9,6 +9,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
 #include <getopt.h>
 #include <string.h>
 #include <math.h>
@@ -20,6 +22,11 @@
 #include <daos/agent.h>
 #include <daos/mgmt.h>
 
+/* Max number of sizes of a --sweep, 0 and the 32 doublings of a uint32_t */
+#define SELF_TEST_SWEEP_MAX_SIZES (33)
+/* Max length of one size of a --sweep list, including its separator */
+#define SELF_TEST_SWEEP_SIZE_LEN (12)
+
 /* User input maximum values */
 #define SELF_TEST_MAX_REPETITIONS (0x40000000)
 #define SELF_TEST_MAX_INFLIGHT (0x40000000)
@@ -70,17 +77,49 @@ static void print_fail_counts(struct st_latency *latencies,
 
 }
 
-static void print_results(struct st_latency *latencies,
-			  struct crt_st_start_params *test_params,
-			  int64_t test_duration_ns, int output_megabits)
+/* Summary of the results of one master endpoint for one message size */
+struct st_summary {
+	uint32_t	num_passed;
+	uint32_t	num_failed;
+	/* RPCs/sec and bytes/sec */
+	double		throughput;
+	double		bandwidth;
+	/* Latencies in ns */
+	int64_t		min;
+	int64_t		p25;
+	int64_t		median;
+	int64_t		p75;
+	int64_t		p90;
+	int64_t		p99;
+	int64_t		p999;
+	int64_t		max;
+	int64_t		avg;
+	double		std_dev;
+};
+
+/* Latency at \a permille of the passed RPCs, the latencies must be sorted by val */
+static int64_t
+st_percentile(struct st_latency *latencies, uint32_t num_failed, uint32_t num_passed,
+	      uint32_t permille)
+{
+	uint64_t idx = (uint64_t)num_passed * permille / 1000;
+
+	if (idx >= num_passed)
+		idx = num_passed - 1;
+	return latencies[num_failed + idx].val;
+}
+
+/*
+ * Compute the summary of the results, this leaves the latencies sorted by val
+ * with the failed RPCs first
+ */
+static void
+st_summarize(struct st_latency *latencies, struct crt_st_start_params *test_params,
+	     int64_t test_duration_ns, struct st_summary *sum)
 {
 	uint32_t	 local_rep;
 	uint32_t	 num_failed = 0;
 	uint32_t	 num_passed = 0;
-	double		 latency_std_dev;
-	int64_t		 latency_avg;
-	double		 throughput;
-	double		 bandwidth;
 
 	/* Check for bugs */
 	D_ASSERT(latencies != NULL);
@@ -88,25 +127,16 @@ static void print_results(struct st_latency *latencies,
 	D_ASSERT(test_params->rep_count != 0);
 	D_ASSERT(test_duration_ns > 0);
 
+	memset(sum, 0, sizeof(*sum));
+
 	/* Compute the throughput in RPCs/sec */
-	throughput = test_params->rep_count /
+	sum->throughput = test_params->rep_count /
 		(test_duration_ns / 1000000000.0F);
 	/* Compute bandwidth in bytes */
-	bandwidth = throughput * (test_params->send_size +
-				  test_params->reply_size);
-
-	/* Print the results for this size */
-	if (output_megabits)
-		printf("\tRPC Bandwidth (Mbits/sec): %.2f\n",
-		       bandwidth * 8.0F / 1000000.0F);
-	else
-		printf("\tRPC Bandwidth (MB/sec): %.2f\n",
-		       bandwidth / (1024.0F * 1024.0F));
-	printf("\tRPC Throughput (RPCs/sec): %.0f\n", throughput);
-
+	sum->bandwidth = sum->throughput * (test_params->send_size +
+					    test_params->reply_size);
 
 	/* Figure out how many repetitions were errors */
-	num_failed = 0;
 	for (local_rep = 0; local_rep < test_params->rep_count; local_rep++)
 		if (latencies[local_rep].cci_rc < 0) {
 			num_failed++;
@@ -126,10 +156,10 @@ static void print_results(struct st_latency *latencies,
 	 * guard against overflow and divide by zero later
 	 */
 	num_passed = test_params->rep_count - num_failed;
-	if (num_passed == 0) {
-		printf("\tAll RPCs for this message size failed\n");
+	sum->num_failed = num_failed;
+	sum->num_passed = num_passed;
+	if (num_passed == 0)
 		return;
-	}
 
 	/*
 	 * Sort the latencies by: (in descending order of precedence)
@@ -142,20 +172,52 @@ static void print_results(struct st_latency *latencies,
 	      sizeof(latencies[0]), st_compare_latencies_by_vals);
 
 	/* Compute average and standard deviation of all results */
-	latency_avg = 0;
 	for (local_rep = num_failed; local_rep < test_params->rep_count;
 	     local_rep++)
-		latency_avg += latencies[local_rep].val;
-	latency_avg /= test_params->rep_count;
+		sum->avg += latencies[local_rep].val;
+	sum->avg /= test_params->rep_count;
 
-	latency_std_dev = 0;
 	for (local_rep = num_failed; local_rep < test_params->rep_count;
 	     local_rep++)
-		latency_std_dev +=
-			pow(latencies[local_rep].val - latency_avg,
+		sum->std_dev +=
+			pow(latencies[local_rep].val - sum->avg,
 			    2);
-	latency_std_dev /= num_passed;
-	latency_std_dev = sqrt(latency_std_dev);
+	sum->std_dev /= num_passed;
+	sum->std_dev = sqrt(sum->std_dev);
+
+	sum->min    = latencies[num_failed].val;
+	sum->p25    = st_percentile(latencies, num_failed, num_passed, 250);
+	sum->median = st_percentile(latencies, num_failed, num_passed, 500);
+	sum->p75    = st_percentile(latencies, num_failed, num_passed, 750);
+	sum->p90    = st_percentile(latencies, num_failed, num_passed, 900);
+	sum->p99    = st_percentile(latencies, num_failed, num_passed, 990);
+	sum->p999   = st_percentile(latencies, num_failed, num_passed, 999);
+	sum->max    = latencies[test_params->rep_count - 1].val;
+}
+
+static void print_results(struct st_latency *latencies,
+			  struct crt_st_start_params *test_params,
+			  int64_t test_duration_ns, int output_megabits)
+{
+	struct st_summary sum;
+	uint32_t	  local_rep;
+	uint32_t	  num_failed;
+
+	st_summarize(latencies, test_params, test_duration_ns, &sum);
+
+	/* Print the results for this size */
+	if (output_megabits)
+		printf("\tRPC Bandwidth (Mbits/sec): %.2f\n",
+		       sum.bandwidth * 8.0F / 1000000.0F);
+	else
+		printf("\tRPC Bandwidth (MB/sec): %.2f\n",
+		       sum.bandwidth / (1024.0F * 1024.0F));
+	printf("\tRPC Throughput (RPCs/sec): %.0f\n", sum.throughput);
+
+	if (sum.num_passed == 0) {
+		printf("\tAll RPCs for this message size failed\n");
+		return;
+	}
 
 	/* Print latency summary results */
 	printf("\tRPC Latencies (us):\n"
@@ -163,18 +225,18 @@ static void print_results(struct st_latency *latencies,
 	       "\t\t25th  %%: %ld\n"
 	       "\t\tMedian : %ld\n"
 	       "\t\t75th  %%: %ld\n"
+	       "\t\t90th  %%: %ld\n"
+	       "\t\t99th  %%: %ld\n"
+	       "\t\t99.9th%%: %ld\n"
 	       "\t\tMax    : %ld\n"
 	       "\t\tAverage: %ld\n"
 	       "\t\tStd Dev: %.2f\n",
-	       latencies[num_failed].val / 1000,
-	       latencies[num_failed + num_passed / 4].val / 1000,
-	       latencies[num_failed + num_passed / 2].val / 1000,
-	       latencies[num_failed + num_passed*3/4].val / 1000,
-	       latencies[test_params->rep_count - 1].val / 1000,
-	       latency_avg / 1000, latency_std_dev / 1000);
+	       sum.min / 1000, sum.p25 / 1000, sum.median / 1000, sum.p75 / 1000,
+	       sum.p90 / 1000, sum.p99 / 1000, sum.p999 / 1000, sum.max / 1000,
+	       sum.avg / 1000, sum.std_dev / 1000);
 
 	/* Print error summary results */
-	printf("\tRPC Failures: %u\n", num_failed);
+	printf("\tRPC Failures: %u\n", sum.num_failed);
 	/* print_fail_counts(&latencies[0], num_failed, "\t\t"); */
 
 	printf("\n");
@@ -330,6 +392,15 @@ print_usage(const char *prog_name, const char *msg_sizes_str, int rep_count, int
 	    "\n"
 	    "      Default: \"%s\"\n"
 	    "\n"
+	    "  --sweep <min>-<max>\n"
+	    "      Short version: -w\n"
+	    "      Test every size from min to max, doubling it at each step, in both\n"
+	    "        directions. Types are chosen automatically as for --message-sizes.\n"
+	    "        A min of 0 tests (0 0) and then starts from 1.\n"
+	    "        Replaces --message-sizes\n"
+	    "\n"
+	    "      Example: --sweep 8-1048576\n"
+	    "\n"
 	    "  --master-endpoint <ranks:tags>\n"
 	    "      Short version: -m\n"
 	    "      Describes an endpoint (or range of endpoints) that will each run a\n"
@@ -399,6 +470,17 @@ print_usage(const char *prog_name, const char *msg_sizes_str, int rep_count, int
 	    "\n"
 	    "      Default is no alignment - whatever is returned by the allocator is used\n"
 	    "\n"
+	    "  --coalesce\n"
+	    "      Short version: -c\n"
+	    "      Send the test RPCs through the coalescing opcodes, so that the RPCs to the\n"
+	    "        same endpoint are packed into a single message (see D_RPC_COALESCE_MAX).\n"
+	    "        Only applies to message sizes without a bulk transfer\n"
+	    "\n"
+	    "  --json <file>\n"
+	    "      Short version: -j\n"
+	    "      Also write the results to file in JSON format, with the latencies of\n"
+	    "        each master endpoint in ns (min, p25, p50, p75, p90, p99, p99.9, max)\n"
+	    "\n"
 	    "  --Mbits\n"
 	    "      Short version: -b\n"
 	    "      By default, self-test outputs performance results in MB (#Bytes/1024^2)\n"
@@ -861,7 +943,8 @@ int parse_message_sizes_string(const char *pch,
 
 static void
 print_size_results(struct crt_st_start_params *test_params, struct st_master_endpt *ms_endpts,
-		   uint32_t num_ms_endpts, struct st_latency **latencies, int output_megabits)
+		   uint32_t num_ms_endpts, struct st_latency **latencies, int64_t *durations,
+		   int output_megabits)
 {
 	int m_idx;
 
@@ -889,9 +972,57 @@ print_size_results(struct crt_st_start_params *test_params, struct st_master_end
 			printf("-");
 		printf("\n");
 
-		print_results(latencies[m_idx], test_params,
-			      ms_endpts[m_idx].reply.test_duration_ns, output_megabits);
+		print_results(latencies[m_idx], test_params, durations[m_idx], output_megabits);
+	}
+
+	/* The master endpoints run concurrently, report their combined rate */
+	if (num_ms_endpts > 1) {
+		double throughput = 0;
+
+		for (m_idx = 0; m_idx < num_ms_endpts; m_idx++)
+			if (ms_endpts[m_idx].test_failed == 0)
+				throughput += test_params->rep_count /
+					(durations[m_idx] / 1000000000.0F);
+		printf("Aggregate RPC Throughput (RPCs/sec): %.0f\n\n", throughput);
+	}
+}
+
+/* Write the results of one message size as a JSON object */
+static void
+write_size_json(FILE *fp, struct crt_st_start_params *test_params,
+		struct st_master_endpt *ms_endpts, uint32_t num_ms_endpts,
+		struct st_latency **latencies, int64_t *durations)
+{
+	struct st_summary	sum;
+	uint32_t		m_idx;
+
+	fprintf(fp, "    {\"send_size\": %u, \"send_type\": \"%s\", "
+		"\"reply_size\": %u, \"reply_type\": \"%s\",\n     \"masters\": [",
+		test_params->send_size, crt_st_msg_type_str[test_params->send_type],
+		test_params->reply_size, crt_st_msg_type_str[test_params->reply_type]);
+
+	for (m_idx = 0; m_idx < num_ms_endpts; m_idx++) {
+		fprintf(fp, "%s\n      {\"rank\": %u, \"tag\": %u, ", m_idx == 0 ? "" : ",",
+			ms_endpts[m_idx].endpt.ep_rank, ms_endpts[m_idx].endpt.ep_tag);
+		if (ms_endpts[m_idx].test_failed != 0) {
+			fprintf(fp, "\"failed\": true}");
+			continue;
+		}
+
+		st_summarize(latencies[m_idx], test_params, durations[m_idx], &sum);
+		fprintf(fp, "\"failed\": false, \"duration_ns\": %" PRId64 ", \"rpcs\": %u, "
+			"\"failures\": %u, \"rpc_rate\": %.0f, \"bandwidth\": %.0f",
+			durations[m_idx], test_params->rep_count,
+			sum.num_failed, sum.throughput, sum.bandwidth);
+		if (sum.num_passed > 0)
+			fprintf(fp, ",\n       \"latency_ns\": {\"min\": %ld, \"p25\": %ld, "
+				"\"p50\": %ld, \"p75\": %ld, \"p90\": %ld, \"p99\": %ld, "
+				"\"p99.9\": %ld, \"max\": %ld, \"avg\": %ld, \"std_dev\": %.0f}",
+				sum.min, sum.p25, sum.median, sum.p75, sum.p90, sum.p99, sum.p999,
+				sum.max, sum.avg, sum.std_dev);
+		fprintf(fp, "}");
 	}
+	fprintf(fp, "\n     ]}");
 }
 
 int main(int argc, char *argv[])
@@ -921,12 +1052,20 @@ int main(int argc, char *argv[])
 	uint32_t                         num_ms_endpts_opt = 0;
 	uint32_t                         num_ms_endpts     = 0;
 	struct st_latency             ***size_latencies    = NULL;
+	int64_t                         *size_durations    = NULL;
 	int                              output_megabits   = 0;
 	int16_t                          buf_alignment     = CRT_ST_BUF_ALIGN_DEFAULT;
 	char                            *attach_info_path  = NULL;
 	bool                             randomize_eps     = false;
 	bool                             use_agent         = false;
 	bool                             no_sync           = false;
+	bool                             coalesce          = false;
+	char                            *sweep_str         = NULL;
+	char                            *json_path         = NULL;
+	FILE                            *json_fp           = NULL;
+	uint32_t                         sweep_min;
+	uint32_t                         sweep_max;
+	uint64_t                         size;
 
 	ret = d_log_init();
 	if (ret != 0) {
@@ -943,6 +1082,9 @@ int main(int argc, char *argv[])
 		    {"repetitions-per-size", required_argument, 0, 'r'},
 		    {"max-inflight-rpcs", required_argument, 0, 'i'},
 		    {"align", required_argument, 0, 'a'},
+		    {"sweep", required_argument, 0, 'w'},
+		    {"json", required_argument, 0, 'j'},
+		    {"coalesce", no_argument, 0, 'c'},
 		    {"Mbits", no_argument, 0, 'b'},
 		    {"randomize-endpoints", no_argument, 0, 'q'},
 		    {"path", required_argument, 0, 'p'},
@@ -951,7 +1093,7 @@ int main(int argc, char *argv[])
 		    {"help", no_argument, 0, 'h'},
 		    {0, 0, 0, 0}};
 
-		c = getopt_long(argc, argv, "g:m:e:s:r:i:a:bhqp:un", long_options, NULL);
+		c = getopt_long(argc, argv, "g:m:e:s:w:j:r:i:a:cbhqp:un", long_options, NULL);
 		if (c == -1)
 			break;
 
@@ -997,6 +1139,34 @@ int main(int argc, char *argv[])
 				buf_alignment = CRT_ST_BUF_ALIGN_DEFAULT;
 			}
 			break;
+		case 'w':
+			ret = sscanf(optarg, "%u-%u", &sweep_min, &sweep_max);
+			if (ret != 2 || sweep_min > sweep_max) {
+				printf("Invalid --sweep argument '%s'\n"
+				       "  Expected <min>-<max> with min <= max\n", optarg);
+				D_GOTO(cleanup, ret = -DER_INVAL);
+			}
+
+			/* Build the equivalent --message-sizes list */
+			D_FREE(sweep_str);
+			D_ALLOC(sweep_str, SELF_TEST_SWEEP_MAX_SIZES * SELF_TEST_SWEEP_SIZE_LEN + 1);
+			if (sweep_str == NULL)
+				D_GOTO(cleanup, ret = -DER_NOMEM);
+			j = 0;
+			if (sweep_min == 0) {
+				j += sprintf(sweep_str + j, "0,");
+				sweep_min = 1;
+			}
+			for (size = sweep_min; size <= sweep_max; size *= 2)
+				j += sprintf(sweep_str + j, "%" PRIu64 ",", size);
+			msg_sizes_str = sweep_str;
+			break;
+		case 'j':
+			json_path = optarg;
+			break;
+		case 'c':
+			coalesce = true;
+			break;
 		case 'b':
 			output_megabits = 1;
 			break;
@@ -1125,6 +1295,9 @@ int main(int argc, char *argv[])
 		all_params = (struct st_size_params *)realloced_mem;
 	}
 
+	for (j = 0; j < num_msg_sizes; j++)
+		all_params[j].coalesce = coalesce;
+
 	/******************** Validate arguments ********************/
 	if (dest_name == NULL) {
 		printf("Warning: no --group-name specified; using '%s'\n",
@@ -1200,6 +1373,7 @@ int main(int argc, char *argv[])
 		printf("  Buffer addresses end with:  <Default>\n");
 	else
 		printf("  Buffer addresses end with:  %d\n", buf_alignment);
+	printf("  Coalescing:                 %s\n", coalesce ? "on" : "off");
 	printf("  Repetitions per size:       %d\n"
 	       "  Max in-flight RPCs:          %d\n\n",
 	       rep_count, max_inflight);
@@ -1208,12 +1382,46 @@ int main(int argc, char *argv[])
 	ret = run_self_test(all_params, num_msg_sizes, rep_count, max_inflight, dest_name,
 			    ms_endpts_opt, num_ms_endpts_opt, tgt_endpts, num_tgt_endpts,
 			    &ms_endpts, &num_ms_endpts, &size_latencies, buf_alignment,
-			    attach_info_path, use_agent, no_sync);
+			    attach_info_path, use_agent, no_sync, &size_durations);
 	if (ret != 0) {
 		DL_ERROR(ret, "run_self_test() failed");
 		D_GOTO(cleanup, ret);
 	}
 
+	/********************* Write the JSON results *********************/
+	if (json_path != NULL) {
+		json_fp = fopen(json_path, "w");
+		if (json_fp == NULL) {
+			printf("Failed to open %s for the JSON results: %s\n", json_path,
+			       strerror(errno));
+			D_GOTO(cleanup, ret = -DER_IO);
+		}
+
+		fprintf(json_fp, "{\"group\": \"%s\", \"rep_count\": %d, \"max_inflight\": %d, "
+			"\"buf_alignment\": %d, \"coalesce\": %s,\n \"sizes\": [\n", dest_name,
+			rep_count, max_inflight, buf_alignment, coalesce ? "true" : "false");
+		for (j = 0; j < num_msg_sizes; j++) {
+			struct crt_st_start_params test_params = {0};
+
+			test_params.rep_count     = rep_count;
+			test_params.max_inflight  = max_inflight;
+			test_params.send_size     = all_params[j].send_size;
+			test_params.reply_size    = all_params[j].reply_size;
+			test_params.send_type     = all_params[j].send_type;
+			test_params.reply_type    = all_params[j].reply_type;
+
+			D_ASSERT(size_latencies[j] != NULL);
+			write_size_json(json_fp, &test_params, ms_endpts, num_ms_endpts,
+					size_latencies[j], &size_durations[j * num_ms_endpts]);
+			fprintf(json_fp, "%s\n", j == num_msg_sizes - 1 ? "" : ",");
+		}
+		fprintf(json_fp, " ]}\n");
+		if (fclose(json_fp) != 0) {
+			printf("Failed to write the JSON results to %s\n", json_path);
+			D_GOTO(cleanup, ret = -DER_IO);
+		}
+	}
+
 	/********************* Print the results *********************/
 	for (j = 0; j < num_msg_sizes; j++) {
 		struct crt_st_start_params test_params = {0};
@@ -1225,20 +1433,23 @@ int main(int argc, char *argv[])
 		test_params.reply_size    = all_params[j].reply_size;
 		test_params.send_type     = all_params[j].send_type;
 		test_params.reply_type    = all_params[j].reply_type;
+		test_params.coalesce      = all_params[j].coalesce;
 		test_params.buf_alignment = buf_alignment;
 		test_params.srv_grp       = dest_name;
 
 		D_ASSERT(size_latencies[j] != NULL);
 		print_size_results(&test_params, ms_endpts, num_ms_endpts, size_latencies[j],
-				   output_megabits);
+				   &size_durations[j * num_ms_endpts], output_megabits);
 	}
 	/********************* Clean up *********************/
 cleanup:
 	free_size_latencies(size_latencies, num_msg_sizes, num_ms_endpts);
+	D_FREE(size_durations);
 	D_FREE(ms_endpts);
 	D_FREE(ms_endpts_opt);
 	D_FREE(tgt_endpts);
 	D_FREE(all_params);
+	D_FREE(sweep_str);
 
 	self_test_fini(use_agent);
 	d_log_fini();
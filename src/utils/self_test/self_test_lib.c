@@ -545,7 +545,8 @@ run_self_test(struct st_size_params all_params[], int num_msg_sizes, int rep_cou
 	      uint32_t num_ms_endpts_in, struct st_endpoint *endpts, uint32_t num_endpts,
 	      struct st_master_endpt **ms_endpts_out, uint32_t *num_ms_endpts_out,
 	      struct st_latency ****size_latencies_out, int16_t buf_alignment,
-	      char *attach_info_path, bool use_agent, bool no_sync)
+	      char *attach_info_path, bool use_agent, bool no_sync,
+	      int64_t **size_durations_out)
 {
 	crt_context_t           crt_ctx;
 	crt_group_t            *srv_grp;
@@ -560,6 +561,7 @@ run_self_test(struct st_size_params all_params[], int num_msg_sizes, int rep_cou
 	uint32_t                num_ms_endpts = 0;
 
 	struct st_latency    ***size_latencies     = NULL;
+	int64_t                *size_durations     = NULL;
 	d_iov_t                *latencies_iov      = NULL;
 	d_sg_list_t            *latencies_sg_list  = NULL;
 	crt_bulk_t             *latencies_bulk_hdl = CRT_BULK_NULL;
@@ -684,6 +686,12 @@ run_self_test(struct st_size_params all_params[], int num_msg_sizes, int rep_cou
 		if (size_latencies[size_idx] == NULL)
 			D_GOTO(cleanup, ret = -DER_NOMEM);
 	}
+	/* The reply of each master endpoint is overwritten by the next size */
+	if (size_durations_out != NULL) {
+		D_ALLOC_ARRAY(size_durations, num_msg_sizes * num_ms_endpts);
+		if (size_durations == NULL)
+			D_GOTO(cleanup, ret = -DER_NOMEM);
+	}
 	D_ALLOC_ARRAY(latencies_iov, num_ms_endpts);
 	if (latencies_iov == NULL)
 		D_GOTO(cleanup, ret = -DER_NOMEM);
@@ -733,6 +741,7 @@ run_self_test(struct st_size_params all_params[], int num_msg_sizes, int rep_cou
 		test_params.reply_size    = all_params[size_idx].reply_size;
 		test_params.send_type     = all_params[size_idx].send_type;
 		test_params.reply_type    = all_params[size_idx].reply_type;
+		test_params.coalesce      = all_params[size_idx].coalesce;
 		test_params.buf_alignment = buf_alignment;
 		test_params.srv_grp       = dest_name;
 
@@ -747,6 +756,11 @@ run_self_test(struct st_size_params all_params[], int num_msg_sizes, int rep_cou
 			D_GOTO(cleanup, ret);
 		}
 
+		if (size_durations != NULL)
+			for (m_idx = 0; m_idx < num_ms_endpts; m_idx++)
+				size_durations[size_idx * num_ms_endpts + m_idx] =
+				    ms_endpts[m_idx].reply.test_duration_ns;
+
 		/* Clean up this size iteration's handles */
 		for (m_idx = 0; m_idx < num_ms_endpts; m_idx++)
 			if (latencies_bulk_hdl[m_idx] != CRT_BULK_NULL)
@@ -777,8 +791,11 @@ cleanup_nothread:
 		if (ms_endpts != NULL)
 			D_FREE(ms_endpts);
 		free_size_latencies(size_latencies, num_msg_sizes, num_ms_endpts);
+		D_FREE(size_durations);
 	} else {
 		*size_latencies_out = size_latencies;
+		if (size_durations_out != NULL)
+			*size_durations_out = size_durations;
 		*ms_endpts_out      = ms_endpts;
 		*num_ms_endpts_out  = num_ms_endpts;
 	}
@@ -21,6 +21,8 @@ struct st_size_params {
 		struct {
 			enum crt_st_msg_type send_type  : 2;
 			enum crt_st_msg_type reply_type : 2;
+			/* send through the coalescing twin opcodes */
+			uint32_t             coalesce   : 1;
 		};
 		uint32_t flags;
 	};
@@ -48,7 +50,7 @@ run_self_test(struct st_size_params all_params[], int num_msg_sizes, int rep_cou
 	      uint32_t num_ms_endpts_in, struct st_endpoint *endpts, uint32_t num_endpts,
 	      struct st_master_endpt **ms_endpts_out, uint32_t *num_ms_endpts_out,
 	      struct st_latency ****size_latencies, int16_t buf_alignment, char *attach_info_path,
-	      bool use_agent, bool no_sync);
+	      bool use_agent, bool no_sync, int64_t **size_durations);
 int
 st_compare_endpts(const void *a_in, const void *b_in);
 int
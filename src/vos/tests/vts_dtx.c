@@ -857,6 +857,118 @@ dtx_18(void **state)
 	assert_memory_equal(update_buf, fetch_buf, UPDATE_BUF_SIZE);
 }
 
+/* Prepare and commit @nr DTXs one by one. */
+static void
+dtx_act_churn(struct io_test_args *args, int nr)
+{
+	daos_iod_t			 iod = { 0 };
+	d_sg_list_t			 sgl = { 0 };
+	daos_recx_t			 rex = { 0 };
+	daos_key_t			 dkey;
+	daos_key_t			 akey;
+	d_iov_t				 val_iov;
+	d_iov_t				 dkey_iov;
+	struct dtx_id			 xid;
+	uint64_t			 epoch;
+	uint64_t			 dkey_hash;
+	char				 dkey_buf[UPDATE_DKEY_SIZE];
+	char				 akey_buf[UPDATE_AKEY_SIZE];
+	char				 update_buf[UPDATE_BUF_SIZE];
+	int				 rc;
+	int				 i;
+
+	for (i = 0; i < nr; i++) {
+		struct dtx_handle	*dth = NULL;
+
+		vts_dtx_prep_update(args, &val_iov, &dkey_iov, &dkey,
+				    dkey_buf, &akey, akey_buf, &iod, &sgl,
+				    &rex, update_buf, UPDATE_BUF_SIZE,
+				    UPDATE_REC_SIZE, &dkey_hash, &epoch, false);
+
+		vts_dtx_begin(&args->oid, args->ctx.tc_co_hdl, epoch, dkey_hash,
+			      &dth);
+
+		rc = io_test_obj_update(args, epoch, 0, &dkey, &iod, &sgl,
+					dth, true);
+		assert_rc_equal(rc, 0);
+
+		xid = dth->dth_xid;
+		vts_dtx_end(dth);
+
+		rc = vos_dtx_commit(args->ctx.tc_co_hdl, &xid, 1, NULL);
+		assert_rc_equal(rc, 1);
+	}
+}
+
+/* Long-lived DTX does not make the active DTX table grow. */
+static void
+dtx_19(void **state)
+{
+	struct io_test_args		*args = *state;
+	struct dtx_handle		*dth = NULL;
+	struct vos_container		*cont;
+	struct vos_dtx_blob_df		*dbd;
+	struct dtx_id			 xid;
+	daos_iod_t			 iod = { 0 };
+	d_sg_list_t			 sgl = { 0 };
+	daos_recx_t			 rex = { 0 };
+	daos_key_t			 dkey;
+	daos_key_t			 akey;
+	d_iov_t				 val_iov;
+	d_iov_t				 dkey_iov;
+	uint64_t			 epoch;
+	uint64_t			 dkey_hash;
+	char				 dkey_buf[UPDATE_DKEY_SIZE];
+	char				 akey_buf[UPDATE_AKEY_SIZE];
+	char				 update_buf[UPDATE_BUF_SIZE];
+	char				 fetch_buf[UPDATE_BUF_SIZE];
+	int				 rc;
+
+	/* Assume I am the leader. */
+	vts_dtx_prep_update(args, &val_iov, &dkey_iov, &dkey,
+			    dkey_buf, &akey, akey_buf, &iod, &sgl,
+			    &rex, update_buf, UPDATE_BUF_SIZE,
+			    UPDATE_REC_SIZE, &dkey_hash, &epoch, false);
+
+	vts_dtx_begin(&args->oid, args->ctx.tc_co_hdl, epoch, dkey_hash, &dth);
+
+	rc = io_test_obj_update(args, epoch, 0, &dkey, &iod, &sgl, dth, true);
+	assert_rc_equal(rc, 0);
+
+	xid = dth->dth_xid;
+	vts_dtx_end(dth);
+
+	cont = vos_hdl2cont(args->ctx.tc_co_hdl);
+	dbd = umem_off2ptr(vos_cont2umm(cont), cont->vc_cont_df->cd_dtx_active_tail);
+	assert_non_null(dbd);
+	assert_int_equal(cont->vc_dtx_act_blob_cnt, 1);
+
+	/* The slots released after the blob is full are reused. */
+	dtx_act_churn(args, dbd->dbd_cap * 2);
+	assert_int_equal(cont->vc_dtx_act_blob_cnt, 1);
+
+	/* Also after the active DTX table is reindexed. */
+	rc = vos_dtx_cache_reset(args->ctx.tc_co_hdl, true);
+	assert_rc_equal(rc, 0);
+
+	dtx_act_churn(args, dbd->dbd_cap);
+	assert_int_equal(cont->vc_dtx_act_blob_cnt, 1);
+
+	rc = vos_dtx_check(args->ctx.tc_co_hdl, &xid, NULL, NULL, NULL, false);
+	assert_int_equal(rc, DTX_ST_PREPARED);
+
+	rc = vos_dtx_commit(args->ctx.tc_co_hdl, &xid, 1, NULL);
+	assert_rc_equal(rc, 1);
+
+	memset(fetch_buf, 0, UPDATE_BUF_SIZE);
+	d_iov_set(&val_iov, fetch_buf, UPDATE_BUF_SIZE);
+	iod.iod_size = DAOS_REC_ANY;
+
+	rc = io_test_obj_fetch(args, epoch, 0, &dkey, &iod, &sgl, true);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(update_buf, fetch_buf, UPDATE_BUF_SIZE);
+}
+
 static int
 dtx_tst_teardown(void **state)
 {
@@ -891,6 +1003,8 @@ static const struct CMUnitTest dtx_tests[] = {
 	  dtx_17, NULL, dtx_tst_teardown },
 	{ "VOS518: DTX aggregation",
 	  dtx_18, NULL, dtx_tst_teardown },
+	{ "VOS519: reuse released active DTX slots",
+	  dtx_19, NULL, dtx_tst_teardown },
 };
 
 int
@@ -586,6 +586,24 @@ vos_tls_init(int tags, int xs_id, int tgt_id)
 		if (rc)
 			D_WARN("Failed to create vos obj cnt: "DF_RC"\n", DP_RC(rc));
 
+		rc = d_tm_add_metric(&tls->vtl_dtx_act_scm, D_TM_GAUGE,
+				     "SCM space of the active DTX blobs", "bytes",
+				     "mem/vos/dtx_act_blob/tgt_%u", tgt_id);
+		if (rc)
+			D_WARN("Failed to create active DTX blob size: "DF_RC"\n", DP_RC(rc));
+
+		rc = d_tm_add_metric(&tls->vtl_dtx_act_rec, D_TM_GAUGE,
+				     "DRAM space of the active DTX records out of inline", "bytes",
+				     "mem/vos/dtx_act_rec/tgt_%u", tgt_id);
+		if (rc)
+			D_WARN("Failed to create active DTX records size: "DF_RC"\n", DP_RC(rc));
+
+		rc = d_tm_add_metric(&tls->vtl_dtx_act_reuse, D_TM_COUNTER,
+				     "Number of released active DTX slots reused", "entries",
+				     "io/dtx/act_slot_reuse/tgt_%u", tgt_id);
+		if (rc)
+			D_WARN("Failed to create active DTX slot reuse cnt: "DF_RC"\n",
+			       DP_RC(rc));
 	}
 
 	rc = d_tm_add_metric(&tls->vtl_lru_alloc_size, D_TM_GAUGE,
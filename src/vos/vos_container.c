@@ -213,6 +213,7 @@ cont_free_internal(struct vos_container *cont)
 	cont->vc_pool->vp_dtx_committed_count -= cont->vc_dtx_committed_count;
 	d_tm_dec_gauge(vos_tls_get(cont->vc_pool->vp_sysdb)->vtl_committed,
 		       cont->vc_dtx_committed_count);
+	vos_dtx_act_fini(cont);
 
 	D_FREE(cont);
 }
@@ -68,6 +68,72 @@ dtx_type2umoff_flag(umem_off_t *rec, uint32_t type)
 	umem_off_set_flags(rec, flag);
 }
 
+static inline void
+dtx_act_rec_track(struct vos_container *cont, int old_cap, int new_cap)
+{
+	struct vos_tls	*tls = vos_tls_get(cont->vc_pool->vp_sysdb);
+
+	if (new_cap > old_cap)
+		d_tm_inc_gauge(tls->vtl_dtx_act_rec, sizeof(umem_off_t) * (new_cap - old_cap));
+	else if (new_cap < old_cap)
+		d_tm_dec_gauge(tls->vtl_dtx_act_rec, sizeof(umem_off_t) * (old_cap - new_cap));
+}
+
+static inline void
+dtx_act_rec_free(struct vos_container *cont, struct vos_dtx_act_ent *dae)
+{
+	dtx_act_rec_track(cont, dae->dae_rec_cap, 0);
+	D_FREE(dae->dae_records);
+	dae->dae_rec_cap = 0;
+}
+
+static inline void
+dtx_act_blob_track(struct vos_container *cont, int cnt)
+{
+	struct vos_tls	*tls = vos_tls_get(cont->vc_pool->vp_sysdb);
+
+	if (cnt > 0)
+		d_tm_inc_gauge(tls->vtl_dtx_act_scm, (uint64_t)DTX_ACT_BLOB_SIZE * cnt);
+	else if (cnt < 0)
+		d_tm_dec_gauge(tls->vtl_dtx_act_scm, (uint64_t)DTX_ACT_BLOB_SIZE * -cnt);
+	cont->vc_dtx_act_blob_cnt += cnt;
+}
+
+/*
+ * The slots of the tail active DTX blob are handed out in order. Once the blob is full,
+ * the slots released since then are reused before allocating another blob, so that the
+ * long-lived DTXs scattered in the former blobs do not cause the table to keep growing.
+ * The free slots are only tracked in DRAM, they are lost (not reused) after restart or
+ * if the release is rolled back, hence double check the slot on-disk status before use.
+ */
+static void
+dtx_act_slot_put(struct vos_container *cont, struct vos_dtx_blob_df *dbd, int32_t idx)
+{
+	if (cont->vc_dtx_act_free == NULL) {
+		D_ALLOC_ARRAY(cont->vc_dtx_act_free, dbd->dbd_cap);
+		/* Not fatal, just not reuse the slot. */
+		if (cont->vc_dtx_act_free == NULL)
+			return;
+	}
+
+	if (cont->vc_dtx_act_free_cnt < dbd->dbd_cap)
+		cont->vc_dtx_act_free[cont->vc_dtx_act_free_cnt++] = idx;
+}
+
+static int32_t
+dtx_act_slot_get(struct vos_container *cont, struct vos_dtx_blob_df *dbd)
+{
+	int32_t	idx;
+
+	while (cont->vc_dtx_act_free_cnt > 0) {
+		idx = cont->vc_dtx_act_free[--cont->vc_dtx_act_free_cnt];
+		if (dbd->dbd_active_data[idx].dae_flags & DTE_INVALID)
+			return idx;
+	}
+
+	return DTX_INDEX_INVAL;
+}
+
 static inline uint32_t
 dtx_umoff_flag2type(umem_off_t umoff)
 {
@@ -207,8 +273,7 @@ dtx_act_ent_cleanup(struct vos_container *cont, struct vos_dtx_act_ent *dae,
 		dae->dae_oid_cnt = 0;
 	}
 
-	D_FREE(dae->dae_records);
-	dae->dae_rec_cap = 0;
+	dtx_act_rec_free(cont, dae);
 	DAE_REC_CNT(dae) = 0;
 
 	dae->dae_df_off = UMOFF_NULL;
@@ -705,6 +770,9 @@ dtx_rec_release(struct vos_container *cont, struct vos_dtx_act_ent *dae,
 		/* Mark the DTX entry as invalid persistently. */
 		dae_df->dae_flags = DTE_INVALID;
 		dbd->dbd_count--;
+
+		if (umem_ptr2off(umm, dbd) == cont->vc_cont_df->cd_dtx_active_tail)
+			dtx_act_slot_put(cont, dbd, DAE_INDEX(dae));
 	} else {
 		struct vos_cont_df	*cont_df = cont->vc_cont_df;
 		umem_off_t		 dbd_off;
@@ -747,9 +815,13 @@ dtx_rec_release(struct vos_container *cont, struct vos_dtx_act_ent *dae,
 				return rc;
 
 			cont_df->cd_dtx_active_tail = dbd->dbd_prev;
+			/* The free slots are gone together with the former tail. */
+			cont->vc_dtx_act_free_cnt = 0;
 		}
 
 		rc = umem_free(umm, dbd_off);
+		if (rc == 0)
+			dtx_act_blob_track(cont, -1);
 
 		DL_CDEBUG(rc != 0, DLOG_ERR, DB_IO, rc,
 			  "Release DTX active blob %p (" UMOFF_PF ") for cont " DF_UUID, dbd,
@@ -952,6 +1024,9 @@ vos_dtx_extend_act_table(struct vos_container *cont)
 	}
 
 	cont_df->cd_dtx_active_tail = dbd_off;
+	/* The former tail is full, its free slots will not be reused any more. */
+	cont->vc_dtx_act_free_cnt = 0;
+	dtx_act_blob_track(cont, 1);
 
 out:
 	DL_CDEBUG(rc == 0, DB_IO, DLOG_ERR, rc,
@@ -1048,16 +1123,11 @@ vos_dtx_append(struct dtx_handle *dth, umem_off_t record, uint32_t type)
 			else
 				count = dae->dae_rec_cap * 2;
 
-			D_ALLOC_ARRAY(rec, count);
+			D_REALLOC_ARRAY_NZ(rec, dae->dae_records, count);
 			if (rec == NULL)
 				return -DER_NOMEM;
 
-			if (dae->dae_records != NULL) {
-				memcpy(rec, dae->dae_records,
-				       sizeof(*rec) * dae->dae_rec_cap);
-				D_FREE(dae->dae_records);
-			}
-
+			dtx_act_rec_track(vos_hdl2cont(dth->dth_coh), dae->dae_rec_cap, count);
 			dae->dae_records = rec;
 			dae->dae_rec_cap = count;
 		}
@@ -1646,6 +1716,7 @@ vos_dtx_prepared(struct dtx_handle *dth, struct vos_dtx_cmt_ent **dce_p)
 	struct vos_dtx_blob_df		*dbd;
 	umem_off_t			 rec_off;
 	size_t				 size;
+	int32_t				 idx = DTX_INDEX_INVAL;
 	int				 count;
 	int				 rc = 0;
 
@@ -1682,7 +1753,10 @@ vos_dtx_prepared(struct dtx_handle *dth, struct vos_dtx_cmt_ent **dce_p)
 	cont_df = cont->vc_cont_df;
 	umm = vos_cont2umm(cont);
 	dbd = umem_off2ptr(umm, cont_df->cd_dtx_active_tail);
-	if (dbd == NULL || dbd->dbd_index >= dbd->dbd_cap) {
+	if (dbd != NULL && dbd->dbd_index >= dbd->dbd_cap)
+		idx = dtx_act_slot_get(cont, dbd);
+
+	if (dbd == NULL || (dbd->dbd_index >= dbd->dbd_cap && idx == DTX_INDEX_INVAL)) {
 		rc = vos_dtx_extend_act_table(cont);
 		if (rc != 0)
 			return rc;
@@ -1695,7 +1769,8 @@ vos_dtx_prepared(struct dtx_handle *dth, struct vos_dtx_cmt_ent **dce_p)
 	dae->dae_dbd = dbd;
 	dae->dae_df_off = umem_ptr2off(umm, dbd) +
 			  offsetof(struct vos_dtx_blob_df, dbd_active_data) +
-			  sizeof(struct vos_dtx_act_ent_df) * dbd->dbd_index;
+			  sizeof(struct vos_dtx_act_ent_df) *
+			  (idx != DTX_INDEX_INVAL ? idx : dbd->dbd_index);
 	dae_df = umem_off2ptr(umm, dae->dae_df_off);
 
 	/* Use the dkey_hash for the last modification as the dkey_hash
@@ -1769,33 +1844,61 @@ vos_dtx_prepared(struct dtx_handle *dth, struct vos_dtx_cmt_ent **dce_p)
 
 		memcpy(umem_off2ptr(umm, rec_off), dae->dae_records, size);
 		DAE_REC_OFF(dae) = rec_off;
+
+		/* No more record will be appended, trim the DRAM copy. */
+		if (dae->dae_rec_cap > count) {
+			umem_off_t	*rec;
+
+			D_REALLOC_ARRAY_NZ(rec, dae->dae_records, count);
+			if (rec != NULL) {
+				dtx_act_rec_track(cont, dae->dae_rec_cap, count);
+				dae->dae_records = rec;
+				dae->dae_rec_cap = count;
+			}
+		}
 	}
 
-	DAE_INDEX(dae) = dbd->dbd_index;
-	if (DAE_INDEX(dae) > 0) {
-		rc = umem_tx_xadd_ptr(umm, dae_df, sizeof(*dae_df), UMEM_XADD_NO_SNAPSHOT);
+	if (idx != DTX_INDEX_INVAL) {
+		DAE_INDEX(dae) = idx;
+
+		/* The reused slot holds the released entry, keep it for rollback. */
+		rc = umem_tx_add_ptr(umm, dae_df, sizeof(*dae_df));
 		if (rc != 0)
 			goto out;
 
-		/* dbd_index is next to dbd_count */
-		rc = umem_tx_add_ptr(umm, &dbd->dbd_count,
-				     sizeof(dbd->dbd_count) + sizeof(dbd->dbd_index));
+		rc = umem_tx_add_ptr(umm, &dbd->dbd_count, sizeof(dbd->dbd_count));
 		if (rc != 0)
 			goto out;
+
+		d_tm_inc_counter(vos_tls_get(cont->vc_pool->vp_sysdb)->vtl_dtx_act_reuse, 1);
+	} else {
+		DAE_INDEX(dae) = dbd->dbd_index;
+		if (DAE_INDEX(dae) > 0) {
+			rc = umem_tx_xadd_ptr(umm, dae_df, sizeof(*dae_df),
+					      UMEM_XADD_NO_SNAPSHOT);
+			if (rc != 0)
+				goto out;
+
+			/* dbd_index is next to dbd_count */
+			rc = umem_tx_add_ptr(umm, &dbd->dbd_count,
+					     sizeof(dbd->dbd_count) + sizeof(dbd->dbd_index));
+			if (rc != 0)
+				goto out;
+		}
+		dbd->dbd_index++;
 	}
 
 	memcpy(dae_df, &dae->dae_base, sizeof(*dae_df));
 	dbd->dbd_count++;
-	dbd->dbd_index++;
 
 	dae->dae_preparing = 1;
 	dae->dae_need_release = 1;
 
 out:
 	DL_CDEBUG(rc != 0, DLOG_ERR, DB_IO, rc,
-		  "Preparing DTX "DF_DTI" in dbd "UMOFF_PF" at index %u, count %u, cap %u",
-		  DP_DTI(&DAE_XID(dae)), UMOFF_P(cont_df->cd_dtx_active_tail),
-		  dbd->dbd_index, dbd->dbd_count, dbd->dbd_cap);
+		  "Preparing DTX "DF_DTI" in dbd "UMOFF_PF" at slot %d, index %u, count %u, "
+		  "cap %u", DP_DTI(&DAE_XID(dae)), UMOFF_P(cont_df->cd_dtx_active_tail),
+		  DAE_INDEX(dae), dbd->dbd_index, dbd->dbd_count, dbd->dbd_cap);
 	return rc;
 }
 
@@ -2898,6 +3001,14 @@ vos_dtx_mark_sync(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch)
 	return 0;
 }
 
+void
+vos_dtx_act_fini(struct vos_container *cont)
+{
+	dtx_act_blob_track(cont, -(int)cont->vc_dtx_act_blob_cnt);
+	D_FREE(cont->vc_dtx_act_free);
+	cont->vc_dtx_act_free_cnt = 0;
+}
+
 int
 vos_dtx_act_reindex(struct vos_container *cont)
 {
@@ -2911,19 +3022,27 @@ vos_dtx_act_reindex(struct vos_container *cont)
 	int				 rc = 0;
 	int				 i;
 
+	/* Rebuild the DRAM state of the blobs, the table may be reindexed on cache reset. */
+	dtx_act_blob_track(cont, -(int)cont->vc_dtx_act_blob_cnt);
+	cont->vc_dtx_act_free_cnt = 0;
+
 	while (!UMOFF_IS_NULL(dbd_off)) {
 		int	dbd_count = 0;
 
 		dbd = umem_off2ptr(umm, dbd_off);
 		D_ASSERT(dbd->dbd_magic == DTX_ACT_BLOB_MAGIC);
+		dtx_act_blob_track(cont, 1);
 
 		for (i = 0; i < dbd->dbd_index; i++) {
 			struct vos_dtx_act_ent_df	*dae_df;
 			struct vos_dtx_act_ent		*dae;
 
 			dae_df = &dbd->dbd_active_data[i];
-			if (dae_df->dae_flags & DTE_INVALID)
+			if (dae_df->dae_flags & DTE_INVALID) {
+				if (dbd_off == cont_df->cd_dtx_active_tail)
+					dtx_act_slot_put(cont, dbd, i);
 				continue;
+			}
 
 			if (daos_is_zero_dti(&dae_df->dae_xid)) {
 				D_WARN("Hit zero active DTX entry.\n");
@@ -2981,6 +3100,7 @@ vos_dtx_act_reindex(struct vos_container *cont)
 				       umem_off2ptr(umm, dae_df->dae_rec_off),
 				       size);
 				dae->dae_rec_cap = count;
+				dtx_act_rec_track(cont, 0, count);
 			}
 
 			d_iov_set(&kiov, &DAE_XID(dae), sizeof(DAE_XID(dae)));
@@ -2989,7 +3109,7 @@ vos_dtx_act_reindex(struct vos_container *cont)
 					   BTR_PROBE_EQ, DAOS_INTENT_UPDATE,
 					   &kiov, &riov, NULL);
 			if (rc != 0) {
-				D_FREE(dae->dae_records);
+				dtx_act_rec_free(cont, dae);
 				dtx_evict_lid(cont, dae);
 				goto out;
 			}
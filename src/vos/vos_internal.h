@@ -382,6 +382,11 @@ struct vos_container {
 	uint64_t		vc_io_nospc_ts;
 	/* The (next) position for committed DTX entries reindex. */
 	umem_off_t		vc_cmt_dtx_reindex_pos;
+	/* The released slots in the tail active DTX blob, reused when it is full. */
+	int			*vc_dtx_act_free;
+	int			 vc_dtx_act_free_cnt;
+	/* The number of the active DTX blobs. */
+	uint32_t		 vc_dtx_act_blob_cnt;
 	/* The epoch for the latest committed solo DTX. Any solo
 	 * * transaction with older epoch must have been committed.
 	 */
@@ -803,6 +808,14 @@ vos_dtx_post_handle(struct vos_container *cont,
 int
 vos_dtx_act_reindex(struct vos_container *cont);
 
+/**
+ * Release the DRAM state of the active DTX table, when the container is freed.
+ *
+ * \param cont	[IN]	Pointer to the container.
+ */
+void
+vos_dtx_act_fini(struct vos_container *cont);
+
 enum vos_tree_class {
 	/** the first reserved tree class */
 	VOS_BTR_BEGIN		= DBTREE_VOS_BEGIN,
@@ -65,6 +65,10 @@ struct vos_tls {
 	struct d_tm_node_t		 *vtl_committed;
 	struct d_tm_node_t		 *vtl_obj_cnt;
 	struct d_tm_node_t		 *vtl_lru_alloc_size;
+	/** Active DTX table footprint: SCM blobs, DRAM records and reused blob slots */
+	struct d_tm_node_t		 *vtl_dtx_act_scm;
+	struct d_tm_node_t		 *vtl_dtx_act_rec;
+	struct d_tm_node_t		 *vtl_dtx_act_reuse;
 };
 
 struct bio_xs_context *vos_xsctxt_get(void);